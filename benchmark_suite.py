@@ -0,0 +1,476 @@
+#!/usr/bin/env python3
+"""
+In-Process Benchmark Suite for Quick Document Convertor
+Per-stage microbenchmarks (readers, writers, image preprocessing steps, OCR
+backends) and convert_batch scaling curves, timed inside one interpreter so
+start-up cost never pollutes the numbers. Results are written as JSON and
+compared against a stored baseline to catch throughput regressions.
+
+Usage:
+    python benchmark_suite.py                               # all suites, print table
+    python benchmark_suite.py --suite readers writers -o results.json
+    python benchmark_suite.py --corpus ~/docs --save-baseline benchmark_baseline.json
+    python benchmark_suite.py --baseline benchmark_baseline.json --tolerance 0.15
+
+Designed and built by Beau Lewis (blewisxx@gmail.com)
+"""
+
+import argparse
+import gc
+import importlib.util
+import json
+import logging
+import os
+import platform
+import random
+import shutil
+import statistics
+import sys
+import tempfile
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Sequence
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+from converter_core import FormatDetector, UniversalConverter, registry
+
+RESULTS_VERSION = 1
+SUITES = ('readers', 'writers', 'image', 'ocr', 'batch')
+DEFAULT_BASELINE = Path(__file__).parent / "benchmark_baseline.json"
+
+_WORDS = (
+    "document converter throughput paragraph heading section report invoice "
+    "scanned page table figure summary appendix reference quarterly analysis "
+    "customer account balance statement archive index record"
+).split()
+
+
+class DatasetGenerator:
+    """
+    Builds benchmark inputs
+
+    Synthetic documents are generated from a seeded word list and written in
+    every format a registered writer supports, so each reader is measured on
+    equivalent content. A corpus directory adds real files, grouped by their
+    detected format. Synthetic images render text lines for the OCR stages.
+    """
+
+    def __init__(self, root: Path, seed: int = 1234):
+        self.root = Path(root)
+        self.root.mkdir(parents=True, exist_ok=True)
+        self.random = random.Random(seed)
+
+    def blocks(self, paragraphs: int = 200, words_per_paragraph: int = 80) -> List[tuple]:
+        """Content blocks shaped like a typical report: headings, paragraphs and lists"""
+        blocks = []
+        for i in range(paragraphs):
+            if i % 20 == 0:
+                blocks.append(('heading', 1 + (i // 20) % 3, f"Section {i // 20 + 1}"))
+            words = [self.random.choice(_WORDS) for _ in range(words_per_paragraph)]
+            if i % 10 == 5:
+                blocks.append(('list_item', ' '.join(words[:12])))
+            else:
+                blocks.append(('paragraph', ' '.join(words).capitalize() + '.'))
+        return blocks
+
+    def documents(self, sizes: Dict[str, int]) -> Dict[str, Dict[str, Path]]:
+        """
+        Write synthetic documents in every writable input format
+
+        Args:
+            sizes: Label -> paragraph count, e.g. {'small': 20, 'large': 2000}
+
+        Returns:
+            Input format -> size label -> file path
+        """
+        dataset: Dict[str, Dict[str, Path]] = {}
+        converter_writers = registry.writers.instances()
+        for label, paragraphs in sizes.items():
+            content = self.blocks(paragraphs)
+            for fmt in registry.readers.keys():
+                if fmt not in registry.writers or registry.writers.missing_dependencies(fmt):
+                    continue
+                ext = FormatDetector.SUPPORTED_OUTPUT_FORMATS[fmt]['extension']
+                path = self.root / f"{label}{ext}"
+                try:
+                    converter_writers[fmt].write(iter(content), path)
+                except Exception as e:
+                    print(f"  skip {fmt} dataset ({label}): {e}")
+                    continue
+                dataset.setdefault(fmt, {})[label] = path
+            docx_path = self._write_docx(content, self.root / f"{label}.docx")
+            if docx_path:
+                dataset.setdefault('docx', {})[label] = docx_path
+        return dataset
+
+    @staticmethod
+    def _write_docx(content: List[tuple], path: Path) -> Optional[Path]:
+        """DOCX has no writer in the converter; build one with python-docx if installed"""
+        if importlib.util.find_spec('docx') is None:
+            return None
+        from docx import Document
+        document = Document()
+        for block in content:
+            if block[0] == 'heading':
+                document.add_heading(block[2], level=block[1])
+            else:
+                document.add_paragraph(block[-1])
+        document.save(str(path))
+        return path
+
+    @staticmethod
+    def corpus(directory: Path, per_format: int = 20) -> Dict[str, Dict[str, Path]]:
+        """Pick up to ``per_format`` real files per detected input format"""
+        dataset: Dict[str, Dict[str, Path]] = {}
+        for path in sorted(Path(directory).rglob('*')):
+            fmt = FormatDetector.detect_format(path) if path.is_file() else None
+            if fmt and len(dataset.get(fmt, {})) < per_format:
+                dataset.setdefault(fmt, {})[f"corpus:{path.name}"] = path
+        return dataset
+
+    def image(self, width: int = 1700, height: int = 2200, lines: int = 40):
+        """A scanned-page-like BGR image with text lines, or None without numpy/OpenCV"""
+        try:
+            import cv2
+            import numpy as np
+        except ImportError:
+            return None
+        image = np.full((height, width, 3), 255, dtype=np.uint8)
+        noise = np.random.default_rng(self.random.randint(0, 2 ** 31)).integers(0, 25, image.shape, dtype=np.uint8)
+        image -= noise
+        for i in range(lines):
+            text = ' '.join(self.random.choice(_WORDS) for _ in range(8))
+            cv2.putText(image, text, (60, 80 + i * (height - 160) // lines), cv2.FONT_HERSHEY_SIMPLEX,
+                        1.2, (20, 20, 20), 2, cv2.LINE_AA)
+        return image
+
+
+class BenchmarkRunner:
+    """Times callables with warm-up and repeats and collects comparable records"""
+
+    def __init__(self, repeat: int = 5, warmup: int = 1, quiet: bool = False):
+        self.repeat = max(1, repeat)
+        self.warmup = max(0, warmup)
+        self.quiet = quiet
+        self.results: Dict[str, Dict[str, Any]] = {}
+
+    def measure(self, name: str, stage: str, fn: Callable[[], Any], units: float = 1.0,
+                unit: str = 'ops', repeat: Optional[int] = None, **extra) -> Dict[str, Any]:
+        """
+        Run ``fn`` repeatedly and record its timing
+
+        Args:
+            name: Unique benchmark name (key in the results and the baseline)
+            stage: Pipeline stage ('reader', 'writer', 'image', 'ocr', 'batch')
+            fn: Work to time; one call is one sample
+            units: Amount of work per call (bytes, files, pages...) for throughput
+            unit: Name of that amount
+        """
+        for _ in range(self.warmup):
+            fn()
+        samples = []
+        gc_was_enabled = gc.isenabled()
+        gc.disable()
+        try:
+            for _ in range(repeat or self.repeat):
+                start = time.perf_counter()
+                fn()
+                samples.append(time.perf_counter() - start)
+                gc.collect()
+        finally:
+            if gc_was_enabled:
+                gc.enable()
+
+        median = statistics.median(samples)
+        record = {
+            'stage': stage,
+            'samples': len(samples),
+            'median_s': median,
+            'min_s': min(samples),
+            'max_s': max(samples),
+            'stdev_s': statistics.stdev(samples) if len(samples) > 1 else 0.0,
+            'units': units,
+            'unit': unit,
+            'throughput': units / median if median > 0 else float('inf'),
+            **extra
+        }
+        self.results[name] = record
+        if not self.quiet:
+            print(f"  {name:<48} {median * 1000:10.2f} ms  {record['throughput']:12.1f} {unit}/s")
+        return record
+
+    def skip(self, name: str, stage: str, reason: str):
+        self.results[name] = {'stage': stage, 'skipped': reason}
+        if not self.quiet:
+            print(f"  {name:<48} skipped: {reason}")
+
+
+def bench_readers(runner: BenchmarkRunner, dataset: Dict[str, Dict[str, Path]]):
+    """Parse each dataset file with its format's reader"""
+    readers = registry.readers.instances()
+    for fmt in registry.readers.keys():
+        missing = registry.readers.missing_dependencies(fmt)
+        if missing:
+            runner.skip(f"reader.{fmt}", 'reader', f"missing {', '.join(missing)}")
+            continue
+        if fmt not in dataset:
+            runner.skip(f"reader.{fmt}", 'reader', "no input files for this format")
+            continue
+        reader = readers[fmt]
+        for label, path in dataset[fmt].items():
+            size = path.stat().st_size
+            runner.measure(f"reader.{fmt}.{label}", 'reader',
+                           lambda reader=reader, path=path: sum(1 for _ in reader.iter_read(path)),
+                           units=size / (1024 * 1024), unit='MB', reader=type(reader).__name__)
+
+
+def bench_writers(runner: BenchmarkRunner, generator: DatasetGenerator, workdir: Path,
+                  sizes: Dict[str, int]):
+    """Write the same synthetic content with every writer"""
+    writers = registry.writers.instances()
+    for label, paragraphs in sizes.items():
+        content = generator.blocks(paragraphs)
+        chars = sum(len(part) for block in content for part in block if isinstance(part, str))
+        for fmt in registry.writers.keys():
+            name = f"writer.{fmt}.{label}"
+            missing = registry.writers.missing_dependencies(fmt)
+            if missing:
+                runner.skip(name, 'writer', f"missing {', '.join(missing)}")
+                continue
+            writer = writers[fmt]
+            output = workdir / f"bench_out_{label}{FormatDetector.SUPPORTED_OUTPUT_FORMATS[fmt]['extension']}"
+            runner.measure(name, 'writer', lambda writer=writer, output=output: writer.write(iter(content), output),
+                           units=chars / (1024 * 1024), unit='MB', writer=type(writer).__name__,
+                           blocks=len(content))
+
+
+def bench_image_steps(runner: BenchmarkRunner, generator: DatasetGenerator):
+    """Time each ImageProcessor step on its own input, plus the full pipeline"""
+    image = generator.image()
+    if image is None:
+        runner.skip("image.pipeline", 'image', "numpy/OpenCV not installed")
+        return
+    import cv2
+    from ocr_engine.image_processor import ImageProcessor, opencl_available
+
+    processor = ImageProcessor()
+    megapixels = image.shape[0] * image.shape[1] / 1e6
+    encoded = cv2.imencode('.png', image)[1].tobytes()
+    resized = processor.resize_image(image, 2048)
+    contrasted = processor.enhance_contrast(resized, 1.5)
+    denoised = processor.denoise_image(contrasted, True)
+    gray = cv2.cvtColor(denoised, cv2.COLOR_BGR2GRAY) if denoised.ndim == 3 else denoised
+
+    steps = [
+        ('image.load', lambda: processor.load_image(encoded)),
+        ('image.resize', lambda: processor.resize_image(image, 2048)),
+        ('image.enhance_contrast', lambda: processor.enhance_contrast(resized, 1.5)),
+        ('image.denoise', lambda: processor.denoise_image(contrasted, True)),
+        ('image.grayscale', lambda: cv2.cvtColor(denoised, cv2.COLOR_BGR2GRAY)),
+        ('image.threshold', lambda: processor.apply_threshold(gray, 'adaptive')),
+        ('image.pipeline', lambda: processor.preprocess_image(image)),
+    ]
+    if opencl_available():
+        steps.append(('image.pipeline_opencl', lambda: processor.preprocess_image(image, {'use_opencl': True})))
+    for name, fn in steps:
+        runner.measure(name, 'image', fn, units=megapixels, unit='MP')
+
+
+def bench_ocr_backends(runner: BenchmarkRunner, generator: DatasetGenerator):
+    """Recognise one synthetic page with every available OCR backend, cache disabled"""
+    image = generator.image(lines=20)
+    if image is None:
+        runner.skip("ocr", 'ocr', "numpy/OpenCV not installed")
+        return
+    try:
+        from ocr_engine.ocr_engine import OCREngine
+        engine = OCREngine()
+    except Exception as e:
+        runner.skip("ocr", 'ocr', f"OCR engine unavailable: {e}")
+        return
+
+    backends = engine.get_available_backends()
+    if not backends:
+        runner.skip("ocr", 'ocr', "no OCR backend available")
+    for backend in backends:
+        options = {'backend': backend, 'use_cache': False}
+        runner.measure(f"ocr.{backend}", 'ocr', lambda options=options: engine.extract_text(image, options),
+                       units=1, unit='pages', repeat=min(runner.repeat, 3))
+
+
+def bench_batch_scaling(runner: BenchmarkRunner, generator: DatasetGenerator, workdir: Path,
+                        files: int, worker_counts: Sequence[int], executors: Sequence[str]):
+    """convert_batch throughput across worker counts and executors"""
+    source_dir = workdir / "batch_src"
+    source_dir.mkdir(exist_ok=True)
+    writer = registry.writers.instances()['txt']
+    file_list = []
+    for i in range(files):
+        path = source_dir / f"doc{i:04d}.txt"
+        writer.write(iter(generator.blocks(40)), path)
+        file_list.append(path)
+
+    converter = UniversalConverter("Benchmark", enable_caching=False)
+    # Per-file INFO logging (inherited by forked workers) would dominate small files
+    logging.disable(logging.INFO)
+    try:
+        _run_batch_curve(runner, converter, file_list, workdir, worker_counts, executors)
+    finally:
+        logging.disable(logging.NOTSET)
+
+
+def _run_batch_curve(runner: BenchmarkRunner, converter: UniversalConverter, file_list: List[Path],
+                     workdir: Path, worker_counts: Sequence[int], executors: Sequence[str]):
+    files = len(file_list)
+    for executor in executors:
+        for workers in worker_counts:
+            output_dir = workdir / f"batch_out_{executor}_{workers}"
+
+            def run(output_dir=output_dir, executor=executor, workers=workers):
+                shutil.rmtree(output_dir, ignore_errors=True)
+                converter.convert_batch(file_list, output_dir, 'txt', 'markdown', max_workers=workers,
+                                        executor=executor, overwrite_existing=True)
+
+            runner.measure(f"batch.{executor}.w{workers}", 'batch', run, units=files, unit='files',
+                           repeat=min(runner.repeat, 3), executor=executor, workers=workers)
+
+
+def compare_to_baseline(results: Dict[str, Dict[str, Any]], baseline: Dict[str, Dict[str, Any]],
+                        tolerance: float = 0.15) -> Dict[str, List[Dict[str, Any]]]:
+    """
+    Compare throughput with a baseline run
+
+    A benchmark regresses when its throughput falls more than ``tolerance``
+    (a fraction) below the baseline's; it improves when it rises more than
+    that. Benchmarks skipped or missing on either side are ignored.
+
+    Returns:
+        {'regressions': [...], 'improvements': [...]}, each entry with name,
+        baseline and current throughput and the relative change
+    """
+    report = {'regressions': [], 'improvements': []}
+    for name, current in results.items():
+        previous = baseline.get(name)
+        if not previous or 'throughput' not in previous or 'throughput' not in current:
+            continue
+        if not previous['throughput']:
+            continue
+        change = current['throughput'] / previous['throughput'] - 1.0
+        entry = {'name': name, 'baseline': previous['throughput'], 'current': current['throughput'],
+                 'unit': current.get('unit'), 'change': change}
+        if change < -tolerance:
+            report['regressions'].append(entry)
+        elif change > tolerance:
+            report['improvements'].append(entry)
+    return report
+
+
+def environment_info() -> Dict[str, Any]:
+    """Host details stored with every run, so baselines are compared like for like"""
+    return {
+        'python': platform.python_version(),
+        'implementation': platform.python_implementation(),
+        'platform': platform.platform(),
+        'machine': platform.machine(),
+        'cpu_count': os.cpu_count(),
+        'timestamp': time.strftime('%Y-%m-%dT%H:%M:%S'),
+    }
+
+
+def run_suites(suites: Sequence[str], workdir: Path, corpus: Optional[Path] = None, repeat: int = 5,
+               batch_files: int = 64, worker_counts: Sequence[int] = (1, 2, 4, 8),
+               executors: Sequence[str] = ('thread', 'process'), quick: bool = False,
+               quiet: bool = False) -> Dict[str, Any]:
+    """
+    Run the selected suites and return the full results document
+
+    ``quick`` shrinks datasets and repeats for smoke runs (e.g. in unit tests).
+    """
+    sizes = {'small': 5, 'medium': 50} if quick else {'small': 20, 'medium': 200, 'large': 2000}
+    runner = BenchmarkRunner(repeat=1 if quick else repeat, warmup=0 if quick else 1, quiet=quiet)
+    generator = DatasetGenerator(workdir / "dataset")
+
+    if 'readers' in suites:
+        if not quiet:
+            print("Readers")
+        dataset = generator.documents(sizes)
+        if corpus:
+            for fmt, files in DatasetGenerator.corpus(corpus).items():
+                dataset.setdefault(fmt, {}).update(files)
+        bench_readers(runner, dataset)
+    if 'writers' in suites:
+        if not quiet:
+            print("Writers")
+        bench_writers(runner, generator, workdir, sizes)
+    if 'image' in suites:
+        if not quiet:
+            print("Image preprocessing")
+        bench_image_steps(runner, generator)
+    if 'ocr' in suites:
+        if not quiet:
+            print("OCR backends")
+        bench_ocr_backends(runner, generator)
+    if 'batch' in suites:
+        if not quiet:
+            print("Batch scaling")
+        bench_batch_scaling(runner, generator, workdir, 8 if quick else batch_files,
+                            worker_counts[:2] if quick else worker_counts, executors)
+
+    return {'version': RESULTS_VERSION, 'environment': environment_info(), 'results': runner.results}
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description="In-process per-stage benchmarks with baseline comparison")
+    parser.add_argument('--suite', nargs='+', choices=SUITES, default=list(SUITES),
+                        help='Suites to run (default: all)')
+    parser.add_argument('--corpus', metavar='DIR', help='Also benchmark readers on real files from DIR')
+    parser.add_argument('--repeat', type=int, default=5, help='Timed samples per benchmark (default: 5)')
+    parser.add_argument('--batch-files', type=int, default=64, help='Files in the batch scaling run')
+    parser.add_argument('--workers', type=int, nargs='+', default=[1, 2, 4, 8],
+                        help='Worker counts for the batch scaling curve')
+    parser.add_argument('--executor', nargs='+', choices=['thread', 'process'], default=['thread', 'process'])
+    parser.add_argument('-o', '--output', metavar='FILE', help='Write results JSON to FILE')
+    parser.add_argument('--baseline', metavar='FILE',
+                        help=f'Compare against this baseline (default: {DEFAULT_BASELINE.name} if present)')
+    parser.add_argument('--save-baseline', metavar='FILE', help='Store this run as the new baseline')
+    parser.add_argument('--tolerance', type=float, default=0.15,
+                        help='Allowed throughput drop before a regression is reported (default: 0.15)')
+    parser.add_argument('--quick', action='store_true', help='Tiny datasets and one sample (smoke run)')
+    parser.add_argument('--quiet', '-q', action='store_true')
+    args = parser.parse_args(argv)
+
+    workdir = Path(tempfile.mkdtemp(prefix="converter_bench_"))
+    try:
+        document = run_suites(args.suite, workdir, Path(args.corpus) if args.corpus else None, args.repeat,
+                              args.batch_files, args.workers, args.executor, args.quick, args.quiet)
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    if args.output:
+        with open(args.output, 'w', encoding='utf-8') as f:
+            json.dump(document, f, indent=2)
+    if args.save_baseline:
+        with open(args.save_baseline, 'w', encoding='utf-8') as f:
+            json.dump(document, f, indent=2)
+        print(f"Baseline saved to {args.save_baseline}")
+
+    baseline_path = Path(args.baseline) if args.baseline else DEFAULT_BASELINE
+    if args.save_baseline or not baseline_path.exists():
+        return 0
+
+    with open(baseline_path, 'r', encoding='utf-8') as f:
+        baseline = json.load(f)
+    report = compare_to_baseline(document['results'], baseline.get('results', {}), args.tolerance)
+    for entry in report['improvements']:
+        print(f"IMPROVED   {entry['name']}: {entry['change']:+.1%}")
+    for entry in report['regressions']:
+        print(f"REGRESSION {entry['name']}: {entry['baseline']:.1f} -> {entry['current']:.1f} "
+              f"{entry['unit']}/s ({entry['change']:+.1%})")
+    if baseline.get('environment', {}).get('machine') != document['environment']['machine']:
+        print("Note: baseline was recorded on a different machine type")
+    return 1 if report['regressions'] else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
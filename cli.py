@@ -5,6 +5,7 @@ Designed and built by Beau Lewis (blewisxx@gmail.com)
 """
 
 import argparse
+import itertools
 import sys
 import os
 from pathlib import Path
@@ -15,13 +16,17 @@ from typing import List, Optional
 
 # Import the converter classes
 try:
-    from universal_document_converter import (
-        UniversalConverter, FormatDetector, ConverterLogger, ConfigManager,
+    from converter_core import (
+        UniversalConverter, FormatDetector, ConverterLogger, ConfigManager, BATCH_EXECUTORS, ContentCache,
         DocumentConverterError, UnsupportedFormatError, FileProcessingError
     )
+    from converter_core.admission import MB, MemoryBudget
+    from converter_core.discovery import iter_input_files
+    from converter_core.scheduler import PRIORITIES, PRIORITY_BATCH, Job
+    from converter_core.distributed import DEFAULT_LEASE_SECONDS, DEFAULT_SHARD_SIZE
 except ImportError as e:
     print(f"Error: Could not import converter modules: {e}")
-    print("Make sure universal_document_converter.py is in the same directory.")
+    print("Make sure the converter_core package is in the same directory.")
     sys.exit(1)
 
 
@@ -51,8 +56,16 @@ Examples:
   %(prog)s *.txt -o output_dir/ -f markdown          # Convert multiple files
   %(prog)s input_dir/ -o output_dir/ --recursive     # Convert directory recursively
   %(prog)s file.pdf -f auto -t html --workers 8      # Auto-detect input, use 8 threads
+  %(prog)s book.docx -o site/ -t markdown,html,epub  # Read once, write three formats
+  %(prog)s docs/ -o out/ -r --executor process       # Use one process per core
+  %(prog)s share/ -o out/ -r --incremental           # Nightly sync: only changed files
+  %(prog)s inbox/ -o out/ -r --watch --ocr           # Convert files as they are dropped in
+  %(prog)s docs/ -o out/ -r --metrics run.prom       # Export stage timings for Prometheus
   %(prog)s --list-formats                            # Show supported formats
   %(prog)s --batch config.json                       # Batch conversion from config file
+  %(prog)s --batch config.json --distribute :8765    # Shard a batch across worker nodes
+                                                     #   (set CONVERTER_CLUSTER_SECRET on every node)
+  %(prog)s --worker coordinator-host:8765            # Convert shards on this node
 
 Supported Input Formats:  DOCX, PDF, TXT, HTML, RTF
 Supported Output Formats: Markdown, TXT, HTML, RTF
@@ -69,9 +82,11 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
         parser.add_argument('-f', '--from-format', default='auto',
                           choices=['auto'] + list(FormatDetector.SUPPORTED_INPUT_FORMATS.keys()),
                           help='Input format (default: auto-detect)')
-        parser.add_argument('-t', '--to-format', default='markdown',
-                          choices=list(FormatDetector.SUPPORTED_OUTPUT_FORMATS.keys()),
-                          help='Output format (default: markdown)')
+        parser.add_argument('-t', '--to-format', default='markdown', type=self.parse_output_formats,
+                          metavar='FORMAT[,FORMAT...]',
+                          help='Output format, or a comma-separated list to read each source once and '
+                               'write every format (' + ', '.join(FormatDetector.SUPPORTED_OUTPUT_FORMATS) +
+                               '; default: markdown)')
         
         # Processing options
         parser.add_argument('--recursive', '-r', action='store_true',
@@ -80,18 +95,70 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
                           help='Preserve directory structure in output (default: True)')
         parser.add_argument('--overwrite', action='store_true',
                           help='Overwrite existing output files')
+        parser.add_argument('--incremental', action='store_true',
+                          help='Convert only new or changed sources, tracked in a manifest in the '
+                               'output directory; outputs of deleted sources are removed')
         parser.add_argument('--workers', type=int, default=None,
-                          help='Number of worker threads (default: auto)')
+                          help='Number of workers (default: auto)')
+        parser.add_argument('--executor', choices=list(BATCH_EXECUTORS), default=None,
+                          help='Batch executor: threads, or processes for CPU-bound '
+                               'batches (default: from config, thread)')
+        parser.add_argument('--memory-budget', type=float, default=None, metavar='MB',
+                          help='Estimated peak memory batch jobs may hold at once; small files run '
+                               'side by side, huge ones alone (default: 3/4 of available memory)')
+        parser.add_argument('--priority', choices=list(PRIORITIES), default='normal',
+                          help='Scheduling priority; batch also lowers the process priority so '
+                               'interactive conversions on this machine stay responsive')
         
+        # Watch-folder ingest
+        parser.add_argument('--watch', action='store_true',
+                          help='Keep running and convert files as they land in the input directory')
+        parser.add_argument('--settle', type=float, default=2.0, metavar='SECONDS',
+                          help='Watch mode: seconds a file must stop changing before it is converted '
+                               '(default: 2.0)')
+        parser.add_argument('--ocr', action='store_true',
+                          help='Watch mode: also OCR images dropped into the folder')
+        parser.add_argument('--poll', action='store_true',
+                          help='Watch mode: poll the folder instead of using OS change notifications')
+
         # Caching and performance
         parser.add_argument('--no-cache', action='store_true',
-                          help='Disable caching for this conversion')
+                          help='Disable caching (including the persistent content cache) for this conversion')
         parser.add_argument('--clear-cache', action='store_true',
                           help='Clear the conversion cache and exit')
+        parser.add_argument('--metrics', metavar='FILE',
+                          help='Write stage timings, cache hit rates and batch utilisation to FILE '
+                               '(rewritten periodically in watch mode)')
+        parser.add_argument('--metrics-format', choices=['json', 'prometheus'], default=None,
+                          help='Metrics file format (default: json for .json files, otherwise '
+                               'Prometheus text format)')
         
         # Batch processing
         parser.add_argument('--batch', metavar='CONFIG_FILE',
                           help='Batch conversion using JSON configuration file')
+
+        # Distributed batches: one coordinator, any number of worker nodes
+        # sharing the input and output file systems
+        parser.add_argument('--distribute', metavar='[HOST]:PORT',
+                          help='Coordinate the batch (--batch, or inputs and -o): serve its shards to '
+                               '--worker nodes, retry failed ones and print the merged results')
+        parser.add_argument('--worker', metavar='HOST:PORT',
+                          help='Run as a worker node: convert shards leased from the coordinator '
+                               'until its batch is done')
+        parser.add_argument('--shard-size', type=int, default=DEFAULT_SHARD_SIZE, metavar='FILES',
+                          help=f'Files per shard (default: {DEFAULT_SHARD_SIZE})')
+        parser.add_argument('--lease', type=float, default=DEFAULT_LEASE_SECONDS, metavar='SECONDS',
+                          help='Shards whose worker stops renewing for this long go to another node '
+                               f'(default: {DEFAULT_LEASE_SECONDS:.0f})')
+        parser.add_argument('--shard-attempts', type=int, default=3, metavar='N',
+                          help='Attempts per shard before it is given up on (default: 3)')
+        parser.add_argument('--queue-db', metavar='FILE',
+                          help='Keep the coordinator\'s shard queue in FILE, so a restarted '
+                               'coordinator resumes the batch')
+        parser.add_argument('--cluster-secret', default=os.environ.get('CONVERTER_CLUSTER_SECRET'),
+                          help='Shared secret coordinator and workers must agree on; required '
+                               'unless --distribute binds a loopback address '
+                               '(default: $CONVERTER_CLUSTER_SECRET)')
         
         # Information commands
         parser.add_argument('--list-formats', action='store_true',
@@ -229,6 +296,19 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
             print(f"Error loading profile: {e}")
             return False
 
+    def clear_cache(self) -> int:
+        """Clear the in-memory and persistent conversion caches"""
+        with self.converter.cache_lock:
+            self.converter.cache.clear()
+
+        content_cache = self.converter.content_cache
+        if content_cache is None:
+            content_cache = ContentCache(self.config_manager.config_dir / "content_cache")
+
+        removed = content_cache.clear()
+        print(f"Cache cleared successfully ({removed} cached documents removed from {content_cache.cache_dir})")
+        return 0
+
     def validate_args(self, args) -> bool:
         """Validate command line arguments"""
         # Check for information commands first
@@ -239,6 +319,9 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
         if args.save_config:
             return True
 
+        if args.worker:
+            return True
+
         # Check for batch mode
         if args.batch:
             if not Path(args.batch).exists():
@@ -254,6 +337,14 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
         if not args.output:
             print("Error: Output path required (use -o/--output)")
             return False
+
+        if args.watch and (len(args.input) != 1 or not Path(args.input[0]).is_dir()):
+            print("Error: --watch needs exactly one input directory")
+            return False
+
+        if (args.incremental or args.watch) and Path(args.output).suffix and not Path(args.output).is_dir():
+            print("Error: --incremental and --watch need an output directory (their manifest is kept there)")
+            return False
         
         # Validate input files exist
         for input_path in args.input:
@@ -282,6 +373,31 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
         for handler in self.logger.handlers:
             handler.setLevel(numeric_level)
     
+    @staticmethod
+    def parse_output_formats(value: str):
+        """argparse type for -t: one output format, or a list for comma-separated input"""
+        formats = [fmt.strip().lower() for fmt in value.split(',') if fmt.strip()]
+        unknown = [fmt for fmt in formats if fmt not in FormatDetector.SUPPORTED_OUTPUT_FORMATS]
+        if not formats or unknown:
+            raise argparse.ArgumentTypeError(
+                f"invalid output format: {', '.join(unknown) or value!r} "
+                f"(choose from {', '.join(FormatDetector.SUPPORTED_OUTPUT_FORMATS)})")
+        formats = list(dict.fromkeys(formats))
+        return formats[0] if len(formats) == 1 else formats
+
+    def get_output_targets(self, input_path: Path, output_base: Path, to_format,
+                           preserve_structure: bool, base_input_dir: Optional[Path] = None):
+        """Output path for one format, or a {format: path} mapping for several"""
+        if isinstance(to_format, str):
+            return self.get_output_path(input_path, output_base, to_format, preserve_structure, base_input_dir)
+        targets = {fmt: self.get_output_path(input_path, output_base, fmt, preserve_structure, base_input_dir)
+                   for fmt in to_format}
+        if len(set(targets.values())) < len(targets):
+            # An explicit output file name: derive one sibling per format
+            targets = {fmt: path.with_suffix(FormatDetector.SUPPORTED_OUTPUT_FORMATS[fmt]['extension'])
+                       for fmt, path in targets.items()}
+        return targets
+
     def convert_single_file(self, input_path: Path, output_path: Path, 
                           from_format: str, to_format: str) -> bool:
         """Convert a single file"""
@@ -316,34 +432,30 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
     
     def collect_input_files(self, input_paths: List[str], recursive: bool) -> List[Path]:
         """Collect all input files to process"""
-        files = []
-        
+        return list(iter_input_files(input_paths, recursive))
+
+    def base_input_directory(self, input_paths: List[str]) -> Optional[Path]:
+        """
+        Directory output paths are made relative to when preserving structure
+
+        Taken from the inputs rather than the discovered files, so it is known
+        before a streamed walk finishes. Glob patterns return None: the caller
+        expands them first.
+        """
+        roots = []
         for input_path in input_paths:
             path = Path(input_path)
-            
-            if path.is_file():
-                files.append(path)
-            elif path.is_dir():
-                if recursive:
-                    # Find all supported files recursively
-                    for fmt_info in FormatDetector.SUPPORTED_INPUT_FORMATS.values():
-                        for ext in fmt_info['extensions']:
-                            files.extend(path.rglob(f"*{ext}"))
-                else:
-                    # Find supported files in directory only
-                    for fmt_info in FormatDetector.SUPPORTED_INPUT_FORMATS.values():
-                        for ext in fmt_info['extensions']:
-                            files.extend(path.glob(f"*{ext}"))
+            if path.is_dir():
+                roots.append(path)
+            elif path.is_file():
+                roots.append(path.parent)
             else:
-                # Handle glob patterns
-                from glob import glob
-                matched_files = glob(str(path))
-                files.extend([Path(f) for f in matched_files if Path(f).is_file()])
-        
-        # Remove duplicates and filter out temporary files
-        unique_files = list(set(files))
-        return [f for f in unique_files if not f.name.startswith('~$')]
-    
+                return None
+        try:
+            return Path(os.path.commonpath([str(root) for root in roots])) if roots else None
+        except ValueError:
+            return None
+
     def run(self, args=None) -> int:
         """Main CLI execution method"""
         parser = self.create_parser()
@@ -362,9 +474,14 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
             return 0
 
         if args.clear_cache:
-            # Clear cache (implementation would go here)
-            print("Cache cleared successfully")
-            return 0
+            return self.clear_cache()
+
+        if args.no_cache:
+            self.converter.enable_caching = False
+            self.converter.content_cache = None
+
+        if args.memory_budget:
+            self.converter.memory_budget = MemoryBudget(args.memory_budget * MB)
 
         # Handle configuration commands
         if args.show_config:
@@ -386,43 +503,119 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
             if not self.load_profile(args.profile):
                 return 1
 
+        # Distributed batches
+        if args.worker:
+            return self.run_worker(args)
+        if args.distribute:
+            return self.run_coordinator(args)
+
         # Handle batch mode
         if args.batch:
             return self.run_batch_conversion(args.batch)
         
-        # Regular conversion mode
-        return self.run_conversion(args)
+        try:
+            if args.watch:
+                return self.run_watch(args)
+
+            # Regular conversion mode
+            return self.run_conversion(args)
+        finally:
+            if args.metrics:
+                self.write_metrics(args)
+
+    def write_metrics(self, args) -> None:
+        """Export the converter's metrics to the --metrics file"""
+        try:
+            path = self.converter.metrics.write(args.metrics, args.metrics_format)
+            self.logger.debug(f"Metrics written to {path}")
+        except OSError as e:
+            print(f"Warning: could not write metrics to {args.metrics}: {e}")
+
+    def run_watch(self, args) -> int:
+        """Convert files continuously as they arrive in a drop folder"""
+        from converter_core.watcher import FolderWatcher
+
+        metrics_written = [time.monotonic()]
+
+        def report(result):
+            if result['status'] == 'error':
+                print(f"ERROR: {result['path']}: {result.get('error')}")
+            elif result['status'] == 'success' and not args.quiet:
+                print(f"SUCCESS: {result['path']}")
+            # Keep the metrics file fresh for scrapers without rewriting it per file
+            if args.metrics and time.monotonic() - metrics_written[0] >= 15:
+                metrics_written[0] = time.monotonic()
+                self.write_metrics(args)
+
+        watcher = FolderWatcher(
+            args.input[0], args.output, self.converter,
+            output_format=args.to_format,
+            recursive=args.recursive,
+            settle_seconds=args.settle,
+            max_workers=args.workers,
+            ocr=args.ocr,
+            use_native=not args.poll,
+            on_result=report,
+            logger=self.logger
+        )
+        if not args.quiet:
+            print(f"Watching {args.input[0]} -> {args.output} (Ctrl+C to stop)")
+        watcher.run_forever()
+
+        stats = watcher.get_stats()
+        if not args.quiet:
+            print(f"\nConverted: {stats['converted']}  OCR: {stats['ocr']}  Failed: {stats['failed']}")
+        return 0
 
     def run_conversion(self, args) -> int:
         """Run regular file conversion"""
         try:
-            # Collect input files
-            input_files = self.collect_input_files(args.input, args.recursive)
+            # Stream input files: directories are walked while the first
+            # files are already converting
+            discovered = iter_input_files(args.input, args.recursive)
+            head = list(itertools.islice(discovered, 2))
 
-            if not input_files:
+            if not head and not args.incremental:
                 print("No supported input files found")
                 return 1
 
             output_path = Path(args.output)
 
-            # Determine base input directory for structure preservation
+            # Determine base input directory for structure preservation. Anchoring
+            # on the scanned directories keeps output paths stable between runs
+            # even as files come and go
             base_input_dir = None
-            if args.preserve_structure and len(input_files) > 1:
-                try:
-                    base_input_dir = Path(os.path.commonpath([str(f.parent) for f in input_files]))
-                except ValueError:
-                    base_input_dir = None
-
-            print(f"Converting {len(input_files)} files...")
-            print(f"From: {args.from_format} -> To: {args.to_format}")
+            input_files = itertools.chain(head, discovered)
+            if args.incremental or (args.preserve_structure and len(head) > 1):
+                base_input_dir = self.base_input_directory(args.input)
+                if base_input_dir is None and len(head) > 1:
+                    # Glob patterns: expand fully to find the common directory
+                    input_files = list(input_files)
+                    try:
+                        base_input_dir = Path(os.path.commonpath([str(f.parent) for f in input_files]))
+                    except ValueError:
+                        base_input_dir = None
+
+            if isinstance(input_files, list):
+                print(f"Converting {len(input_files)} files...")
+            elif len(head) > 1:
+                print("Converting files as they are found...")
+            else:
+                print(f"Converting {len(head)} files...")
+            to_formats = [args.to_format] if isinstance(args.to_format, str) else args.to_format
+            print(f"From: {args.from_format} -> To: {', '.join(to_formats)}")
 
             # Progress tracking
             successful = 0
             failed = 0
             start_time = time.time()
 
-            # Use batch conversion for multiple files
-            if len(input_files) > 1:
+            # Use batch conversion for multiple files (and always when incremental,
+            # since the manifest lives in the batch path)
+            unchanged = 0
+            pruned = 0
+            results = None
+            if len(head) > 1 or args.incremental:
                 def progress_callback(completed, total, result):
                     nonlocal successful, failed
                     if result['status'] == 'success':
@@ -435,12 +628,19 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
                     elif result['status'] == 'skipped':
                         if not args.quiet:
                             print(f"SKIPPED (exists): {result['file']}")
+                    elif result['status'] == 'unchanged':
+                        if args.verbose:
+                            print(f"UNCHANGED: {result['file']}")
 
                 # Create output directory
                 if not output_path.exists():
                     output_path.mkdir(parents=True, exist_ok=True)
 
-                # Run batch conversion
+                # Run batch conversion; Ctrl+C cancels the job, stopping files mid-conversion
+                job = Job("CLI batch", PRIORITIES[args.priority])
+                if job.priority >= PRIORITY_BATCH and hasattr(os, 'nice'):
+                    # Other processes (the GUI, the pipe server) get the CPU first
+                    os.nice(10)
                 results = self.converter.convert_batch(
                     file_list=input_files,
                     output_dir=output_path,
@@ -450,27 +650,34 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
                     progress_callback=progress_callback,
                     preserve_structure=args.preserve_structure,
                     overwrite_existing=args.overwrite,
-                    base_dir=base_input_dir
+                    base_dir=base_input_dir,
+                    executor=args.executor,
+                    incremental=args.incremental,
+                    job=job
                 )
 
                 successful = results['successful']
                 failed = results['failed']
+                unchanged = results['unchanged']
+                pruned = results['pruned']
 
             else:
                 # Single file conversion
-                input_file = input_files[0]
-                output_file = self.get_output_path(
+                input_file = head[0]
+                output_file = self.get_output_targets(
                     input_file, output_path, args.to_format,
                     args.preserve_structure, base_input_dir
                 )
+                output_files = list(output_file.values()) if isinstance(output_file, dict) else [output_file]
 
                 # Create output directory
-                output_file.parent.mkdir(parents=True, exist_ok=True)
+                for path in output_files:
+                    path.parent.mkdir(parents=True, exist_ok=True)
 
                 if self.convert_single_file(input_file, output_file, args.from_format, args.to_format):
                     successful = 1
                     if not args.quiet:
-                        print(f"SUCCESS: {input_file.name} -> {output_file.name}")
+                        print(f"SUCCESS: {input_file.name} -> {', '.join(path.name for path in output_files)}")
                 else:
                     failed = 1
 
@@ -479,9 +686,14 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
 
             if not args.quiet:
                 print(f"\nConversion complete in {duration:.2f} seconds!")
+                if results is not None:
+                    print(f"Files found: {results['total']}")
                 print(f"Successful: {successful}")
                 if failed > 0:
                     print(f"Failed: {failed}")
+                if args.incremental:
+                    print(f"Unchanged: {unchanged}")
+                    print(f"Pruned (source deleted): {pruned}")
                 print(f"Output saved to: {output_path}")
 
             return 0 if failed == 0 else 1
@@ -490,6 +702,92 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
             self.logger.error(f"Conversion failed: {e}")
             return 1
 
+    def run_coordinator(self, args) -> int:
+        """Shard a batch over worker nodes and report the merged results"""
+        from converter_core.distributed import BatchCoordinator, ShardQueue, build_shards, parse_address
+
+        queue = None
+        try:
+            queue = ShardQueue(args.queue_db or ':memory:', lease_seconds=args.lease,
+                               max_attempts=args.shard_attempts)
+            # Bind and check the secret before enqueueing, so a misconfigured
+            # start leaves no shards behind in --queue-db
+            coordinator = BatchCoordinator(queue, parse_address(args.distribute), secret=args.cluster_secret,
+                                           logger=self.logger)
+            try:
+                if queue.counts():
+                    print(f"Resuming batch from {args.queue_db}: {queue.counts()}")
+                else:
+                    if args.batch:
+                        with open(args.batch, 'r') as f:
+                            conversions = json.load(f).get('conversions', [])
+                    else:
+                        conversions = [{
+                            'input': args.input, 'output': args.output, 'from_format': args.from_format,
+                            'to_format': args.to_format, 'recursive': args.recursive,
+                            'preserve_structure': args.preserve_structure, 'overwrite': args.overwrite,
+                            'workers': args.workers, 'executor': args.executor
+                        }]
+                    added = queue.add(build_shards(conversions, args.shard_size))
+                    if not added:
+                        print("No supported input files found")
+                        return 1
+                    print(f"Split batch into {added} shards of up to {args.shard_size} files")
+
+                coordinator.start()
+                host, port = coordinator.address[:2]
+                print(f"Coordinating on {host}:{port}; start workers with --worker <this host>:{port}")
+                start_time = time.time()
+                coordinator.wait()
+            finally:
+                coordinator.shutdown()
+
+            results = queue.merged_results()
+        except (OSError, ValueError, DocumentConverterError) as e:
+            print(f"Error coordinating batch: {e}")
+            return 1
+        finally:
+            if queue is not None:
+                queue.close()
+
+        print(f"\nDistributed batch complete in {time.time() - start_time:.2f} seconds!")
+        print(f"Files: {results['total']} in {results['shards']} shards")
+        print(f"Successful: {results['successful']}")
+        print(f"Failed: {results['failed']}")
+        print(f"Skipped: {results['skipped']}")
+        for node, files in sorted(results['nodes'].items()):
+            print(f"  {node}: {files} files")
+        for error in results['errors']:
+            print(f"ERROR: {error['file']}: {error['error']}")
+        for shard in results['failed_shards']:
+            print(f"ERROR: shard {shard['shard']} ({shard['files']} files) given up after "
+                  f"{shard['attempts']} attempts: {shard['error']}")
+        return 0 if results['failed'] == 0 and not results['unprocessed'] else 1
+
+    def run_worker(self, args) -> int:
+        """Convert shards from a coordinator until its batch is done"""
+        from converter_core.distributed import BatchWorker, parse_address
+
+        worker = BatchWorker(self.converter, parse_address(args.worker), secret=args.cluster_secret,
+                             max_workers=args.workers, executor=args.executor, logger=self.logger)
+        if not args.quiet:
+            print(f"Worker {worker.worker_id} serving {args.worker} (Ctrl+C to stop)")
+        try:
+            stats = worker.run()
+        except KeyboardInterrupt:
+            print("\nWorker stopped; its shard was handed back to the coordinator")
+            return 1
+        except (ConnectionError, DocumentConverterError) as e:
+            print(f"Error: {e}")
+            return 1
+
+        if not args.quiet:
+            print(f"Shards converted: {stats['shards']}")
+            print(f"Successful: {stats['successful']}")
+            if stats['failed']:
+                print(f"Failed: {stats['failed']}")
+        return 0
+
     def run_batch_conversion(self, config_file: str) -> int:
         """Run batch conversion from configuration file"""
         try:
@@ -516,10 +814,18 @@ Supported Output Formats: Markdown, TXT, HTML, RTF
                 args.output = conversion.get('output')
                 args.from_format = conversion.get('from_format', 'auto')
                 args.to_format = conversion.get('to_format', 'markdown')
+                if isinstance(args.to_format, str):
+                    try:
+                        args.to_format = self.parse_output_formats(args.to_format)
+                    except argparse.ArgumentTypeError as e:
+                        print(f"ERROR: Conversion {i+1}: {e}")
+                        total_failed += 1
+                        continue
                 args.recursive = conversion.get('recursive', False)
                 args.preserve_structure = conversion.get('preserve_structure', True)
                 args.overwrite = conversion.get('overwrite', False)
                 args.workers = conversion.get('workers')
+                args.executor = conversion.get('executor')
                 args.quiet = False
 
                 # Validate conversion config
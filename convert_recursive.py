@@ -110,7 +110,7 @@ def convert_txt_to_markdown(file_path):
         return None
 
 def convert_file(file_path, output_dir, preserve_structure=True):
-    """Convert a single file to Markdown"""
+    """Convert a single file to Markdown; returns the output path, or False on failure"""
     file_path = Path(file_path)
     output_dir = Path(output_dir)
     
@@ -142,13 +142,19 @@ def convert_file(file_path, output_dir, preserve_structure=True):
             output_file.write(content)
         
         print(f"✓ Converted to: {output_path}")
-        return True
+        return output_path
     else:
         print(f"✗ Failed to convert: {file_path}")
         return False
 
-def scan_and_convert_recursive(input_dir, output_dir):
-    """Recursively scan directory and convert all supported files"""
+def scan_and_convert_recursive(input_dir, output_dir, incremental=False):
+    """
+    Recursively scan directory and convert all supported files
+
+    With incremental=True a manifest in the output directory records every
+    converted source; files unchanged since the last run are skipped and the
+    Markdown of deleted sources is removed.
+    """
     input_dir = Path(input_dir)
     output_dir = Path(output_dir)
     
@@ -156,57 +162,65 @@ def scan_and_convert_recursive(input_dir, output_dir):
         print(f"Error: Input directory '{input_dir}' does not exist")
         return 0, 0
     
-    # Find all supported files recursively
-    supported_extensions = ['.docx', '.pdf', '.txt']
-    files_to_convert = []
-    
-    for ext in supported_extensions:
-        # Use rglob for recursive search
-        files_to_convert.extend(input_dir.rglob(f'*{ext}'))
+    # Stream supported files from a single parallel scandir pass, so the
+    # first conversions start while the rest of the tree is still being walked
+    sys.path.insert(0, str(Path(__file__).parent))
+    from converter_core.discovery import walk_directory
     
-    if not files_to_convert:
-        print(f"No supported files found in '{input_dir}' and subdirectories")
-        print(f"Supported formats: {', '.join(supported_extensions)}")
-        return 0, 0
+    supported_extensions = ['.docx', '.pdf', '.txt']
+    files_to_convert = walk_directory(input_dir, recursive=True, extensions=supported_extensions)
     
-    print(f"Found {len(files_to_convert)} files to convert:")
-    
-    # Group files by directory for better organization
-    files_by_dir = {}
-    for file in files_to_convert:
-        rel_dir = file.parent.relative_to(input_dir)
-        if rel_dir not in files_by_dir:
-            files_by_dir[rel_dir] = []
-        files_by_dir[rel_dir].append(file)
-    
-    # Show organized file list
-    for dir_name, files in files_by_dir.items():
-        if str(dir_name) == '.':
-            print(f"\n📁 Root directory:")
-        else:
-            print(f"\n📁 {dir_name}:")
-        for file in files:
-            print(f"  - {file.name}")
-    
-    print(f"\nOutput directory: {output_dir}")
+    print(f"Scanning {input_dir} for {', '.join(supported_extensions)} files")
+    print(f"Output directory: {output_dir}")
     print("=" * 80)
     
     # Convert files, preserving directory structure
     successful = 0
     failed = 0
+    unchanged = 0
     
-    for file_path in files_to_convert:
-        # Calculate relative path to preserve structure
-        rel_path = file_path.parent.relative_to(input_dir)
-        if str(rel_path) == '.':
-            target_dir = output_dir
-        else:
-            target_dir = output_dir / rel_path
+    manifest = None
+    if incremental:
+        from converter_core.manifest import ConversionManifest, fingerprint_source
+        manifest = ConversionManifest(output_dir)
+    
+    try:
+        for file_path in files_to_convert:
+            # Calculate relative path to preserve structure
+            rel_path = file_path.parent.relative_to(input_dir)
+            if str(rel_path) == '.':
+                target_dir = output_dir
+            else:
+                target_dir = output_dir / rel_path
+            
+            fingerprint = None
+            if manifest is not None:
+                if manifest.is_current(file_path, 'markdown', target_dir / (file_path.stem + '.md')):
+                    unchanged += 1
+                    continue
+                fingerprint = fingerprint_source(file_path)
+            
+            output_path = convert_file(file_path, target_dir)
+            if output_path:
+                successful += 1
+                if manifest is not None:
+                    manifest.record(file_path, 'markdown', output_path, file_path.suffix.lstrip('.').lower(),
+                                    fingerprint)
+            else:
+                failed += 1
+        
+        if successful + failed + unchanged == 0:
+            print(f"No supported files found in '{input_dir}' and subdirectories")
+            print(f"Supported formats: {', '.join(supported_extensions)}")
         
-        if convert_file(file_path, target_dir):
-            successful += 1
-        else:
-            failed += 1
+        if manifest is not None:
+            # Every recorded source still on disk is kept
+            pruned = manifest.prune((), 'markdown')
+            print(f"\nUnchanged since last run: {unchanged}")
+            print(f"Removed outputs of deleted sources: {len(pruned)}")
+    finally:
+        if manifest is not None:
+            manifest.close()
     
     return successful, failed
 
@@ -220,6 +234,8 @@ def main():
                        help='Install required packages')
     parser.add_argument('--flat', action='store_true',
                        help='Save all files to output root (no subdirectories)')
+    parser.add_argument('--incremental', action='store_true',
+                       help='Only convert new or changed files; remove outputs of deleted ones')
     
     args = parser.parse_args()
     
@@ -227,7 +243,7 @@ def main():
         install_requirements()
         return
     
-    successful, failed = scan_and_convert_recursive(args.input_dir, args.output)
+    successful, failed = scan_and_convert_recursive(args.input_dir, args.output, args.incremental)
     
     print("=" * 80)
     print(f"Conversion complete!")
@@ -0,0 +1,53 @@
+"""
+Headless Conversion Core for Quick Document Convertor
+
+GUI-free readers, writers and conversion engine. Only the standard library
+is imported here; parsers such as PyPDF2, python-docx, BeautifulSoup and
+ebooklib are imported by the reader or writer that needs them, the first
+time that format is converted. The Tk desktop app, the CLI, the pipe
+server and batch worker processes all build on this package.
+
+Third-party formats plug in through the registry:
+
+    from converter_core import DocumentReader, register_reader
+
+    @register_reader('csv', extensions=['.csv'], name='CSV Table')
+    class CsvReader(DocumentReader):
+        def iter_read(self, file_path): ...
+
+Author: Beau Lewis (blewisxx@gmail.com)
+Version: 3.1.0
+"""
+
+from .errors import (
+    DocumentConverterError, UnsupportedFormatError, FileProcessingError,
+    ContentReadError, DependencyError, ConfigurationError, JobCancelled
+)
+from .config import ConverterLogger, ConfigManager
+from .formats import FormatDetector
+from .registry import FormatRegistry, register_reader, register_writer
+from .readers import (
+    DocumentReader, PartialContent, DocxReader, PdfReader, TxtReader, HtmlReader, RtfReader, EpubReader, MarkdownReader
+)
+from .writers import DocumentWriter, MarkdownWriter, TxtWriter, HtmlWriter, RtfWriter, EpubWriter
+from .cache import ContentCache
+from .metrics import MetricsRegistry, METRICS
+from .scheduler import (
+    Job, JobScheduler, shared_scheduler, PRIORITY_INTERACTIVE, PRIORITY_NORMAL, PRIORITY_BATCH
+)
+from .engine import UniversalConverter, BATCH_EXECUTORS
+
+__all__ = [
+    'DocumentConverterError', 'UnsupportedFormatError', 'FileProcessingError', 'ContentReadError',
+    'DependencyError', 'ConfigurationError', 'JobCancelled', 'ConverterLogger', 'ConfigManager', 'FormatDetector',
+    'FormatRegistry', 'register_reader', 'register_writer',
+    'DocumentReader', 'PartialContent', 'DocxReader', 'PdfReader', 'TxtReader', 'HtmlReader', 'RtfReader', 'EpubReader',
+    'MarkdownReader', 'DocumentWriter', 'MarkdownWriter', 'TxtWriter', 'HtmlWriter', 'RtfWriter',
+    'EpubWriter', 'ContentCache', 'MetricsRegistry', 'METRICS', 'Job', 'JobScheduler', 'shared_scheduler',
+    'PRIORITY_INTERACTIVE', 'PRIORITY_NORMAL', 'PRIORITY_BATCH', 'UniversalConverter', 'BATCH_EXECUTORS'
+]
+
+# Version information
+__version__ = '3.1.0'
+__author__ = 'Beau Lewis'
+__email__ = 'blewisxx@gmail.com'
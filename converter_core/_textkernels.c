@@ -0,0 +1,499 @@
+/*
+ * Text Kernels
+ * Single-pass escaping and sanitising loops and the Markdown block scanner
+ * for converter_core.textkernels, which falls back to equivalent pure-Python
+ * code when this is not built.
+ *
+ * Every escaping function sizes its result in a first pass and fills it in a
+ * second, so each output string is allocated exactly once and in its final kind.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <string.h>
+
+typedef const char *(*entity_fn)(Py_UCS4);
+
+/* Extra output characters per Latin-1 character, filled at import */
+static unsigned char html_extra[256];
+static unsigned char rtf_extra[256];
+
+static const char *
+html_entity(Py_UCS4 ch)
+{
+    switch (ch) {
+    case '&': return "&amp;";
+    case '<': return "&lt;";
+    case '>': return "&gt;";
+    case '"': return "&quot;";
+    case '\'': return "&#x27;";
+    default: return NULL;
+    }
+}
+
+static const char *
+rtf_entity(Py_UCS4 ch)
+{
+    switch (ch) {
+    case '\\': return "\\\\";
+    case '{': return "\\{";
+    case '}': return "\\}";
+    default: return NULL;
+    }
+}
+
+/* Control characters removed from OCR output: C0 except tab, newline and
+   carriage return, plus DEL */
+static int
+is_dropped_control(Py_UCS4 ch)
+{
+    return (ch <= 0x08) || ch == 0x0B || ch == 0x0C || (ch >= 0x0E && ch <= 0x1F) || ch == 0x7F;
+}
+
+static void
+fill_extra(unsigned char *table, entity_fn entity)
+{
+    int i;
+    for (i = 0; i < 256; i++) {
+        const char *replacement = entity((Py_UCS4)i);
+        table[i] = replacement != NULL ? (unsigned char)(strlen(replacement) - 1) : 0;
+    }
+}
+
+static PyObject *
+escape_with(PyObject *text, entity_fn entity, const unsigned char *extra_table)
+{
+    Py_ssize_t length, extra = 0, i, j;
+    const void *data;
+    void *out_data;
+    int kind, out_kind;
+    PyObject *out;
+
+    if (!PyUnicode_Check(text)) {
+        PyErr_Format(PyExc_TypeError, "expected str, got %.200s", Py_TYPE(text)->tp_name);
+        return NULL;
+    }
+    length = PyUnicode_GET_LENGTH(text);
+    kind = PyUnicode_KIND(text);
+    data = PyUnicode_DATA(text);
+
+    if (kind == PyUnicode_1BYTE_KIND) {
+        /* The common case (ASCII and Latin-1 text): scan the bytes through
+           a table, without decoding each character */
+        const Py_UCS1 *chars = (const Py_UCS1 *)data;
+        for (i = 0; i < length; i++)
+            extra += extra_table[chars[i]];
+    }
+    else {
+        for (i = 0; i < length; i++) {
+            const char *replacement = entity(PyUnicode_READ(kind, data, i));
+            if (replacement != NULL)
+                extra += (Py_ssize_t)strlen(replacement) - 1;
+        }
+    }
+    if (extra == 0) {
+        Py_INCREF(text);
+        return text;
+    }
+
+    /* Replacements are ASCII, so the widest character is unchanged */
+    out = PyUnicode_New(length + extra, PyUnicode_MAX_CHAR_VALUE(text));
+    if (out == NULL)
+        return NULL;
+    out_kind = PyUnicode_KIND(out);
+    out_data = PyUnicode_DATA(out);
+    for (i = 0, j = 0; i < length; i++) {
+        Py_UCS4 ch = PyUnicode_READ(kind, data, i);
+        const char *replacement = entity(ch);
+        if (replacement == NULL) {
+            PyUnicode_WRITE(out_kind, out_data, j++, ch);
+            continue;
+        }
+        for (; *replacement; replacement++)
+            PyUnicode_WRITE(out_kind, out_data, j++, (Py_UCS4)(unsigned char)*replacement);
+    }
+    return out;
+}
+
+static PyObject *
+escape_html(PyObject *module, PyObject *text)
+{
+    (void)module;
+    return escape_with(text, html_entity, html_extra);
+}
+
+static PyObject *
+escape_rtf(PyObject *module, PyObject *text)
+{
+    (void)module;
+    return escape_with(text, rtf_entity, rtf_extra);
+}
+
+/*
+ * One pass of sanitize_text: with out_data NULL it only measures the result
+ * (its length and widest character), otherwise it writes it.
+ */
+static Py_ssize_t
+sanitize_pass(int kind, const void *data, Py_ssize_t length, int out_kind, void *out_data,
+              Py_UCS4 *max_char)
+{
+    Py_ssize_t i, j = 0;
+    int pending_space = 0;
+
+    for (i = 0; i < length; i++) {
+        Py_UCS4 ch = PyUnicode_READ(kind, data, i);
+        const char *replacement;
+
+        if (is_dropped_control(ch))
+            continue;
+        if (Py_UNICODE_ISSPACE(ch)) {
+            /* Runs collapse to one space; none at either end */
+            pending_space = j > 0;
+            continue;
+        }
+        if (pending_space) {
+            if (out_data != NULL)
+                PyUnicode_WRITE(out_kind, out_data, j, ' ');
+            j++;
+            pending_space = 0;
+        }
+        replacement = html_entity(ch);
+        if (replacement == NULL) {
+            if (out_data != NULL)
+                PyUnicode_WRITE(out_kind, out_data, j, ch);
+            else if (ch > *max_char)
+                *max_char = ch;
+            j++;
+            continue;
+        }
+        for (; *replacement; replacement++, j++) {
+            if (out_data != NULL)
+                PyUnicode_WRITE(out_kind, out_data, j, (Py_UCS4)(unsigned char)*replacement);
+        }
+    }
+    return j;
+}
+
+static PyObject *
+sanitize_text(PyObject *module, PyObject *text)
+{
+    Py_ssize_t length, out_length;
+    Py_UCS4 max_char = 0x7F;
+    const void *data;
+    int kind;
+    PyObject *out;
+
+    (void)module;
+    if (!PyUnicode_Check(text)) {
+        PyErr_Format(PyExc_TypeError, "expected str, got %.200s", Py_TYPE(text)->tp_name);
+        return NULL;
+    }
+    length = PyUnicode_GET_LENGTH(text);
+    kind = PyUnicode_KIND(text);
+    data = PyUnicode_DATA(text);
+
+    /* Dropped characters may narrow the result, so measure its widest
+       character rather than reusing the input's kind */
+    out_length = sanitize_pass(kind, data, length, 0, NULL, &max_char);
+    out = PyUnicode_New(out_length, max_char);
+    if (out == NULL)
+        return NULL;
+    sanitize_pass(kind, data, length, PyUnicode_KIND(out), PyUnicode_DATA(out), &max_char);
+    return out;
+}
+
+/*
+ * MarkdownScanner: the Markdown reader's block splitter. Lines are
+ * classified by index arithmetic on the input string, so only the text of
+ * each block is copied out.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *paragraph;    /* list of line texts joined by ' ' when flushed */
+    PyObject *code_block;   /* list of verbatim lines inside a ``` fence */
+    int in_code_block;
+} MarkdownScanner;
+
+static int
+append_block(PyObject *blocks, PyObject *block)
+{
+    int status;
+    if (block == NULL)
+        return -1;
+    status = PyList_Append(blocks, block);
+    Py_DECREF(block);
+    return status;
+}
+
+/* Append ('kind', text[start:end]) when the slice is not empty */
+static int
+append_text_block(PyObject *blocks, const char *kind, PyObject *text, Py_ssize_t start, Py_ssize_t end)
+{
+    PyObject *slice;
+    if (start >= end)
+        return 0;
+    slice = PyUnicode_Substring(text, start, end);
+    if (slice == NULL)
+        return -1;
+    return append_block(blocks, Py_BuildValue("(sN)", kind, slice));
+}
+
+/* Append (kind, separator.join(parts)) if parts is not empty, then empty it */
+static int
+flush_lines(PyObject *blocks, const char *kind, PyObject **parts, const char *separator)
+{
+    PyObject *sep, *joined, *fresh;
+    if (PyList_GET_SIZE(*parts) == 0)
+        return 0;
+    sep = PyUnicode_FromString(separator);
+    if (sep == NULL)
+        return -1;
+    joined = PyUnicode_Join(sep, *parts);
+    Py_DECREF(sep);
+    if (joined == NULL)
+        return -1;
+    if (append_block(blocks, Py_BuildValue("(sN)", kind, joined)) < 0)
+        return -1;
+    fresh = PyList_New(0);
+    if (fresh == NULL)
+        return -1;
+    Py_SETREF(*parts, fresh);
+    return 0;
+}
+
+static int
+append_slice(PyObject *list, PyObject *text, Py_ssize_t start, Py_ssize_t end)
+{
+    PyObject *slice = PyUnicode_Substring(text, start, end);
+    int status;
+    if (slice == NULL)
+        return -1;
+    status = PyList_Append(list, slice);
+    Py_DECREF(slice);
+    return status;
+}
+
+static Py_ssize_t
+skip_space(int kind, const void *data, Py_ssize_t i, Py_ssize_t end)
+{
+    while (i < end && Py_UNICODE_ISSPACE(PyUnicode_READ(kind, data, i)))
+        i++;
+    return i;
+}
+
+/* One line, matching PyMarkdownScanner.feed's loop body */
+static int
+scan_line(MarkdownScanner *self, PyObject *blocks, PyObject *line)
+{
+    Py_ssize_t end, start, i, j;
+    const void *data;
+    int kind;
+    Py_UCS4 first;
+
+    if (!PyUnicode_Check(line)) {
+        PyErr_Format(PyExc_TypeError, "expected str lines, got %.200s", Py_TYPE(line)->tp_name);
+        return -1;
+    }
+    kind = PyUnicode_KIND(line);
+    data = PyUnicode_DATA(line);
+    end = PyUnicode_GET_LENGTH(line);
+    while (end > 0 && Py_UNICODE_ISSPACE(PyUnicode_READ(kind, data, end - 1)))
+        end--;
+    /* line is [0, end), its unindented lead [start, end) */
+    start = skip_space(kind, data, 0, end);
+
+    if (end >= 3 && PyUnicode_READ(kind, data, 0) == '`' && PyUnicode_READ(kind, data, 1) == '`'
+            && PyUnicode_READ(kind, data, 2) == '`') {
+        if (self->in_code_block) {
+            self->in_code_block = 0;
+            return flush_lines(blocks, "code_block", &self->code_block, "\n");
+        }
+        self->in_code_block = 1;
+        return flush_lines(blocks, "paragraph", &self->paragraph, " ");
+    }
+
+    if (self->in_code_block)
+        return append_slice(self->code_block, line, 0, end);
+
+    if (end > 0 && PyUnicode_READ(kind, data, 0) == '#') {
+        Py_ssize_t level = 0;
+        if (flush_lines(blocks, "paragraph", &self->paragraph, " ") < 0)
+            return -1;
+        while (level < end && PyUnicode_READ(kind, data, level) == '#')
+            level++;
+        if (level <= 6 && level < end && PyUnicode_READ(kind, data, level) == ' ') {
+            i = skip_space(kind, data, level + 1, end);
+            if (i < end) {
+                PyObject *text = PyUnicode_Substring(line, i, end);
+                if (text == NULL)
+                    return -1;
+                return append_block(blocks, Py_BuildValue("(snN)", "heading", level, text));
+            }
+        }
+        return 0;
+    }
+
+    if (start == end)
+        return flush_lines(blocks, "paragraph", &self->paragraph, " ");
+
+    /* '- ', '* ', '+ ' and '> ' leads; their first characters never start
+       a numbered item, so the order of these tests does not matter */
+    first = PyUnicode_READ(kind, data, start);
+    if ((first == '-' || first == '*' || first == '+' || first == '>') && start + 1 < end
+            && PyUnicode_READ(kind, data, start + 1) == ' ') {
+        if (flush_lines(blocks, "paragraph", &self->paragraph, " ") < 0)
+            return -1;
+        return append_text_block(blocks, first == '>' ? "blockquote" : "list_item", line,
+                                 skip_space(kind, data, start + 2, end), end);
+    }
+
+    /* \s*(\d+)\.\s+(.+) on the lead: decimal digits, a dot, whitespace, then
+       the item text up to any newline, stripped */
+    if (Py_UNICODE_ISDECIMAL(first)) {
+        i = start;
+        while (i < end && Py_UNICODE_ISDECIMAL(PyUnicode_READ(kind, data, i)))
+            i++;
+        if (i < end && PyUnicode_READ(kind, data, i) == '.') {
+            j = skip_space(kind, data, i + 1, end);
+            if (j > i + 1 && j < end) {
+                Py_ssize_t stop = j;
+                while (stop < end && PyUnicode_READ(kind, data, stop) != '\n')
+                    stop++;
+                while (stop > j && Py_UNICODE_ISSPACE(PyUnicode_READ(kind, data, stop - 1)))
+                    stop--;
+                if (flush_lines(blocks, "paragraph", &self->paragraph, " ") < 0)
+                    return -1;
+                return append_text_block(blocks, "numbered_list_item", line, j, stop);
+            }
+        }
+    }
+
+
+    return append_slice(self->paragraph, line, start, end);
+}
+
+static PyObject *
+scanner_feed(MarkdownScanner *self, PyObject *lines)
+{
+    PyObject *iterator, *line, *blocks;
+
+    iterator = PyObject_GetIter(lines);
+    if (iterator == NULL)
+        return NULL;
+    blocks = PyList_New(0);
+    if (blocks == NULL) {
+        Py_DECREF(iterator);
+        return NULL;
+    }
+    while ((line = PyIter_Next(iterator)) != NULL) {
+        int status = scan_line(self, blocks, line);
+        Py_DECREF(line);
+        if (status < 0)
+            break;
+    }
+    Py_DECREF(iterator);
+    if (PyErr_Occurred()) {
+        Py_DECREF(blocks);
+        return NULL;
+    }
+    return blocks;
+}
+
+static PyObject *
+scanner_close(MarkdownScanner *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *blocks = PyList_New(0);
+    if (blocks == NULL)
+        return NULL;
+    if (flush_lines(blocks, "paragraph", &self->paragraph, " ") < 0 ||
+            (self->in_code_block && flush_lines(blocks, "code_block", &self->code_block, "\n") < 0)) {
+        Py_DECREF(blocks);
+        return NULL;
+    }
+    self->in_code_block = 0;
+    return blocks;
+}
+
+static int
+scanner_init(MarkdownScanner *self, PyObject *args, PyObject *kwargs)
+{
+    if (PyTuple_GET_SIZE(args) || (kwargs != NULL && PyDict_GET_SIZE(kwargs))) {
+        PyErr_SetString(PyExc_TypeError, "MarkdownScanner() takes no arguments");
+        return -1;
+    }
+    Py_XSETREF(self->paragraph, PyList_New(0));
+    Py_XSETREF(self->code_block, PyList_New(0));
+    if (self->paragraph == NULL || self->code_block == NULL)
+        return -1;
+    self->in_code_block = 0;
+    return 0;
+}
+
+static void
+scanner_dealloc(MarkdownScanner *self)
+{
+    Py_XDECREF(self->paragraph);
+    Py_XDECREF(self->code_block);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyMethodDef scanner_methods[] = {
+    {"feed", (PyCFunction)scanner_feed, METH_O,
+     "Scan an iterable of lines; return the blocks they completed"},
+    {"close", (PyCFunction)scanner_close, METH_NOARGS,
+     "Return the blocks still open at the end of the input"},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyTypeObject MarkdownScannerType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "converter_core._textkernels.MarkdownScanner",
+    .tp_doc = "Incremental Markdown block scanner (see textkernels.PyMarkdownScanner)",
+    .tp_basicsize = sizeof(MarkdownScanner),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc)scanner_init,
+    .tp_dealloc = (destructor)scanner_dealloc,
+    .tp_methods = scanner_methods,
+};
+
+static PyMethodDef textkernels_methods[] = {
+    {"escape_html", escape_html, METH_O,
+     "Escape &, <, >, \" and ' as HTML entities in one pass"},
+    {"escape_rtf", escape_rtf, METH_O,
+     "Escape RTF control characters (backslash and braces) in one pass"},
+    {"sanitize_text", sanitize_text, METH_O,
+     "HTML-escape, drop control characters and collapse whitespace in one pass"},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef textkernels_module = {
+    PyModuleDef_HEAD_INIT,
+    "_textkernels",
+    "Compiled text kernels for converter_core.textkernels",
+    -1,
+    textkernels_methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC
+PyInit__textkernels(void)
+{
+    PyObject *module;
+
+    fill_extra(html_extra, html_entity);
+    fill_extra(rtf_extra, rtf_entity);
+    if (PyType_Ready(&MarkdownScannerType) < 0)
+        return NULL;
+    module = PyModule_Create(&textkernels_module);
+    if (module == NULL)
+        return NULL;
+    Py_INCREF(&MarkdownScannerType);
+    if (PyModule_AddObject(module, "MarkdownScanner", (PyObject *)&MarkdownScannerType) < 0) {
+        Py_DECREF(&MarkdownScannerType);
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+"""
+Memory-Aware Admission
+Estimates each job's peak memory before it starts and admits jobs against a
+global budget, so many small conversions run side by side while giant ones
+run on their own instead of getting the worker killed
+"""
+
+import collections
+import concurrent.futures
+import os
+import threading
+from pathlib import Path
+from typing import Any, Callable, Iterable, Iterator, Optional, Tuple, Union
+
+from .formats import FormatDetector
+from .metrics import METRICS
+
+MB = 1024 * 1024
+
+# Fixed cost of any conversion: reader/writer objects, output buffers
+JOB_BASE_BYTES = 16 * MB
+
+# Peak memory per byte of source file. Compressed containers (docx, epub)
+# inflate before their object trees are built; HTML trees are many times the
+# markup; PDFs hold decoded page streams.
+FORMAT_MEMORY_FACTORS = {
+    'txt': 4,
+    'markdown': 6,
+    'rtf': 6,
+    'html': 12,
+    'pdf': 8,
+    'docx': 20,
+    'epub': 20,
+}
+DEFAULT_MEMORY_FACTOR = 10
+
+# Used when neither psutil nor a cgroup limit says how much memory there is
+FALLBACK_BUDGET_BYTES = 2048 * MB
+
+
+def estimate_job_memory(file_path: Union[str, Path], input_format: Optional[str] = None,
+                        size: Optional[int] = None) -> int:
+    """
+    Estimated peak bytes a conversion of ``file_path`` needs
+
+    Args:
+        input_format: Reader format ('auto' or None detects it from the extension)
+        size: Source size in bytes if already known (saves a stat call)
+    """
+    if size is None:
+        try:
+            size = os.stat(file_path).st_size
+        except OSError:
+            size = 0
+    if not input_format or input_format == 'auto':
+        input_format = FormatDetector.detect_format(file_path)
+    factor = FORMAT_MEMORY_FACTORS.get(input_format, DEFAULT_MEMORY_FACTOR)
+    return JOB_BASE_BYTES + size * factor
+
+
+def _cgroup_memory_headroom() -> Optional[int]:
+    """Bytes left under this container's memory limit (cgroup v2 or v1), or None"""
+    for limit_file, usage_file in (('/sys/fs/cgroup/memory.max', '/sys/fs/cgroup/memory.current'),
+                                   ('/sys/fs/cgroup/memory/memory.limit_in_bytes',
+                                    '/sys/fs/cgroup/memory/memory.usage_in_bytes')):
+        try:
+            with open(limit_file) as f:
+                limit = f.read().strip()
+            if limit == 'max':
+                return None
+            with open(usage_file) as f:
+                usage = int(f.read().strip())
+        except (OSError, ValueError):
+            continue
+        limit = int(limit)
+        # cgroup v1 reports "unlimited" as a huge page-aligned number
+        if limit >= 1 << 60:
+            return None
+        return max(0, limit - usage)
+    return None
+
+
+def available_memory_bytes() -> Optional[int]:
+    """
+    Memory this process can still use: the smaller of what the host has free
+    and what the container's cgroup limit allows, or None if unknown
+
+    psutil alone reports the host's memory, which inside a 4 GB container is
+    the wrong answer.
+    """
+    candidates = []
+    try:
+        import psutil
+        candidates.append(psutil.virtual_memory().available)
+    except Exception:
+        pass
+    headroom = _cgroup_memory_headroom()
+    if headroom is not None:
+        candidates.append(headroom)
+    return min(candidates) if candidates else None
+
+
+def default_budget_bytes(fraction: float = 0.75) -> int:
+    """Budget for a new MemoryBudget: a share of the memory available right now"""
+    available = available_memory_bytes()
+    if available is None:
+        return FALLBACK_BUDGET_BYTES
+    return max(256 * MB, int(available * fraction))
+
+
+class MemoryBudget:
+    """
+    Thread-safe count of estimated bytes held by running jobs
+
+    A job is admitted if it fits next to the running ones. A job bigger than
+    the whole budget is still admitted once nothing else runs, so it gets
+    the machine to itself rather than never running at all.
+    """
+
+    def __init__(self, limit_bytes: Optional[int] = None):
+        self.limit = int(limit_bytes) if limit_bytes else default_budget_bytes()
+        self._released = threading.Condition()
+        self.used = 0
+        self.running = 0
+        self.peak = 0
+
+    def try_acquire(self, nbytes: int) -> bool:
+        """Reserve ``nbytes`` if they fit; returns whether they were reserved"""
+        with self._released:
+            if self.running and self.used + nbytes > self.limit:
+                return False
+            self.used += nbytes
+            self.running += 1
+            self.peak = max(self.peak, self.used)
+            METRICS.set_gauge('memory_reserved_bytes', self.used)
+            return True
+
+    def release(self, nbytes: int) -> None:
+        with self._released:
+            self.used = max(0, self.used - nbytes)
+            self.running = max(0, self.running - 1)
+            METRICS.set_gauge('memory_reserved_bytes', self.used)
+            self._released.notify_all()
+
+    def wait_for_release(self, timeout: Optional[float] = None) -> bool:
+        """Block until some job releases its bytes (or the timeout passes)"""
+        with self._released:
+            return self._released.wait(timeout)
+
+
+_shared_budget: Optional[MemoryBudget] = None
+_shared_budget_lock = threading.Lock()
+
+
+def shared_budget(limit_mb: Optional[float] = None) -> MemoryBudget:
+    """
+    The process-wide budget that batch conversion and batch OCR share
+
+    The first caller fixes the limit (``limit_mb``, else a share of available
+    memory); later callers get the same instance.
+    """
+    global _shared_budget
+    with _shared_budget_lock:
+        if _shared_budget is None:
+            _shared_budget = MemoryBudget(limit_mb * MB if limit_mb else None)
+        return _shared_budget
+
+
+def admit_submit(pool: concurrent.futures.Executor, fn: Callable[[Any], Any], items: Iterable,
+                 max_in_flight: int, budget: MemoryBudget, estimate: Callable[[Any], int],
+                 cancel_event: Optional[threading.Event] = None, lookahead: Optional[int] = None,
+                 max_bypass: int = 16) -> Iterator[Tuple[Any, concurrent.futures.Future]]:
+    """
+    bounded_submit with memory admission: yields ``(item, future)`` as tasks finish
+
+    Each item is weighed with ``estimate`` and only submitted once its bytes
+    fit in ``budget``. At most ``max_in_flight`` items are pulled ahead, as
+    with bounded_submit. When the oldest waiting item does not fit, up to
+    ``lookahead`` more are read to find smaller ones that may go first, but
+    only ``max_bypass`` times in a row; after that nothing new starts until the
+    big item can, so a giant waits for the running jobs to drain and then
+    runs alone instead of starving.
+
+    Estimates are released as results are yielded (or once abandoned tasks
+    finish, if the generator is closed early), so a budget can be shared by
+    several batches.
+    """
+    items = iter(items)
+    max_in_flight = max(1, max_in_flight)
+    lookahead = max(1, lookahead or max_in_flight)
+    waiting = collections.deque()
+    in_flight = {}
+    exhausted = False
+    cancelled = False
+    bypassed = 0
+    try:
+        while True:
+            if cancel_event is not None and cancel_event.is_set() and not cancelled:
+                cancelled = True
+                waiting.clear()
+                for future in in_flight:
+                    future.cancel()
+
+            head_blocked = False
+            progress = True
+            while progress and not cancelled:
+                progress = False
+                # Read past the window only to find work that fits beside a blocked head
+                while (not exhausted and len(waiting) < lookahead and
+                       (len(waiting) + len(in_flight) < max_in_flight or head_blocked)):
+                    try:
+                        item = next(items)
+                    except StopIteration:
+                        exhausted = True
+                        break
+                    waiting.append((item, estimate(item)))
+
+                position = 0
+                while position < len(waiting) and len(in_flight) < max_in_flight:
+                    item, weight = waiting[position]
+                    if position > 0 and bypassed >= max_bypass:
+                        break
+                    if not budget.try_acquire(weight):
+                        head_blocked = head_blocked or position == 0
+                        position += 1
+                        continue
+                    del waiting[position]
+                    try:
+                        future = pool.submit(fn, item)
+                    except BaseException:
+                        budget.release(weight)
+                        raise
+                    in_flight[future] = (item, weight)
+                    bypassed = bypassed + 1 if position > 0 else 0
+                    progress = True
+
+                if (head_blocked and not exhausted and len(waiting) < lookahead and
+                        len(in_flight) < max_in_flight and bypassed < max_bypass and
+                        len(waiting) + len(in_flight) >= max_in_flight):
+                    # Nothing in the window fits: look further ahead once more
+                    progress = True
+
+            if not in_flight:
+                if cancelled or not waiting:
+                    return
+                # The budget is held by another batch sharing it
+                budget.wait_for_release(0.5)
+                continue
+
+            # Wake up periodically so a cancel request is noticed mid-task
+            done, _ = concurrent.futures.wait(in_flight, timeout=None if cancel_event is None else 0.5,
+                                              return_when=concurrent.futures.FIRST_COMPLETED)
+            for future in done:
+                item, weight = in_flight.pop(future)
+                budget.release(weight)
+                if not future.cancelled():
+                    yield item, future
+    finally:
+        for future, (_, weight) in in_flight.items():
+            future.cancel()
+            future.add_done_callback(lambda _future, weight=weight: budget.release(weight))
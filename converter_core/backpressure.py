@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+"""
+Bounded Work Submission
+Feeds an executor from an iterator with a fixed number of tasks in flight,
+so a batch of any size runs in constant memory and can be stopped early
+"""
+
+import concurrent.futures
+import threading
+from typing import Any, Callable, Iterable, Iterator, Optional, Tuple
+
+
+def bounded_submit(pool: concurrent.futures.Executor, fn: Callable[[Any], Any], items: Iterable,
+                   max_in_flight: int, cancel_event: Optional[threading.Event] = None
+                   ) -> Iterator[Tuple[Any, concurrent.futures.Future]]:
+    """
+    Run ``fn(item)`` on ``pool`` for each item, yielding ``(item, future)`` as tasks finish
+
+    At most ``max_in_flight`` tasks are submitted at once; the next item is
+    only pulled from ``items`` when one completes, so a lazy iterator is
+    never materialised. Results arrive in completion order.
+
+    Setting ``cancel_event`` stops pulling new items and cancels tasks that
+    have not started; tasks already running finish and are still yielded.
+    Closing the generator cancels whatever has not started.
+    """
+    items = iter(items)
+    max_in_flight = max(1, max_in_flight)
+    in_flight = {}
+    exhausted = False
+    cancelled = False
+    try:
+        while True:
+            if cancel_event is not None and cancel_event.is_set() and not cancelled:
+                cancelled = True
+                for future in in_flight:
+                    future.cancel()
+            while not exhausted and not cancelled and len(in_flight) < max_in_flight:
+                try:
+                    item = next(items)
+                except StopIteration:
+                    exhausted = True
+                    break
+                in_flight[pool.submit(fn, item)] = item
+            if not in_flight:
+                return
+
+            # Wake up periodically so a cancel request is noticed mid-task
+            done, _ = concurrent.futures.wait(in_flight, timeout=None if cancel_event is None else 0.5,
+                                              return_when=concurrent.futures.FIRST_COMPLETED)
+            for future in done:
+                item = in_flight.pop(future)
+                if not future.cancelled():
+                    yield item, future
+    finally:
+        for future in in_flight:
+            future.cancel()
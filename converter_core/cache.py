@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""
+Parsed Content Cache
+Content-addressed, size-capped store of reader output shared across runs
+"""
+
+import hashlib
+import json
+import logging
+import os
+import time
+from collections import OrderedDict
+from pathlib import Path
+from threading import Lock
+from typing import Any, Dict, Optional
+
+
+class ContentCache:
+    """Persistent, content-addressed cache of parsed reader output
+
+    Entries are keyed by a SHA-256 of the source bytes plus the input format,
+    so a file that moves or is copied elsewhere still hits, and a second
+    output format for the same source skips the reader stage entirely.
+    Entries are gzipped JSON files; the least recently used ones are evicted
+    once the cache grows beyond max_size_mb.
+    """
+
+    # Bump whenever reader output changes shape so stale entries stop matching
+    FORMAT_VERSION = 1
+    # Source hashes remembered per process; long-running watchers see unbounded files
+    HASH_MEMO_ENTRIES = 4096
+
+    def __init__(self, cache_dir: Path, max_size_mb: int = 512, logger: Optional[logging.Logger] = None):
+        self.cache_dir = Path(cache_dir)
+        self.cache_dir.mkdir(parents=True, exist_ok=True)
+        self.max_size_bytes = max_size_mb * 1024 * 1024
+        # A single entry may use at most a quarter of the cache
+        self.max_entry_bytes = self.max_size_bytes // 4
+        self.logger = logger or logging.getLogger("ContentCache")
+        self._lock = Lock()
+        self._total_size = None  # Computed lazily from disk
+        self._hash_memo = OrderedDict()  # (path, size, mtime) -> content hash, least recent first
+        self._memo_lock = Lock()
+
+    def hash_file(self, file_path: Path) -> str:
+        """Return the SHA-256 of a file's bytes, memoized on path, size and mtime"""
+        stat = file_path.stat()
+        memo_key = (str(file_path), stat.st_size, stat.st_mtime_ns)
+        with self._memo_lock:
+            cached = self._hash_memo.get(memo_key)
+            if cached:
+                self._hash_memo.move_to_end(memo_key)
+                return cached
+
+        hasher = hashlib.sha256()
+        with open(file_path, 'rb') as f:
+            for chunk in iter(lambda: f.read(1024 * 1024), b''):
+                hasher.update(chunk)
+        digest = hasher.hexdigest()
+        with self._memo_lock:
+            self._hash_memo[memo_key] = digest
+            while len(self._hash_memo) > self.HASH_MEMO_ENTRIES:
+                self._hash_memo.popitem(last=False)
+        return digest
+
+    def key_for(self, file_path: Path, input_format: str) -> Optional[str]:
+        """Build the cache key for a source file read with the given format"""
+        try:
+            content_hash = self.hash_file(Path(file_path))
+        except OSError as e:
+            self.logger.debug(f"Could not hash {file_path} for content cache: {e}")
+            return None
+        return hashlib.sha256(f"{content_hash}:{input_format}:v{self.FORMAT_VERSION}".encode()).hexdigest()
+
+    def _entry_path(self, key: str) -> Path:
+        return self.cache_dir / key[:2] / f"{key}.json.gz"
+
+    def get(self, key: str) -> Optional[list]:
+        """Return cached content blocks, or None on a miss"""
+        import gzip
+
+        entry = self._entry_path(key)
+        try:
+            with gzip.open(entry, 'rt', encoding='utf-8') as f:
+                data = json.load(f)
+        except FileNotFoundError:
+            return None
+        except Exception as e:
+            self.logger.warning(f"Discarding unreadable content cache entry {entry.name}: {e}")
+            self._remove(entry)
+            return None
+
+        # Refresh the entry's position in the LRU order
+        try:
+            os.utime(entry)
+        except OSError:
+            pass
+        return [tuple(block) for block in data['blocks']]
+
+    def put(self, key: str, blocks: list, input_format: str = None) -> bool:
+        """Store content blocks under key, evicting old entries if needed"""
+        import gzip
+        import tempfile
+
+        entry = self._entry_path(key)
+        entry.parent.mkdir(parents=True, exist_ok=True)
+        data = {
+            'version': self.FORMAT_VERSION,
+            'input_format': input_format,
+            'created': time.time(),
+            'blocks': blocks
+        }
+
+        try:
+            # Write to a temporary file first so concurrent readers never see a partial entry
+            fd, tmp_name = tempfile.mkstemp(dir=entry.parent, suffix='.tmp')
+            with os.fdopen(fd, 'wb') as raw:
+                with gzip.GzipFile(fileobj=raw, mode='wb', compresslevel=1) as f:
+                    f.write(json.dumps(data, ensure_ascii=False).encode('utf-8'))
+            os.replace(tmp_name, entry)
+        except Exception as e:
+            self.logger.warning(f"Failed to store content cache entry: {e}")
+            try:
+                os.unlink(tmp_name)
+            except Exception:
+                pass
+            return False
+
+        with self._lock:
+            if self._total_size is not None:
+                self._total_size += entry.stat().st_size
+        self._evict_if_needed()
+        return True
+
+    def _remove(self, entry: Path) -> int:
+        try:
+            size = entry.stat().st_size
+            entry.unlink()
+            return size
+        except OSError:
+            return 0
+
+    def _entries(self) -> list:
+        return list(self.cache_dir.glob("*/*.json.gz"))
+
+    def _evict_if_needed(self):
+        """Evict least recently used entries until the cache is back under 90% of its cap"""
+        with self._lock:
+            if self._total_size is None:
+                self._total_size = sum(e.stat().st_size for e in self._entries())
+            if self._total_size <= self.max_size_bytes:
+                return
+
+            entries = []
+            for e in self._entries():
+                try:
+                    stat = e.stat()
+                    entries.append((stat.st_mtime, stat.st_size, e))
+                except OSError:
+                    continue
+            entries.sort()
+
+            # Other processes may share the directory, so trust the disk over the counter
+            self._total_size = sum(size for _, size, _ in entries)
+            target = int(self.max_size_bytes * 0.9)
+            evicted = 0
+            for _, size, e in entries:
+                if self._total_size <= target:
+                    break
+                self._total_size -= self._remove(e)
+                evicted += 1
+            self.logger.debug(f"Evicted {evicted} content cache entries")
+
+    def clear(self) -> int:
+        """Delete every entry and return how many were removed"""
+        with self._lock:
+            removed = 0
+            for e in self._entries():
+                if self._remove(e):
+                    removed += 1
+            self._total_size = 0
+            self._hash_memo.clear()
+            return removed
+
+    def get_stats(self) -> Dict[str, Any]:
+        """Get cache statistics"""
+        entries = self._entries()
+        total_size = sum(e.stat().st_size for e in entries)
+        return {
+            'entries': len(entries),
+            'total_size': total_size,
+            'total_size_mb': round(total_size / (1024 * 1024), 2),
+            'max_size_mb': self.max_size_bytes // (1024 * 1024),
+            'cache_dir': str(self.cache_dir)
+        }
+
+
+class _ContentRecorder:
+    """Pass-through iterator that keeps a copy of the blocks for the content cache
+
+    Recording stops (and the copy is dropped) once the text exceeds
+    max_bytes, so caching never defeats the bounded-memory streaming path.
+    """
+
+    def __init__(self, blocks, max_bytes: int):
+        self._blocks = blocks
+        self._max_bytes = max_bytes
+        self._size = 0
+        self.recorded = []
+        self.overflowed = False
+
+    def __iter__(self):
+        for block in self._blocks:
+            if not self.overflowed:
+                self._size += sum(len(part) for part in block if isinstance(part, str))
+                if self._size > self._max_bytes:
+                    self.overflowed = True
+                    self.recorded = []
+                else:
+                    self.recorded.append(block)
+            yield block
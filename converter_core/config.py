@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+"""
+Converter Logging and Configuration
+Logger set-up and the persisted user/performance settings
+"""
+
+import datetime
+import json
+import logging
+import os
+from pathlib import Path
+from typing import Optional
+
+from .errors import ConfigurationError
+
+
+class ConverterLogger:
+    """Enhanced logging system for the document converter"""
+
+    def __init__(self, name: str = "DocumentConverter", log_level: str = "INFO"):
+        self.name = name
+        self.log_level = getattr(logging, log_level.upper(), logging.INFO)
+        self._logger = None
+        self._setup_logger()
+
+    def _setup_logger(self):
+        """Setup logger with appropriate handlers and formatting"""
+        self._logger = logging.getLogger(self.name)
+        self._logger.setLevel(self.log_level)
+
+        # Clear existing handlers to avoid duplicates
+        self._logger.handlers.clear()
+
+        # Create formatter
+        formatter = logging.Formatter(
+            '%(asctime)s - %(name)s - %(levelname)s - %(message)s',
+            datefmt='%Y-%m-%d %H:%M:%S'
+        )
+
+        # Console handler
+        console_handler = logging.StreamHandler()
+        console_handler.setLevel(self.log_level)
+        console_handler.setFormatter(formatter)
+        self._logger.addHandler(console_handler)
+
+        # File handler (optional, logs to file in user's temp directory)
+        try:
+            log_dir = Path.home() / "Documents" / "DocumentConverter" / "logs"
+            log_dir.mkdir(parents=True, exist_ok=True)
+            log_file = log_dir / f"converter_{datetime.datetime.now().strftime('%Y%m%d')}.log"
+
+            file_handler = logging.FileHandler(log_file, encoding='utf-8')
+            file_handler.setLevel(logging.DEBUG)  # File gets all messages
+            file_handler.setFormatter(formatter)
+            self._logger.addHandler(file_handler)
+        except Exception:
+            # If file logging fails, continue with console only
+            pass
+
+    def get_logger(self) -> logging.Logger:
+        """Get the configured logger instance"""
+        return self._logger
+
+
+# Configuration Management System
+class ConfigManager:
+    """Manages user preferences, settings persistence, and configuration files"""
+
+    DEFAULT_CONFIG = {
+        'general': {
+            'default_input_format': 'auto',
+            'default_output_format': 'markdown',
+            'default_output_directory': str(Path.home() / "Desktop" / "converted_documents"),
+            'preserve_folder_structure': True,
+            'overwrite_existing_files': False,
+            'auto_open_output_folder': False
+        },
+        'performance': {
+            'enable_caching': True,
+            'enable_content_cache': True,
+            'content_cache_max_mb': 512,
+            'max_worker_threads': min(4, (os.cpu_count() or 1) + 1),
+            'executor': 'thread',  # 'thread' or 'process' for batch conversion
+            'max_in_flight': None,  # batch tasks queued ahead of the workers (None: 2 per worker)
+            'memory_threshold_mb': 500,
+            'memory_admission': True,  # start batch jobs only when their estimated memory fits the budget
+            'memory_budget_mb': None,  # estimated peak memory admitted at once (None: 3/4 of available)
+            'scheduler_workers': None,  # threads shared by conversion and OCR jobs (None: max(4, CPUs) + 1)
+            'enable_memory_monitoring': True
+        },
+        'gui': {
+            'window_width': 700,
+            'window_height': 600,
+            'theme': 'light',  # 'light' or 'dark'
+            'font_size': 9,
+            'show_advanced_options': True,
+            'remember_window_position': True,
+            'last_window_x': None,
+            'last_window_y': None
+        },
+        'logging': {
+            'log_level': 'INFO',
+            'enable_file_logging': True,
+            'log_retention_days': 30,
+            'console_logging': True
+        },
+        'formats': {
+            'custom_extensions': {},  # Custom file extension mappings
+            'format_preferences': {}  # Per-format specific settings
+        }
+    }
+
+    def __init__(self, config_file: Optional[str] = None):
+        """Initialize configuration manager
+
+        Args:
+            config_file: Path to configuration file. If None, uses default location.
+        """
+        self.config_dir = Path.home() / ".quick_document_convertor"
+        self.config_dir.mkdir(exist_ok=True)
+
+        if config_file:
+            self.config_file = Path(config_file)
+        else:
+            self.config_file = self.config_dir / "config.json"
+
+        import copy
+        self.config = copy.deepcopy(self.DEFAULT_CONFIG)
+        self.logger = ConverterLogger("ConfigManager").get_logger()
+
+        # Load existing configuration
+        self.load_config()
+
+    def load_config(self) -> bool:
+        """Load configuration from file
+
+        Returns:
+            True if config was loaded successfully, False otherwise
+        """
+        try:
+            if self.config_file.exists():
+                with open(self.config_file, 'r', encoding='utf-8') as f:
+                    loaded_config = json.load(f)
+
+                # Merge with defaults to ensure all keys exist
+                self._merge_config(self.config, loaded_config)
+                self.logger.info(f"Configuration loaded from {self.config_file}")
+                return True
+            else:
+                self.logger.info("No configuration file found, using defaults")
+                return False
+        except Exception as e:
+            self.logger.error(f"Failed to load configuration: {e}")
+            raise ConfigurationError(f"Failed to load configuration: {e}")
+
+    def save_config(self) -> bool:
+        """Save current configuration to file
+
+        Returns:
+            True if config was saved successfully, False otherwise
+        """
+        try:
+            # Ensure config directory exists
+            self.config_file.parent.mkdir(parents=True, exist_ok=True)
+
+            with open(self.config_file, 'w', encoding='utf-8') as f:
+                json.dump(self.config, f, indent=2, ensure_ascii=False)
+
+            self.logger.info(f"Configuration saved to {self.config_file}")
+            return True
+        except Exception as e:
+            self.logger.error(f"Failed to save configuration: {e}")
+            raise ConfigurationError(f"Failed to save configuration: {e}")
+
+    def _merge_config(self, default: dict, loaded: dict) -> None:
+        """Recursively merge loaded config with defaults"""
+        for key, value in loaded.items():
+            if key in default:
+                if isinstance(value, dict) and isinstance(default[key], dict):
+                    self._merge_config(default[key], value)
+                else:
+                    default[key] = value
+
+    def get(self, section: str, key: str, default=None):
+        """Get a configuration value
+
+        Args:
+            section: Configuration section name
+            key: Configuration key name
+            default: Default value if key not found
+
+        Returns:
+            Configuration value or default
+        """
+        try:
+            return self.config.get(section, {}).get(key, default)
+        except Exception:
+            return default
+
+    def set(self, section: str, key: str, value) -> None:
+        """Set a configuration value
+
+        Args:
+            section: Configuration section name
+            key: Configuration key name
+            value: Value to set
+        """
+        if section not in self.config:
+            self.config[section] = {}
+        self.config[section][key] = value
+
+    def get_section(self, section: str) -> dict:
+        """Get entire configuration section
+
+        Args:
+            section: Section name
+
+        Returns:
+            Dictionary containing section configuration
+        """
+        return self.config.get(section, {}).copy()
+
+    def update_section(self, section: str, updates: dict) -> None:
+        """Update multiple values in a configuration section
+
+        Args:
+            section: Section name
+            updates: Dictionary of key-value pairs to update
+        """
+        if section not in self.config:
+            self.config[section] = {}
+        self.config[section].update(updates)
+
+    def reset_to_defaults(self, section: Optional[str] = None) -> None:
+        """Reset configuration to defaults
+
+        Args:
+            section: If specified, only reset this section. Otherwise reset all.
+        """
+        import copy
+        if section:
+            if section in self.DEFAULT_CONFIG:
+                self.config[section] = copy.deepcopy(self.DEFAULT_CONFIG[section])
+                self.logger.info(f"Reset section '{section}' to defaults")
+        else:
+            self.config = copy.deepcopy(self.DEFAULT_CONFIG)
+            self.logger.info("Reset all configuration to defaults")
+
+    def export_config(self, export_path: str) -> bool:
+        """Export configuration to a file
+
+        Args:
+            export_path: Path to export file
+
+        Returns:
+            True if export successful, False otherwise
+        """
+        try:
+            export_file = Path(export_path)
+            with open(export_file, 'w', encoding='utf-8') as f:
+                json.dump(self.config, f, indent=2, ensure_ascii=False)
+            self.logger.info(f"Configuration exported to {export_file}")
+            return True
+        except Exception as e:
+            self.logger.error(f"Failed to export configuration: {e}")
+            return False
+
+    def import_config(self, import_path: str) -> bool:
+        """Import configuration from a file
+
+        Args:
+            import_path: Path to import file
+
+        Returns:
+            True if import successful, False otherwise
+        """
+        try:
+            import_file = Path(import_path)
+            if not import_file.exists():
+                raise FileNotFoundError(f"Configuration file not found: {import_file}")
+
+            with open(import_file, 'r', encoding='utf-8') as f:
+                imported_config = json.load(f)
+
+            # Validate imported config structure
+            if not isinstance(imported_config, dict):
+                raise ValueError("Invalid configuration format")
+
+            # Merge with current config
+            self._merge_config(self.config, imported_config)
+            self.logger.info(f"Configuration imported from {import_file}")
+            return True
+        except Exception as e:
+            self.logger.error(f"Failed to import configuration: {e}")
+            return False
+
+    def set_level(self, level: str):
+        """Change the logging level"""
+        self.log_level = getattr(logging, level.upper(), logging.INFO)
+        self._logger.setLevel(self.log_level)
+        for handler in self._logger.handlers:
+            if isinstance(handler, logging.StreamHandler) and not isinstance(handler, logging.FileHandler):
+                handler.setLevel(self.log_level)
@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""
+Streaming Source Discovery
+Parallel os.scandir walk that yields convertible files as they are found,
+so a batch can start converting before a large tree has been listed
+"""
+
+import os
+import queue
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from glob import glob
+from pathlib import Path
+from typing import Iterable, Iterator, Optional, Set, Union
+
+from .formats import FormatDetector
+
+# Office lock files and editor droppings that share a document extension
+SKIPPED_PREFIXES = ('~$', '.~lock.')
+
+
+def supported_extensions() -> Set[str]:
+    """Every extension a registered reader accepts, lower-cased"""
+    return {ext.lower() for info in FormatDetector.SUPPORTED_INPUT_FORMATS.values()
+            for ext in info['extensions']}
+
+
+def _matches(name: str, extensions: Set[str]) -> bool:
+    if name.startswith(SKIPPED_PREFIXES):
+        return False
+    dot = name.rfind('.')
+    return dot > 0 and name[dot:].lower() in extensions
+
+
+class _ParallelWalk:
+    """
+    Directory walk spread over a thread pool
+
+    Each task scans one directory; matching files go into a bounded queue
+    and subdirectories become new tasks. When the consumer falls behind, the
+    scanners block on the full queue, so memory stays flat however big the
+    tree is. Closing the iterator early stops the scanners.
+    """
+
+    _DONE = object()
+
+    def __init__(self, root: str, extensions: Set[str], max_workers: int, follow_symlinks: bool,
+                 queue_size: int):
+        self.root = root
+        self.extensions = extensions
+        self.follow_symlinks = follow_symlinks
+        self.files: "queue.Queue" = queue.Queue(maxsize=queue_size)
+        self.stop = threading.Event()
+        self.pool = ThreadPoolExecutor(max_workers=max_workers, thread_name_prefix="scandir")
+        self._outstanding = 0
+        self._lock = threading.Lock()
+
+    def _submit(self, directory: str):
+        with self._lock:
+            self._outstanding += 1
+        self.pool.submit(self._scan, directory)
+
+    def _put(self, item) -> bool:
+        while not self.stop.is_set():
+            try:
+                self.files.put(item, timeout=0.1)
+                return True
+            except queue.Full:
+                continue
+        return False
+
+    def _scan(self, directory: str):
+        try:
+            with os.scandir(directory) as entries:
+                for entry in entries:
+                    if self.stop.is_set():
+                        return
+                    try:
+                        if entry.is_dir(follow_symlinks=self.follow_symlinks):
+                            self._submit(entry.path)
+                        elif _matches(entry.name, self.extensions) and entry.is_file():
+                            if not self._put(entry.path):
+                                return
+                    except OSError:
+                        continue
+        except OSError:
+            # Unreadable or vanished directory: skip it like rglob would
+            pass
+        finally:
+            with self._lock:
+                self._outstanding -= 1
+                finished = self._outstanding == 0
+            if finished:
+                self._put(self._DONE)
+
+    def __iter__(self) -> Iterator[str]:
+        self._submit(self.root)
+        try:
+            while True:
+                item = self.files.get()
+                if item is self._DONE:
+                    return
+                yield item
+        finally:
+            self.stop.set()
+            self.pool.shutdown(wait=False)
+
+
+def walk_directory(root: Union[str, Path], recursive: bool = True, extensions: Optional[Iterable[str]] = None,
+                   max_workers: Optional[int] = None, follow_symlinks: bool = False,
+                   queue_size: int = 1024) -> Iterator[Path]:
+    """
+    Yield supported files under a directory as they are discovered
+
+    Args:
+        root: Directory to scan
+        recursive: Descend into subdirectories
+        extensions: Extensions to match (default: every supported input format),
+            matched in the same single pass
+        max_workers: Scanner threads; directory listing is I/O bound, so
+            several help on network shares and cold caches (default: up to 8)
+        follow_symlinks: Follow symlinked directories (may loop on cyclic links)
+        queue_size: Discovered files buffered ahead of the consumer
+
+    Order is not defined: it depends on which directory a scanner finishes first.
+    """
+    extensions = {ext.lower() for ext in extensions} if extensions else supported_extensions()
+    root = os.fspath(root)
+
+    if not recursive:
+        try:
+            with os.scandir(root) as entries:
+                for entry in entries:
+                    try:
+                        if _matches(entry.name, extensions) and entry.is_file():
+                            yield Path(entry.path)
+                    except OSError:
+                        continue
+        except OSError:
+            return
+        return
+
+    max_workers = max_workers or min(8, (os.cpu_count() or 1) * 2)
+    if max_workers <= 1:
+        stack = [root]
+        while stack:
+            try:
+                with os.scandir(stack.pop()) as entries:
+                    for entry in entries:
+                        try:
+                            if entry.is_dir(follow_symlinks=follow_symlinks):
+                                stack.append(entry.path)
+                            elif _matches(entry.name, extensions) and entry.is_file():
+                                yield Path(entry.path)
+                        except OSError:
+                            continue
+            except OSError:
+                continue
+        return
+
+    for path in _ParallelWalk(root, extensions, max_workers, follow_symlinks, queue_size):
+        yield Path(path)
+
+
+def iter_input_files(input_paths: Iterable[Union[str, Path]], recursive: bool = False,
+                     extensions: Optional[Iterable[str]] = None,
+                     max_workers: Optional[int] = None) -> Iterator[Path]:
+    """
+    Stream the files named by CLI-style inputs: files, directories and glob patterns
+
+    Explicit files are yielded as given (whatever their extension); directories
+    are walked for supported files. Duplicates are only tracked when several
+    inputs are given, so a single huge tree never builds a seen-set.
+    """
+    input_paths = list(input_paths)
+    extensions = set(extensions) if extensions else supported_extensions()
+    seen: Optional[Set[str]] = set() if len(input_paths) > 1 else None
+
+    def unseen(path: Path) -> bool:
+        if seen is None:
+            return True
+        key = os.path.abspath(path)
+        if key in seen:
+            return False
+        seen.add(key)
+        return True
+
+    for input_path in input_paths:
+        path = Path(input_path)
+        if path.is_file():
+            candidates: Iterable[Path] = [path]
+        elif path.is_dir():
+            candidates = walk_directory(path, recursive, extensions, max_workers)
+        else:
+            candidates = (Path(match) for match in glob(str(path)) if os.path.isfile(match))
+        for candidate in candidates:
+            if not candidate.name.startswith(SKIPPED_PREFIXES) and unseen(candidate):
+                yield candidate
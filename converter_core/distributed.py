@@ -0,0 +1,661 @@
+#!/usr/bin/env python3
+"""
+Distributed Batch Execution
+Shards a batch across conversion nodes: a coordinator keeps the shards in a
+persistent, leased queue served over TCP, and workers on each node lease a
+shard, convert it with convert_batch and report back for the merged results
+"""
+
+import hmac
+import ipaddress
+import json
+import logging
+import os
+import socket
+import socketserver
+import sqlite3
+import threading
+import time
+import uuid
+from pathlib import Path
+from typing import Any, Dict, Iterable, List, Optional, Sequence, Tuple, Union
+
+from .discovery import iter_input_files
+from .errors import ConfigurationError, DocumentConverterError
+from .metrics import METRICS
+from .scheduler import PRIORITY_BATCH, Job
+
+DEFAULT_PORT = 8765
+DEFAULT_SHARD_SIZE = 50
+DEFAULT_LEASE_SECONDS = 120.0
+MAX_MESSAGE_BYTES = 16 * 1024 * 1024
+
+# Error records a worker sends back per shard; the rest are only counted
+MAX_SHARD_ERRORS = 100
+
+# A shard with at least this share of its attempted files failed points at
+# the node (a broken mount, a missing dependency), so it is retried elsewhere
+SHARD_FAILURE_RATIO = 0.5
+
+Address = Tuple[str, int]
+
+
+def parse_address(value: str, default_port: int = DEFAULT_PORT) -> Address:
+    """'host:port', 'host' or ':port' as a (host, port) pair"""
+    host, _, port = value.rpartition(':') if ':' in value else (value, '', '')
+    return host or '0.0.0.0', int(port) if port else default_port
+
+
+def is_loopback(host: str) -> bool:
+    """Whether a bind address only accepts connections from this machine"""
+    if host == 'localhost':
+        return True
+    try:
+        return ipaddress.ip_address(host).is_loopback
+    except ValueError:
+        return False
+
+
+def _output_formats(value: Union[str, Sequence[str]]) -> Union[str, List[str]]:
+    if isinstance(value, str):
+        formats = [name.strip() for name in value.split(',') if name.strip()]
+        return formats[0] if len(formats) == 1 else formats
+    return list(value)
+
+
+def _base_directory(inputs: Sequence[str], files: Sequence[str]) -> Optional[str]:
+    """Directory outputs are made relative to: the input roots, else the files' common parent"""
+    roots = []
+    for input_path in inputs:
+        path = Path(input_path)
+        if path.is_dir():
+            roots.append(path)
+        elif path.is_file():
+            roots.append(path.parent)
+        else:
+            # A glob pattern: anchor on what it matched
+            roots = [Path(file).parent for file in files]
+            break
+    try:
+        return os.path.abspath(os.path.commonpath([str(root) for root in roots])) if roots else None
+    except ValueError:
+        return None
+
+
+def build_shards(conversions: Iterable[Dict[str, Any]],
+                 shard_size: int = DEFAULT_SHARD_SIZE) -> List[Dict[str, Any]]:
+    """
+    Cut the ``conversions`` of a batch config into shards of ``shard_size`` files
+
+    Each conversion takes the keys of the CLI's --batch config ('input',
+    'output', 'from_format', 'to_format', 'recursive', 'preserve_structure',
+    'overwrite', 'workers', 'executor'). 'manifest' may name a text file
+    listing one input path per line, in place of or beside 'input'. Paths
+    are made absolute here, so every node must see the same file systems
+    at the same paths (a shared mount).
+    """
+    shard_size = max(1, int(shard_size))
+    shards = []
+    for index, conversion in enumerate(conversions):
+        inputs = conversion.get('input', [])
+        inputs = [inputs] if isinstance(inputs, str) else list(inputs)
+        if conversion.get('manifest'):
+            with open(conversion['manifest'], 'r', encoding='utf-8') as f:
+                inputs.extend(line.strip() for line in f if line.strip() and not line.startswith('#'))
+        if not inputs or not conversion.get('output'):
+            raise ConfigurationError(f"Conversion {index + 1}: missing input or output")
+
+        files = [os.path.abspath(path) for path in iter_input_files(inputs, conversion.get('recursive', False))]
+        preserve_structure = conversion.get('preserve_structure', True)
+        base = {
+            'conversion': index,
+            'output': os.path.abspath(conversion['output']),
+            'input_format': conversion.get('from_format', 'auto'),
+            'output_format': _output_formats(conversion.get('to_format', 'markdown')),
+            'preserve_structure': preserve_structure,
+            'overwrite': conversion.get('overwrite', False),
+            'base_dir': _base_directory(inputs, files) if preserve_structure and len(files) > 1 else None,
+            'workers': conversion.get('workers'),
+            'executor': conversion.get('executor')
+        }
+        for start in range(0, len(files), shard_size):
+            shards.append({**base, 'files': files[start:start + shard_size]})
+    return shards
+
+
+class ShardQueue:
+    """
+    Persistent queue of batch shards handed out under time-limited leases
+
+    Like the watch folder's WorkQueue, state lives in SQLite, so a restarted
+    coordinator resumes the same batch. A lease is a token that is valid
+    until it expires; workers renew it while converting. A shard whose lease
+    runs out (its node died or lost the network) goes back to the queue, and
+    a failed shard is retried with back-off, up to ``max_attempts`` attempts
+    in total, preferably on a node other than the one it last ran on.
+    Reports carrying an expired token are ignored, so a shard taken over by
+    another node is never counted twice.
+    """
+
+    SCHEMA_VERSION = 1
+
+    def __init__(self, db_path: Union[str, Path] = ':memory:', lease_seconds: float = DEFAULT_LEASE_SECONDS,
+                 max_attempts: int = 3, retry_delay: float = 5.0):
+        if str(db_path) != ':memory:':
+            Path(db_path).parent.mkdir(parents=True, exist_ok=True)
+        self.lease_seconds = lease_seconds
+        self.max_attempts = max(1, max_attempts)
+        self.retry_delay = retry_delay
+        self._lock = threading.Lock()
+        self._conn = sqlite3.connect(str(db_path), check_same_thread=False, isolation_level=None)
+        self._init_schema()
+
+    def _init_schema(self):
+        conn = self._conn
+        conn.execute("PRAGMA journal_mode=WAL")
+        conn.execute("PRAGMA synchronous=NORMAL")
+        version = conn.execute("PRAGMA user_version").fetchone()[0]
+        if version != self.SCHEMA_VERSION:
+            conn.execute("DROP TABLE IF EXISTS shards")
+            conn.execute(f"PRAGMA user_version={self.SCHEMA_VERSION}")
+        conn.execute(
+            """CREATE TABLE IF NOT EXISTS shards (
+                   id INTEGER PRIMARY KEY,
+                   spec TEXT NOT NULL,
+                   status TEXT NOT NULL DEFAULT 'queued',
+                   attempts INTEGER NOT NULL DEFAULT 0,
+                   worker TEXT,
+                   token TEXT,
+                   lease_expires REAL NOT NULL DEFAULT 0,
+                   not_before REAL NOT NULL DEFAULT 0,
+                   result TEXT,
+                   error TEXT,
+                   updated REAL NOT NULL
+               )"""
+        )
+
+    def add(self, specs: Iterable[Dict[str, Any]]) -> int:
+        """Queue shards; returns how many were added"""
+        now = time.time()
+        rows = [(json.dumps(spec), now) for spec in specs]
+        with self._lock:
+            self._conn.executemany("INSERT INTO shards (spec, updated) VALUES (?, ?)", rows)
+        return len(rows)
+
+    def _reclaim(self, now: float):
+        """Return shards with expired leases to the queue (caller holds the lock)"""
+        expired = self._conn.execute(
+            "SELECT id, attempts, worker FROM shards WHERE status = 'leased' AND lease_expires < ?", (now,)
+        ).fetchall()
+        for shard_id, attempts, worker in expired:
+            self._record_failure(shard_id, attempts, f"lease expired on {worker}", now, backoff=False)
+
+    def _record_failure(self, shard_id: int, attempts: int, error: str, now: float, backoff: bool = True) -> bool:
+        attempts += 1
+        retry = attempts < self.max_attempts
+        delay = self.retry_delay * (2 ** (attempts - 1)) if retry and backoff else 0
+        self._conn.execute(
+            "UPDATE shards SET status = ?, attempts = ?, token = NULL, not_before = ?, error = ?, updated = ? "
+            "WHERE id = ?", ('queued' if retry else 'failed', attempts, now + delay, error[:1000], now, shard_id)
+        )
+        METRICS.inc('distributed_shards_total', status='retried' if retry else 'failed')
+        return retry
+
+    def lease(self, worker: str) -> Optional[Dict[str, Any]]:
+        """
+        Lease the next ready shard to ``worker``
+
+        Shards this worker last ran (and failed or lost) are handed out only
+        after every other ready shard.
+        
+        Returns:
+            ``{'shard', 'token', 'attempt', 'max_attempts', 'lease_seconds', 'spec'}``
+            or None when nothing is ready right now (see finished())
+        """
+        now = time.time()
+        with self._lock:
+            self._reclaim(now)
+            row = self._conn.execute(
+                "SELECT id, spec, attempts FROM shards WHERE status = 'queued' AND not_before <= ? "
+                "ORDER BY COALESCE(worker = ?, 0), id LIMIT 1", (now, worker)
+            ).fetchone()
+            if row is None:
+                return None
+            shard_id, spec, attempts = row
+            token = uuid.uuid4().hex
+            self._conn.execute(
+                "UPDATE shards SET status = 'leased', worker = ?, token = ?, lease_expires = ?, updated = ? "
+                "WHERE id = ?", (worker, token, now + self.lease_seconds, now, shard_id)
+            )
+        return {'shard': shard_id, 'token': token, 'attempt': attempts + 1, 'max_attempts': self.max_attempts,
+                'lease_seconds': self.lease_seconds, 'spec': json.loads(spec)}
+
+    def renew(self, shard_id: int, token: str) -> bool:
+        """Extend a lease; False when it is no longer held (expired and reassigned)"""
+        now = time.time()
+        with self._lock:
+            cursor = self._conn.execute(
+                "UPDATE shards SET lease_expires = ?, updated = ? WHERE id = ? AND token = ? AND status = 'leased'",
+                (now + self.lease_seconds, now, shard_id, token)
+            )
+            return cursor.rowcount == 1
+
+    def complete(self, shard_id: int, token: str, result: Dict[str, Any]) -> bool:
+        """Record a converted shard; False (and ignored) when the lease was lost"""
+        now = time.time()
+        with self._lock:
+            cursor = self._conn.execute(
+                "UPDATE shards SET status = 'done', token = NULL, result = ?, error = NULL, updated = ? "
+                "WHERE id = ? AND token = ? AND status = 'leased'", (json.dumps(result), now, shard_id, token)
+            )
+            if cursor.rowcount == 1:
+                METRICS.inc('distributed_shards_total', status='done')
+                return True
+            return False
+
+    def fail(self, shard_id: int, token: str, error: str) -> bool:
+        """
+        Record a failed attempt
+
+        Returns:
+            True if the shard will be retried; False once it is given up on
+            or when the lease was no longer held
+        """
+        now = time.time()
+        with self._lock:
+            row = self._conn.execute(
+                "SELECT attempts FROM shards WHERE id = ? AND token = ? AND status = 'leased'", (shard_id, token)
+            ).fetchone()
+            if row is None:
+                return False
+            return self._record_failure(shard_id, row[0], error, now)
+
+    def release(self, shard_id: int, token: str) -> bool:
+        """Hand a shard back untouched (its worker is stopping); it does not count as an attempt"""
+        now = time.time()
+        with self._lock:
+            cursor = self._conn.execute(
+                "UPDATE shards SET status = 'queued', token = NULL, not_before = 0, updated = ? "
+                "WHERE id = ? AND token = ? AND status = 'leased'", (now, shard_id, token)
+            )
+            return cursor.rowcount == 1
+
+    def finished(self) -> bool:
+        """Whether every shard is done or given up on (expired leases are reclaimed first)"""
+        with self._lock:
+            self._reclaim(time.time())
+            row = self._conn.execute(
+                "SELECT COUNT(*) FROM shards WHERE status IN ('queued', 'leased')"
+            ).fetchone()
+            return row[0] == 0
+
+    def counts(self) -> Dict[str, int]:
+        """Number of shards per status"""
+        with self._lock:
+            rows = self._conn.execute("SELECT status, COUNT(*) FROM shards GROUP BY status").fetchall()
+        return {status: count for status, count in rows}
+
+    def merged_results(self, max_errors: Optional[int] = 1000) -> Dict[str, Any]:
+        """
+        convert_batch-style totals over all shards
+
+        Files of shards that were given up on count as 'unprocessed' and are
+        listed per shard in 'failed_shards'; 'nodes' has the files each
+        worker converted.
+        """
+        with self._lock:
+            rows = self._conn.execute(
+                "SELECT id, spec, status, attempts, worker, result, error FROM shards ORDER BY id"
+            ).fetchall()
+        merged = {
+            'successful': 0, 'failed': 0, 'skipped': 0, 'unchanged': 0, 'unprocessed': 0, 'total': 0,
+            'errors': [], 'errors_dropped': 0, 'shards': len(rows), 'shards_done': 0,
+            'failed_shards': [], 'nodes': {}
+        }
+        for shard_id, spec, status, attempts, worker, result, error in rows:
+            files = json.loads(spec)['files']
+            merged['total'] += len(files)
+            if status == 'failed':
+                merged['unprocessed'] += len(files)
+                merged['failed_shards'].append({'shard': shard_id, 'files': len(files),
+                                                'attempts': attempts, 'error': error})
+                continue
+            if status != 'done':
+                merged['unprocessed'] += len(files)
+                continue
+            result = json.loads(result)
+            merged['shards_done'] += 1
+            for key in ('successful', 'failed', 'skipped', 'unchanged'):
+                merged[key] += result.get(key, 0)
+            merged['nodes'][worker] = merged['nodes'].get(worker, 0) + len(files)
+            merged['errors_dropped'] += result.get('errors_dropped', 0)
+            for record in result.get('errors', []):
+                if max_errors is None or len(merged['errors']) < max_errors:
+                    merged['errors'].append(record)
+                else:
+                    merged['errors_dropped'] += 1
+        return merged
+
+    def close(self):
+        with self._lock:
+            self._conn.close()
+
+
+class _CoordinatorHandler(socketserver.StreamRequestHandler):
+    """Newline-delimited JSON requests, one response line each"""
+
+    def handle(self):
+        coordinator = self.server.coordinator
+        while True:
+            line = self.rfile.readline(MAX_MESSAGE_BYTES)
+            if not line:
+                return
+            if not line.strip():
+                continue
+            try:
+                request = json.loads(line)
+                if not isinstance(request, dict):
+                    raise ValueError("Request must be a JSON object")
+                response = coordinator.handle(request)
+            except Exception as e:
+                response = {'status': 'failed', 'error': f"Invalid request: {e}"}
+            self.wfile.write(json.dumps(response).encode('utf-8') + b'\n')
+            self.wfile.flush()
+
+
+class _CoordinatorServer(socketserver.ThreadingMixIn, socketserver.TCPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+class BatchCoordinator:
+    """
+    Serves a ShardQueue to worker nodes over TCP
+
+    Requests are JSON lines ``{"command": ..., "secret": ...}``: 'lease'
+    (with 'worker'), 'renew', 'complete' (with 'result'), 'fail' (with
+    'error') and 'release' (with 'shard' and 'token'), and 'status'. A lease
+    request answers with a shard, ``{"status": "wait"}`` while the remaining
+    shards are leased or backing off, or ``{"status": "done"}``. With a
+    ``secret`` every request must carry it; one is required unless the
+    coordinator binds a loopback address.
+    """
+
+    def __init__(self, queue: ShardQueue, address: Address = ('0.0.0.0', DEFAULT_PORT),
+                 secret: Optional[str] = None, poll_interval: float = 2.0,
+                 logger: Optional[logging.Logger] = None):
+        if not secret and not is_loopback(address[0]):
+            raise ConfigurationError(
+                f"Serving shards on {address[0] or 'all interfaces'} needs a cluster secret "
+                "(--cluster-secret or CONVERTER_CLUSTER_SECRET); only loopback addresses may run without one"
+            )
+        self.queue = queue
+        self.secret = secret or None
+        self.poll_interval = poll_interval
+        self.logger = logger or logging.getLogger("BatchCoordinator")
+        self.server = _CoordinatorServer(address, _CoordinatorHandler)
+        self.server.coordinator = self
+        self.address = self.server.server_address
+        self.started = time.time()
+        self._thread: Optional[threading.Thread] = None
+
+    def handle(self, request: Dict[str, Any]) -> Dict[str, Any]:
+        """Process one worker request"""
+        if self.secret is not None and not hmac.compare_digest(str(request.get('secret', '')), self.secret):
+            return {'status': 'failed', 'error': 'Unauthorized'}
+        command = request.get('command')
+        queue = self.queue
+
+        if command == 'lease':
+            worker = str(request.get('worker') or 'unknown')
+            lease = queue.lease(worker)
+            if lease is not None:
+                self.logger.info(f"Shard {lease['shard']} (attempt {lease['attempt']}, "
+                                 f"{len(lease['spec']['files'])} files) leased to {worker}")
+                return {'status': 'success', **lease}
+            if queue.finished():
+                return {'status': 'done'}
+            return {'status': 'wait', 'retry_after': self.poll_interval}
+        if command == 'status':
+            return {'status': 'success', 'shards': queue.counts(), 'finished': queue.finished(),
+                    'uptime': round(time.time() - self.started, 1)}
+        if command not in ('renew', 'complete', 'fail', 'release'):
+            return {'status': 'failed', 'error': f"Unknown command: {command}"}
+
+        shard_id, token = int(request['shard']), str(request['token'])
+        if command == 'renew':
+            held = queue.renew(shard_id, token)
+        elif command == 'complete':
+            held = queue.complete(shard_id, token, request.get('result') or {})
+            if held:
+                self.logger.info(f"Shard {shard_id} done")
+        elif command == 'release':
+            held = queue.release(shard_id, token)
+        else:
+            error = str(request.get('error', 'unknown error'))
+            retry = queue.fail(shard_id, token, error)
+            self.logger.warning(f"Shard {shard_id} failed ({'retrying' if retry else 'giving up'}): {error}")
+            return {'status': 'success', 'retry': retry}
+        return {'status': 'success' if held else 'lost'}
+
+    def start(self) -> None:
+        """Serve on a background thread"""
+        self._thread = threading.Thread(target=self.server.serve_forever, name="batch-coordinator", daemon=True)
+        self._thread.start()
+
+    def wait(self, timeout: Optional[float] = None) -> bool:
+        """Block until every shard is done or given up on; False on timeout"""
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while not self.queue.finished():
+            if deadline is not None and time.monotonic() >= deadline:
+                return False
+            time.sleep(self.poll_interval if deadline is None else
+                       max(0.0, min(self.poll_interval, deadline - time.monotonic())))
+        return True
+
+    def shutdown(self, linger: Optional[float] = None) -> None:
+        """
+        Stop serving, or just release the socket if start() was never called
+
+        Args:
+            linger: Keep answering for this many seconds first, so idle
+                workers hear 'done' instead of a refused connection
+                (default: two poll intervals)
+        """
+        if self._thread is not None:
+            time.sleep(self.poll_interval * 2 if linger is None else linger)
+            self.server.shutdown()
+            self._thread = None
+        self.server.server_close()
+
+
+class CoordinatorClient:
+    """One worker's connection to the coordinator; reconnects after network errors"""
+
+    def __init__(self, address: Address, secret: Optional[str] = None, timeout: float = 30.0):
+        self.address = address
+        self.secret = secret
+        self.timeout = timeout
+        self._lock = threading.Lock()
+        self._socket: Optional[socket.socket] = None
+        self._stream = None
+
+    def call(self, command: str, **fields) -> Dict[str, Any]:
+        """Send one request and return the response; raises ConnectionError when unreachable"""
+        request = {'command': command, **fields}
+        if self.secret is not None:
+            request['secret'] = self.secret
+        data = json.dumps(request).encode('utf-8') + b'\n'
+        with self._lock:
+            for attempt in range(2):
+                try:
+                    if self._stream is None:
+                        self._socket = socket.create_connection(self.address, timeout=self.timeout)
+                        self._stream = self._socket.makefile('rwb')
+                    self._stream.write(data)
+                    self._stream.flush()
+                    line = self._stream.readline(MAX_MESSAGE_BYTES)
+                    if not line:
+                        raise ConnectionError("Coordinator closed the connection")
+                    return json.loads(line)
+                except OSError as e:
+                    self._close()
+                    if attempt:
+                        raise ConnectionError(f"Coordinator {self.address[0]}:{self.address[1]} "
+                                              f"unreachable: {e}") from e
+
+    def _close(self):
+        if self._stream is not None:
+            try:
+                self._stream.close()
+                self._socket.close()
+            except OSError:
+                pass
+        self._stream = self._socket = None
+
+    def close(self):
+        with self._lock:
+            self._close()
+
+
+class BatchWorker:
+    """
+    Converts shards leased from a coordinator on this node
+
+    Each shard runs through the node's own ``convert_batch`` (thread or
+    process executor, caches and memory admission as configured here) as a
+    batch-priority job. A heartbeat thread renews the lease; if the lease
+    is lost the job is cancelled, since the shard now belongs to another
+    node. ``run()`` returns once the coordinator reports the batch done.
+    """
+
+    def __init__(self, converter, address: Address, worker_id: Optional[str] = None,
+                 secret: Optional[str] = None, max_workers: Optional[int] = None,
+                 executor: Optional[str] = None, connect_timeout: float = 60.0,
+                 logger: Optional[logging.Logger] = None):
+        self.converter = converter
+        self.client = CoordinatorClient(address, secret)
+        self.worker_id = worker_id or f"{socket.gethostname()}-{os.getpid()}"
+        self.max_workers = max_workers
+        self.executor = executor
+        self.connect_timeout = connect_timeout
+        self.logger = logger or logging.getLogger("BatchWorker")
+        self.stats = {'shards': 0, 'lost': 0, 'failed_shards': 0, 'successful': 0, 'failed': 0, 'skipped': 0}
+        self._stopping = threading.Event()
+
+    def stop(self) -> None:
+        """Return from run() once the current shard is finished"""
+        self._stopping.set()
+
+    def _call(self, command: str, **fields) -> Dict[str, Any]:
+        """A request, retried while the coordinator is unreachable for up to connect_timeout"""
+        deadline = time.monotonic() + self.connect_timeout
+        while True:
+            try:
+                response = self.client.call(command, **fields)
+            except ConnectionError:
+                if time.monotonic() >= deadline or self._stopping.is_set():
+                    raise
+                time.sleep(1.0)
+                continue
+            if response.get('status') == 'failed':
+                raise DocumentConverterError(f"Coordinator refused {command}: {response.get('error')}")
+            return response
+
+    def run(self) -> Dict[str, Any]:
+        """Lease and convert shards until the batch is done (or stop() is called)"""
+        try:
+            while not self._stopping.is_set():
+                response = self._call('lease', worker=self.worker_id)
+                if response['status'] == 'done':
+                    break
+                if response['status'] == 'wait':
+                    self._stopping.wait(response.get('retry_after', 2.0))
+                    continue
+                self.run_shard(response)
+        finally:
+            self.client.close()
+        return dict(self.stats)
+
+    def run_shard(self, lease: Dict[str, Any]) -> None:
+        """Convert one leased shard and report it"""
+        shard_id, token, spec = lease['shard'], lease['token'], lease['spec']
+        job = Job(f"shard {shard_id}", PRIORITY_BATCH)
+        lost = threading.Event()
+        done = threading.Event()
+
+        def heartbeat():
+            interval = max(1.0, lease['lease_seconds'] / 3)
+            while not done.wait(interval):
+                try:
+                    if self.client.call('renew', shard=shard_id, token=token).get('status') != 'success':
+                        lost.set()
+                        job.cancel()
+                        return
+                except ConnectionError as e:
+                    # Keep converting: the lease may outlive a short outage
+                    self.logger.warning(f"Lease renewal for shard {shard_id} failed: {e}")
+
+        beat = threading.Thread(target=heartbeat, name=f"shard-{shard_id}-lease", daemon=True)
+        beat.start()
+        self.logger.info(f"Converting shard {shard_id} ({len(spec['files'])} files, attempt {lease['attempt']})")
+        try:
+            results = self.converter.convert_batch(
+                file_list=[Path(path) for path in spec['files']],
+                output_dir=Path(spec['output']),
+                input_format=spec.get('input_format', 'auto'),
+                output_format=spec.get('output_format', 'markdown'),
+                max_workers=self.max_workers or spec.get('workers'),
+                preserve_structure=spec.get('preserve_structure', True),
+                overwrite_existing=spec.get('overwrite', False),
+                base_dir=Path(spec['base_dir']) if spec.get('base_dir') else None,
+                executor=self.executor or spec.get('executor'),
+                max_errors=MAX_SHARD_ERRORS,
+                job=job
+            )
+        except BaseException as e:
+            done.set()
+            if isinstance(e, Exception):
+                self.stats['failed_shards'] += 1
+                self._call('fail', shard=shard_id, token=token, error=f"{self.worker_id}: {e}")
+                return
+            # Ctrl-C: give the shard back for another node
+            self._call('release', shard=shard_id, token=token)
+            raise
+        finally:
+            done.set()
+            beat.join()
+
+        if lost.is_set():
+            self.stats['lost'] += 1
+            self.logger.warning(f"Lease on shard {shard_id} lost; its results are dropped")
+            return
+
+        # convert_batch reports per-file errors instead of raising, so a node
+        # that fails most of a shard hands it back for a retry elsewhere; the
+        # last attempt is completed so its per-file errors are reported
+        attempted = results['total'] - results['skipped'] - results['unchanged']
+        if (results['failed'] and results['failed'] >= attempted * SHARD_FAILURE_RATIO
+                and lease['attempt'] < lease.get('max_attempts', 1)):
+            first = results['errors'][0] if results['errors'] else {}
+            self.stats['failed_shards'] += 1
+            self.logger.warning(f"Shard {shard_id}: {results['failed']} of {attempted} files failed; "
+                                "handing it back for another node")
+            self._call('fail', shard=shard_id, token=token,
+                       error=f"{self.worker_id}: {results['failed']} of {attempted} files failed "
+                             f"(first: {first.get('file')}: {first.get('error')})")
+            return
+
+        result = {
+            'worker': self.worker_id,
+            'duration': round(results['duration'], 3),
+            'errors': [{'file': record['file'], 'error': record.get('error')} for record in results['errors']],
+            'errors_dropped': results['errors_dropped'],
+            **{key: results[key] for key in ('successful', 'failed', 'skipped', 'unchanged', 'total')}
+        }
+        for key in ('successful', 'failed', 'skipped'):
+            self.stats[key] += results[key]
+        if self._call('complete', shard=shard_id, token=token, result=result)['status'] == 'success':
+            self.stats['shards'] += 1
+        else:
+            self.stats['lost'] += 1
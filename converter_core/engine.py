@@ -0,0 +1,1055 @@
+#!/usr/bin/env python3
+"""
+Conversion Engine
+UniversalConverter and its thread/process batch executors, free of any GUI
+dependency so the CLI, pipe server and workers start quickly
+"""
+
+import concurrent.futures
+import gc
+import hashlib
+import importlib.util
+import itertools
+import os
+import queue
+import tempfile
+import threading
+import time
+from collections.abc import Mapping
+from pathlib import Path
+from threading import Lock
+from typing import Any, Dict, Iterable, Iterator, List, Optional, Sequence, Union
+
+from . import registry
+from . import readers as _readers  # noqa: F401  (registers the built-in readers)
+from . import writers as _writers  # noqa: F401  (registers the built-in writers)
+from .admission import MemoryBudget, admit_submit, estimate_job_memory, shared_budget
+from .backpressure import bounded_submit
+from .cache import ContentCache, _ContentRecorder
+from .config import ConfigManager, ConverterLogger
+from .errors import (
+    DocumentConverterError, UnsupportedFormatError, FileProcessingError,
+    ContentReadError, ConfigurationError, JobCancelled
+)
+from .formats import FormatDetector
+from .manifest import ConversionManifest, fingerprint_source, hash_source
+from .metrics import METRICS, timed_iter
+from .readers import PartialContent
+from .scheduler import PRIORITY_BATCH, Job, JobScheduler, check_cancelled, shared_scheduler
+
+# psutil is only imported when memory monitoring actually samples the process
+PSUTIL_AVAILABLE = importlib.util.find_spec('psutil') is not None
+
+# Blocks buffered per writer when one document is written to several formats
+FAN_OUT_QUEUE_BLOCKS = 64
+
+_END_OF_CONTENT = object()
+
+
+class _ReadFailure:
+    """Stands in the fan-out queues for an exception raised by the reader"""
+
+    def __init__(self, error: BaseException):
+        self.error = error
+
+
+class UniversalConverter:
+    """Main conversion engine with enhanced logging, caching, and performance optimization"""
+
+    def __init__(self, logger_name: str = "UniversalConverter", enable_caching: Optional[bool] = None,
+                 config_manager: Optional[ConfigManager] = None):
+        # Initialize configuration manager
+        self.config_manager = config_manager or ConfigManager()
+
+        # Get configuration values
+        if enable_caching is None:
+            enable_caching = self.config_manager.get('performance', 'enable_caching', True)
+
+        log_level = self.config_manager.get('logging', 'log_level', 'INFO')
+        self.logger_instance = ConverterLogger(logger_name, log_level)
+        self.logger = self.logger_instance.get_logger()
+
+        # Readers and writers come from the registry and are only instantiated
+        # when their format is first converted
+        self.readers = registry.readers.instances()
+        self.writers = registry.writers.instances()
+
+        # Performance optimization features from config
+        self.enable_caching = enable_caching
+        self.cache = {}  # Simple in-memory cache
+        self.cache_lock = Lock()  # Thread-safe cache access
+
+        # Persistent cache of parsed reader output, shared across runs
+        self.content_cache = None
+        if enable_caching and self.config_manager.get('performance', 'enable_content_cache', True):
+            try:
+                self.content_cache = ContentCache(
+                    self.config_manager.config_dir / "content_cache",
+                    self.config_manager.get('performance', 'content_cache_max_mb', 512),
+                    self.logger
+                )
+            except OSError as e:
+                self.logger.warning(f"Content cache disabled: {e}")
+
+        # Memory optimization features from config
+        self.memory_threshold_mb = self.config_manager.get('performance', 'memory_threshold_mb', 500)
+        self.enable_memory_monitoring = (PSUTIL_AVAILABLE and
+                                       self.config_manager.get('performance', 'enable_memory_monitoring', True))
+        self._process = None
+        # Memory admission for batches: None uses the process-wide shared budget
+        self.memory_budget: Optional[MemoryBudget] = None
+        # Worker threads for thread batches: None uses the process-wide shared scheduler
+        self.scheduler: Optional[JobScheduler] = None
+
+        # Stage timings, cache hit rates and batch utilisation (process-wide by default)
+        self.metrics = METRICS
+
+        self.logger.info("UniversalConverter initialized successfully")
+
+    def _get_memory_usage_mb(self) -> float:
+        """Get current memory usage in MB (also published as the process_rss_bytes gauge)"""
+        if not PSUTIL_AVAILABLE:
+            return 0.0
+        try:
+            if self._process is None:
+                import psutil
+                self._process = psutil.Process()
+            rss = self._process.memory_info().rss
+        except Exception:
+            return 0.0
+        self.metrics.set_gauge('process_rss_bytes', rss)
+        return rss / 1024 / 1024
+
+    def _should_optimize_memory(self, current_memory: Optional[float] = None) -> bool:
+        """Check if memory optimization should be enabled"""
+        if not self.enable_memory_monitoring:
+            return False
+
+        if current_memory is None:
+            current_memory = self._get_memory_usage_mb()
+        return current_memory > self.memory_threshold_mb
+
+    def _batch_memory_budget(self) -> Optional[MemoryBudget]:
+        """Budget batch jobs are admitted against, or None when admission is turned off"""
+        if not self.config_manager.get('performance', 'memory_admission', True):
+            return None
+        if self.memory_budget is None:
+            self.memory_budget = shared_budget(self.config_manager.get('performance', 'memory_budget_mb', None))
+        return self.memory_budget
+
+    def _job_scheduler(self) -> JobScheduler:
+        """Scheduler thread batches run on, shared with OCR, previews and the pipe server"""
+        if self.scheduler is None:
+            self.scheduler = shared_scheduler(self.config_manager.get('performance', 'scheduler_workers', None))
+        return self.scheduler
+
+    def _cleanup_memory(self):
+        """Force garbage collection to free memory"""
+        gc.collect()
+
+        # Clear cache if memory usage is high
+        if self._should_optimize_memory():
+            with self.cache_lock:
+                cache_size = len(self.cache)
+                if cache_size > 0:
+                    self.cache.clear()
+                    self.logger.debug(f"Cleared cache ({cache_size} entries) due to high memory usage")
+
+    def _get_file_hash(self, file_path: Path) -> str:
+        """Generate a hash for file content and metadata for caching"""
+        try:
+            stat = file_path.stat()
+            # Use file size, modification time, and path for hash
+            content = f"{file_path}:{stat.st_size}:{stat.st_mtime}"
+            return hashlib.md5(content.encode()).hexdigest()
+        except Exception:
+            return None
+
+    def _get_cache_key(self, input_path: Path, output_format: str, input_format: str) -> str:
+        """Generate cache key for conversion"""
+        file_hash = self._get_file_hash(input_path)
+        if file_hash:
+            return f"{file_hash}:{input_format}:{output_format}"
+        return None
+
+    def _is_cached_valid(self, input_path: Path, output_path: Path, cache_key: str) -> bool:
+        """Check if cached result is still valid"""
+        if not self.enable_caching or cache_key not in self.cache:
+            return False
+
+        # Check if output file exists and is newer than input
+        if not output_path.exists():
+            return False
+
+        try:
+            input_mtime = input_path.stat().st_mtime
+            output_mtime = output_path.stat().st_mtime
+            return output_mtime >= input_mtime
+        except Exception:
+            return False
+
+    def _iter_content(self, input_format: str, input_path: Path):
+        """
+        Stream content blocks from the reader, tagging any failure as a read error
+
+        A cancelled scheduler job stops the stream between blocks.
+        """
+        try:
+            for block in self.readers[input_format].iter_read(input_path):
+                check_cancelled()
+                yield block
+        except JobCancelled:
+            raise
+        except Exception as e:
+            raise ContentReadError(f"Failed to read {input_path}: {str(e)}") from e
+
+    def _discard_partial_output(self, staging_dir: Path):
+        """Remove the staging directory of a conversion that failed mid-stream"""
+        for leftover in staging_dir.glob('*'):
+            try:
+                leftover.unlink()
+            except OSError:
+                pass
+        try:
+            staging_dir.rmdir()
+        except OSError:
+            pass
+
+    @staticmethod
+    def _output_formats(output_format: Union[str, Sequence[str]]) -> List[str]:
+        """One output format or several, as a list without duplicates"""
+        if isinstance(output_format, str):
+            return [output_format]
+        return list(dict.fromkeys(output_format))
+
+    @staticmethod
+    def _output_targets(output_path: Union[str, Path, Mapping], output_formats: List[str]) -> Dict[str, Path]:
+        """Map each output format to the path it is written to"""
+        if isinstance(output_path, Mapping):
+            missing = [fmt for fmt in output_formats if fmt not in output_path]
+            if missing:
+                raise ConfigurationError(f"No output path given for format(s): {', '.join(missing)}")
+            return {fmt: Path(output_path[fmt]) for fmt in output_formats}
+        output_path = Path(output_path)
+        if len(output_formats) == 1:
+            return {output_formats[0]: output_path}
+        return {fmt: output_path.with_suffix(
+                    FormatDetector.SUPPORTED_OUTPUT_FORMATS.get(fmt, {}).get('extension', f'.{fmt}'))
+                for fmt in output_formats}
+
+    def _write_output(self, output_format: str, content: Iterable, output_path: Path):
+        """
+        Run one writer over the content stream and move its output into place
+
+        The writer fills a file of the same name in a hidden directory next to
+        output_path, which replaces output_path only once the writer finishes,
+        so a failed re-conversion leaves the previous output untouched and
+        nodes sharing a mount never see each other's half-written files.
+        """
+        output_path.parent.mkdir(parents=True, exist_ok=True)
+        staging_dir = Path(tempfile.mkdtemp(prefix=f".{output_path.name}.", suffix=".partial",
+                                            dir=output_path.parent))
+        staged = staging_dir / output_path.name
+        try:
+            self.writers[output_format].write(content, staged)
+            os.replace(staged, output_path)
+        except (ContentReadError, JobCancelled):
+            raise
+        except Exception as e:
+            raise FileProcessingError(f"Failed to write {output_path}: {str(e)}")
+        finally:
+            self._discard_partial_output(staging_dir)
+
+    def _fan_out_write(self, content: Iterable, targets: Dict[str, Path]) -> Dict[str, float]:
+        """
+        Stream one content iterator to several writers at once
+
+        Every writer runs on its own thread behind a bounded queue, so the
+        document is read once and a slow writer holds the reader back by at
+        most FAN_OUT_QUEUE_BLOCKS blocks. If the reader or any writer fails,
+        the error is raised once all writers have stopped; the failed writers'
+        partial outputs are removed and their previous outputs are kept.
+
+        Returns:
+            Seconds each writer spent writing (time waiting for blocks excluded)
+        """
+        queues = {fmt: queue.Queue(maxsize=FAN_OUT_QUEUE_BLOCKS) for fmt in targets}
+        failures: Dict[str, BaseException] = {}
+        write_seconds: Dict[str, float] = {}
+
+        def blocks(fmt):
+            while True:
+                block = queues[fmt].get()
+                if block is _END_OF_CONTENT:
+                    return
+                if isinstance(block, _ReadFailure):
+                    raise block.error
+                yield block
+
+        def run_writer(fmt, path):
+            waited = []
+            start = time.perf_counter()
+            try:
+                self._write_output(fmt, timed_iter(blocks(fmt), waited.append), path)
+            except BaseException as e:
+                failures[fmt] = e
+            finally:
+                write_seconds[fmt] = max(0.0, time.perf_counter() - start - sum(waited))
+
+        threads = {fmt: threading.Thread(target=run_writer, args=(fmt, path), name=f"writer-{fmt}", daemon=True)
+                   for fmt, path in targets.items()}
+        for thread in threads.values():
+            thread.start()
+
+        def offer(fmt, item):
+            # A writer that stopped (failed, or returned without reading
+            # everything) no longer drains its queue
+            while threads[fmt].is_alive():
+                try:
+                    queues[fmt].put(item, timeout=0.1)
+                    return
+                except queue.Full:
+                    continue
+
+        read_error = None
+        try:
+            for block in content:
+                for fmt in targets:
+                    offer(fmt, block)
+                if not any(thread.is_alive() for thread in threads.values()):
+                    break
+        except BaseException as e:
+            read_error = e
+        finally:
+            end = _END_OF_CONTENT if read_error is None else _ReadFailure(read_error)
+            for fmt in targets:
+                offer(fmt, end)
+            for thread in threads.values():
+                thread.join()
+
+        if read_error is not None:
+            raise read_error
+        if failures:
+            errors = list(failures.values())
+            if len(errors) == 1:
+                raise errors[0]
+            raise FileProcessingError("; ".join(str(error) for error in errors))
+        return write_seconds
+
+    def convert_file(self, input_path: Union[str, Path], output_path: Union[str, Path, Mapping],
+                    input_format: Optional[str] = None, output_format: Union[str, Sequence[str]] = 'markdown'):
+        """
+        Convert a single file with enhanced error handling and logging
+
+        ``output_format`` may be a list of formats: the document is then read
+        once and its content handed to every writer in parallel. Give
+        ``output_path`` as a {format: path} mapping, or as one path whose
+        suffix is replaced by each format's extension.
+        """
+        metrics = self.metrics
+        start_time = time.perf_counter()
+        status = 'error'
+        output_formats = self._output_formats(output_format)
+        cached_formats = []
+        try:
+            input_path = Path(input_path)
+            targets = self._output_targets(output_path, output_formats)
+            destination = ', '.join(str(path) for path in targets.values())
+
+            self.logger.info(f"Starting conversion: {input_path} -> {destination}")
+
+            # Validate input file exists
+            if not input_path.exists():
+                raise FileProcessingError(f"Input file does not exist: {input_path}")
+
+            # Auto-detect format if not specified
+            if input_format is None or input_format == 'auto':
+                with metrics.timer('stage_seconds', stage='detect'):
+                    input_format = FormatDetector.detect_format(input_path)
+                if input_format is None:
+                    raise UnsupportedFormatError(f"Unsupported file format: {input_path}")
+                self.logger.debug(f"Auto-detected format: {input_format}")
+
+            # Validate input format
+            if input_format not in self.readers:
+                raise UnsupportedFormatError(f"No reader available for format: {input_format}")
+
+            # Validate output formats
+            for fmt in output_formats:
+                if fmt not in self.writers:
+                    raise UnsupportedFormatError(f"No writer available for format: {fmt}")
+
+            # Check cache if enabled; only outputs without a valid cached result are written
+            cache_keys = {}
+            if self.enable_caching:
+                for fmt, path in list(targets.items()):
+                    cache_key = self._get_cache_key(input_path, fmt, input_format)
+                    if cache_key and self._is_cached_valid(input_path, path, cache_key):
+                        metrics.inc('cache_lookups_total', cache='conversion', result='hit')
+                        self.logger.debug(f"Using cached {fmt} result for {input_path}")
+                        cached_formats.append(fmt)
+                        del targets[fmt]
+                        continue
+                    metrics.inc('cache_lookups_total', cache='conversion', result='miss')
+                    cache_keys[fmt] = cache_key
+                if not targets:
+                    status = 'cached'
+                    return
+
+            # Monitor memory before processing; sampled once here and once at the end
+            initial_memory = 0.0
+            if self.enable_memory_monitoring:
+                initial_memory = self._get_memory_usage_mb()
+                self.logger.debug(f"Memory usage before conversion: {initial_memory:.1f} MB")
+
+            # Create output directories if needed
+            for path in targets.values():
+                path.parent.mkdir(parents=True, exist_ok=True)
+
+            # Reuse parsed content from an earlier run when the source bytes match
+            content_key = None
+            recorder = None
+            cached_content = None
+            if self.content_cache:
+                content_key = self.content_cache.key_for(input_path, input_format)
+                if content_key:
+                    cached_content = self.content_cache.get(content_key)
+                    metrics.inc('cache_lookups_total', cache='content',
+                                result='miss' if cached_content is None else 'hit')
+
+            read_seconds = []
+            if cached_content is not None:
+                self.logger.debug(f"Using cached content for {input_path}, skipping {input_format} reader")
+                content = iter(cached_content)
+            else:
+                # Stream the document from the reader straight into the writer so
+                # only the block being processed is held in memory
+                content = timed_iter(self._iter_content(input_format, input_path), read_seconds.append)
+                if content_key:
+                    recorder = _ContentRecorder(content, self.content_cache.max_entry_bytes)
+                    content = iter(recorder)
+
+            write_start = time.perf_counter()
+            if len(targets) == 1:
+                (fmt, path), = targets.items()
+                self.logger.debug(f"Writing document with {fmt} writer")
+                self._write_output(fmt, content, path)
+                # Reader and writer run interleaved; the writer gets the remainder
+                read_time = sum(read_seconds)
+                write_seconds = {fmt: time.perf_counter() - write_start - read_time}
+            else:
+                # Read once, write many: each writer consumes the same stream
+                self.logger.debug(f"Writing document with {', '.join(targets)} writers in parallel")
+                write_seconds = self._fan_out_write(content, targets)
+                read_time = sum(read_seconds)
+
+            if cached_content is None:
+                metrics.observe('stage_seconds', read_time, stage='read', format=input_format)
+            for fmt, seconds in write_seconds.items():
+                metrics.observe('stage_seconds', seconds, stage='write', format=fmt)
+
+            if recorder is not None and not recorder.overflowed:
+                self.content_cache.put(content_key, recorder.recorded, input_format)
+
+            # Update cache if enabled
+            if self.enable_caching:
+                with self.cache_lock:
+                    for fmt, cache_key in cache_keys.items():
+                        if cache_key:
+                            self.cache[cache_key] = {
+                                'timestamp': time.time(),
+                                'input_path': str(input_path),
+                                'output_path': str(targets[fmt])
+                            }
+
+            # Final memory check, once the stream has been written
+            if self.enable_memory_monitoring:
+                final_memory = self._get_memory_usage_mb()
+                total_change = final_memory - initial_memory
+                if abs(total_change) > 10:  # Log significant memory changes
+                    self.logger.debug(f"Memory change during conversion: {total_change:+.1f} MB")
+
+                # Cleanup if memory usage is high
+                if self._should_optimize_memory(final_memory):
+                    self._cleanup_memory()
+
+            status = 'success'
+            self.logger.info(f"Conversion completed successfully: {input_path} -> {destination}")
+
+        except (UnsupportedFormatError, FileProcessingError) as e:
+            self.logger.error(f"Conversion failed: {str(e)}")
+            raise
+        except JobCancelled:
+            status = 'cancelled'
+            self.logger.info(f"Conversion cancelled: {input_path}")
+            raise
+        except Exception as e:
+            error_msg = f"Unexpected error during conversion: {str(e)}"
+            self.logger.error(error_msg)
+            raise DocumentConverterError(error_msg) from e
+        finally:
+            for fmt in output_formats:
+                metrics.inc('conversions_total', input_format=input_format, output_format=fmt,
+                            status='cached' if fmt in cached_formats else status)
+            metrics.observe('stage_seconds', time.perf_counter() - start_time, stage='total',
+                            format=input_format)
+
+    def read_partial(self, input_path: Union[str, Path], input_format: Optional[str] = None,
+                     max_pages: Optional[int] = None, max_blocks: Optional[int] = None,
+                     max_bytes: Optional[int] = None, cursor: Any = None) -> PartialContent:
+        """
+        The first content blocks of a document (or those after ``cursor``)
+        without parsing the rest; see DocumentReader.read_partial
+        """
+        input_path = Path(input_path)
+        if not input_path.exists():
+            raise FileProcessingError(f"Input file does not exist: {input_path}")
+        if input_format is None or input_format == 'auto':
+            input_format = FormatDetector.detect_format(input_path)
+            if input_format is None:
+                raise UnsupportedFormatError(f"Unsupported file format: {input_path}")
+        if input_format not in self.readers:
+            raise UnsupportedFormatError(f"No reader available for format: {input_format}")
+
+        with self.metrics.timer('stage_seconds', stage='read_partial', format=input_format):
+            try:
+                return self.readers[input_format].read_partial(input_path, max_pages, max_blocks, max_bytes, cursor)
+            except DocumentConverterError:
+                raise
+            except Exception as e:
+                raise ContentReadError(f"Failed to read {input_path}: {str(e)}") from e
+
+    def preview(self, input_path: Union[str, Path], output_format: str = 'markdown',
+                input_format: Optional[str] = None, max_pages: Optional[int] = None,
+                max_blocks: Optional[int] = 50, max_bytes: Optional[int] = 64 * 1024,
+                cursor: Any = None) -> Dict[str, Any]:
+        """
+        The start of a document rendered by a text writer (markdown, txt, html, rtf)
+
+        Returns ``{'text', 'cursor', 'complete'}``; pass ``cursor`` back for
+        the next part. Only the blocks shown are parsed, so the first screen
+        of a 1,000-page file costs about as much as a one-page file.
+        """
+        if output_format not in self.writers:
+            raise UnsupportedFormatError(f"No writer available for format: {output_format}")
+        part = self.read_partial(input_path, input_format, max_pages, max_blocks, max_bytes, cursor)
+
+        # Writers only write to paths; a preview is small, so a temp file is cheap
+        with tempfile.TemporaryDirectory(prefix="preview-") as temp_dir:
+            preview_path = Path(temp_dir) / Path(input_path).with_suffix(
+                FormatDetector.SUPPORTED_OUTPUT_FORMATS[output_format]['extension']).name
+            self.writers[output_format].write(part.blocks, preview_path)
+            text = preview_path.read_text(encoding='utf-8', errors='replace')
+        return {'text': text, 'cursor': part.cursor, 'complete': part.complete}
+
+    @staticmethod
+    def _batch_output_path(file_path: Path, output_dir: Path, output_format: str,
+                           preserve_structure: bool, base_dir: Optional[Path]) -> Path:
+        """Where a batch writes the output for one source file"""
+        output_ext = FormatDetector.SUPPORTED_OUTPUT_FORMATS[output_format]['extension']
+        if preserve_structure and base_dir:
+            rel_path = file_path.relative_to(base_dir)
+            return output_dir / rel_path.with_suffix(output_ext)
+        return output_dir / f"{file_path.stem}{output_ext}"
+
+    def _hash_source(self, file_path: Path) -> str:
+        """Source content hash, shared with the content cache's per-process memo"""
+        if self.content_cache:
+            return self.content_cache.hash_file(file_path)
+        return hash_source(file_path)
+
+    def _convert_batch_item(self, file_path, index, output_dir: Path, input_format: str,
+                            output_format: str, preserve_structure: bool,
+                            overwrite_existing: bool, base_dir: Optional[Path],
+                            incremental: bool = False) -> Dict[str, Any]:
+        """Convert one file of a batch and return its result record (never raises)"""
+        start_time = time.perf_counter()
+        result = self._convert_batch_item_untimed(file_path, index, output_dir, input_format, output_format,
+                                                  preserve_structure, overwrite_existing, base_dir, incremental)
+        result['duration'] = time.perf_counter() - start_time
+        return result
+
+    def _convert_batch_item_untimed(self, file_path, index, output_dir: Path, input_format: str,
+                                    output_format: str, preserve_structure: bool,
+                                    overwrite_existing: bool, base_dir: Optional[Path],
+                                    incremental: bool) -> Dict[str, Any]:
+        try:
+            file_path = Path(file_path)
+
+            # Determine output paths, one per output format
+            targets = {fmt: self._batch_output_path(file_path, output_dir, fmt, preserve_structure, base_dir)
+                       for fmt in self._output_formats(output_format)}
+
+            # Skip outputs that exist unless overwriting
+            if not overwrite_existing:
+                targets = {fmt: path for fmt, path in targets.items() if not path.exists()}
+                if not targets:
+                    return {'status': 'skipped', 'file': file_path.name, 'index': index}
+
+            # Fingerprint the source before reading it, for the incremental manifest
+            fingerprint = fingerprint_source(file_path, self._hash_source) if incremental else None
+
+            # Convert the file: read once, written to every output format
+            self.convert_file(file_path, targets, input_format, list(targets))
+
+            outputs = [path.name for path in targets.values()]
+            result = {'status': 'success', 'file': file_path.name, 'output': ', '.join(outputs),
+                      'outputs': outputs, 'index': index}
+            if incremental:
+                result.update({
+                    'source_path': str(file_path),
+                    'output_paths': {fmt: str(path) for fmt, path in targets.items()},
+                    'input_format': (FormatDetector.detect_format(file_path)
+                                     if input_format in (None, 'auto') else input_format),
+                    'fingerprint': fingerprint
+                })
+            return result
+
+        except JobCancelled:
+            return {'status': 'cancelled', 'file': Path(file_path).name, 'index': index}
+        except Exception as e:
+            return {'status': 'error', 'file': Path(file_path).name, 'error': str(e), 'index': index}
+
+    def convert_batch(self, file_list: Iterable, output_dir: Path, input_format: str = 'auto',
+                     output_format: Union[str, Sequence[str]] = 'markdown', max_workers: int = None,
+                     progress_callback=None, preserve_structure: bool = True,
+                     overwrite_existing: bool = False, base_dir: Path = None,
+                     executor: Optional[str] = None, chunk_size: Optional[int] = None,
+                     incremental: bool = False, prune_deleted: bool = True,
+                     max_in_flight: Optional[int] = None, cancel_event: Optional[threading.Event] = None,
+                     max_errors: Optional[int] = 1000, job: Optional[Job] = None) -> Dict[str, Any]:
+        """
+        Convert multiple files concurrently with progress tracking
+
+        Args:
+            file_list: Input file paths: a list, or any iterable such as the
+                discovery.iter_input_files() stream, consumed as workers free up
+                so conversion starts while a large tree is still being walked
+            output_dir: Output directory
+            input_format: Input format ('auto' for detection)
+            output_format: Output format, or a list of them: each file is then
+                read once and written in every format (result 'outputs')
+            max_workers: Maximum number of concurrent workers (None for auto)
+            progress_callback: Function to call with progress updates
+            preserve_structure: Whether to preserve directory structure
+            overwrite_existing: Whether to overwrite existing files
+            base_dir: Base directory for structure preservation
+            executor: 'thread' or 'process' (None uses the configured default)
+            chunk_size: Files per work unit sent to a process worker (None for auto)
+            incremental: Keep a ConversionManifest in output_dir and convert only
+                sources that are new or changed since the last incremental run;
+                up-to-date ones are reported with status 'unchanged'
+            prune_deleted: In incremental mode, delete outputs (and manifest
+                entries) of recorded sources that no longer exist
+            max_in_flight: Files (thread executor) or chunks (process executor)
+                submitted ahead of the workers (None: from config, else twice
+                the worker count)
+            cancel_event: Set it to stop the batch; running conversions finish,
+                nothing new starts and results['cancelled'] is True
+            max_errors: Error records kept in results['errors'] (None keeps all);
+                the rest are only counted in results['errors_dropped']
+            job: Scheduler job to run as: its priority orders the thread
+                workers, cancelling it also stops files mid-conversion, and
+                it receives a progress event per file
+
+        Returns:
+            Dictionary with conversion results and statistics. For a streamed
+            file_list, 'total' (and the total passed to progress_callback)
+            counts the files discovered so far. Per-file results are not kept:
+            use iter_convert_batch() or progress_callback to see each of them.
+        """
+        results = {
+            'successful': 0,
+            'failed': 0,
+            'skipped': 0,
+            'unchanged': 0,
+            'pruned': 0,
+            'total': 0,
+            'errors': [],
+            'errors_dropped': 0,
+            'cancelled': False,
+            'start_time': time.time()
+        }
+
+        for result in self.iter_convert_batch(
+                file_list, output_dir, input_format, output_format, max_workers, preserve_structure,
+                overwrite_existing, base_dir, executor, chunk_size, incremental, prune_deleted,
+                max_in_flight, cancel_event, summary=results, job=job):
+            status = result['status']
+            if status == 'success':
+                results['successful'] += 1
+            elif status == 'error':
+                results['failed'] += 1
+                if max_errors is None or len(results['errors']) < max_errors:
+                    results['errors'].append(result)
+                else:
+                    results['errors_dropped'] += 1
+            elif status in ('skipped', 'unchanged'):
+                results[status] += 1
+
+            # Call progress callback if provided
+            if progress_callback or job is not None:
+                completed = (results['successful'] + results['failed'] + results['skipped'] +
+                             results['unchanged'])
+                if progress_callback:
+                    progress_callback(completed, results['total'], result)
+                if job is not None:
+                    job.progress(completed, results['total'], file=result['file'], status=status)
+
+        results['end_time'] = time.time()
+        results['duration'] = results['end_time'] - results['start_time']
+
+        self.logger.info(f"Batch conversion {'cancelled' if results['cancelled'] else 'completed'}: "
+                        f"{results['successful']} successful, "
+                        f"{results['failed']} failed, {results['skipped']} skipped, "
+                        f"{results['unchanged']} unchanged, {results['pruned']} pruned in "
+                        f"{results['duration']:.2f} seconds")
+
+        if job is not None:
+            job.finish()
+        return results
+
+    def iter_convert_batch(self, file_list: Iterable, output_dir: Path, input_format: str = 'auto',
+                           output_format: Union[str, Sequence[str]] = 'markdown', max_workers: int = None,
+                           preserve_structure: bool = True, overwrite_existing: bool = False,
+                           base_dir: Path = None, executor: Optional[str] = None,
+                           chunk_size: Optional[int] = None, incremental: bool = False,
+                           prune_deleted: bool = True, max_in_flight: Optional[int] = None,
+                           cancel_event: Optional[threading.Event] = None,
+                           summary: Optional[Dict[str, Any]] = None,
+                           job: Optional[Job] = None) -> Iterator[Dict[str, Any]]:
+        """
+        Convert a batch, yielding each file's result record as it finishes
+
+        Takes the same arguments as convert_batch. Only a bounded window of
+        work is in flight, so memory stays constant however many files the
+        batch has. Stopping early (cancel_event, or closing the generator)
+        lets running conversions finish; an incremental run has recorded
+        them in its manifest and the next run resumes with what is left.
+
+        Args:
+            summary: Optional dict updated with 'total' (files seen), 'pruned',
+                'cancelled' and 'worker_utilization'
+            job: Scheduler job the thread executor runs as (default: a
+                batch-priority job); its cancel flag doubles as cancel_event
+
+        Yields:
+            Result dicts with 'status' ('success', 'error', 'skipped',
+            'unchanged' or, for files stopped by a cancelled job,
+            'cancelled'), 'file', 'index' and, for converted files, 'duration'
+        """
+        if executor is None:
+            executor = self.config_manager.get('performance', 'executor', 'thread')
+        if executor not in BATCH_EXECUTORS:
+            raise ConfigurationError(f"Unknown batch executor: {executor}")
+        if job is not None and cancel_event is None:
+            cancel_event = job.cancel_event
+
+        if max_workers is None:
+            if executor == 'process':
+                # Reader/writer work is CPU bound, so one process per core
+                max_workers = os.cpu_count() or 1
+            else:
+                max_workers = min(4, (os.cpu_count() or 1) + 1)  # Conservative default
+        if max_in_flight is None:
+            max_in_flight = self.config_manager.get('performance', 'max_in_flight', None) or max_workers * 2
+
+        output_dir = Path(output_dir)
+        base_dir = Path(base_dir) if base_dir else None
+        output_formats = self._output_formats(output_format)
+        for fmt in output_formats:
+            if fmt not in FormatDetector.SUPPORTED_OUTPUT_FORMATS:
+                raise UnsupportedFormatError(f"Unsupported output format: {fmt}")
+        summary = summary if summary is not None else {}
+        summary.setdefault('pruned', 0)
+        summary['cancelled'] = False
+
+        sized = hasattr(file_list, '__len__')
+        summary['total'] = len(file_list) if sized else 0
+        if sized:
+            self.logger.info(f"Starting batch conversion of {len(file_list)} files with "
+                            f"{max_workers} {executor} workers")
+        else:
+            self.logger.info(f"Starting streamed batch conversion with {max_workers} {executor} workers")
+
+        manifest = ConversionManifest(output_dir, self.logger) if incremental else None
+        metrics = self.metrics
+        busy_seconds = 0.0
+        dispatched = [0]
+        unchanged = []
+        wall_start = time.perf_counter()
+
+        def finish(result):
+            """Account for a finished item; returns it ready to hand to the caller"""
+            nonlocal busy_seconds
+            metrics.inc('batch_files_total', executor=executor, status=result['status'])
+            if 'duration' in result:
+                busy_seconds += result['duration']
+                metrics.observe('batch_item_seconds', result['duration'], executor=executor)
+            if result['status'] == 'success' and manifest is not None:
+                source_path, fingerprint = result.pop('source_path'), result.pop('fingerprint')
+                item_input_format = result.pop('input_format')
+                for fmt, output_path in result.pop('output_paths').items():
+                    manifest.record(source_path, fmt, output_path, item_input_format, fingerprint)
+            return result
+
+        def discover():
+            """(index, path) items still to convert, in input order, pulled lazily"""
+            for i, file_path in enumerate(file_list):
+                if not sized:
+                    summary['total'] += 1
+                file_path = Path(file_path)
+                if manifest is not None:
+                    # Up-to-date sources never reach the executor; stale ones
+                    # are converted over their previous output
+                    try:
+                        current = all(
+                            manifest.is_current(file_path, fmt,
+                                                self._batch_output_path(file_path, output_dir, fmt,
+                                                                        preserve_structure, base_dir),
+                                                self._hash_source)
+                            for fmt in output_formats)
+                    except Exception:
+                        current = False
+                    if current:
+                        unchanged.append({'status': 'unchanged', 'file': file_path.name, 'index': i})
+                        if len(unchanged) >= 256:
+                            # Long unchanged runs: hand control back so the
+                            # records are delivered instead of piling up
+                            yield None
+                        continue
+                dispatched[0] += 1
+                if executor == 'thread':
+                    metrics.add_gauge('batch_queue_depth', 1, executor='thread')
+                yield i, file_path
+
+        def drain_unchanged():
+            while unchanged:
+                yield finish(unchanged.pop(0))
+
+        try:
+            if manifest is not None:
+                overwrite_existing = True
+
+            item_options = (output_dir, input_format, output_format, preserve_structure,
+                            overwrite_existing, base_dir, incremental)
+            metrics.set_gauge('batch_queue_depth', 0, executor=executor)
+            metrics.set_gauge('batch_workers_busy', 0, executor=executor)
+
+            budget = self._batch_memory_budget()
+            if executor == 'process':
+                item_results = self._iter_batch_in_processes(discover(), item_options, max_workers, chunk_size,
+                                                            len(file_list) if sized else None, max_in_flight,
+                                                            cancel_event, budget)
+            else:
+                item_results = self._iter_batch_in_threads(discover(), item_options, max_workers,
+                                                          max_in_flight, cancel_event, budget, job)
+            for result in item_results:
+                yield from drain_unchanged()
+                if result is not None:
+                    yield finish(result)
+            yield from drain_unchanged()
+
+            summary['cancelled'] = cancel_event is not None and cancel_event.is_set()
+            if manifest is not None and prune_deleted and not summary['cancelled']:
+                # A consumed stream cannot be replayed; prune then checks every
+                # recorded source on disk instead
+                for fmt in output_formats:
+                    summary['pruned'] += len(manifest.prune(file_list if sized else (), fmt))
+        finally:
+            if manifest is not None:
+                manifest.close()
+
+        # Share of the available worker time spent converting; low values
+        # mean the batch was too small or too uneven for this many workers
+        wall_seconds = time.perf_counter() - wall_start
+        if dispatched[0] and wall_seconds > 0:
+            workers_used = min(max_workers, dispatched[0])
+            summary['worker_utilization'] = min(1.0, busy_seconds / (wall_seconds * workers_used))
+            metrics.set_gauge('batch_worker_utilization', summary['worker_utilization'], executor=executor)
+
+    def _iter_batch_in_threads(self, items: Iterable, item_options: tuple, max_workers: int,
+                               max_in_flight: int, cancel_event: Optional[threading.Event],
+                               budget: Optional[MemoryBudget] = None,
+                               job: Optional[Job] = None) -> Iterator[Dict[str, Any]]:
+        """
+        Convert (index, path) batch items on the shared scheduler, a bounded window at a time
+
+        At most ``max_workers`` files convert at once, at the job's priority
+        (batch priority without a job), so previews and daemon requests
+        sharing the scheduler go ahead of queued files. With a ``budget``,
+        each file starts only once its estimated peak memory fits next to
+        the conversions already running.
+        """
+        metrics = self.metrics
+        input_format = item_options[1]
+
+        def estimate(item):
+            return 0 if item is None else estimate_job_memory(item[1], input_format)
+
+        def run_item(item):
+            if item is None:
+                return None
+            index, file_path = item
+            metrics.add_gauge('batch_queue_depth', -1, executor='thread')
+            metrics.add_gauge('batch_workers_busy', 1, executor='thread')
+            try:
+                return self._convert_batch_item(file_path, index, *item_options)
+            finally:
+                metrics.add_gauge('batch_workers_busy', -1, executor='thread')
+
+        max_in_flight = max(max_in_flight, max_workers)
+        with self._job_scheduler().executor(PRIORITY_BATCH, job, max_workers) as pool:
+            if budget is None:
+                submitted = bounded_submit(pool, run_item, items, max_in_flight, cancel_event)
+            else:
+                submitted = admit_submit(pool, run_item, items, max_in_flight, budget, estimate, cancel_event)
+            for _, future in submitted:
+                yield future.result()
+
+    def _iter_batch_in_processes(self, items: Iterable, item_options: tuple, max_workers: int,
+                                 chunk_size: Optional[int], total: Optional[int] = None,
+                                 max_in_flight: Optional[int] = None,
+                                 cancel_event: Optional[threading.Event] = None,
+                                 budget: Optional[MemoryBudget] = None) -> Iterator[Dict[str, Any]]:
+        """
+        Fan (index, path) batch items out to a process pool in chunks, streaming results as chunks finish
+
+        Chunks are cut from ``items`` as workers free up, with at most
+        ``max_in_flight`` chunks submitted, so a streamed batch is never
+        materialised. With a ``budget``, a worker converts its chunk one file
+        at a time, so a chunk weighs as much as its biggest file; files too
+        big to share the machine get a chunk of their own.
+        """
+        if chunk_size is None:
+            if total:
+                # Several chunks per worker keeps the pool balanced when file sizes vary
+                chunk_size = max(1, min(32, total // (max_workers * 4)))
+            else:
+                chunk_size = 8
+        max_in_flight = max(max_in_flight or max_workers * 2, max_workers)
+
+        items = iter(items)
+        input_format = item_options[1]
+        # Estimated peak bytes per chunk, by id() of the chunk list while it is queued
+        chunk_weights = {}
+        giant = budget.limit / max_workers if budget is not None else None
+
+        def cut(chunk, weight):
+            queued[0] += len(chunk)
+            if chunk:
+                chunk_weights[id(chunk)] = weight
+            return chunk
+
+        def chunks():
+            chunk = []
+            weight = 0
+            for item in items:
+                if item is not None:
+                    entry = (str(item[1]), item[0])
+                    if budget is not None:
+                        item_weight = estimate_job_memory(item[1], input_format)
+                        if item_weight > giant:
+                            if chunk:
+                                yield cut(chunk, weight)
+                                chunk, weight = [], 0
+                            yield cut([entry], item_weight)
+                            continue
+                        weight = max(weight, item_weight)
+                    chunk.append(entry)
+                # A None marker flushes early, possibly as an empty chunk
+                if item is None or len(chunk) >= chunk_size:
+                    yield cut(chunk, weight)
+                    chunk, weight = [], 0
+            if chunk:
+                yield cut(chunk, weight)
+
+        initargs = (str(self.config_manager.config_file), self.config_manager.config,
+                    self.enable_caching, item_options)
+
+        # The pool hides which chunk each worker is on, so busy workers and
+        # queue depth are derived from the chunks still outstanding
+        metrics = self.metrics
+        queued = [0]
+        in_flight = [0]
+
+        def publish_progress():
+            busy = min(max_workers, in_flight[0])
+            metrics.set_gauge('batch_workers_busy', busy, executor='process')
+            metrics.set_gauge('batch_queue_depth', max(0, queued[0] - busy * chunk_size), executor='process')
+
+        def counted(chunk_stream):
+            for chunk in chunk_stream:
+                in_flight[0] += 1
+                publish_progress()
+                yield chunk
+
+        # Only start worker processes once there is something to convert
+        chunk_stream = chunks()
+        for first in chunk_stream:
+            if first:
+                break
+            yield None
+        else:
+            return
+
+        with concurrent.futures.ProcessPoolExecutor(max_workers=max_workers,
+                                                    initializer=_init_batch_worker,
+                                                    initargs=initargs) as pool:
+            pending = counted(itertools.chain([first], chunk_stream))
+            if budget is None:
+                submitted = bounded_submit(pool, _convert_batch_chunk, pending, max_in_flight, cancel_event)
+            else:
+                submitted = admit_submit(pool, _convert_batch_chunk, pending, max_in_flight, budget,
+                                         lambda chunk: chunk_weights.pop(id(chunk), 0), cancel_event)
+            for chunk, future in submitted:
+                try:
+                    chunk_results, worker_metrics = future.result()
+                    # Stage timings recorded inside the worker
+                    metrics.merge(worker_metrics)
+                except Exception as e:
+                    # A crashed worker takes its whole chunk with it
+                    chunk_results = [{'status': 'error', 'file': Path(path).name,
+                                      'error': f"Worker process failed: {e}", 'index': index}
+                                     for path, index in chunk]
+                in_flight[0] -= 1
+                queued[0] -= len(chunk)
+                publish_progress()
+                yield from chunk_results
+                if not chunk_results:
+                    yield None
+
+
+BATCH_EXECUTORS = ('thread', 'process')
+
+# Per-process state for the 'process' batch executor. Each worker builds its
+# converter once in the pool initializer and reuses it for every chunk.
+_batch_worker_converter = None
+_batch_worker_options = None
+
+
+def _init_batch_worker(config_file: str, config: dict, enable_caching: bool, item_options: tuple):
+    """Process pool initializer: build this worker's converter from the parent's settings"""
+    global _batch_worker_converter, _batch_worker_options
+    config_manager = ConfigManager(config_file)
+    config_manager.config = config
+    _batch_worker_converter = UniversalConverter("UniversalConverterWorker", enable_caching=enable_caching,
+                                                 config_manager=config_manager)
+    _batch_worker_options = item_options
+
+
+def _convert_batch_chunk(chunk: list) -> tuple:
+    """
+    Convert a chunk of (path, index) pairs inside a process worker
+
+    Returns:
+        (results, metrics snapshot of this chunk) so the parent can merge the
+        worker's stage timings into its own registry
+    """
+    METRICS.reset()
+    results = [_batch_worker_converter._convert_batch_item(path, index, *_batch_worker_options)
+               for path, index in chunk]
+    snapshot = METRICS.snapshot()
+    # Process gauges (RSS) describe the worker, not the parent
+    snapshot.pop('process_rss_bytes', None)
+    return results, snapshot
@@ -0,0 +1,33 @@
+#!/usr/bin/env python3
+"""
+Converter Exceptions
+Error hierarchy shared by the readers, writers and conversion engine
+"""
+
+class DocumentConverterError(Exception):
+    """Base exception class for document converter errors"""
+    pass
+
+class UnsupportedFormatError(DocumentConverterError):
+    """Raised when an unsupported file format is encountered"""
+    pass
+
+class FileProcessingError(DocumentConverterError):
+    """Raised when file processing fails"""
+    pass
+
+class ContentReadError(FileProcessingError):
+    """Raised when a reader fails while its content is being streamed to a writer"""
+    pass
+
+class DependencyError(DocumentConverterError):
+    """Raised when required dependencies are missing"""
+    pass
+
+class ConfigurationError(DocumentConverterError):
+    """Raised when configuration operations fail"""
+    pass
+
+class JobCancelled(DocumentConverterError):
+    """Raised inside a running task when its scheduler job has been cancelled"""
+    pass
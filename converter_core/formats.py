@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+"""
+Format Detection
+Supported input/output formats and extension-based detection
+"""
+
+from pathlib import Path
+
+
+class FormatDetector:
+    """Utility class for detecting and validating file formats"""
+    
+    SUPPORTED_INPUT_FORMATS = {
+        'docx': {'extensions': ['.docx'], 'name': 'Word Document', 'reader': 'DocxReader'},
+        'pdf': {'extensions': ['.pdf'], 'name': 'PDF Document', 'reader': 'PdfReader'},
+        'txt': {'extensions': ['.txt'], 'name': 'Text File', 'reader': 'TxtReader'},
+        'html': {'extensions': ['.html', '.htm'], 'name': 'HTML Document', 'reader': 'HtmlReader'},
+        'rtf': {'extensions': ['.rtf'], 'name': 'Rich Text Format', 'reader': 'RtfReader'},
+        'markdown': {'extensions': ['.md', '.markdown'], 'name': 'Markdown Document', 'reader': 'MarkdownReader'},
+        'epub': {'extensions': ['.epub'], 'name': 'EPUB eBook', 'reader': 'EpubReader'}
+    }
+    
+    SUPPORTED_OUTPUT_FORMATS = {
+        'markdown': {'extension': '.md', 'name': 'Markdown', 'writer': 'MarkdownWriter'},
+        'txt': {'extension': '.txt', 'name': 'Plain Text', 'writer': 'TxtWriter'},
+        'html': {'extension': '.html', 'name': 'HTML Document', 'writer': 'HtmlWriter'},
+        'rtf': {'extension': '.rtf', 'name': 'Rich Text Format', 'writer': 'RtfWriter'},
+        'epub': {'extension': '.epub', 'name': 'EPUB eBook', 'writer': 'EpubWriter'}
+    }
+    
+    @classmethod
+    def detect_format(cls, file_path):
+        """Auto-detect the format of a file"""
+        ext = Path(file_path).suffix.lower()
+        for format_key, format_info in cls.SUPPORTED_INPUT_FORMATS.items():
+            if ext in format_info['extensions']:
+                return format_key
+        return None
+    
+    @classmethod
+    def get_input_format_list(cls):
+        """Get list of input formats for dropdown"""
+        formats = [('Auto-detect', 'auto')]
+        for key, info in cls.SUPPORTED_INPUT_FORMATS.items():
+            formats.append((f"{info['name']} ({', '.join(info['extensions'])})", key))
+        return formats
+    
+    @classmethod
+    def get_output_format_list(cls):
+        """Get list of output formats for dropdown"""
+        formats = []
+        for key, info in cls.SUPPORTED_OUTPUT_FORMATS.items():
+            formats.append((f"{info['name']} ({info['extension']})", key))
+        return formats
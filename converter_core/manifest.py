@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+"""
+Incremental Conversion Manifest
+Journal kept in the output tree of which sources were converted, from what
+bytes and to which outputs, so repeat runs only convert what changed
+"""
+
+import hashlib
+import logging
+import os
+import sqlite3
+import threading
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterable, List, Optional, Union
+
+
+def hash_source(file_path: Union[str, Path]) -> str:
+    """SHA-256 of a file's bytes (the same digest ContentCache keys on)"""
+    hasher = hashlib.sha256()
+    with open(file_path, 'rb') as f:
+        for chunk in iter(lambda: f.read(1024 * 1024), b''):
+            hasher.update(chunk)
+    return hasher.hexdigest()
+
+
+def fingerprint_source(file_path: Union[str, Path],
+                       hash_file: Callable[[Path], str] = hash_source) -> Dict[str, Any]:
+    """
+    Size, mtime and content hash of a source, taken before it is converted
+
+    Recording the fingerprint from before the read means an edit made while
+    the conversion runs is picked up by the next incremental run.
+    """
+    stat = os.stat(file_path)
+    return {'size': stat.st_size, 'mtime_ns': stat.st_mtime_ns, 'hash': hash_file(Path(file_path))}
+
+
+class ConversionManifest:
+    """
+    SQLite journal of converted sources, stored at the root of an output tree
+
+    One row per (source, output format) records the source's size, mtime and
+    content hash, the detected input format and the output path relative to
+    the output directory. A source is current when its size and mtime match
+    the row and the output still exists; when only the mtime moved, the
+    content hash decides, so a touched-but-identical file is not reconverted.
+    Writes are committed in batches, so a killed run loses at most the last
+    few records and those files are simply converted again next time.
+    """
+
+    FILENAME = ".converter_manifest.sqlite3"
+    SCHEMA_VERSION = 1
+    COMMIT_EVERY = 500
+
+    def __init__(self, output_dir: Union[str, Path], logger: Optional[logging.Logger] = None):
+        self.output_dir = Path(output_dir)
+        self.output_dir.mkdir(parents=True, exist_ok=True)
+        self._root = os.path.abspath(self.output_dir)
+        self.db_path = self.output_dir / self.FILENAME
+        self.logger = logger or logging.getLogger("ConversionManifest")
+        self._lock = threading.Lock()
+        self._pending = 0
+        self._conn = sqlite3.connect(str(self.db_path), check_same_thread=False)
+        self._init_schema()
+
+    def _init_schema(self):
+        """Create the table, resetting the journal on schema changes"""
+        conn = self._conn
+        conn.execute("PRAGMA journal_mode=WAL")
+        conn.execute("PRAGMA synchronous=NORMAL")
+        version = conn.execute("PRAGMA user_version").fetchone()[0]
+        if version != self.SCHEMA_VERSION:
+            conn.execute("DROP TABLE IF EXISTS sources")
+            conn.execute(f"PRAGMA user_version={self.SCHEMA_VERSION}")
+        conn.execute(
+            """CREATE TABLE IF NOT EXISTS sources (
+                   source TEXT NOT NULL,
+                   output_format TEXT NOT NULL,
+                   size INTEGER NOT NULL,
+                   mtime_ns INTEGER NOT NULL,
+                   hash TEXT NOT NULL,
+                   input_format TEXT,
+                   output TEXT NOT NULL,
+                   converted REAL NOT NULL,
+                   PRIMARY KEY (source, output_format)
+               )"""
+        )
+        conn.commit()
+
+    @staticmethod
+    def source_key(file_path: Union[str, Path]) -> str:
+        """Stable key for a source file: its absolute path"""
+        return os.path.abspath(str(file_path))
+
+    def _output_path(self, relative: str) -> Path:
+        return self.output_dir / relative
+
+    def _relative_output(self, output_path: Union[str, Path]) -> str:
+        output_path = os.path.abspath(output_path)
+        if os.path.commonpath([output_path, self._root]) == self._root:
+            return Path(os.path.relpath(output_path, self._root)).as_posix()
+        return output_path
+
+    def get(self, file_path: Union[str, Path], output_format: str) -> Optional[Dict[str, Any]]:
+        """Manifest row for a source and output format, or None"""
+        with self._lock:
+            row = self._conn.execute(
+                "SELECT size, mtime_ns, hash, input_format, output, converted FROM sources "
+                "WHERE source = ? AND output_format = ?",
+                (self.source_key(file_path), output_format)
+            ).fetchone()
+        if row is None:
+            return None
+        size, mtime_ns, content_hash, input_format, output, converted = row
+        return {
+            'size': size, 'mtime_ns': mtime_ns, 'hash': content_hash, 'input_format': input_format,
+            'output': self._output_path(output), 'converted': converted
+        }
+
+    def is_current(self, file_path: Union[str, Path], output_format: str,
+                   output_path: Optional[Union[str, Path]] = None,
+                   hash_file: Callable[[Path], str] = hash_source) -> bool:
+        """
+        Check whether a source's recorded output is still up to date
+
+        Args:
+            file_path: Source file
+            output_format: Output format the entry was recorded for
+            output_path: Where the output is expected now; a different path
+                (e.g. structure preservation toggled) counts as stale
+            hash_file: Content hasher, consulted only when size matches but mtime moved
+        """
+        entry = self.get(file_path, output_format)
+        if entry is None or not entry['output'].exists():
+            return False
+        if output_path is not None and os.path.abspath(output_path) != os.path.abspath(entry['output']):
+            return False
+        try:
+            stat = os.stat(file_path)
+        except OSError:
+            return False
+        if stat.st_size != entry['size']:
+            return False
+        if stat.st_mtime_ns == entry['mtime_ns']:
+            return True
+
+        # Touched, restored from backup or re-synced: compare the bytes
+        try:
+            unchanged = hash_file(Path(file_path)) == entry['hash']
+        except OSError:
+            return False
+        if unchanged:
+            with self._lock:
+                self._conn.execute(
+                    "UPDATE sources SET mtime_ns = ? WHERE source = ? AND output_format = ?",
+                    (stat.st_mtime_ns, self.source_key(file_path), output_format)
+                )
+                self._maybe_commit_locked()
+        return unchanged
+
+    def record(self, file_path: Union[str, Path], output_format: str, output_path: Union[str, Path],
+               input_format: Optional[str] = None,
+               fingerprint: Optional[Dict[str, Any]] = None) -> None:
+        """
+        Record a successful conversion
+
+        Args:
+            fingerprint: fingerprint_source() result taken before the
+                conversion (computed now if omitted)
+
+        A previous output of the same source and format at a different path
+        is removed so the output tree never keeps orphans.
+        """
+        fingerprint = fingerprint or fingerprint_source(file_path)
+        previous = self.get(file_path, output_format)
+        if previous and os.path.abspath(previous['output']) != os.path.abspath(output_path):
+            self._remove_output(previous['output'])
+
+        with self._lock:
+            self._conn.execute(
+                "INSERT OR REPLACE INTO sources "
+                "(source, output_format, size, mtime_ns, hash, input_format, output, converted) "
+                "VALUES (?, ?, ?, ?, ?, ?, ?, ?)",
+                (self.source_key(file_path), output_format, fingerprint['size'], fingerprint['mtime_ns'],
+                 fingerprint['hash'], input_format, self._relative_output(output_path), time.time())
+            )
+            self._maybe_commit_locked()
+
+    def prune(self, keep: Iterable[Union[str, Path]], output_format: Optional[str] = None) -> List[Path]:
+        """
+        Remove outputs and entries of sources that no longer exist
+
+        Sources in ``keep`` (the files of the current run) are left alone
+        without a stat; any other recorded source is pruned only if it is
+        gone from disk, so a run over a subset of the tree never deletes the
+        rest of it.
+
+        Returns:
+            Output files that were deleted
+        """
+        keep_keys = {self.source_key(path) for path in keep}
+        query = "SELECT source, output_format, output FROM sources"
+        params: tuple = ()
+        if output_format:
+            query += " WHERE output_format = ?"
+            params = (output_format,)
+        with self._lock:
+            rows = self._conn.execute(query, params).fetchall()
+
+        removed = []
+        stale = []
+        for source, fmt, output in rows:
+            if source in keep_keys or os.path.exists(source):
+                continue
+            output_path = self._output_path(output)
+            if self._remove_output(output_path):
+                removed.append(output_path)
+            stale.append((source, fmt))
+
+        if stale:
+            with self._lock:
+                self._conn.executemany("DELETE FROM sources WHERE source = ? AND output_format = ?", stale)
+                self._conn.commit()
+                self._pending = 0
+            self.logger.info(f"Pruned {len(stale)} deleted sources ({len(removed)} outputs removed)")
+        return removed
+
+    def _remove_output(self, output_path: Path) -> bool:
+        """Delete an output file and any directories it leaves empty"""
+        try:
+            output_path.unlink()
+        except FileNotFoundError:
+            return False
+        except OSError as e:
+            self.logger.warning(f"Could not remove stale output {output_path}: {e}")
+            return False
+
+        parent = os.path.dirname(os.path.abspath(output_path))
+        while parent != self._root and os.path.commonpath([parent, self._root]) == self._root:
+            try:
+                os.rmdir(parent)
+            except OSError:
+                break
+            parent = os.path.dirname(parent)
+        return True
+
+    def _maybe_commit_locked(self):
+        self._pending += 1
+        if self._pending >= self.COMMIT_EVERY:
+            self._conn.commit()
+            self._pending = 0
+
+    def get_stats(self) -> Dict[str, Any]:
+        """Entry counts per output format"""
+        with self._lock:
+            rows = self._conn.execute(
+                "SELECT output_format, COUNT(*) FROM sources GROUP BY output_format"
+            ).fetchall()
+        return {'entries': sum(count for _, count in rows), 'formats': dict(rows)}
+
+    def close(self):
+        """Commit outstanding records and close the journal"""
+        with self._lock:
+            self._conn.commit()
+            self._conn.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        self.close()
@@ -0,0 +1,323 @@
+#!/usr/bin/env python3
+"""
+Conversion Metrics
+Process-wide counters, gauges and timing histograms for the conversion and
+OCR pipelines, exported as JSON or in the Prometheus text format
+"""
+
+import json
+import math
+import threading
+import time
+from contextlib import contextmanager
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterable, Iterator, Optional, Tuple, Union
+
+# Seconds; spans a cached small text file up to a multi-minute OCR job
+DEFAULT_BUCKETS = (0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0, 300.0)
+
+LabelKey = Tuple[Tuple[str, str], ...]
+
+
+class _Histogram:
+    """Cumulative-bucket histogram as Prometheus expects it"""
+
+    __slots__ = ('buckets', 'counts', 'sum', 'count')
+
+    def __init__(self, buckets: Tuple[float, ...]):
+        self.buckets = buckets
+        self.counts = [0] * len(buckets)
+        self.sum = 0.0
+        self.count = 0
+
+    def observe(self, value: float):
+        self.sum += value
+        self.count += 1
+        for i, bound in enumerate(self.buckets):
+            if value <= bound:
+                self.counts[i] += 1
+
+    def merge(self, data: Dict[str, Any]):
+        if tuple(data['buckets']) != self.buckets:
+            # Incompatible layout: keep totals, fold every sample into +Inf
+            self.sum += data['sum']
+            self.count += data['count']
+            return
+        self.counts = [a + b for a, b in zip(self.counts, data['counts'])]
+        self.sum += data['sum']
+        self.count += data['count']
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {'buckets': list(self.buckets), 'counts': list(self.counts), 'sum': self.sum, 'count': self.count}
+
+
+class MetricsRegistry:
+    """
+    Thread-safe store of labelled metrics
+
+    Three kinds are supported: counters (``inc``), gauges (``set_gauge``) and
+    histograms (``observe``/``timer``). Metrics are created on first use;
+    ``describe`` adds help text and custom buckets. A disabled registry turns
+    every update into a no-op, so instrumented code needs no guards.
+    ``snapshot``/``merge`` carry metrics recorded in batch worker processes
+    back to the parent.
+    """
+
+    def __init__(self, prefix: str = 'converter', enabled: bool = True):
+        self.prefix = prefix
+        self.enabled = enabled
+        self._lock = threading.Lock()
+        self._kinds: Dict[str, str] = {}
+        self._help: Dict[str, str] = {}
+        self._buckets: Dict[str, Tuple[float, ...]] = {}
+        self._values: Dict[str, Dict[LabelKey, Any]] = {}
+        self.started = time.time()
+
+    def describe(self, name: str, kind: str, help_text: str = '',
+                 buckets: Optional[Iterable[float]] = None) -> None:
+        """Declare a metric's kind ('counter', 'gauge' or 'histogram') and help text"""
+        with self._lock:
+            self._declare(name, kind)
+            self._help[name] = help_text
+            if buckets is not None:
+                self._buckets[name] = tuple(sorted(buckets))
+
+    def _declare(self, name: str, kind: str):
+        existing = self._kinds.setdefault(name, kind)
+        if existing != kind:
+            raise ValueError(f"Metric {name} is a {existing}, not a {kind}")
+        self._values.setdefault(name, {})
+
+    @staticmethod
+    def _key(labels: Dict[str, Any]) -> LabelKey:
+        return tuple(sorted((k, str(v)) for k, v in labels.items() if v is not None))
+
+    def inc(self, name: str, value: float = 1, **labels) -> None:
+        """Add to a counter"""
+        if not self.enabled:
+            return
+        key = self._key(labels)
+        with self._lock:
+            self._declare(name, 'counter')
+            series = self._values[name]
+            series[key] = series.get(key, 0) + value
+
+    def set_gauge(self, name: str, value: float, **labels) -> None:
+        """Set a gauge to its current value"""
+        if not self.enabled:
+            return
+        key = self._key(labels)
+        with self._lock:
+            self._declare(name, 'gauge')
+            self._values[name][key] = value
+
+    def add_gauge(self, name: str, delta: float, **labels) -> None:
+        """Move a gauge up or down (in-flight work, queue depth)"""
+        if not self.enabled:
+            return
+        key = self._key(labels)
+        with self._lock:
+            self._declare(name, 'gauge')
+            series = self._values[name]
+            series[key] = series.get(key, 0) + delta
+
+    def observe(self, name: str, value: float, **labels) -> None:
+        """Record one sample (normally seconds) in a histogram"""
+        if not self.enabled:
+            return
+        key = self._key(labels)
+        with self._lock:
+            self._declare(name, 'histogram')
+            series = self._values[name]
+            histogram = series.get(key)
+            if histogram is None:
+                histogram = series[key] = _Histogram(self._buckets.get(name, DEFAULT_BUCKETS))
+            histogram.observe(value)
+
+    @contextmanager
+    def timer(self, name: str, **labels) -> Iterator[None]:
+        """Time the enclosed block into a histogram (recorded even when it raises)"""
+        if not self.enabled:
+            yield
+            return
+        start = time.perf_counter()
+        try:
+            yield
+        finally:
+            self.observe(name, time.perf_counter() - start, **labels)
+
+    def get(self, name: str, **labels) -> Any:
+        """Current value of one series: a number, a histogram dict, or None"""
+        with self._lock:
+            value = self._values.get(name, {}).get(self._key(labels))
+            return value.to_dict() if isinstance(value, _Histogram) else value
+
+    def reset(self) -> None:
+        """Drop all recorded values (declarations and help text are kept)"""
+        with self._lock:
+            for series in self._values.values():
+                series.clear()
+            self.started = time.time()
+
+    def snapshot(self) -> Dict[str, Any]:
+        """
+        JSON-serialisable copy of every metric
+
+        Shape: ``{name: {'type', 'help', 'series': [{'labels': {...}, 'value': ...}]}}``
+        where histogram values are ``{'buckets', 'counts', 'sum', 'count'}``.
+        """
+        with self._lock:
+            metrics = {}
+            for name, series in self._values.items():
+                metrics[name] = {
+                    'type': self._kinds[name],
+                    'help': self._help.get(name, ''),
+                    'series': [
+                        {'labels': dict(key),
+                         'value': value.to_dict() if isinstance(value, _Histogram) else value}
+                        for key, value in sorted(series.items())
+                    ]
+                }
+            return metrics
+
+    def merge(self, snapshot: Dict[str, Any]) -> None:
+        """Fold another registry's snapshot in: counters and histograms add up, gauges are overwritten"""
+        if not self.enabled:
+            return
+        with self._lock:
+            for name, metric in snapshot.items():
+                kind = metric['type']
+                self._declare(name, kind)
+                if metric.get('help') and name not in self._help:
+                    self._help[name] = metric['help']
+                series = self._values[name]
+                for entry in metric['series']:
+                    key = self._key(entry['labels'])
+                    value = entry['value']
+                    if kind == 'counter':
+                        series[key] = series.get(key, 0) + value
+                    elif kind == 'gauge':
+                        series[key] = value
+                    else:
+                        histogram = series.get(key)
+                        if histogram is None:
+                            histogram = series[key] = _Histogram(tuple(value['buckets']))
+                        histogram.merge(value)
+
+    def to_json(self, indent: Optional[int] = 2) -> str:
+        return json.dumps({
+            'generated': time.time(),
+            'started': self.started,
+            'metrics': self.snapshot()
+        }, indent=indent)
+
+    def to_prometheus(self) -> str:
+        """Prometheus text exposition format (version 0.0.4)"""
+        lines = []
+        for name, metric in self.snapshot().items():
+            full_name = f"{self.prefix}_{name}" if self.prefix else name
+            if metric['help']:
+                lines.append(f"# HELP {full_name} {_escape_help(metric['help'])}")
+            lines.append(f"# TYPE {full_name} {metric['type']}")
+            for entry in metric['series']:
+                labels, value = entry['labels'], entry['value']
+                if metric['type'] != 'histogram':
+                    lines.append(f"{full_name}{_format_labels(labels)} {_format_value(value)}")
+                    continue
+                for bound, count in zip(value['buckets'], value['counts']):
+                    lines.append(f"{full_name}_bucket{_format_labels({**labels, 'le': _format_value(bound)})} {count}")
+                lines.append(f"{full_name}_bucket{_format_labels({**labels, 'le': '+Inf'})} {value['count']}")
+                lines.append(f"{full_name}_sum{_format_labels(labels)} {_format_value(value['sum'])}")
+                lines.append(f"{full_name}_count{_format_labels(labels)} {value['count']}")
+        return '\n'.join(lines) + '\n'
+
+    def write(self, path: Union[str, Path], fmt: Optional[str] = None) -> Path:
+        """
+        Write the metrics to a file
+
+        Args:
+            fmt: 'json' or 'prometheus'; by default '.json' files get JSON and
+                anything else (e.g. '.prom' for node_exporter's textfile
+                collector) the Prometheus text format
+        """
+        path = Path(path)
+        fmt = fmt or ('json' if path.suffix.lower() == '.json' else 'prometheus')
+        text = self.to_json() if fmt == 'json' else self.to_prometheus()
+        path.parent.mkdir(parents=True, exist_ok=True)
+        # Write-then-rename so a scraper never reads a half-written file
+        temp_path = path.with_name(path.name + '.tmp')
+        temp_path.write_text(text, encoding='utf-8')
+        temp_path.replace(path)
+        return path
+
+
+def _escape_help(text: str) -> str:
+    return text.replace('\\', '\\\\').replace('\n', '\\n')
+
+
+def _format_labels(labels: Dict[str, str]) -> str:
+    if not labels:
+        return ''
+    parts = []
+    for key, value in labels.items():
+        value = str(value).replace('\\', '\\\\').replace('"', '\\"').replace('\n', '\\n')
+        parts.append(f'{key}="{value}"')
+    return '{' + ','.join(parts) + '}'
+
+
+def _format_value(value: float) -> str:
+    if isinstance(value, float):
+        if math.isinf(value):
+            return '+Inf' if value > 0 else '-Inf'
+        if value.is_integer():
+            return str(int(value)) if abs(value) < 1e15 else repr(value)
+        return repr(value)
+    return str(value)
+
+
+def timed_iter(iterable: Iterable, record: Callable[[float], None]) -> Iterator:
+    """
+    Yield from ``iterable``, timing only the time spent producing items
+
+    Used around a streaming reader so read time can be told apart from the
+    writer consuming the blocks. ``record`` receives the total seconds once
+    the stream ends, fails or is abandoned.
+    """
+    elapsed = 0.0
+    iterator = iter(iterable)
+    try:
+        while True:
+            start = time.perf_counter()
+            try:
+                item = next(iterator)
+            except StopIteration:
+                return
+            finally:
+                elapsed += time.perf_counter() - start
+            yield item
+    finally:
+        record(elapsed)
+
+
+METRICS = MetricsRegistry()
+
+METRICS.describe('stage_seconds', 'histogram',
+                 'Time spent per pipeline stage (detect, read, write, preprocess, ocr), by format and backend')
+METRICS.describe('conversions_total', 'counter', 'Finished document conversions by formats and status')
+METRICS.describe('cache_lookups_total', 'counter', 'Conversion, content and OCR cache lookups by result')
+METRICS.describe('ocr_pages_total', 'counter', 'Images recognised by OCR backend and status')
+METRICS.describe('preprocess_steps_total', 'counter', 'Image preprocessing stages run, by stage')
+METRICS.describe('process_rss_bytes', 'gauge', 'Resident memory of the converting process')
+METRICS.describe('memory_reserved_bytes', 'gauge', 'Estimated peak memory of the batch jobs admitted right now')
+METRICS.describe('batch_files_total', 'counter', 'Batch items by executor and status')
+METRICS.describe('batch_queue_depth', 'gauge', 'Batch items waiting for a worker')
+METRICS.describe('batch_workers_busy', 'gauge', 'Batch workers currently converting')
+METRICS.describe('batch_worker_utilization', 'gauge', 'Busy worker time over available worker time in the last batch')
+METRICS.describe('batch_item_seconds', 'histogram', 'Wall time per batch item including skipped ones')
+METRICS.describe('scheduler_queue_depth', 'gauge', 'Tasks waiting in the shared job scheduler')
+METRICS.describe('scheduler_wait_seconds', 'histogram', 'Time tasks spent queued before a worker took them, by priority')
+METRICS.describe('scheduler_tasks_total', 'counter', 'Scheduler tasks finished by priority and status')
+METRICS.describe('distributed_shards_total', 'counter', 'Distributed batch shards done, retried or given up on')
+METRICS.describe('ocr_backend_calls_total', 'counter', 'OCR backend calls routed, by backend and status (success, failure, skipped)')
+METRICS.describe('ocr_circuit_state', 'gauge', 'OCR backend circuit breaker state: 0 closed, 1 half-open, 2 open')
+METRICS.describe('ocr_hedged_requests_total', 'counter', 'Slow remote OCR requests raced by a local backend')
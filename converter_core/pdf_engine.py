@@ -0,0 +1,318 @@
+#!/usr/bin/env python3
+"""
+PDF Text Engine
+Text-layer extraction for PdfReader: PyMuPDF when installed (PyPDF2
+otherwise), with large documents split into page ranges that worker
+processes extract in parallel
+"""
+
+import collections
+import concurrent.futures
+import importlib.util
+import multiprocessing
+import os
+import threading
+from concurrent.futures.process import BrokenProcessPool
+from pathlib import Path
+from typing import Callable, Dict, Iterator, List, Optional, Tuple, Type, Union
+
+from .errors import ConfigurationError, DependencyError
+
+# Documents shorter than this are extracted in-process: spreading a few pages
+# over workers costs more in pickling than it saves
+MIN_PARALLEL_PAGES = 32
+
+# Pages per work unit sent to a worker process
+DEFAULT_PAGES_PER_RANGE = 16
+
+# Pages with fewer characters in their text layer are treated as scans
+DEFAULT_MIN_TEXT_CHARS = 50
+
+
+class PdfTextEngine:
+    """
+    One library's way of reading a PDF's text layer
+
+    Engines are used as classes, never instantiated, so one can be handed to
+    a worker process by reference.
+    """
+
+    name = ''
+    module = ''
+
+    @classmethod
+    def available(cls) -> bool:
+        return importlib.util.find_spec(cls.module) is not None
+
+    @staticmethod
+    def page_count(path: str) -> int:
+        raise NotImplementedError
+
+    @staticmethod
+    def extract_range(path: str, start: int, stop: int) -> List[str]:
+        """Text of pages ``start`` to ``stop - 1`` (0-based), one string per page"""
+        raise NotImplementedError
+
+    @classmethod
+    def open_renderer(cls, path: str) -> Optional["PageRenderer"]:
+        """A renderer producing page images for OCR, or None if this engine cannot render"""
+        if PyMuPDFEngine.available():
+            return PageRenderer(path)
+        return None
+
+
+class PyMuPDFEngine(PdfTextEngine):
+    """PyMuPDF (fitz): C-speed extraction, several times faster than PyPDF2"""
+
+    name = 'pymupdf'
+    module = 'fitz'
+
+    @staticmethod
+    def page_count(path: str) -> int:
+        import fitz
+        with fitz.open(path) as doc:
+            return len(doc)
+
+    @staticmethod
+    def extract_range(path: str, start: int, stop: int) -> List[str]:
+        import fitz
+        with fitz.open(path) as doc:
+            return [doc[index].get_text() for index in range(start, stop)]
+
+
+class PyPDF2Engine(PdfTextEngine):
+    """Pure-Python fallback when PyMuPDF is not installed"""
+
+    name = 'pypdf2'
+    module = 'PyPDF2'
+
+    @staticmethod
+    def page_count(path: str) -> int:
+        import PyPDF2
+        with open(path, 'rb') as file:
+            return len(PyPDF2.PdfReader(file).pages)
+
+    @staticmethod
+    def extract_range(path: str, start: int, stop: int) -> List[str]:
+        import PyPDF2
+        with open(path, 'rb') as file:
+            pages = PyPDF2.PdfReader(file).pages
+            return [pages[index].extract_text() or '' for index in range(start, stop)]
+
+
+class PageRenderer:
+    """Renders pages of one open document to grayscale images for OCR (PyMuPDF; not thread-safe)"""
+
+    def __init__(self, path: str):
+        import fitz
+        self._fitz = fitz
+        self._doc = fitz.open(path)
+
+    def render(self, index: int, dpi: int) -> bytes:
+        """Page ``index`` as an encoded grayscale PGM, which the OCR engine decodes without temp files"""
+        zoom = self._fitz.Matrix(dpi / 72, dpi / 72)
+        pix = self._doc[index].get_pixmap(matrix=zoom, colorspace=self._fitz.csGRAY, alpha=False)
+        return pix.tobytes('pgm')
+
+    def close(self):
+        self._doc.close()
+
+
+PDF_TEXT_ENGINES: Dict[str, Type[PdfTextEngine]] = {
+    PyMuPDFEngine.name: PyMuPDFEngine,
+    PyPDF2Engine.name: PyPDF2Engine,
+}
+
+
+def select_engine(name: Union[str, Type[PdfTextEngine]] = 'auto') -> Type[PdfTextEngine]:
+    """
+    Resolve an engine name ('auto', 'pymupdf' or 'pypdf2') or class
+
+    'auto' prefers PyMuPDF and falls back to PyPDF2.
+    """
+    if isinstance(name, type):
+        return name
+    if name == 'auto':
+        for engine in PDF_TEXT_ENGINES.values():
+            if engine.available():
+                return engine
+        raise DependencyError("PyMuPDF or PyPDF2 is required for PDF support. Install with: pip install pymupdf")
+    engine = PDF_TEXT_ENGINES.get(name)
+    if engine is None:
+        raise ConfigurationError(f"Unknown PDF engine: {name} (choose from auto, {', '.join(PDF_TEXT_ENGINES)})")
+    if not engine.available():
+        raise DependencyError(f"The {name} PDF engine needs the {engine.module} module")
+    return engine
+
+
+_range_pool: Optional[concurrent.futures.ProcessPoolExecutor] = None
+_range_pool_lock = threading.Lock()
+
+
+def _get_range_pool(workers: int) -> concurrent.futures.ProcessPoolExecutor:
+    """Process pool shared by every PDF being read, so concurrent conversions do not multiply workers"""
+    global _range_pool
+    with _range_pool_lock:
+        if _range_pool is None:
+            _range_pool = concurrent.futures.ProcessPoolExecutor(max_workers=workers)
+        return _range_pool
+
+
+def _discard_range_pool(pool: concurrent.futures.ProcessPoolExecutor):
+    global _range_pool
+    with _range_pool_lock:
+        if _range_pool is pool:
+            _range_pool = None
+    pool.shutdown(wait=False, cancel_futures=True)
+
+
+def _extract_range(engine: Type[PdfTextEngine], path: str, start: int, stop: int) -> List[str]:
+    """Worker-process entry point"""
+    return engine.extract_range(path, start, stop)
+
+
+def iter_page_texts(path: Union[str, Path], engine: Type[PdfTextEngine], workers: Optional[int] = None,
+                    pages_per_range: int = DEFAULT_PAGES_PER_RANGE,
+                    min_parallel_pages: int = MIN_PARALLEL_PAGES, start_page: int = 0,
+                    stop_page: Optional[int] = None) -> Iterator[Tuple[int, str]]:
+    """
+    Yield ``(page_index, text)`` for pages ``start_page`` to ``stop_page - 1``
+    (default: all of them), in page order
+
+    Spans of at least ``min_parallel_pages`` pages are cut into ranges of
+    ``pages_per_range`` extracted in worker processes, with at most two
+    ranges per worker running ahead of the consumer. Inside a batch worker
+    process, or with one worker, pages are extracted in-process.
+    """
+    path = str(path)
+    total = engine.page_count(path)
+    if stop_page is not None:
+        total = min(total, stop_page)
+    start_page = max(0, start_page)
+    workers = workers or os.cpu_count() or 1
+    pages_per_range = max(1, pages_per_range)
+    ranges = ((start, min(start + pages_per_range, total)) for start in range(start_page, total, pages_per_range))
+
+    if workers <= 1 or total - start_page < min_parallel_pages or multiprocessing.parent_process() is not None:
+        for start, stop in ranges:
+            yield from enumerate(engine.extract_range(path, start, stop), start)
+        return
+
+    pool = _get_range_pool(workers)
+    window = collections.deque()
+    try:
+        for start, stop in ranges:
+            try:
+                window.append((start, stop, pool.submit(_extract_range, engine, path, start, stop)))
+            except (BrokenProcessPool, RuntimeError):
+                window.append((start, stop, None))
+            if len(window) >= workers * 2:
+                yield from _range_result(engine, path, pool, *window.popleft())
+        while window:
+            yield from _range_result(engine, path, pool, *window.popleft())
+    finally:
+        for _, _, future in window:
+            if future is not None:
+                future.cancel()
+
+
+def _range_result(engine: Type[PdfTextEngine], path: str, pool, start: int, stop: int,
+                  future: Optional[concurrent.futures.Future]) -> Iterator[Tuple[int, str]]:
+    try:
+        if future is None:
+            raise BrokenProcessPool("PDF worker pool unavailable")
+        texts = future.result()
+    except BrokenProcessPool:
+        # A worker died (or could not start): replace the pool for the next
+        # document and finish this range here
+        _discard_range_pool(pool)
+        texts = engine.extract_range(path, start, stop)
+    return enumerate(texts, start)
+
+
+def iter_pdf_pages(path: Union[str, Path], engine: Union[str, Type[PdfTextEngine]] = 'auto',
+                   workers: Optional[int] = None, pages_per_range: int = DEFAULT_PAGES_PER_RANGE,
+                   min_parallel_pages: int = MIN_PARALLEL_PAGES, min_text_chars: int = DEFAULT_MIN_TEXT_CHARS,
+                   ocr_page: Optional[Callable[[bytes], Optional[str]]] = None, ocr_dpi: int = 200,
+                   ocr_workers: int = 2, start_page: int = 0,
+                   stop_page: Optional[int] = None) -> Iterator[Tuple[str, int, str]]:
+    """
+    Stream ``('page', number, text)`` blocks for a PDF, in page order
+
+    Args:
+        engine: 'auto', 'pymupdf', 'pypdf2' or a PdfTextEngine class
+        workers: Worker processes for large documents (default: CPU count)
+        min_text_chars: Pages whose text layer is shorter are OCR'd, if
+            ``ocr_page`` is given and the page can be rendered (PyMuPDF)
+        ocr_page: Recognises one rendered page image and returns its text,
+            or None when no OCR backend is available (no further pages of
+            the document are then rendered)
+        ocr_dpi: Render resolution for OCR'd pages
+        ocr_workers: Pages OCR'd concurrently
+        start_page, stop_page: Read only pages ``start_page`` (0-based) up
+            to ``stop_page - 1``; pages outside are never parsed
+
+    Empty pages produce no block. OCR text replaces the text layer only
+    when it recovers more text.
+    """
+    engine = select_engine(engine)
+    pages = iter_page_texts(path, engine, workers, pages_per_range, min_parallel_pages, start_page, stop_page)
+
+    if ocr_page is None:
+        for index, text in pages:
+            text = text.strip()
+            if text:
+                yield ('page', index + 1, text)
+        return
+
+    # Rendering is only set up once a page actually needs OCR, so text PDFs
+    # never pay for it
+    renderer = None
+    ocr_enabled = True
+
+    def page_block(index, text, future):
+        nonlocal ocr_enabled
+        text = text.strip()
+        if future is not None:
+            try:
+                recognised = future.result()
+            except Exception:
+                recognised = ''
+            if recognised is None:
+                ocr_enabled = False
+            elif len(recognised.strip()) > len(text):
+                text = recognised.strip()
+        return ('page', index + 1, text) if text else None
+
+    # Pages are rendered here (PyMuPDF documents are not thread-safe) and
+    # recognised on a small pool; blocks still leave in page order
+    pending = collections.deque()
+    try:
+        with concurrent.futures.ThreadPoolExecutor(max_workers=max(1, ocr_workers),
+                                                   thread_name_prefix="pdf-ocr") as pool:
+            try:
+                for index, text in pages:
+                    future = None
+                    if ocr_enabled and len(text.strip()) < min_text_chars:
+                        if renderer is None:
+                            renderer = engine.open_renderer(str(path))
+                            ocr_enabled = renderer is not None
+                        if ocr_enabled:
+                            future = pool.submit(ocr_page, renderer.render(index, ocr_dpi))
+                    pending.append((index, text, future))
+                    while pending and (pending[0][2] is None or pending[0][2].done() or
+                                       len(pending) > ocr_workers * 2):
+                        block = page_block(*pending.popleft())
+                        if block:
+                            yield block
+                while pending:
+                    block = page_block(*pending.popleft())
+                    if block:
+                        yield block
+            finally:
+                for _, _, future in pending:
+                    if future is not None:
+                        future.cancel()
+    finally:
+        if renderer is not None:
+            renderer.close()
@@ -0,0 +1,396 @@
+#!/usr/bin/env python3
+"""
+Document Readers
+Streaming readers for each supported input format. Third-party parsers are
+imported inside iter_read(), so importing this module stays cheap
+"""
+
+import itertools
+import re
+import threading
+from pathlib import Path
+from typing import Any, Iterable, List, NamedTuple, Optional, Tuple
+
+from . import pdf_engine, textdecode, textkernels
+from .errors import DependencyError, FileProcessingError
+from .registry import register_reader
+
+
+class PartialContent(NamedTuple):
+    """The blocks returned by DocumentReader.read_partial()
+
+    ``cursor`` is passed back as ``read_partial(..., cursor=...)`` to fetch
+    what follows; it is None once the end of the document was reached.
+    """
+
+    blocks: List[tuple]
+    cursor: Any
+
+    @property
+    def complete(self) -> bool:
+        return self.cursor is None
+
+
+def _take(stream: Iterable[tuple], max_pages: Optional[int], max_blocks: Optional[int],
+          max_bytes: Optional[int]) -> Tuple[List[tuple], bool]:
+    """
+    Collect blocks until a limit is reached; returns ``(blocks, exhausted)``
+
+    At least one block is returned when there is one. When a limit is hit,
+    one more block is pulled to tell a finished document from a cut one.
+    """
+    blocks = []
+    pages = size = 0
+    for block in stream:
+        if blocks and ((max_blocks and len(blocks) >= max_blocks) or
+                       (max_pages and pages >= max_pages) or
+                       (max_bytes and size >= max_bytes)):
+            return blocks, False
+        blocks.append(block)
+        if block[0] == 'page':
+            pages += 1
+        size += len(str(block[-1]).encode('utf-8'))
+    return blocks, True
+
+
+class DocumentReader:
+    """Base class for document readers
+
+    Readers produce content blocks such as ('heading', level, text),
+    ('paragraph', text) and ('page', number, text). Subclasses implement
+    iter_read() to yield blocks as they are parsed so large documents never
+    have to be held in memory as a whole; read() collects them into a list.
+    read_partial() returns just the first blocks, for previews.
+    """
+
+    def read(self, file_path):
+        """Read document and return the full list of content blocks"""
+        return list(self.iter_read(file_path))
+
+    def iter_read(self, file_path):
+        """Yield content blocks as they are parsed"""
+        if type(self).read is DocumentReader.read:
+            raise NotImplementedError
+        # Readers that only override read() are still usable as a stream
+        yield from self.read(file_path)
+
+    def read_partial(self, file_path, max_pages: Optional[int] = None, max_blocks: Optional[int] = None,
+                     max_bytes: Optional[int] = None, cursor: Any = None) -> PartialContent:
+        """
+        Read only the start of a document, or the part after ``cursor``
+
+        Args:
+            max_pages: Stop after this many pages
+            max_blocks: Stop after this many content blocks
+            max_bytes: Stop once the blocks hold this much UTF-8 text
+            cursor: ``cursor`` of a previous PartialContent, to continue
+
+        Parsing stops as soon as the limit is reached. This default resumes
+        by parsing again and skipping the blocks already returned; readers
+        that can seek (PdfReader) start at the cursor directly.
+        """
+        start = cursor or 0
+        stream = self.iter_read(file_path)
+        try:
+            blocks, exhausted = _take(itertools.islice(stream, start, None), max_pages, max_blocks, max_bytes)
+        finally:
+            if hasattr(stream, 'close'):
+                stream.close()
+        return PartialContent(blocks, None if exhausted else start + len(blocks))
+
+@register_reader('docx', requires=('docx',))
+class DocxReader(DocumentReader):
+    """Reader for DOCX files"""
+
+    def iter_read(self, file_path):
+        from docx import Document
+        doc = Document(file_path)
+
+        for paragraph in doc.paragraphs:
+            text = paragraph.text.strip()
+            if text:
+                # Preserve heading structure
+                if paragraph.style.name.startswith('Heading'):
+                    level = int(paragraph.style.name.split()[-1]) if paragraph.style.name.split()[-1].isdigit() else 1
+                    yield ('heading', level, text)
+                else:
+                    yield ('paragraph', text)
+
+@register_reader('pdf', requires=(('fitz', 'PyPDF2'),))
+class PdfReader(DocumentReader):
+    """Reader for PDF files
+
+    Extracts with PyMuPDF when it is installed and PyPDF2 otherwise; large
+    documents are split into page ranges read by parallel worker processes
+    (see pdf_engine). Pages whose text layer has fewer than min_text_chars
+    characters are OCR'd when an OCR backend is available. To change the
+    settings for one converter, assign an instance:
+    ``converter.readers['pdf'] = PdfReader(engine='pypdf2', ocr_fallback=False)``.
+    """
+
+    def __init__(self, engine: str = 'auto', workers: Optional[int] = None,
+                 pages_per_range: int = pdf_engine.DEFAULT_PAGES_PER_RANGE,
+                 min_parallel_pages: int = pdf_engine.MIN_PARALLEL_PAGES,
+                 ocr_fallback: bool = True, min_text_chars: int = pdf_engine.DEFAULT_MIN_TEXT_CHARS,
+                 ocr_language: str = 'eng', ocr_dpi: int = 200, ocr_workers: int = 2):
+        self.engine = engine
+        self.workers = workers
+        self.pages_per_range = pages_per_range
+        self.min_parallel_pages = min_parallel_pages
+        self.ocr_fallback = ocr_fallback
+        self.min_text_chars = min_text_chars
+        self.ocr_language = ocr_language
+        self.ocr_dpi = ocr_dpi
+        self.ocr_workers = ocr_workers
+        self._ocr_engine = None
+        self._ocr_lock = threading.Lock()
+
+    def iter_read(self, file_path):
+        return pdf_engine.iter_pdf_pages(
+            file_path, self.engine, self.workers, self.pages_per_range, self.min_parallel_pages,
+            self.min_text_chars, self._ocr_page if self.ocr_fallback else None,
+            self.ocr_dpi, self.ocr_workers
+        )
+
+    def read_partial(self, file_path, max_pages: Optional[int] = None, max_blocks: Optional[int] = None,
+                     max_bytes: Optional[int] = None, cursor: Any = None) -> PartialContent:
+        """
+        Like DocumentReader.read_partial, but seeks: the cursor is the
+        0-based index of the next page, and ``max_pages`` counts pages of the
+        document (empty ones included), so later pages are never parsed
+        """
+        start = cursor or 0
+        total = pdf_engine.select_engine(self.engine).page_count(str(file_path))
+        stop = min(total, start + max_pages) if max_pages else total
+        stream = pdf_engine.iter_pdf_pages(
+            file_path, self.engine, self.workers, self.pages_per_range, self.min_parallel_pages,
+            self.min_text_chars, self._ocr_page if self.ocr_fallback else None,
+            self.ocr_dpi, self.ocr_workers, start, stop
+        )
+        try:
+            blocks, exhausted = _take(stream, None, max_blocks, max_bytes)
+        finally:
+            stream.close()
+        if not exhausted:
+            # The next block's page number is the index after the last one returned
+            return PartialContent(blocks, blocks[-1][1])
+        return PartialContent(blocks, stop if stop < total else None)
+
+    def _get_ocr_engine(self):
+        """The OCR engine for scanned pages, created on first use; None when OCR is unavailable"""
+        with self._ocr_lock:
+            if self._ocr_engine is None:
+                try:
+                    from ocr_engine.ocr_engine import OCREngine
+                    engine = OCREngine()
+                    self._ocr_engine = engine if engine.get_available_backends() else False
+                except Exception:
+                    self._ocr_engine = False
+        return self._ocr_engine or None
+
+    def _ocr_page(self, image: bytes) -> Optional[str]:
+        engine = self._get_ocr_engine()
+        if engine is None:
+            return None
+        return engine.extract_text(image, {'language': self.ocr_language}).get('text', '')
+
+@register_reader('txt')
+class TxtReader(DocumentReader):
+    """Reader for TXT files with memory optimization for large files"""
+
+    ENCODINGS = list(textdecode.DEFAULT_ENCODINGS)
+
+    def __init__(self, chunk_size: int = 8192, max_memory_mb: int = 100):
+        """
+        Initialize TXT reader with memory optimization settings
+
+        Args:
+            chunk_size: Size of chunks to read at a time (bytes)
+            max_memory_mb: Maximum memory to use before switching to streaming mode
+        """
+        self.chunk_size = chunk_size
+        self.max_memory_threshold = max_memory_mb * 1024 * 1024  # Convert to bytes
+
+    def iter_read(self, file_path):
+        file_path = Path(file_path)
+        file_size = file_path.stat().st_size
+
+        # Use streaming for large files
+        if file_size > self.max_memory_threshold:
+            return self._read_large_file(file_path)
+        else:
+            return self._read_small_file(file_path)
+
+    def _read_small_file(self, file_path):
+        """Read small files entirely into memory and split them in one pass"""
+        paragraphs = textdecode.iter_paragraphs(file_path, self.ENCODINGS, use_mmap=False)
+        return [('paragraph', p) for p in paragraphs]
+
+    def _read_large_file(self, file_path):
+        """Stream large files paragraph by paragraph from a memory map to keep memory bounded"""
+        for paragraph in textdecode.iter_paragraphs(file_path, self.ENCODINGS,
+                                                    chunk_size=self.chunk_size * 128):
+            yield ('paragraph', paragraph)
+
+@register_reader('html', requires=('bs4',))
+class HtmlReader(DocumentReader):
+    """Reader for HTML files"""
+
+    def iter_read(self, file_path):
+        from bs4 import BeautifulSoup
+
+        soup = BeautifulSoup(textdecode.read_text(file_path, declared=True), 'html.parser')
+
+        # Extract headings and paragraphs
+        for element in soup.find_all(['h1', 'h2', 'h3', 'h4', 'h5', 'h6', 'p', 'div']):
+            text = element.get_text().strip()
+            if text:
+                if element.name.startswith('h'):
+                    level = int(element.name[1])
+                    yield ('heading', level, text)
+                else:
+                    yield ('paragraph', text)
+
+@register_reader('rtf', requires=('striprtf',))
+class RtfReader(DocumentReader):
+    """Reader for RTF files"""
+
+    def iter_read(self, file_path):
+        from striprtf.striprtf import rtf_to_text
+
+        text = rtf_to_text(textdecode.read_text(file_path))
+        for p in text.split('\n\n'):
+            if p.strip():
+                yield ('paragraph', p.strip())
+
+
+@register_reader('epub', requires=('ebooklib', 'bs4'))
+class EpubReader(DocumentReader):
+    """Reader for EPUB files"""
+
+    def iter_read(self, file_path):
+        try:
+            import ebooklib
+            from ebooklib import epub
+        except ImportError:
+            raise DependencyError("ebooklib is required for EPUB support. Install with: pip install ebooklib")
+
+        try:
+            # Read the EPUB file
+            book = epub.read_epub(file_path)
+
+            # Extract metadata
+            title = book.get_metadata('DC', 'title')
+            if title:
+                yield ('heading', 1, title[0][0])
+
+            authors = book.get_metadata('DC', 'creator')
+            if authors:
+                author_names = [author[0] for author in authors]
+                yield ('paragraph', f"By: {', '.join(author_names)}")
+
+            # Process all document items (chapters)
+            for item in book.get_items():
+                if item.get_type() == ebooklib.ITEM_DOCUMENT:
+                    # Parse HTML content
+                    html_content = item.get_content().decode('utf-8')
+                    yield from self._parse_html_content(html_content, item.get_name())
+
+        except Exception as e:
+            raise FileProcessingError(f"Failed to read EPUB file: {str(e)}")
+
+    def _parse_html_content(self, html_content, chapter_name):
+        """Parse HTML content from EPUB chapter"""
+        try:
+            from bs4 import BeautifulSoup
+        except ImportError:
+            # Fallback to simple text extraction if BeautifulSoup is not available
+            return self._simple_text_extraction(html_content, chapter_name)
+
+        try:
+            soup = BeautifulSoup(html_content, 'html.parser')
+            content = []
+
+            # Add chapter title if available
+            title_elem = soup.find(['h1', 'h2', 'title'])
+            if title_elem and title_elem.get_text().strip():
+                content.append(('heading', 2, title_elem.get_text().strip()))
+            elif chapter_name and not chapter_name.startswith('nav'):
+                # Use filename as chapter title if no title found
+                clean_name = chapter_name.replace('.xhtml', '').replace('.html', '').replace('_', ' ').title()
+                content.append(('heading', 2, clean_name))
+
+            # Extract content elements
+            for element in soup.find_all(['h1', 'h2', 'h3', 'h4', 'h5', 'h6', 'p', 'div']):
+                text = element.get_text().strip()
+                if text and len(text) > 3:  # Skip very short text
+                    if element.name.startswith('h'):
+                        level = min(int(element.name[1]) + 1, 6)  # Offset by 1 since book title is h1
+                        content.append(('heading', level, text))
+                    else:
+                        content.append(('paragraph', text))
+
+            return content
+
+        except Exception:
+            # Fallback to simple extraction
+            return self._simple_text_extraction(html_content, chapter_name)
+
+    def _simple_text_extraction(self, html_content, chapter_name):
+        """Simple text extraction fallback"""
+        import re
+
+        # Remove HTML tags
+        text = re.sub(r'<[^>]+>', '', html_content)
+        # Clean up whitespace
+        text = re.sub(r'\s+', ' ', text).strip()
+
+        content = []
+        if chapter_name and not chapter_name.startswith('nav'):
+            clean_name = chapter_name.replace('.xhtml', '').replace('.html', '').replace('_', ' ').title()
+            content.append(('heading', 2, clean_name))
+
+        if text:
+            # Split into paragraphs
+            paragraphs = [p.strip() for p in text.split('\n\n') if p.strip()]
+            content.extend([('paragraph', p) for p in paragraphs])
+
+        return content
+
+
+@register_reader('markdown', requires=('markdown',))
+class MarkdownReader(DocumentReader):
+    """Reader for Markdown files"""
+
+    # Lines handed to the block scanner per call; keeps reading streamed
+    LINES_PER_SCAN = 1024
+
+    def iter_read(self, file_path):
+        try:
+            import markdown
+        except ImportError:
+            raise DependencyError("markdown is required for Markdown support. Install with: pip install markdown")
+
+        try:
+            # Parse the markdown file line by line as it is read
+            with textdecode.open_text(file_path) as file:
+                yield from self._iter_markdown_blocks(file)
+
+        except Exception as e:
+            raise FileProcessingError(f"Failed to read Markdown file: {str(e)}")
+
+    def _parse_markdown_content(self, md_content):
+        """Parse Markdown content and extract structured elements"""
+        return list(self._iter_markdown_blocks(md_content.split('\n')))
+
+    def _iter_markdown_blocks(self, lines):
+        """Yield structured elements from an iterable of Markdown lines"""
+        # textkernels.MarkdownScanner runs compiled when the extension is built
+        scanner = textkernels.MarkdownScanner()
+        lines = iter(lines)
+        while True:
+            chunk = list(itertools.islice(lines, self.LINES_PER_SCAN))
+            if not chunk:
+                break
+            yield from scanner.feed(chunk)
+        yield from scanner.close()
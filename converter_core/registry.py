@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+Reader/Writer Registry
+Maps format keys to reader and writer classes; instances are only created
+when a format is first used, so start-up never pays for unused formats
+"""
+
+import importlib.util
+import threading
+from collections.abc import MutableMapping
+from typing import Dict, Iterable, Iterator, List, Optional, Tuple, Union
+
+from .formats import FormatDetector
+
+
+class FormatRegistry:
+    """Format key -> class table for one kind of component (readers or writers)"""
+
+    def __init__(self, kind: str):
+        self.kind = kind
+        self._classes: Dict[str, type] = {}
+        self._requires: Dict[str, Tuple[Union[str, Tuple[str, ...]], ...]] = {}
+
+    def register(self, format_key: str, cls: type, requires: Iterable[Union[str, Tuple[str, ...]]] = ()) -> None:
+        """
+        Register (or replace) the class handling a format
+
+        Each entry of ``requires`` is a module name, or a tuple of
+        alternatives of which any one will do.
+        """
+        self._classes[format_key] = cls
+        self._requires[format_key] = tuple(requires)
+
+    def unregister(self, format_key: str) -> None:
+        self._classes.pop(format_key, None)
+        self._requires.pop(format_key, None)
+
+    def get_class(self, format_key: str) -> type:
+        return self._classes[format_key]
+
+    def keys(self) -> List[str]:
+        return list(self._classes)
+
+    def __contains__(self, format_key) -> bool:
+        return format_key in self._classes
+
+    def missing_dependencies(self, format_key: str) -> List[str]:
+        """
+        Optional modules a format needs that are not installed
+
+        Checked with importlib.util.find_spec, so nothing is imported. A group
+        of alternatives with none installed is reported as "a or b".
+        """
+        missing = []
+        for requirement in self._requires.get(format_key, ()):
+            alternatives = (requirement,) if isinstance(requirement, str) else requirement
+            if all(importlib.util.find_spec(module) is None for module in alternatives):
+                missing.append(' or '.join(alternatives))
+        return missing
+
+    def instances(self) -> "LazyInstances":
+        """A fresh per-converter mapping of format key -> instance"""
+        return LazyInstances(self)
+
+
+class LazyInstances(MutableMapping):
+    """
+    Per-converter view of a registry that creates each instance on first lookup
+
+    Assigning a key overrides the registered class for this converter only;
+    deleting one hides the format from it.
+    """
+
+    def __init__(self, registry: FormatRegistry):
+        self._registry = registry
+        self._instances = {}
+        self._removed = set()
+        self._lock = threading.Lock()
+
+    def __getitem__(self, format_key):
+        instance = self._instances.get(format_key)
+        if instance is not None:
+            return instance
+        if format_key in self._removed or format_key not in self._registry:
+            raise KeyError(format_key)
+        with self._lock:
+            instance = self._instances.get(format_key)
+            if instance is None:
+                instance = self._registry.get_class(format_key)()
+                self._instances[format_key] = instance
+        return instance
+
+    def __setitem__(self, format_key, instance):
+        with self._lock:
+            self._instances[format_key] = instance
+            self._removed.discard(format_key)
+
+    def __delitem__(self, format_key):
+        if format_key not in self:
+            raise KeyError(format_key)
+        with self._lock:
+            self._instances.pop(format_key, None)
+            self._removed.add(format_key)
+
+    def __contains__(self, format_key) -> bool:
+        if format_key in self._removed:
+            return False
+        return format_key in self._instances or format_key in self._registry
+
+    def __iter__(self) -> Iterator[str]:
+        keys = dict.fromkeys(self._registry.keys())
+        keys.update(dict.fromkeys(self._instances))
+        return (key for key in keys if key not in self._removed)
+
+    def __len__(self) -> int:
+        return sum(1 for _ in self)
+
+
+readers = FormatRegistry('reader')
+writers = FormatRegistry('writer')
+
+
+def register_reader(format_key: str, requires: Iterable[str] = (),
+                    extensions: Optional[List[str]] = None, name: Optional[str] = None):
+    """
+    Class decorator registering a DocumentReader for an input format
+
+    Args:
+        format_key: Format key used by converters and FormatDetector
+        requires: Optional modules the reader imports when it runs
+        extensions: File extensions for a format FormatDetector does not know yet
+        name: Display name for a new format
+    """
+    def decorator(cls):
+        readers.register(format_key, cls, requires)
+        if format_key not in FormatDetector.SUPPORTED_INPUT_FORMATS:
+            FormatDetector.SUPPORTED_INPUT_FORMATS[format_key] = {
+                'extensions': [ext.lower() for ext in (extensions or [f'.{format_key}'])],
+                'name': name or format_key.upper(),
+                'reader': cls.__name__
+            }
+        return cls
+    return decorator
+
+
+def register_writer(format_key: str, requires: Iterable[str] = (),
+                    extension: Optional[str] = None, name: Optional[str] = None):
+    """
+    Class decorator registering a DocumentWriter for an output format
+
+    Args:
+        format_key: Format key used by converters and FormatDetector
+        requires: Optional modules the writer imports when it runs
+        extension: Output file extension for a format FormatDetector does not know yet
+        name: Display name for a new format
+    """
+    def decorator(cls):
+        writers.register(format_key, cls, requires)
+        if format_key not in FormatDetector.SUPPORTED_OUTPUT_FORMATS:
+            FormatDetector.SUPPORTED_OUTPUT_FORMATS[format_key] = {
+                'extension': (extension or f'.{format_key}').lower(),
+                'name': name or format_key.upper(),
+                'writer': cls.__name__
+            }
+        return cls
+    return decorator
@@ -0,0 +1,448 @@
+#!/usr/bin/env python3
+"""
+Job Scheduler
+One pool of worker threads shared by document conversion and OCR. Queued
+tasks are served by priority, so an interactive preview does not wait behind
+a background batch. Jobs can be cancelled mid-file and report progress
+events as they go.
+"""
+
+import bisect
+import concurrent.futures
+import itertools
+import os
+import threading
+import time
+from contextlib import contextmanager
+from typing import Any, Callable, Dict, Iterator, List, Optional, Set
+
+from .errors import JobCancelled
+from .metrics import METRICS
+
+# Lower runs first
+PRIORITY_INTERACTIVE = 0
+PRIORITY_NORMAL = 10
+PRIORITY_BATCH = 20
+
+PRIORITIES = {'interactive': PRIORITY_INTERACTIVE, 'normal': PRIORITY_NORMAL, 'batch': PRIORITY_BATCH}
+
+# Workers kept free of batch-priority tasks so interactive work starts at once
+DEFAULT_INTERACTIVE_RESERVE = 1
+
+_job_ids = itertools.count(1)
+_local = threading.local()
+
+
+def priority_label(priority: int) -> str:
+    """Name of the priority band a value falls in, for metrics labels"""
+    if priority < PRIORITY_NORMAL:
+        return 'interactive'
+    return 'normal' if priority < PRIORITY_BATCH else 'batch'
+
+
+class Job:
+    """
+    One piece of user-visible work (a preview, a batch, a daemon request)
+
+    All tasks of a job share its priority, its cancel flag and its progress
+    listeners. ``cancel()`` stops queued tasks from starting. Running tasks
+    see the flag at their next ``check_cancelled()``, so a long file stops
+    between blocks or pages instead of finishing first.
+
+    Listeners receive event dicts with 'event' ('started', 'progress' or
+    'finished'), 'job', 'name', 'state', 'done', 'total', 'message' and any
+    extra details. They are called on worker threads, so a GUI should hand
+    the events to its own event loop.
+    """
+
+    def __init__(self, name: str = '', priority: int = PRIORITY_NORMAL,
+                 listener: Optional[Callable[[Dict[str, Any]], None]] = None):
+        self.id = next(_job_ids)
+        self.name = name or f"job-{self.id}"
+        self.priority = priority
+        self.cancel_event = threading.Event()
+        self.state = 'queued'
+        self.done = 0
+        self.total: Optional[int] = None
+        self.created = time.time()
+        self._listeners: List[Callable[[Dict[str, Any]], None]] = [listener] if listener else []
+        self._futures: Set[concurrent.futures.Future] = set()
+        self._lock = threading.Lock()
+
+    @property
+    def cancelled(self) -> bool:
+        return self.cancel_event.is_set()
+
+    def add_listener(self, listener: Callable[[Dict[str, Any]], None]) -> None:
+        self._listeners.append(listener)
+
+    def cancel(self) -> None:
+        """Ask the job to stop; returns at once"""
+        if self.cancel_event.is_set():
+            return
+        self.cancel_event.set()
+        with self._lock:
+            futures = list(self._futures)
+        for future in futures:
+            future.cancel()
+
+    def check(self) -> None:
+        """Raise JobCancelled if the job has been cancelled"""
+        if self.cancel_event.is_set():
+            raise JobCancelled(f"{self.name} was cancelled")
+
+    def progress(self, done: Optional[int] = None, total: Optional[int] = None,
+                 message: Optional[str] = None, **details) -> None:
+        """Record progress and notify the listeners"""
+        with self._lock:
+            if done is not None:
+                self.done = done
+            if total is not None:
+                self.total = total
+            if self.state == 'queued':
+                self.state = 'running'
+        self._emit('progress', message, details)
+
+    def finish(self, message: Optional[str] = None) -> None:
+        """Mark the job finished ('done', or 'cancelled' if it was cancelled)"""
+        with self._lock:
+            if self.state in ('done', 'cancelled'):
+                return
+            self.state = 'cancelled' if self.cancel_event.is_set() else 'done'
+        self._emit('finished', message)
+
+    def _track(self, future: concurrent.futures.Future) -> None:
+        with self._lock:
+            self._futures.add(future)
+        future.add_done_callback(self._untrack)
+        if self.cancel_event.is_set():
+            future.cancel()
+
+    def _untrack(self, future: concurrent.futures.Future) -> None:
+        with self._lock:
+            self._futures.discard(future)
+
+    def _started(self) -> None:
+        with self._lock:
+            if self.state != 'queued':
+                return
+            self.state = 'running'
+        self._emit('started')
+
+    def _emit(self, kind: str, message: Optional[str] = None, details: Optional[Dict[str, Any]] = None):
+        event = {'event': kind, 'job': self.id, 'name': self.name, 'state': self.state,
+                 'done': self.done, 'total': self.total, 'message': message, **(details or {})}
+        for listener in list(self._listeners):
+            try:
+                listener(event)
+            except Exception:
+                # A broken progress display must not fail the work it reports on
+                pass
+
+
+def current_job() -> Optional[Job]:
+    """The job the calling thread is working for, if any"""
+    return getattr(_local, 'job', None)
+
+
+def check_cancelled() -> None:
+    """
+    Raise JobCancelled if the calling thread's job has been cancelled
+
+    Long-running loops (reading blocks, OCR'ing pages) call this between
+    steps. With no current job it does nothing.
+    """
+    job = getattr(_local, 'job', None)
+    if job is not None and job.cancel_event.is_set():
+        raise JobCancelled(f"{job.name} was cancelled")
+
+
+@contextmanager
+def job_context(job: Optional[Job]) -> Iterator[Optional[Job]]:
+    """Make ``job`` the calling thread's current job for work run outside the scheduler"""
+    previous = getattr(_local, 'job', None)
+    _local.job = job
+    try:
+        yield job
+    finally:
+        _local.job = previous
+
+
+class _Lane:
+    """Concurrency limit shared by the tasks of one JobExecutor"""
+
+    __slots__ = ('limit', 'running')
+
+    def __init__(self, limit: int):
+        self.limit = max(1, limit)
+        self.running = 0
+
+
+class _Task:
+    __slots__ = ('priority', 'seq', 'future', 'fn', 'args', 'kwargs', 'job', 'lane', 'submitted')
+
+    def __init__(self, priority, seq, future, fn, args, kwargs, job, lane):
+        self.priority = priority
+        self.seq = seq
+        self.future = future
+        self.fn = fn
+        self.args = args
+        self.kwargs = kwargs
+        self.job = job
+        self.lane = lane
+        self.submitted = time.perf_counter()
+
+    def __lt__(self, other: "_Task") -> bool:
+        return (self.priority, self.seq) < (other.priority, other.seq)
+
+
+class JobScheduler:
+    """
+    Priority task queue served by a shared set of worker threads
+
+    Tasks run in priority order, first come first served within one
+    priority. ``interactive_reserve`` workers never take batch-priority
+    tasks, so a preview or daemon request starts at once even when a large
+    batch keeps every other worker busy. Workers start on demand and stay
+    alive for later jobs.
+
+    A task must not block waiting for another scheduler task. ``run()``
+    called from a worker runs the function inline on that worker.
+    """
+
+    def __init__(self, max_workers: Optional[int] = None,
+                 interactive_reserve: int = DEFAULT_INTERACTIVE_RESERVE, name: str = 'scheduler'):
+        if not max_workers:
+            max_workers = max(4, os.cpu_count() or 1) + interactive_reserve
+        self.max_workers = max(1, int(max_workers))
+        self.interactive_reserve = max(0, min(interactive_reserve, self.max_workers - 1))
+        self.name = name
+        self._queue: List[_Task] = []
+        self._cond = threading.Condition()
+        self._threads: List[threading.Thread] = []
+        self._idle = 0
+        self._batch_running = 0
+        self._seq = itertools.count()
+        self._shutdown = False
+
+    @property
+    def batch_limit(self) -> int:
+        """Workers batch-priority tasks may occupy at once"""
+        return self.max_workers - self.interactive_reserve
+
+    def submit(self, fn: Callable, *args, priority: int = PRIORITY_NORMAL, job: Optional[Job] = None,
+               **kwargs) -> concurrent.futures.Future:
+        """Queue ``fn(*args, **kwargs)``; the job's priority wins over ``priority`` when a job is given"""
+        return self._submit(fn, args, kwargs, job.priority if job is not None else priority, job, None)
+
+    def run(self, fn: Callable, *args, priority: int = PRIORITY_NORMAL, job: Optional[Job] = None,
+            **kwargs) -> Any:
+        """Run ``fn`` on a worker at the given priority and return its result (or raise its error)"""
+        if getattr(_local, 'scheduler', None) is self:
+            with job_context(job or current_job()):
+                return fn(*args, **kwargs)
+        return self.submit(fn, *args, priority=priority, job=job, **kwargs).result()
+
+    def executor(self, priority: int = PRIORITY_NORMAL, job: Optional[Job] = None,
+                 max_workers: Optional[int] = None) -> "JobExecutor":
+        """
+        A concurrent.futures.Executor whose tasks run on this scheduler
+
+        Args:
+            priority: Priority of its tasks (a job's own priority wins)
+            job: Job the tasks belong to, for cancellation and current_job()
+            max_workers: Tasks of this executor running at once
+        """
+        return JobExecutor(self, job.priority if job is not None else priority, job, max_workers)
+
+    def _submit(self, fn, args, kwargs, priority, job, lane) -> concurrent.futures.Future:
+        future = concurrent.futures.Future()
+        with self._cond:
+            if self._shutdown:
+                raise RuntimeError('cannot schedule new futures after shutdown')
+            task = _Task(priority, next(self._seq), future, fn, args, kwargs or {}, job, lane)
+            bisect.insort(self._queue, task)
+            METRICS.set_gauge('scheduler_queue_depth', len(self._queue))
+            if self._idle == 0 and len(self._threads) < self.max_workers:
+                thread = threading.Thread(target=self._work, name=f"{self.name}-{len(self._threads)}",
+                                          daemon=True)
+                self._threads.append(thread)
+                thread.start()
+            self._cond.notify()
+        if job is not None:
+            job._track(future)
+        return future
+
+    def _runnable(self, task: _Task) -> bool:
+        if task.lane is not None and task.lane.running >= task.lane.limit:
+            return False
+        return task.priority < PRIORITY_BATCH or self._batch_running < self.batch_limit
+
+    def _take(self) -> Optional[_Task]:
+        """Remove and return the first task allowed to run now (called holding the lock)"""
+        index = 0
+        while index < len(self._queue):
+            task = self._queue[index]
+            if task.future.cancelled() or (task.job is not None and task.job.cancelled):
+                del self._queue[index]
+                task.future.cancel()
+                continue
+            if self._runnable(task):
+                del self._queue[index]
+                if task.lane is not None:
+                    task.lane.running += 1
+                if task.priority >= PRIORITY_BATCH:
+                    self._batch_running += 1
+                METRICS.set_gauge('scheduler_queue_depth', len(self._queue))
+                return task
+            index += 1
+        return None
+
+    def _release(self, task: _Task):
+        with self._cond:
+            if task.lane is not None:
+                task.lane.running -= 1
+            if task.priority >= PRIORITY_BATCH:
+                self._batch_running -= 1
+            # A freed lane or batch slot may unblock any waiting task
+            self._cond.notify_all()
+
+    def _work(self):
+        _local.scheduler = self
+        while True:
+            with self._cond:
+                while True:
+                    task = self._take()
+                    if task is not None:
+                        break
+                    if self._shutdown:
+                        return
+                    self._idle += 1
+                    self._cond.wait()
+                    self._idle -= 1
+            try:
+                self._run(task)
+            finally:
+                self._release(task)
+
+    def _run(self, task: _Task):
+        if not task.future.set_running_or_notify_cancel():
+            return
+        label = priority_label(task.priority)
+        METRICS.observe('scheduler_wait_seconds', time.perf_counter() - task.submitted, priority=label)
+        if task.job is not None:
+            task.job._started()
+        previous = getattr(_local, 'job', None)
+        _local.job = task.job
+        try:
+            result = task.fn(*task.args, **task.kwargs)
+        except BaseException as e:
+            task.future.set_exception(e)
+            METRICS.inc('scheduler_tasks_total', priority=label,
+                        status='cancelled' if isinstance(e, JobCancelled) else 'error')
+        else:
+            task.future.set_result(result)
+            METRICS.inc('scheduler_tasks_total', priority=label, status='success')
+        finally:
+            _local.job = previous
+            # Drop references to arguments and results held by the task
+            task.fn = task.args = task.kwargs = None
+
+    def shutdown(self, wait: bool = True, cancel_futures: bool = False) -> None:
+        """Stop the workers once the queue is empty (or cancel what is queued)"""
+        with self._cond:
+            self._shutdown = True
+            if cancel_futures:
+                for task in self._queue:
+                    task.future.cancel()
+                self._queue.clear()
+            self._cond.notify_all()
+            threads = list(self._threads)
+        if wait:
+            for thread in threads:
+                if thread is not threading.current_thread():
+                    thread.join()
+
+    def get_stats(self) -> Dict[str, Any]:
+        """Workers started and idle, tasks queued by priority band"""
+        with self._cond:
+            queued: Dict[str, int] = {}
+            for task in self._queue:
+                label = priority_label(task.priority)
+                queued[label] = queued.get(label, 0) + 1
+            return {
+                'max_workers': self.max_workers,
+                'interactive_reserve': self.interactive_reserve,
+                'workers': len(self._threads),
+                'idle': self._idle,
+                'batch_running': self._batch_running,
+                'queued': queued
+            }
+
+
+class JobExecutor(concurrent.futures.Executor):
+    """
+    Executor view of a JobScheduler: one priority, one job, its own worker limit
+
+    Lets code written for ThreadPoolExecutor (bounded_submit, admit_submit)
+    run on the shared workers. Leaving a ``with`` block waits only for this
+    executor's tasks. Leaving it on Ctrl-C also cancels the job, so running
+    files stop at their next check instead of finishing.
+    """
+
+    def __init__(self, scheduler: JobScheduler, priority: int, job: Optional[Job] = None,
+                 max_workers: Optional[int] = None):
+        self.scheduler = scheduler
+        self.priority = priority
+        self.job = job
+        self._lane = _Lane(max_workers or scheduler.max_workers)
+        self._futures: Set[concurrent.futures.Future] = set()
+        self._lock = threading.Lock()
+        self._shutdown = False
+
+    def submit(self, fn, /, *args, **kwargs) -> concurrent.futures.Future:
+        if self._shutdown:
+            raise RuntimeError('cannot schedule new futures after shutdown')
+        future = self.scheduler._submit(fn, args, kwargs, self.priority, self.job, self._lane)
+        with self._lock:
+            self._futures.add(future)
+        future.add_done_callback(self._discard)
+        return future
+
+    def _discard(self, future: concurrent.futures.Future):
+        with self._lock:
+            self._futures.discard(future)
+
+    def shutdown(self, wait: bool = True, *, cancel_futures: bool = False) -> None:
+        self._shutdown = True
+        with self._lock:
+            futures = list(self._futures)
+        if cancel_futures:
+            for future in futures:
+                future.cancel()
+        if wait:
+            concurrent.futures.wait(futures)
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        if exc_type is not None and issubclass(exc_type, KeyboardInterrupt) and self.job is not None:
+            self.job.cancel()
+        return super().__exit__(exc_type, exc_val, exc_tb)
+
+
+_shared_scheduler: Optional[JobScheduler] = None
+_shared_scheduler_lock = threading.Lock()
+
+
+def shared_scheduler(max_workers: Optional[int] = None) -> JobScheduler:
+    """
+    The process-wide scheduler used by batch conversion, OCR, the GUIs and the pipe server
+
+    The first caller fixes the worker count (``max_workers``, else the CPU
+    count with a minimum of four, plus the interactive reserve). Later
+    callers get the same instance.
+    """
+    global _shared_scheduler
+    with _shared_scheduler_lock:
+        if _shared_scheduler is None:
+            _shared_scheduler = JobScheduler(max_workers)
+        return _shared_scheduler
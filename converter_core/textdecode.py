@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""
+Text Decoding
+One-pass encoding detection and decoding shared by the text-based readers:
+the encoding is settled from the BOM and a bounded sample, then the file is
+decoded once (memory-mapped when large) instead of once per candidate
+"""
+
+import codecs
+import io
+import mmap
+import re
+from pathlib import Path
+from typing import Iterator, NamedTuple, Sequence, Union
+
+from .errors import FileProcessingError
+
+# Tried in order on the sample; latin-1 accepts any byte, so it ends the search
+DEFAULT_ENCODINGS = ('utf-8', 'latin-1', 'cp1252', 'iso-8859-1')
+
+# Bytes inspected before committing to an encoding
+SAMPLE_BYTES = 64 * 1024
+
+# Longest BOMs first: the UTF-32 LE mark starts with the UTF-16 LE one
+_BOMS = (
+    (codecs.BOM_UTF32_LE, 'utf-32'),
+    (codecs.BOM_UTF32_BE, 'utf-32'),
+    (codecs.BOM_UTF8, 'utf-8-sig'),
+    (codecs.BOM_UTF16_LE, 'utf-16'),
+    (codecs.BOM_UTF16_BE, 'utf-16'),
+)
+
+_CHARSET_DECLARATION = re.compile(rb'''<meta[^>]+charset\s*=\s*["']?\s*([A-Za-z0-9_.:-]+)''', re.IGNORECASE)
+
+# A paragraph break is a line holding nothing but whitespace. In the
+# ASCII-compatible encodings these bytes never occur inside a multi-byte
+# character, so breaks can be found on the raw bytes.
+_BYTE_BREAK = re.compile(rb'(?:\r\n|\n|\r(?!\n))[ \t\f\v]*(?:\r\n|\n|\r(?!\n))')
+_TEXT_BREAK = re.compile(r'(?:\r\n|\n|\r(?!\n))[ \t\f\v]*(?:\r\n|\n|\r(?!\n))')
+
+# Bytes the detected encoding turns out not to cover past the sample are
+# decoded as latin-1 under this handler, rather than failing the whole read
+FALLBACK_ERRORS = 'converter-latin1-fallback'
+
+
+def _latin1_fallback(error: UnicodeError):
+    if not isinstance(error, UnicodeDecodeError):
+        raise error
+    return error.object[error.start:error.end].decode('latin-1'), error.end
+
+
+codecs.register_error(FALLBACK_ERRORS, _latin1_fallback)
+
+
+class DetectedEncoding(NamedTuple):
+    """Codec name to decode with and whether it came from a byte-order mark"""
+    encoding: str
+    from_bom: bool = False
+
+    @property
+    def ascii_compatible(self) -> bool:
+        """Whether newlines and spaces are single ASCII bytes, so the raw bytes can be split"""
+        try:
+            return ' \n'.encode(self.encoding) == b' \n'
+        except (LookupError, UnicodeError):
+            return False
+
+
+def detect_encoding(sample: bytes, candidates: Sequence[str] = DEFAULT_ENCODINGS,
+                    declared: bool = False) -> DetectedEncoding:
+    """
+    Pick the encoding for a file from its first bytes
+
+    A BOM wins. With ``declared`` (HTML), a ``<meta charset>`` naming a known
+    codec comes next. Otherwise the first candidate that decodes the sample
+    is chosen; a multi-byte character cut off at the sample's end does not
+    count against it.
+    """
+    for bom, encoding in _BOMS:
+        if sample.startswith(bom):
+            return DetectedEncoding(encoding, True)
+
+    if declared:
+        match = _CHARSET_DECLARATION.search(sample)
+        if match:
+            try:
+                return DetectedEncoding(codecs.lookup(match.group(1).decode('ascii')).name)
+            except LookupError:
+                pass
+
+    for encoding in candidates:
+        try:
+            codecs.getincrementaldecoder(encoding)().decode(sample, final=False)
+            return DetectedEncoding(encoding)
+        except UnicodeDecodeError:
+            continue
+
+    raise FileProcessingError(f"Could not decode file with encodings: {list(candidates)}")
+
+
+def sniff_file(file_path: Union[str, Path], candidates: Sequence[str] = DEFAULT_ENCODINGS,
+               declared: bool = False) -> DetectedEncoding:
+    """detect_encoding on the first SAMPLE_BYTES of a file"""
+    with open(file_path, 'rb') as file:
+        return detect_encoding(file.read(SAMPLE_BYTES), candidates, declared)
+
+
+def decode_bytes(data: bytes, detected: DetectedEncoding) -> str:
+    """Decode a whole buffer once, with newlines normalised as text mode would"""
+    text = codecs.decode(data, detected.encoding, FALLBACK_ERRORS)
+    if '\r' in text:
+        text = text.replace('\r\n', '\n').replace('\r', '\n')
+    return text
+
+
+def read_text(file_path: Union[str, Path], candidates: Sequence[str] = DEFAULT_ENCODINGS,
+              declared: bool = False) -> str:
+    """A file's whole text, read and decoded once"""
+    with open(file_path, 'rb') as file:
+        data = file.read()
+    return decode_bytes(data, detect_encoding(data[:SAMPLE_BYTES], candidates, declared))
+
+
+def open_text(file_path: Union[str, Path], candidates: Sequence[str] = DEFAULT_ENCODINGS,
+              buffer_size: int = io.DEFAULT_BUFFER_SIZE) -> io.TextIOWrapper:
+    """
+    Open a file for line-by-line reading in its detected encoding
+
+    The stream is decoded incrementally as it is iterated, one pass over
+    the file; a BOM is consumed by the codec.
+    """
+    raw = open(file_path, 'rb', buffering=buffer_size)
+    try:
+        detected = detect_encoding(raw.peek(SAMPLE_BYTES)[:SAMPLE_BYTES], candidates)
+    except BaseException:
+        raw.close()
+        raise
+    return io.TextIOWrapper(raw, encoding=detected.encoding, errors=FALLBACK_ERRORS)
+
+
+def iter_paragraphs(file_path: Union[str, Path], candidates: Sequence[str] = DEFAULT_ENCODINGS,
+                    use_mmap: bool = True, chunk_size: int = 1024 * 1024) -> Iterator[str]:
+    """
+    Yield a text file's paragraphs (runs of lines between blank lines), stripped
+
+    For ASCII-compatible encodings the breaks are found on the bytes --
+    memory-mapped when ``use_mmap``, so even a huge dump is not read into
+    memory -- and each paragraph is decoded once on its own. UTF-16/32 files
+    go through an incremental decoder in ``chunk_size`` byte steps instead.
+    """
+    with open(file_path, 'rb') as file:
+        detected = detect_encoding(file.read(SAMPLE_BYTES), candidates)
+        file.seek(0)
+
+        if not detected.ascii_compatible:
+            yield from _iter_decoded_paragraphs(file, detected, chunk_size)
+            return
+
+        if use_mmap:
+            try:
+                buffer = mmap.mmap(file.fileno(), 0, access=mmap.ACCESS_READ)
+            except ValueError:
+                # Empty files cannot be mapped
+                return
+        else:
+            buffer = file.read()
+
+        try:
+            start = len(codecs.BOM_UTF8) if detected.from_bom else 0
+            for match in _BYTE_BREAK.finditer(buffer, start):
+                paragraph = decode_bytes(buffer[start:match.start()], detected).strip()
+                start = match.end()
+                if paragraph:
+                    yield paragraph
+            paragraph = decode_bytes(buffer[start:], detected).strip()
+            if paragraph:
+                yield paragraph
+        finally:
+            if use_mmap:
+                buffer.close()
+
+
+def _iter_decoded_paragraphs(file, detected: DetectedEncoding, chunk_size: int) -> Iterator[str]:
+    decoder = codecs.getincrementaldecoder(detected.encoding)(FALLBACK_ERRORS)
+    pending = ''
+    while True:
+        chunk = file.read(chunk_size)
+        pending += decoder.decode(chunk, final=not chunk)
+        # A break may straddle chunks: keep everything after the last one
+        # (and any trailing newline) for the next round
+        last = 0
+        for match in _TEXT_BREAK.finditer(pending):
+            paragraph = pending[last:match.start()].replace('\r\n', '\n').replace('\r', '\n').strip()
+            last = match.end()
+            if paragraph:
+                yield paragraph
+        pending = pending[last:]
+        if not chunk:
+            break
+    paragraph = pending.replace('\r\n', '\n').replace('\r', '\n').strip()
+    if paragraph:
+        yield paragraph
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+Text Kernels
+Escaping and sanitising loops shared by the writers and the OCR output
+validator, and the Markdown reader's block scanner, run by the compiled
+_textkernels extension when it is built (``python setup.py build_ext
+--inplace``) and by equivalent pure Python otherwise
+"""
+
+import html
+import os
+import re
+from typing import Iterable, List
+
+try:
+    if os.environ.get('CONVERTER_PURE_PYTHON'):
+        raise ImportError("compiled kernels disabled by CONVERTER_PURE_PYTHON")
+    from . import _textkernels as _native
+    NATIVE_AVAILABLE = True
+except ImportError:
+    _native = None
+    NATIVE_AVAILABLE = False
+
+# Injection patterns dropped from OCR text before it is escaped
+_MARKUP = re.compile(r'<script[^>]*>.*?</script>|on\w+\s*=\s*["\'][^"\']*["\']|javascript:',
+                     re.IGNORECASE | re.DOTALL)
+
+# Control characters except tab, newline and carriage return, and DEL
+_CONTROL_CHARS = dict.fromkeys([*range(0x00, 0x09), 0x0B, 0x0C, *range(0x0E, 0x20), 0x7F])
+
+# '12. item' in Markdown, tried only on lines starting with a digit
+_NUMBERED_ITEM = re.compile(r'\s*(\d+)\.\s+(.+)')
+
+
+def py_escape_html(text: str) -> str:
+    """Pure-Python escape_html: chained str.replace beats translate() and regex callbacks here"""
+    return (text.replace('&', '&amp;')
+               .replace('<', '&lt;')
+               .replace('>', '&gt;')
+               .replace('"', '&quot;')
+               .replace("'", '&#x27;'))
+
+
+def py_escape_rtf(text: str) -> str:
+    """Pure-Python escape_rtf"""
+    return text.replace('\\', '\\\\').replace('{', '\\{').replace('}', '\\}')
+
+
+def py_sanitize_text(text: str) -> str:
+    """Pure-Python sanitize_text"""
+    return ' '.join(html.escape(text).translate(_CONTROL_CHARS).split())
+
+
+class PyMarkdownScanner:
+    """
+    Pure-Python MarkdownScanner: turns Markdown lines into content blocks
+
+    ``feed(lines)`` returns the blocks completed by those lines and may be
+    called any number of times; ``close()`` returns what the last lines left
+    open (a paragraph, an unterminated code block).
+    """
+
+    def __init__(self):
+        self.paragraph = []
+        self.in_code_block = False
+        self.code_block = []
+
+    def _flush_paragraph(self, blocks):
+        if self.paragraph:
+            blocks.append(('paragraph', ' '.join(self.paragraph)))
+            self.paragraph = []
+
+    def feed(self, lines: Iterable[str]) -> List[tuple]:
+        blocks = []
+        for line in lines:
+            line = line.rstrip()
+            # The line without indentation, computed once for every test below
+            lead = line.lstrip()
+
+            # Code fences toggle verbatim mode
+            if line.startswith('```'):
+                if self.in_code_block:
+                    if self.code_block:
+                        blocks.append(('code_block', '\n'.join(self.code_block)))
+                    self.code_block = []
+                    self.in_code_block = False
+                else:
+                    self._flush_paragraph(blocks)
+                    self.in_code_block = True
+                continue
+
+            if self.in_code_block:
+                self.code_block.append(line)
+                continue
+
+            if line.startswith('#'):
+                self._flush_paragraph(blocks)
+                level = 0
+                while level < len(line) and line[level] == '#':
+                    level += 1
+                if level <= 6 and level < len(line) and line[level] == ' ':
+                    heading_text = line[level + 1:].strip()
+                    if heading_text:
+                        blocks.append(('heading', level, heading_text))
+                continue
+
+            # Empty lines end paragraphs
+            if not lead:
+                self._flush_paragraph(blocks)
+                continue
+
+            if lead.startswith(('- ', '* ', '+ ')):
+                self._flush_paragraph(blocks)
+                list_text = lead[2:].strip()
+                if list_text:
+                    blocks.append(('list_item', list_text))
+                continue
+
+            numbered_list_match = _NUMBERED_ITEM.match(lead) if lead[0].isdigit() else None
+            if numbered_list_match:
+                self._flush_paragraph(blocks)
+                list_text = numbered_list_match.group(2).strip()
+                if list_text:
+                    blocks.append(('numbered_list_item', list_text))
+                continue
+
+            if lead.startswith('> '):
+                self._flush_paragraph(blocks)
+                quote_text = lead[2:].strip()
+                if quote_text:
+                    blocks.append(('blockquote', quote_text))
+                continue
+
+            # Regular text joins the current paragraph
+            self.paragraph.append(lead)
+        return blocks
+
+    def close(self) -> List[tuple]:
+        blocks = []
+        self._flush_paragraph(blocks)
+        if self.in_code_block and self.code_block:
+            blocks.append(('code_block', '\n'.join(self.code_block)))
+        self.in_code_block = False
+        self.code_block = []
+        return blocks
+
+
+# escape_html(text), escape_rtf(text), sanitize_text(text) and MarkdownScanner(): compiled when available
+escape_html = _native.escape_html if NATIVE_AVAILABLE else py_escape_html
+escape_rtf = _native.escape_rtf if NATIVE_AVAILABLE else py_escape_rtf
+sanitize_text = _native.sanitize_text if NATIVE_AVAILABLE else py_sanitize_text
+# An in-place build from before the scanner existed still provides the rest
+MarkdownScanner = getattr(_native, 'MarkdownScanner', PyMarkdownScanner)
+
+
+def sanitize_ocr_text(text: str) -> str:
+    """
+    OCR text made safe to display or store as HTML
+
+    Script blocks, inline event handlers and ``javascript:`` are removed
+    (repeatedly, so removing one cannot assemble another), then the text is
+    HTML-escaped, control characters other than tab and newlines dropped
+    and whitespace runs collapsed to single spaces, all in one pass.
+    """
+    while True:
+        # Plain OCR text never matches: this is a single scan
+        text, removed = _MARKUP.subn('', text)
+        if not removed:
+            break
+    return sanitize_text(text)
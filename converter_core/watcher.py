@@ -0,0 +1,574 @@
+#!/usr/bin/env python3
+"""
+Watch-Folder Ingest
+Turns file-change notifications on a drop folder into a persistent,
+debounced work queue drained by the batch converter and the OCR engine
+"""
+
+import logging
+import os
+import sqlite3
+import threading
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Union
+
+from .formats import FormatDetector
+
+# Partial downloads, editor lock files and other names that are never documents
+IGNORED_PREFIXES = ('~$', '.')
+IGNORED_SUFFIXES = ('.tmp', '.part', '.partial', '.crdownload', '.download', '.swp')
+
+
+class WorkQueue:
+    """
+    Persistent queue of files waiting to be converted
+
+    Jobs live in SQLite so a restart resumes where the previous process
+    stopped: jobs left 'running' by a crash are queued again by recover().
+    Re-enqueueing a path that is already queued only refreshes it, and one
+    that changes while running is converted once more when it finishes.
+    Failed jobs retry with exponential back-off up to ``max_attempts``.
+    """
+
+    SCHEMA_VERSION = 1
+
+    def __init__(self, db_path: Union[str, Path], max_attempts: int = 3, retry_delay: float = 5.0):
+        self.db_path = Path(db_path)
+        self.db_path.parent.mkdir(parents=True, exist_ok=True)
+        self.max_attempts = max_attempts
+        self.retry_delay = retry_delay
+        self._lock = threading.Lock()
+        self._conn = sqlite3.connect(str(self.db_path), check_same_thread=False, isolation_level=None)
+        self._init_schema()
+
+    def _init_schema(self):
+        conn = self._conn
+        conn.execute("PRAGMA journal_mode=WAL")
+        conn.execute("PRAGMA synchronous=NORMAL")
+        version = conn.execute("PRAGMA user_version").fetchone()[0]
+        if version != self.SCHEMA_VERSION:
+            conn.execute("DROP TABLE IF EXISTS jobs")
+            conn.execute(f"PRAGMA user_version={self.SCHEMA_VERSION}")
+        conn.execute(
+            """CREATE TABLE IF NOT EXISTS jobs (
+                   path TEXT PRIMARY KEY,
+                   status TEXT NOT NULL,
+                   attempts INTEGER NOT NULL DEFAULT 0,
+                   dirty INTEGER NOT NULL DEFAULT 0,
+                   not_before REAL NOT NULL DEFAULT 0,
+                   enqueued REAL NOT NULL,
+                   updated REAL NOT NULL,
+                   error TEXT
+               )"""
+        )
+        conn.execute("CREATE INDEX IF NOT EXISTS jobs_ready ON jobs(status, not_before)")
+
+    def enqueue(self, path: Union[str, Path]) -> None:
+        """Queue a file (again); a running job is marked to run once more"""
+        path = os.path.abspath(str(path))
+        now = time.time()
+        with self._lock:
+            row = self._conn.execute("SELECT status FROM jobs WHERE path = ?", (path,)).fetchone()
+            if row is None:
+                self._conn.execute(
+                    "INSERT INTO jobs (path, status, enqueued, updated) VALUES (?, 'queued', ?, ?)",
+                    (path, now, now)
+                )
+            elif row[0] == 'running':
+                self._conn.execute("UPDATE jobs SET dirty = 1, updated = ? WHERE path = ?", (now, path))
+            else:
+                self._conn.execute(
+                    "UPDATE jobs SET status = 'queued', attempts = 0, not_before = 0, error = NULL, "
+                    "enqueued = ?, updated = ? WHERE path = ?", (now, now, path)
+                )
+
+    def claim(self, limit: int) -> List[str]:
+        """Mark up to ``limit`` ready jobs as running and return their paths, oldest first"""
+        now = time.time()
+        with self._lock:
+            rows = self._conn.execute(
+                "SELECT path FROM jobs WHERE status = 'queued' AND not_before <= ? "
+                "ORDER BY enqueued LIMIT ?", (now, limit)
+            ).fetchall()
+            paths = [row[0] for row in rows]
+            if paths:
+                self._conn.executemany(
+                    "UPDATE jobs SET status = 'running', dirty = 0, updated = ? WHERE path = ?",
+                    [(now, path) for path in paths]
+                )
+        return paths
+
+    def complete(self, path: str) -> None:
+        """Mark a job done, or queue it again if the file changed while it ran"""
+        now = time.time()
+        with self._lock:
+            self._conn.execute(
+                "UPDATE jobs SET status = CASE dirty WHEN 1 THEN 'queued' ELSE 'done' END, "
+                "dirty = 0, attempts = 0, error = NULL, updated = ? WHERE path = ?", (now, path)
+            )
+
+    def fail(self, path: str, error: str) -> bool:
+        """
+        Record a failed attempt
+
+        Returns:
+            True if the job will be retried, False once it is given up on
+        """
+        now = time.time()
+        with self._lock:
+            row = self._conn.execute("SELECT attempts FROM jobs WHERE path = ?", (path,)).fetchone()
+            attempts = (row[0] if row else 0) + 1
+            retry = attempts < self.max_attempts
+            self._conn.execute(
+                "UPDATE jobs SET status = ?, attempts = ?, not_before = ?, error = ?, updated = ? WHERE path = ?",
+                ('queued' if retry else 'failed', attempts,
+                 now + self.retry_delay * (2 ** (attempts - 1)) if retry else 0, error[:1000], now, path)
+            )
+        return retry
+
+    def forget(self, path: Union[str, Path]) -> None:
+        """Drop a job whose file disappeared before it was converted"""
+        with self._lock:
+            self._conn.execute("DELETE FROM jobs WHERE path = ? AND status != 'running'",
+                               (os.path.abspath(str(path)),))
+
+    def recover(self) -> int:
+        """Queue jobs a previous process left running; returns how many"""
+        with self._lock:
+            cursor = self._conn.execute(
+                "UPDATE jobs SET status = 'queued', not_before = 0 WHERE status = 'running'"
+            )
+            return cursor.rowcount
+
+    def purge_done(self, older_than: float = 86400) -> int:
+        """Remove finished jobs older than ``older_than`` seconds"""
+        with self._lock:
+            cursor = self._conn.execute(
+                "DELETE FROM jobs WHERE status = 'done' AND updated < ?", (time.time() - older_than,)
+            )
+            return cursor.rowcount
+
+    def counts(self) -> Dict[str, int]:
+        """Number of jobs per status"""
+        with self._lock:
+            rows = self._conn.execute("SELECT status, COUNT(*) FROM jobs GROUP BY status").fetchall()
+        return {status: count for status, count in rows}
+
+    def close(self):
+        with self._lock:
+            self._conn.close()
+
+
+class Debouncer:
+    """
+    Holds change events until a file has stopped being written
+
+    A file is released once no event arrived for ``settle_seconds`` and its
+    size and mtime are the same as when last checked, which catches slow
+    copies and scanners that write in bursts without emitting events.
+    """
+
+    def __init__(self, settle_seconds: float = 2.0):
+        self.settle_seconds = settle_seconds
+        self._pending: Dict[str, list] = {}
+        self._lock = threading.Lock()
+
+    @staticmethod
+    def _signature(path: str) -> Optional[tuple]:
+        try:
+            stat = os.stat(path)
+        except OSError:
+            return None
+        return (stat.st_size, stat.st_mtime_ns)
+
+    def touch(self, path: str, now: Optional[float] = None) -> None:
+        now = time.time() if now is None else now
+        signature = self._signature(path)
+        with self._lock:
+            self._pending[path] = [now, signature]
+
+    def discard(self, path: str) -> None:
+        with self._lock:
+            self._pending.pop(path, None)
+
+    def ready(self, now: Optional[float] = None) -> List[str]:
+        """Pop and return the files whose writes have completed"""
+        now = time.time() if now is None else now
+        released = []
+        with self._lock:
+            for path, entry in list(self._pending.items()):
+                if now - entry[0] < self.settle_seconds:
+                    continue
+                signature = self._signature(path)
+                if signature is None:
+                    # Moved away or deleted before it settled
+                    del self._pending[path]
+                    continue
+                if signature != entry[1]:
+                    # Still growing without events: wait another settle period
+                    entry[0] = now
+                    entry[1] = signature
+                    continue
+                del self._pending[path]
+                released.append(path)
+        return released
+
+    def __len__(self):
+        return len(self._pending)
+
+
+class _PollingSource:
+    """Fallback change source that rescans the tree with os.scandir"""
+
+    def __init__(self, root: Path, recursive: bool, on_change: Callable[[str], None],
+                 interval: float = 2.0, exclude: Optional[Path] = None):
+        self.root = root
+        self.recursive = recursive
+        self.on_change = on_change
+        self.interval = interval
+        self.exclude = os.path.abspath(exclude) if exclude else None
+        self._seen: Dict[str, tuple] = {}
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+
+    def _scan(self, directory: str):
+        try:
+            with os.scandir(directory) as entries:
+                for entry in entries:
+                    try:
+                        if entry.is_dir(follow_symlinks=False):
+                            if self.recursive and os.path.abspath(entry.path) != self.exclude:
+                                yield from self._scan(entry.path)
+                        elif entry.is_file():
+                            yield entry.path, entry.stat()
+                    except OSError:
+                        continue
+        except OSError:
+            return
+
+    def poll(self):
+        """Report files that are new or changed since the previous scan"""
+        current = {}
+        for path, stat in self._scan(str(self.root)):
+            signature = (stat.st_size, stat.st_mtime_ns)
+            current[path] = signature
+            if self._seen.get(path) != signature:
+                self.on_change(path)
+        self._seen = current
+
+    def start(self):
+        # The first scan only records the baseline; the watcher sweeps existing files itself
+        for path, stat in self._scan(str(self.root)):
+            self._seen[path] = (stat.st_size, stat.st_mtime_ns)
+
+        def run():
+            while not self._stop.wait(self.interval):
+                self.poll()
+
+        self._thread = threading.Thread(target=run, name="watch-poll", daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        self._stop.set()
+        if self._thread:
+            self._thread.join(timeout=5)
+
+
+class _NativeSource:
+    """Change source backed by watchdog (inotify, FSEvents or ReadDirectoryChangesW)"""
+
+    def __init__(self, root: Path, recursive: bool, on_change: Callable[[str], None],
+                 on_delete: Callable[[str], None]):
+        from watchdog.events import FileSystemEventHandler
+        from watchdog.observers import Observer
+
+        class Handler(FileSystemEventHandler):
+            def on_created(self, event):
+                if not event.is_directory:
+                    on_change(event.src_path)
+
+            def on_modified(self, event):
+                if not event.is_directory:
+                    on_change(event.src_path)
+
+            def on_closed(self, event):
+                if not event.is_directory:
+                    on_change(event.src_path)
+
+            def on_moved(self, event):
+                if not event.is_directory:
+                    on_delete(event.src_path)
+                    on_change(event.dest_path)
+
+            def on_deleted(self, event):
+                if not event.is_directory:
+                    on_delete(event.src_path)
+
+        self._observer = Observer()
+        self._observer.schedule(Handler(), str(root), recursive=recursive)
+
+    def start(self):
+        self._observer.start()
+
+    def stop(self):
+        self._observer.stop()
+        self._observer.join(timeout=5)
+
+
+class FolderWatcher:
+    """
+    Continuous ingest of a drop folder
+
+    File-change notifications (watchdog when installed, otherwise an
+    os.scandir poll) pass through a Debouncer into a persistent WorkQueue.
+    A worker thread drains the queue in batches: documents go through
+    ``convert_batch(incremental=True)``, so the output tree's manifest
+    suppresses duplicate work, and images go to the OCR engine when
+    ``ocr`` is enabled. Outputs mirror the drop folder's structure.
+    """
+
+    QUEUE_FILENAME = ".converter_watch_queue.sqlite3"
+
+    def __init__(self, watch_dir: Union[str, Path], output_dir: Union[str, Path], converter,
+                 output_format: str = 'markdown', recursive: bool = True, settle_seconds: float = 2.0,
+                 batch_size: int = 32, max_workers: Optional[int] = None, ocr: bool = False,
+                 ocr_integration_factory: Optional[Callable[[], Any]] = None, ocr_format: str = 'txt',
+                 use_native: bool = True, poll_interval: float = 2.0,
+                 on_result: Optional[Callable[[Dict[str, Any]], None]] = None,
+                 logger: Optional[logging.Logger] = None):
+        self.watch_dir = Path(watch_dir).resolve()
+        self.output_dir = Path(output_dir).resolve()
+        self.converter = converter
+        self.output_format = output_format
+        self.recursive = recursive
+        self.batch_size = batch_size
+        self.max_workers = max_workers
+        self.ocr = ocr
+        self.ocr_format = ocr_format
+        self.use_native = use_native
+        self.poll_interval = poll_interval
+        self.on_result = on_result
+        self.logger = logger or logging.getLogger("FolderWatcher")
+        self._ocr_integration_factory = ocr_integration_factory
+        self._ocr_integration = None
+        self._image_extensions = None
+
+        self.debouncer = Debouncer(settle_seconds)
+        self.queue = WorkQueue(self.output_dir / self.QUEUE_FILENAME)
+        self.stats = {'converted': 0, 'ocr': 0, 'failed': 0, 'unchanged': 0}
+        self._source = None
+        self._stop = threading.Event()
+        self._wake = threading.Event()
+        self._worker: Optional[threading.Thread] = None
+
+    # -- filtering ---------------------------------------------------------
+
+    def _is_image(self, path: str) -> bool:
+        if self._image_extensions is None:
+            from ocr_engine.format_detector import OCRFormatDetector
+            self._image_extensions = OCRFormatDetector.SUPPORTED_IMAGE_FORMATS
+        return Path(path).suffix.lower() in self._image_extensions
+
+    def accepts(self, path: Union[str, Path]) -> bool:
+        """Whether a path is a document (or, with OCR, an image) this watcher converts"""
+        path = os.path.abspath(str(path))
+        name = os.path.basename(path)
+        if name.startswith(IGNORED_PREFIXES) or name.lower().endswith(IGNORED_SUFFIXES):
+            return False
+        # Never feed our own outputs back in when the output tree sits inside the drop folder
+        if os.path.commonpath([path, str(self.output_dir)]) == str(self.output_dir):
+            return False
+        if not self.recursive and os.path.dirname(path) != str(self.watch_dir):
+            return False
+        if FormatDetector.detect_format(path):
+            return True
+        return self.ocr and self._is_image(path)
+
+    # -- event intake ------------------------------------------------------
+
+    def notify(self, path: str) -> None:
+        """Record a change event for a path"""
+        if self.accepts(path):
+            self.debouncer.touch(os.path.abspath(path))
+
+    def notify_deleted(self, path: str) -> None:
+        path = os.path.abspath(path)
+        self.debouncer.discard(path)
+        self.queue.forget(path)
+
+    def sweep(self) -> int:
+        """Queue every acceptable file already in the drop folder; returns the count"""
+        count = 0
+        iterator = self.watch_dir.rglob('*') if self.recursive else self.watch_dir.iterdir()
+        for path in iterator:
+            if path.is_file() and self.accepts(path):
+                self.queue.enqueue(path)
+                count += 1
+        return count
+
+    # -- processing --------------------------------------------------------
+
+    @property
+    def ocr_integration(self):
+        if self._ocr_integration is None:
+            if self._ocr_integration_factory is not None:
+                self._ocr_integration = self._ocr_integration_factory()
+            else:
+                from ocr_engine.ocr_integration import OCRIntegration
+                self._ocr_integration = OCRIntegration()
+        return self._ocr_integration
+
+    def _report(self, result: Dict[str, Any]):
+        if self.on_result:
+            try:
+                self.on_result(result)
+            except Exception as e:
+                self.logger.debug(f"Watch result callback failed: {e}")
+
+    def _convert_documents(self, paths: List[str]):
+        settled = set()
+
+        def failed(path, error):
+            self.stats['failed'] += 1
+            retry = self.queue.fail(path, error)
+            self.logger.warning(f"Watch conversion failed for {path}: {error}"
+                                f"{' (will retry)' if retry else ''}")
+
+        def progress(completed, total, result):
+            path = paths[result['index']]
+            settled.add(path)
+            status = result['status']
+            if status == 'error':
+                failed(path, result.get('error', 'Conversion failed'))
+            else:
+                self.stats['unchanged' if status == 'unchanged' else 'converted'] += 1
+                self.queue.complete(path)
+            self._report(dict(result, path=path))
+
+        # A batch-level error (output tree, manifest) reports no per-file
+        # results; every claimed file still needs an outcome or it stays
+        # 'running' in the queue until the next restart
+        error = 'Not processed'
+        try:
+            self.converter.convert_batch(
+                [Path(path) for path in paths], self.output_dir, output_format=self.output_format,
+                max_workers=self.max_workers, progress_callback=progress, preserve_structure=True,
+                base_dir=self.watch_dir, incremental=True, prune_deleted=False
+            )
+        except Exception as e:
+            error = str(e)
+        for path in paths:
+            if path not in settled:
+                failed(path, error)
+                self._report({'file': path, 'path': path, 'status': 'error', 'error': error})
+
+    def _ocr_images(self, paths: List[str]):
+        # OCRIntegration writes flat into one folder, so group per source directory
+        by_dir: Dict[Path, List[str]] = {}
+        for path in paths:
+            relative = Path(path).parent.relative_to(self.watch_dir)
+            by_dir.setdefault(self.output_dir / relative, []).append(path)
+
+        for target_dir, group in by_dir.items():
+            target_dir.mkdir(parents=True, exist_ok=True)
+            try:
+                outcome = self.ocr_integration.process_files(group, str(target_dir), self.ocr_format)
+                results = {os.path.abspath(r['file']): r for r in outcome.get('results', [])}
+            except Exception as e:
+                results = {path: {'file': path, 'success': False, 'error': str(e)} for path in group}
+
+            for path in group:
+                result = results.get(path, {'file': path, 'success': False, 'error': 'Not processed'})
+                if result.get('success'):
+                    self.stats['ocr'] += 1
+                    self.queue.complete(path)
+                else:
+                    self.stats['failed'] += 1
+                    self.queue.fail(path, result.get('error', 'OCR failed'))
+                self._report(dict(result, path=path,
+                                  status='success' if result.get('success') else 'error'))
+
+    def process_pending(self) -> int:
+        """Release settled files into the queue and convert one batch; returns jobs handled"""
+        for path in self.debouncer.ready():
+            self.queue.enqueue(path)
+
+        paths = self.queue.claim(self.batch_size)
+        if not paths:
+            return 0
+
+        documents, images = [], []
+        for path in paths:
+            if not os.path.exists(path):
+                self.queue.complete(path)
+            elif FormatDetector.detect_format(path):
+                documents.append(path)
+            else:
+                images.append(path)
+
+        if documents:
+            self._convert_documents(documents)
+        if images:
+            self._ocr_images(images)
+        return len(paths)
+
+    def _run(self):
+        idle_wait = min(0.5, self.debouncer.settle_seconds / 2 or 0.5)
+        while not self._stop.is_set():
+            try:
+                handled = self.process_pending()
+            except Exception as e:
+                self.logger.error(f"Watch worker error: {e}")
+                handled = 0
+            if not handled:
+                self._wake.wait(idle_wait)
+                self._wake.clear()
+
+    # -- lifecycle ---------------------------------------------------------
+
+    def start(self) -> None:
+        """Recover the queue, sweep existing files and start watching"""
+        recovered = self.queue.recover()
+        queued = self.sweep()
+        self.logger.info(f"Watching {self.watch_dir} -> {self.output_dir} "
+                         f"({queued} existing files queued, {recovered} recovered)")
+
+        self._source = None
+        if self.use_native:
+            try:
+                self._source = _NativeSource(self.watch_dir, self.recursive, self.notify, self.notify_deleted)
+            except ImportError:
+                self.logger.info("watchdog not installed; polling the folder for changes")
+        if self._source is None:
+            self._source = _PollingSource(self.watch_dir, self.recursive, self.notify,
+                                          self.poll_interval, exclude=self.output_dir)
+        self._source.start()
+
+        self._stop.clear()
+        self._worker = threading.Thread(target=self._run, name="watch-worker", daemon=True)
+        self._worker.start()
+
+    def stop(self) -> None:
+        """Stop watching; queued jobs stay persisted for the next watcher on this output tree"""
+        self._stop.set()
+        self._wake.set()
+        if self._source:
+            self._source.stop()
+        if self._worker:
+            self._worker.join(timeout=30)
+        self.queue.close()
+
+    def run_forever(self) -> None:
+        """Block until interrupted (Ctrl+C)"""
+        self.start()
+        try:
+            while not self._stop.wait(1.0):
+                pass
+        except KeyboardInterrupt:
+            self.logger.info("Stopping watch")
+        finally:
+            self.stop()
+
+    def get_stats(self) -> Dict[str, Any]:
+        return dict(self.stats, pending_events=len(self.debouncer), queue=self.queue.counts())
@@ -0,0 +1,336 @@
+#!/usr/bin/env python3
+"""
+Document Writers
+Writers that consume a content block stream for each supported output format
+"""
+
+from pathlib import Path
+
+from .errors import DependencyError, FileProcessingError
+from .registry import register_writer
+from .textkernels import escape_html, escape_rtf
+
+
+class DocumentWriter:
+    """Base class for document writers
+
+    write() accepts any iterable of content blocks, including the generator
+    returned by DocumentReader.iter_read(), and writes output as it goes.
+    """
+
+    def write(self, content, output_path):
+        """Write content to output file"""
+        raise NotImplementedError
+
+    def _write_lines(self, lines, output_path, separator='\n'):
+        """Write an iterable of lines incrementally, joined by separator"""
+        with open(output_path, 'w', encoding='utf-8') as file:
+            first = True
+            for line in lines:
+                if not first:
+                    file.write(separator)
+                file.write(line)
+                first = False
+
+@register_writer('markdown')
+class MarkdownWriter(DocumentWriter):
+    """Writer for Markdown files"""
+
+    def write(self, content, output_path):
+        self._write_lines(self._iter_lines(content), output_path)
+
+    def _iter_lines(self, content):
+        for item in content:
+            if item[0] == 'heading':
+                level, text = item[1], item[2]
+                yield f"{'#' * level} {text}"
+                yield ""
+            elif item[0] == 'paragraph':
+                yield item[1]
+                yield ""
+            elif item[0] == 'page':
+                page_num, text = item[1], item[2]
+                yield f"## Page {page_num}"
+                yield ""
+                yield text
+                yield ""
+
+@register_writer('txt')
+class TxtWriter(DocumentWriter):
+    """Writer for plain text files"""
+
+    def write(self, content, output_path):
+        self._write_lines(self._iter_lines(content), output_path)
+
+    def _iter_lines(self, content):
+        for item in content:
+            if item[0] == 'heading':
+                text = item[2]
+                yield text.upper()
+                yield '=' * len(text)
+                yield ""
+            elif item[0] == 'paragraph':
+                yield item[1]
+                yield ""
+            elif item[0] == 'page':
+                page_num, text = item[1], item[2]
+                yield f"PAGE {page_num}"
+                yield "-" * 20
+                yield text
+                yield ""
+
+@register_writer('html')
+class HtmlWriter(DocumentWriter):
+    """Writer for HTML files"""
+
+    def write(self, content, output_path):
+        self._write_lines(self._iter_lines(content, output_path), output_path)
+
+    def _iter_lines(self, content, output_path):
+        yield from [
+            "<!DOCTYPE html>",
+            "<html lang='en'>",
+            "<head>",
+            "    <meta charset='UTF-8'>",
+            "    <meta name='viewport' content='width=device-width, initial-scale=1.0'>",
+            f"    <title>{Path(output_path).stem}</title>",
+            "    <style>",
+            "        body { font-family: Arial, sans-serif; max-width: 800px; margin: 0 auto; padding: 20px; }",
+            "        h1, h2, h3, h4, h5, h6 { color: #333; }",
+            "        p { line-height: 1.6; margin-bottom: 1em; }",
+            "    </style>",
+            "</head>",
+            "<body>"
+        ]
+
+        for item in content:
+            if item[0] == 'heading':
+                level, text = item[1], item[2]
+                yield f"    <h{level}>{self._escape_html(text)}</h{level}>"
+            elif item[0] == 'paragraph':
+                yield f"    <p>{self._escape_html(item[1])}</p>"
+            elif item[0] == 'page':
+                page_num, text = item[1], item[2]
+                yield f"    <h2>Page {page_num}</h2>"
+                yield f"    <p>{self._escape_html(text)}</p>"
+
+        yield from ["</body>", "</html>"]
+
+    def _escape_html(self, text):
+        """Escape HTML special characters"""
+        return escape_html(text)
+
+@register_writer('rtf')
+class RtfWriter(DocumentWriter):
+    """Writer for RTF files"""
+
+    def write(self, content, output_path):
+        self._write_lines(self._iter_lines(content), output_path, separator='')
+
+    def _iter_lines(self, content):
+        # Basic RTF structure
+        yield from [
+            r"{\rtf1\ansi\deff0",
+            r"{\fonttbl{\f0 Times New Roman;}}",
+            r"\f0\fs24"
+        ]
+
+        for item in content:
+            if item[0] == 'heading':
+                level, text = item[1], item[2]
+                size = max(32 - (level * 4), 20)  # Larger size for higher level headings
+                yield f"\\par\\fs{size}\\b {self._escape_rtf(text)}\\b0\\fs24"
+            elif item[0] == 'paragraph':
+                yield f"\\par {self._escape_rtf(item[1])}"
+            elif item[0] == 'page':
+                page_num, text = item[1], item[2]
+                yield f"\\par\\fs28\\b Page {page_num}\\b0\\fs24"
+                yield f"\\par {self._escape_rtf(text)}"
+
+        yield "}"
+
+    def _escape_rtf(self, text):
+        """Escape RTF special characters"""
+        return escape_rtf(text)
+
+
+@register_writer('epub', requires=('ebooklib',))
+class EpubWriter(DocumentWriter):
+    """Writer for EPUB files"""
+
+    def write(self, content, output_path):
+        try:
+            import ebooklib
+            from ebooklib import epub
+        except ImportError:
+            raise DependencyError("ebooklib is required for EPUB support. Install with: pip install ebooklib")
+
+        # Title and author lookups need the whole document, so EPUB output
+        # materializes the content stream before building the book
+        content = list(content)
+
+        try:
+            # Create new EPUB book
+            book = epub.EpubBook()
+
+            # Extract title and author from content
+            title = "Converted Document"
+            author = "Unknown Author"
+
+            # Look for title in first heading
+            for item in content:
+                if item[0] == 'heading' and item[1] == 1:
+                    title = item[2]
+                    break
+
+            # Look for author in content
+            for item in content:
+                if item[0] == 'paragraph' and item[1].lower().startswith('by:'):
+                    author = item[1][3:].strip()
+                    break
+
+            # Set metadata
+            book.set_identifier(f"converted-{hash(str(content)) % 1000000}")
+            book.set_title(title)
+            book.set_language('en')
+            book.add_author(author)
+
+            # Create chapters
+            chapters = []
+            current_chapter = None
+            current_chapter_content = []
+            chapter_count = 0
+
+            for item in content:
+                if item[0] == 'heading' and item[1] <= 2:
+                    # Start new chapter
+                    if current_chapter is not None:
+                        # Save previous chapter
+                        self._finalize_chapter(current_chapter, current_chapter_content)
+                        chapters.append(current_chapter)
+                        book.add_item(current_chapter)
+
+                    # Create new chapter
+                    chapter_count += 1
+                    chapter_title = item[2] if item[1] == 1 else item[2]
+                    current_chapter = epub.EpubHtml(
+                        title=chapter_title,
+                        file_name=f'chap_{chapter_count:02d}.xhtml',
+                        lang='en'
+                    )
+                    current_chapter_content = []
+
+                    # Add heading to chapter content
+                    level = item[1]
+                    current_chapter_content.append(f'<h{level}>{self._escape_html(item[2])}</h{level}>')
+
+                elif item[0] == 'heading':
+                    # Add sub-heading to current chapter
+                    if current_chapter is None:
+                        # Create first chapter if none exists
+                        chapter_count += 1
+                        current_chapter = epub.EpubHtml(
+                            title="Chapter 1",
+                            file_name=f'chap_{chapter_count:02d}.xhtml',
+                            lang='en'
+                        )
+                        current_chapter_content = []
+
+                    level = min(item[1], 6)
+                    current_chapter_content.append(f'<h{level}>{self._escape_html(item[2])}</h{level}>')
+
+                elif item[0] == 'paragraph':
+                    # Add paragraph to current chapter
+                    if current_chapter is None:
+                        # Create first chapter if none exists
+                        chapter_count += 1
+                        current_chapter = epub.EpubHtml(
+                            title="Chapter 1",
+                            file_name=f'chap_{chapter_count:02d}.xhtml',
+                            lang='en'
+                        )
+                        current_chapter_content = []
+
+                    # Skip author line if it's already in metadata
+                    if not (item[1].lower().startswith('by:') and author != "Unknown Author"):
+                        current_chapter_content.append(f'<p>{self._escape_html(item[1])}</p>')
+
+                elif item[0] == 'page':
+                    # Handle page breaks from PDF
+                    if current_chapter is None:
+                        chapter_count += 1
+                        current_chapter = epub.EpubHtml(
+                            title=f"Page {item[1]}",
+                            file_name=f'chap_{chapter_count:02d}.xhtml',
+                            lang='en'
+                        )
+                        current_chapter_content = []
+
+                    current_chapter_content.append(f'<h3>Page {item[1]}</h3>')
+                    current_chapter_content.append(f'<p>{self._escape_html(item[2])}</p>')
+
+            # Finalize last chapter
+            if current_chapter is not None:
+                self._finalize_chapter(current_chapter, current_chapter_content)
+                chapters.append(current_chapter)
+                book.add_item(current_chapter)
+
+            # Create table of contents
+            book.toc = chapters
+
+            # Add navigation files
+            book.add_item(epub.EpubNcx())
+            book.add_item(epub.EpubNav())
+
+            # Add basic CSS
+            style = """
+                body {
+                    font-family: Georgia, serif;
+                    line-height: 1.6;
+                    margin: 2em;
+                }
+                h1, h2, h3, h4, h5, h6 {
+                    color: #333;
+                    margin-top: 1.5em;
+                    margin-bottom: 0.5em;
+                }
+                p {
+                    margin-bottom: 1em;
+                    text-align: justify;
+                }
+            """
+            nav_css = epub.EpubItem(
+                uid="style_nav",
+                file_name="style/nav.css",
+                media_type="text/css",
+                content=style
+            )
+            book.add_item(nav_css)
+
+            # Define spine (reading order)
+            book.spine = ['nav'] + chapters
+
+            # Write EPUB file
+            epub.write_epub(output_path, book, {})
+
+        except Exception as e:
+            raise FileProcessingError(f"Failed to write EPUB file: {str(e)}")
+
+    def _finalize_chapter(self, chapter, content_list):
+        """Finalize chapter with proper HTML structure"""
+        html_content = f"""
+        <html xmlns="http://www.w3.org/1999/xhtml">
+        <head>
+            <title>{chapter.title}</title>
+            <link rel="stylesheet" type="text/css" href="../style/nav.css"/>
+        </head>
+        <body>
+            {''.join(content_list)}
+        </body>
+        </html>
+        """
+        chapter.content = html_content
+
+    def _escape_html(self, text):
+        """Escape HTML special characters"""
+        return escape_html(text)
@@ -39,6 +39,7 @@ class QuickConverterTray:
         self.icon = None
         self.running = False
         self.main_window = None
+        self.watch_process = None
         self.config = self.load_config()
         
         # Add current directory to path
@@ -51,7 +52,11 @@ class QuickConverterTray:
             "show_notifications": True,
             "default_output_format": "markdown",
             "quick_convert_enabled": True,
-            "minimize_to_tray": True
+            "minimize_to_tray": True,
+            "watch_folder": "",
+            "watch_output_folder": "",
+            "watch_ocr": True,
+            "watch_on_start": False
         }
         
         if self.config_file.exists():
@@ -178,6 +183,70 @@ class QuickConverterTray:
         except Exception as e:
             self.show_error("Quick Convert Error", f"Failed to convert file: {e}")
     
+    def is_watching(self) -> bool:
+        """Whether the watch-folder ingest process is running"""
+        return self.watch_process is not None and self.watch_process.poll() is None
+
+    def start_watch(self, watch_folder: str, output_folder: str) -> bool:
+        """Start continuous ingest of a drop folder through the CLI's watch mode"""
+        cli_script = self.app_dir / "cli.py"
+        if not cli_script.exists():
+            self.show_error("CLI Not Found", "Command-line interface not available")
+            return False
+
+        cmd = [
+            sys.executable, str(cli_script), watch_folder, "-o", output_folder,
+            "-t", self.config.get("default_output_format", "markdown"),
+            "--recursive", "--watch", "--quiet"
+        ]
+        if self.config.get("watch_ocr", True):
+            cmd.append("--ocr")
+        self.watch_process = subprocess.Popen(cmd)
+        self.show_notification("Watching Folder", f"Converting new files in: {watch_folder}")
+        return True
+
+    def stop_watch(self):
+        """Stop the watch-folder process; its queue resumes on the next start"""
+        if self.is_watching():
+            self.watch_process.terminate()
+            try:
+                self.watch_process.wait(timeout=10)
+            except subprocess.TimeoutExpired:
+                self.watch_process.kill()
+        self.watch_process = None
+
+    def toggle_watch(self, icon=None, item=None):
+        """Pick a drop folder and start watching it, or stop the running watch"""
+        try:
+            if self.is_watching():
+                self.stop_watch()
+                self.config["watch_on_start"] = False
+                self.save_config()
+                self.show_notification("Watch Stopped", "No longer watching for new files")
+                return
+
+            root = tk.Tk()
+            root.withdraw()
+            watch_folder = filedialog.askdirectory(
+                title="Select folder to watch", initialdir=self.config.get("watch_folder") or None
+            )
+            output_folder = ""
+            if watch_folder:
+                output_folder = filedialog.askdirectory(
+                    title="Select output folder", initialdir=self.config.get("watch_output_folder") or None
+                )
+            root.destroy()
+
+            if watch_folder and output_folder and self.start_watch(watch_folder, output_folder):
+                self.config.update({
+                    "watch_folder": watch_folder,
+                    "watch_output_folder": output_folder,
+                    "watch_on_start": True
+                })
+                self.save_config()
+        except Exception as e:
+            self.show_error("Watch Folder Error", f"Failed to start watching: {e}")
+
     def show_settings(self, icon=None, item=None):
         """Show settings dialog"""
         settings_window = tk.Toplevel()
@@ -329,6 +398,7 @@ Features:
     def quit_app(self, icon=None, item=None):
         """Quit the tray application"""
         self.running = False
+        self.stop_watch()
         if self.icon:
             self.icon.stop()
     
@@ -341,6 +411,11 @@ Features:
         # Add quick convert if enabled
         if self.config.get("quick_convert_enabled", True):
             menu_items.append(pystray.MenuItem("Quick Convert File...", self.quick_convert_file))
+
+        menu_items.append(pystray.MenuItem(
+            lambda item: "Stop Watching Folder" if self.is_watching() else "Watch Folder...",
+            self.toggle_watch
+        ))
         
         menu_items.extend([
             pystray.Menu.SEPARATOR,
@@ -379,6 +454,11 @@ Features:
             
             threading.Thread(target=show_startup_notification, daemon=True).start()
         
+        # Resume the watch folder from the previous session
+        if (self.config.get("watch_on_start") and self.config.get("watch_folder")
+                and self.config.get("watch_output_folder") and Path(self.config["watch_folder"]).is_dir()):
+            self.start_watch(self.config["watch_folder"], self.config["watch_output_folder"])
+
         # Run the icon
         try:
             self.icon.run()
@@ -8,13 +8,33 @@ Author: Beau Lewis (blewisxx@gmail.com)
 Version: 3.1.0
 """
 
-from .ocr_engine import OCREngine
-from .image_processor import ImageProcessor
-from .format_detector import OCRFormatDetector
-from .ocr_integration import OCRIntegration
+import importlib
+
+# Submodules are imported on first attribute access so that importing a light
+# module such as ocr_engine.config_manager does not load numpy, OpenCV and the
+# OCR backends
+_LAZY_EXPORTS = {
+    'OCREngine': '.ocr_engine',
+    'ImageProcessor': '.image_processor',
+    'OCRFormatDetector': '.format_detector',
+    'OCRIntegration': '.ocr_integration',
+}
 
 __all__ = ['OCREngine', 'ImageProcessor', 'OCRFormatDetector', 'OCRIntegration']
 
+
+def __getattr__(name):
+    module_name = _LAZY_EXPORTS.get(name)
+    if module_name is None:
+        raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+    value = getattr(importlib.import_module(module_name, __name__), name)
+    globals()[name] = value
+    return value
+
+
+def __dir__():
+    return sorted(set(globals()) | set(__all__))
+
 # Version information
 __version__ = '3.1.0'
 __author__ = 'Beau Lewis'
@@ -0,0 +1,496 @@
+#!/usr/bin/env python3
+"""
+OCR Backend Router
+Routes each recognition to the first healthy backend, keeping per-backend
+latency and error-rate state with a circuit breaker, so a cloud outage costs
+a page one quick local fallback instead of a timeout plus retry sleeps
+"""
+
+import collections
+import heapq
+import itertools
+import logging
+import os
+import threading
+import time
+from concurrent.futures import FIRST_COMPLETED, Future, InvalidStateError, ThreadPoolExecutor, wait
+from typing import Any, Callable, Dict, List, Optional, Sequence, Tuple
+
+from converter_core.errors import JobCancelled
+from converter_core.metrics import METRICS
+from converter_core.scheduler import check_cancelled, current_job, job_context
+from .error_handler import OCRErrorHandler
+
+CLOSED = 'closed'
+OPEN = 'open'
+HALF_OPEN = 'half_open'
+
+# Gauge values for ocr_circuit_state
+_STATE_VALUES = {CLOSED: 0, HALF_OPEN: 1, OPEN: 2}
+
+# Backends reached over the network: only these are hedged and retried
+REMOTE_BACKENDS = frozenset({'google_vision'})
+
+# Seconds between cancellation checks while waiting on a backend
+_CANCEL_POLL = 0.25
+
+
+class BackendRoutingError(Exception):
+    """Raised when every candidate backend failed; ``failures`` maps backend to reason"""
+
+    def __init__(self, failures: Dict[str, str]):
+        self.failures = dict(failures)
+        super().__init__(", ".join(f"{name}: {reason}" for name, reason in self.failures.items())
+                         or "no OCR backend to try")
+
+
+class BackendHealth:
+    """
+    Rolling health of one backend and its circuit breaker
+
+    The circuit opens after ``failures`` consecutive failures, or when at
+    least ``error_rate`` of the last ``window`` calls failed (once half the
+    window has been seen). An open circuit rejects calls for ``cooldown``
+    seconds, then lets one probe through (half-open): a successful probe
+    closes it, a failed one reopens it with the cooldown doubled up to
+    ``max_cooldown``. Calls slower than ``slow_call`` seconds count as failures
+    when it is set.
+    """
+
+    def __init__(self, name: str, failures: int = 3, error_rate: float = 0.5, window: int = 20,
+                 cooldown: float = 30.0, max_cooldown: float = 300.0, slow_call: Optional[float] = None,
+                 latency_alpha: float = 0.2, clock: Callable[[], float] = time.monotonic):
+        self.name = name
+        self.failure_limit = max(1, int(failures))
+        self.error_rate_limit = error_rate
+        self.base_cooldown = cooldown
+        self.max_cooldown = max(cooldown, max_cooldown)
+        self.slow_call = slow_call
+        self.latency_alpha = latency_alpha
+        self.clock = clock
+        self._outcomes: "collections.deque[bool]" = collections.deque(maxlen=max(1, int(window)))
+        self._lock = threading.Lock()
+        self._state = CLOSED
+        self._consecutive = 0
+        self._cooldown = cooldown
+        self._opened_at = 0.0
+        self._probe_started: Optional[float] = None
+        self.latency: Optional[float] = None  # exponentially weighted, seconds
+        self.calls = 0
+        self.errors = 0
+        self.last_error: Optional[str] = None
+
+    @property
+    def state(self) -> str:
+        return self._state
+
+    @property
+    def error_rate(self) -> float:
+        with self._lock:
+            return sum(self._outcomes) / len(self._outcomes) if self._outcomes else 0.0
+
+    def retry_in(self) -> float:
+        """Seconds until an open circuit lets a probe through"""
+        with self._lock:
+            if self._state != OPEN:
+                return 0.0
+            return max(0.0, self._opened_at + self._cooldown - self.clock())
+
+    def allow(self) -> bool:
+        """Whether a call may go to this backend now; in half-open state this claims the probe"""
+        with self._lock:
+            if self._state == CLOSED:
+                return True
+            now = self.clock()
+            if self._state == OPEN:
+                if now < self._opened_at + self._cooldown:
+                    return False
+                self._set_state(HALF_OPEN)
+            # One probe at a time; a probe that never reported back is replaced after a cooldown
+            if self._probe_started is not None and now < self._probe_started + self._cooldown:
+                return False
+            self._probe_started = now
+            return True
+
+    def accepting(self) -> bool:
+        """Whether allow() would let a call through now, without claiming the probe"""
+        with self._lock:
+            if self._state == CLOSED:
+                return True
+            now = self.clock()
+            if self._state == OPEN:
+                return now >= self._opened_at + self._cooldown
+            return self._probe_started is None or now >= self._probe_started + self._cooldown
+
+    def release(self) -> None:
+        """Give back a probe slot without an outcome (the call was cancelled)"""
+        with self._lock:
+            self._probe_started = None
+
+    def record_success(self, latency: float) -> None:
+        if self.slow_call is not None and latency > self.slow_call:
+            self.record_failure(latency, f"slow call ({latency:.1f}s)")
+            return
+        with self._lock:
+            self._observe(latency, failed=False)
+            self._consecutive = 0
+            if self._state != CLOSED:
+                # Recovered: start again from a clean window and the base cooldown
+                self._outcomes.clear()
+                self._cooldown = self.base_cooldown
+                self._set_state(CLOSED)
+
+    def record_failure(self, latency: float, reason: str = '') -> None:
+        with self._lock:
+            self._observe(latency, failed=True)
+            self.errors += 1
+            self.last_error = reason
+            self._consecutive += 1
+            if self._state == HALF_OPEN:
+                self._cooldown = min(self._cooldown * 2, self.max_cooldown)
+                self._open()
+            elif self._state == CLOSED and self._tripped():
+                self._open()
+
+    def _observe(self, latency: float, failed: bool):
+        self.calls += 1
+        self._outcomes.append(failed)
+        self._probe_started = None
+        if self.latency is None:
+            self.latency = latency
+        else:
+            self.latency += self.latency_alpha * (latency - self.latency)
+
+    def _tripped(self) -> bool:
+        if self._consecutive >= self.failure_limit:
+            return True
+        seen = len(self._outcomes)
+        return seen * 2 >= self._outcomes.maxlen and sum(self._outcomes) / seen >= self.error_rate_limit
+
+    def _open(self):
+        self._opened_at = self.clock()
+        self._set_state(OPEN)
+
+    def _set_state(self, state: str):
+        if state == self._state:
+            return
+        self._state = state
+        METRICS.set_gauge('ocr_circuit_state', _STATE_VALUES[state], backend=self.name)
+        logging.getLogger("BackendRouter").log(
+            logging.WARNING if state == OPEN else logging.INFO,
+            f"OCR backend {self.name} circuit {state.replace('_', '-')}"
+            + (f" for {self._cooldown:g}s: {self.last_error}" if state == OPEN else '')
+        )
+
+    def snapshot(self) -> Dict[str, Any]:
+        with self._lock:
+            return {
+                'state': self._state,
+                'calls': self.calls,
+                'errors': self.errors,
+                'error_rate': sum(self._outcomes) / len(self._outcomes) if self._outcomes else 0.0,
+                'latency': self.latency,
+                'cooldown': self._cooldown,
+                'last_error': self.last_error
+            }
+
+
+class RetryTimer:
+    """
+    Runs callbacks after a delay from one daemon thread
+
+    Backoff waits live here as heap entries, so a request waiting to be
+    retried occupies no worker thread.
+    """
+
+    def __init__(self):
+        self._heap: List[Tuple[float, int, Callable[[], None]]] = []
+        self._seq = itertools.count()
+        self._cond = threading.Condition()
+        self._thread: Optional[threading.Thread] = None
+
+    def schedule(self, delay: float, fn: Callable[[], None]) -> None:
+        with self._cond:
+            heapq.heappush(self._heap, (time.monotonic() + max(0.0, delay), next(self._seq), fn))
+            if self._thread is None:
+                self._thread = threading.Thread(target=self._run, name="ocr-retry-timer", daemon=True)
+                self._thread.start()
+            self._cond.notify()
+
+    def _run(self):
+        while True:
+            with self._cond:
+                while not self._heap or self._heap[0][0] > time.monotonic():
+                    self._cond.wait(self._heap[0][0] - time.monotonic() if self._heap else None)
+                _, _, fn = heapq.heappop(self._heap)
+            try:
+                fn()
+            except Exception:
+                logging.getLogger("BackendRouter").exception("Scheduled OCR retry failed to start")
+
+
+_shared_timer: Optional[RetryTimer] = None
+_shared_timer_lock = threading.Lock()
+
+
+def shared_retry_timer() -> RetryTimer:
+    """The process-wide retry timer"""
+    global _shared_timer
+    with _shared_timer_lock:
+        if _shared_timer is None:
+            _shared_timer = RetryTimer()
+        return _shared_timer
+
+
+class BackendRouter:
+    """
+    Health-aware routing over an ordered list of OCR backends
+
+    ``run`` tries candidates in order, skipping a backend whose circuit is
+    open while another candidate remains. A failure moves straight on to the
+    next candidate without retrying or sleeping. With ``hedge_after`` set, a
+    remote request that has not answered within that many seconds is left
+    running and the next candidate starts beside it on the router's pool;
+    whichever succeeds first is returned, and the loser still reports its
+    outcome to the breaker.
+    Only a remote backend that is the last resort is retried, with backoff
+    waits held by the retry timer rather than a thread.
+
+    Config keys (the OCR engine config): ``circuit_failures``,
+    ``circuit_error_rate``, ``circuit_window``, ``circuit_cooldown``,
+    ``circuit_slow_call`` and ``hedge_after``; retry pacing comes from the
+    ``google_vision`` settings read by OCRErrorHandler.
+    """
+
+    def __init__(self, config: Optional[Dict[str, Any]] = None, logger: Optional[logging.Logger] = None,
+                 clock: Callable[[], float] = time.monotonic, timer: Optional[RetryTimer] = None):
+        self.config = config or {}
+        self.logger = logger or logging.getLogger("BackendRouter")
+        self.clock = clock
+        self.timer = timer or shared_retry_timer()
+        self.retry_policy = OCRErrorHandler(self.config.get('google_vision', {}))
+        self.hedge_after = self.config.get('hedge_after')
+        self._health: Dict[str, BackendHealth] = {}
+        self._lock = threading.Lock()
+        self._executor: Optional[ThreadPoolExecutor] = None
+
+    def health(self, name: str) -> BackendHealth:
+        with self._lock:
+            health = self._health.get(name)
+            if health is None:
+                health = self._health[name] = BackendHealth(
+                    name,
+                    failures=self.config.get('circuit_failures', 3),
+                    error_rate=self.config.get('circuit_error_rate', 0.5),
+                    window=self.config.get('circuit_window', 20),
+                    cooldown=self.config.get('circuit_cooldown', 30.0),
+                    slow_call=self.config.get('circuit_slow_call'),
+                    clock=self.clock
+                )
+            return health
+
+    def available(self, name: str) -> bool:
+        """Whether the backend's circuit lets a call through (claims a half-open probe)"""
+        return self.health(name).allow()
+
+    def get_stats(self) -> Dict[str, Dict[str, Any]]:
+        with self._lock:
+            healths = list(self._health.values())
+        return {health.name: health.snapshot() for health in healths}
+
+    def _pool(self) -> ThreadPoolExecutor:
+        with self._lock:
+            if self._executor is None:
+                # Remote calls mostly wait on the network, so allow plenty in flight
+                self._executor = ThreadPoolExecutor(max_workers=max(8, 2 * (os.cpu_count() or 1)),
+                                                    thread_name_prefix="ocr-router")
+            return self._executor
+
+    def call(self, name: str, fn: Callable[[str], Any]) -> Any:
+        """Run ``fn(name)`` in this thread, recording its latency and outcome"""
+        health = self.health(name)
+        start = time.perf_counter()
+        try:
+            result = fn(name)
+        except JobCancelled:
+            health.release()
+            raise
+        except Exception as e:
+            health.record_failure(time.perf_counter() - start, str(e))
+            METRICS.inc('ocr_backend_calls_total', backend=name, status='failure')
+            raise
+        health.record_success(time.perf_counter() - start)
+        METRICS.inc('ocr_backend_calls_total', backend=name, status='success')
+        return result
+
+    def submit(self, name: str, fn: Callable[[str], Any], attempts: int = 1) -> Future:
+        """
+        Run ``fn(name)`` on the router's pool, retrying transient failures
+
+        Up to ``attempts`` tries with the retry policy's backoff; each wait is
+        a retry-timer entry, not a sleeping thread. The calls run for the
+        caller's current job, so its cancellation reaches them. Cancelling the
+        returned future stops further retries (a call already running
+        finishes and is still recorded).
+        """
+        outer: Future = Future()
+        delay = self.retry_policy.retry_delay
+        job = current_job()
+
+        def attempt(number: int, delay: float):
+            if outer.cancelled():
+                return
+            try:
+                with job_context(job):
+                    result = self.call(name, fn)
+            except Exception as e:
+                retry = (number + 1 < attempts and not isinstance(e, JobCancelled)
+                         and self.retry_policy.is_retryable(e) and self.health(name).allow())
+                if not retry:
+                    _settle(outer, error=e)
+                    return
+                wait_time = self.retry_policy.retry_wait(e, delay)
+                self.logger.warning(f"{name} attempt {number + 1} failed, retrying in {wait_time:g}s: {e}")
+                next_delay = min(delay * self.retry_policy.backoff_multiplier, self.retry_policy.max_retry_delay)
+                self.timer.schedule(wait_time, lambda: self._pool().submit(attempt, number + 1, next_delay))
+                return
+            _settle(outer, result=result)
+
+        self._pool().submit(attempt, 0, delay)
+        return outer
+
+    def run(self, candidates: Sequence[str], call: Callable[[str], Any],
+            hedge_after: Optional[float] = None) -> Tuple[str, Any, Dict[str, str]]:
+        """
+        Recognise with the first candidate that succeeds
+
+        The calling thread waits for the answer, so a last-resort remote
+        retry keeps it waiting through the backoff (though no pool thread
+        sleeps, and a cancelled job stops the wait). Callers that must not
+        wait build on ``submit``, which returns a future.
+
+        Args:
+            candidates: Backend names, preferred first
+            call: ``call(name)`` runs one recognition on that backend
+            hedge_after: Seconds before a slow remote request is hedged with
+                the next candidate (defaults to the config's ``hedge_after``;
+                None disables hedging)
+
+        Returns:
+            (backend that answered, its result, reasons earlier candidates were passed over)
+
+        Raises:
+            BackendRoutingError: every candidate failed
+        """
+        if hedge_after is None:
+            hedge_after = self.hedge_after
+        reasons: Dict[str, str] = {}
+        hedged: Optional[Tuple[str, Future]] = None  # a slow remote request still in flight
+        for index, name in enumerate(candidates):
+            last = index == len(candidates) - 1
+            remote = name in REMOTE_BACKENDS
+            if not last and not self.available(name):
+                reasons[name] = f"circuit open, next probe in {self.health(name).retry_in():.0f}s"
+                METRICS.inc('ocr_backend_calls_total', backend=name, status='skipped')
+                continue
+            if hedged is not None:
+                # Race this candidate against the slow request
+                winner = self._race([hedged, (name, self.submit(name, call))], reasons)
+                hedged = None
+                if winner is not None:
+                    return winner[0], winner[1], reasons
+                continue
+            try:
+                if remote and not last and hedge_after is not None:
+                    future = self.submit(name, call)
+                    try:
+                        answered = self._wait(future, timeout=hedge_after)
+                    except JobCancelled:
+                        future.cancel()
+                        raise
+                    if not answered:
+                        # Keep the request running and start the next candidate beside it
+                        hedged = (name, future)
+                        reasons[name] = f"no answer within the {hedge_after:g}s hedge budget"
+                        METRICS.inc('ocr_hedged_requests_total', backend=name)
+                        continue
+                    result = future.result()
+                elif remote and last:
+                    # No fallback left, so transient failures are worth a retry
+                    future = self.submit(name, call, attempts=self.retry_policy.retry_attempts)
+                    try:
+                        self._wait(future)
+                    except JobCancelled:
+                        future.cancel()
+                        raise
+                    result = future.result()
+                else:
+                    result = self.call(name, call)
+            except JobCancelled:
+                raise
+            except Exception as e:
+                reasons[name] = str(e)
+                continue
+            return name, result, reasons
+        raise BackendRoutingError(reasons)
+
+    def _race(self, entrants: List[Tuple[str, Future]], reasons: Dict[str, str]) -> Optional[Tuple[str, Any]]:
+        """First successful (backend, result) among running requests, or None when all fail"""
+        running = list(entrants)
+        try:
+            while running:
+                # Entrants are in preference order, so a tie goes to the earlier one
+                finished = next((entrant for entrant in running if entrant[1].done()), None)
+                if finished is None:
+                    self._wait_any([future for _, future in running])
+                    continue
+                running.remove(finished)
+                name, future = finished
+                try:
+                    result = future.result()
+                except JobCancelled:
+                    raise
+                except Exception as e:
+                    reasons[name] = str(e)
+                    continue
+                reasons.pop(name, None)
+                return name, result
+            return None
+        finally:
+            # Losers stop retrying; a call already running finishes and is still recorded
+            for _, future in running:
+                future.cancel()
+
+    @staticmethod
+    def _wait(future: Future, timeout: Optional[float] = None) -> bool:
+        """Wait for ``future`` (up to ``timeout``), raising JobCancelled if the caller's job is cancelled"""
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while not future.done():
+            remaining = None if deadline is None else deadline - time.monotonic()
+            if remaining is not None and remaining <= 0:
+                return False
+            wait([future], timeout=min(_CANCEL_POLL, remaining) if remaining is not None else _CANCEL_POLL)
+            check_cancelled()
+        return True
+
+    @staticmethod
+    def _wait_any(futures: List[Future]) -> None:
+        wait(futures, timeout=_CANCEL_POLL, return_when=FIRST_COMPLETED)
+        check_cancelled()
+
+    def shutdown(self, wait: bool = False) -> None:
+        with self._lock:
+            executor, self._executor = self._executor, None
+        if executor is not None:
+            executor.shutdown(wait=wait)
+
+
+def _settle(future: Future, result: Any = None, error: Optional[BaseException] = None):
+    """Complete a future unless its caller already cancelled it"""
+    try:
+        if error is not None:
+            future.set_exception(error)
+        else:
+            future.set_result(result)
+    except InvalidStateError:
+        pass
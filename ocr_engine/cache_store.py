@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+"""
+Indexed OCR Result Cache
+SQLite-backed store for OCR text with full-content keys, TTL expiry,
+size-capped LRU eviction and per-entry confidence/metadata
+"""
+
+import hashlib
+import json
+import logging
+import mmap
+import sqlite3
+import threading
+import time
+from pathlib import Path
+from typing import Any, Dict, Optional, Union
+
+try:
+    import xxhash
+    _HASH_NAME = 'xxh3'
+    _new_hasher = xxhash.xxh3_128
+except ImportError:
+    try:
+        import blake3
+        _HASH_NAME = 'blake3'
+        _new_hasher = blake3.blake3
+    except ImportError:
+        _HASH_NAME = 'blake2b'
+        _new_hasher = lambda: hashlib.blake2b(digest_size=20)
+
+
+def new_content_hasher():
+    """
+    Create the fastest available full-content hasher
+
+    Prefers xxHash, then BLAKE3, then the standard library's BLAKE2b. The
+    algorithm name is part of every cache key, so switching libraries never
+    produces false hits.
+    """
+    return _new_hasher()
+
+
+def content_hash_name() -> str:
+    """Name of the hash algorithm used for cache keys"""
+    return _HASH_NAME
+
+
+def update_hasher_from_file(hasher, file_path: Union[str, Path]) -> None:
+    """Feed a whole file to a hasher through mmap, without reading it into memory"""
+    with open(file_path, 'rb') as f:
+        try:
+            with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mapped:
+                hasher.update(mapped)
+        except ValueError:
+            # Empty files cannot be mapped
+            hasher.update(b'')
+
+
+class OCRResultCache:
+    """
+    Persistent OCR result cache in a single SQLite file
+
+    Entries hold the recognised text, its confidence and a JSON metadata
+    blob. Reads skip and delete entries older than ``ttl`` seconds; writes
+    evict least-recently-used entries once the stored text exceeds
+    ``max_size_mb``. Statistics come from the index, never a directory scan.
+    """
+
+    SCHEMA_VERSION = 1
+
+    def __init__(self, cache_dir: Union[str, Path], ttl: Optional[float] = 86400,
+                 max_size_mb: float = 256, logger: Optional[logging.Logger] = None):
+        self.cache_dir = Path(cache_dir)
+        self.cache_dir.mkdir(parents=True, exist_ok=True)
+        self.db_path = self.cache_dir / "ocr_cache.sqlite3"
+        self.ttl = ttl
+        self.max_bytes = int(max_size_mb * 1024 * 1024)
+        self.logger = logger or logging.getLogger("OCRResultCache")
+        self._lock = threading.Lock()
+        self._conn = sqlite3.connect(str(self.db_path), check_same_thread=False, isolation_level=None)
+        self._init_schema()
+        self._total_size = self._conn.execute("SELECT COALESCE(SUM(size), 0) FROM entries").fetchone()[0]
+
+    def _init_schema(self):
+        """Create tables and indexes, resetting the store on schema changes"""
+        conn = self._conn
+        conn.execute("PRAGMA journal_mode=WAL")
+        conn.execute("PRAGMA synchronous=NORMAL")
+        version = conn.execute("PRAGMA user_version").fetchone()[0]
+        if version != self.SCHEMA_VERSION:
+            conn.execute("DROP TABLE IF EXISTS entries")
+            conn.execute(f"PRAGMA user_version={self.SCHEMA_VERSION}")
+        conn.execute(
+            """CREATE TABLE IF NOT EXISTS entries (
+                   key TEXT PRIMARY KEY,
+                   text TEXT NOT NULL,
+                   confidence REAL,
+                   metadata TEXT,
+                   size INTEGER NOT NULL,
+                   created REAL NOT NULL,
+                   accessed REAL NOT NULL
+               )"""
+        )
+        conn.execute("CREATE INDEX IF NOT EXISTS entries_accessed ON entries(accessed)")
+        conn.execute("CREATE INDEX IF NOT EXISTS entries_created ON entries(created)")
+
+    def _is_expired(self, created: float, now: float) -> bool:
+        return bool(self.ttl) and now - created > self.ttl
+
+    def get(self, key: str) -> Optional[Dict[str, Any]]:
+        """
+        Look up a cached result
+
+        Returns:
+            Dictionary with ``text``, ``confidence`` and ``metadata``, or None
+            on a miss or expired entry
+        """
+        now = time.time()
+        with self._lock:
+            row = self._conn.execute(
+                "SELECT text, confidence, metadata, size, created FROM entries WHERE key = ?", (key,)
+            ).fetchone()
+            if row is None:
+                return None
+            text, confidence, metadata, size, created = row
+            if self._is_expired(created, now):
+                self._conn.execute("DELETE FROM entries WHERE key = ?", (key,))
+                self._total_size -= size
+                return None
+            self._conn.execute("UPDATE entries SET accessed = ? WHERE key = ?", (now, key))
+
+        return {
+            'text': text,
+            'confidence': confidence,
+            'metadata': json.loads(metadata) if metadata else {},
+            'cached_at': created
+        }
+
+    def put(self, key: str, text: str, confidence: Optional[float] = None,
+            metadata: Optional[Dict[str, Any]] = None) -> None:
+        """Store a result, evicting old entries if the size cap is exceeded"""
+        metadata_json = json.dumps(metadata or {}, default=str)
+        size = len(text.encode('utf-8')) + len(metadata_json)
+        if size > self.max_bytes:
+            return
+        now = time.time()
+        with self._lock:
+            previous = self._conn.execute("SELECT size FROM entries WHERE key = ?", (key,)).fetchone()
+            self._conn.execute(
+                "INSERT OR REPLACE INTO entries (key, text, confidence, metadata, size, created, accessed) "
+                "VALUES (?, ?, ?, ?, ?, ?, ?)",
+                (key, text, confidence, metadata_json, size, now, now)
+            )
+            self._total_size += size - (previous[0] if previous else 0)
+            if self._total_size > self.max_bytes:
+                self._evict_locked()
+
+    def _evict_locked(self):
+        """Drop expired entries, then least-recently-used ones down to 90% of the cap"""
+        self.purge_expired(locked=True)
+        target = int(self.max_bytes * 0.9)
+        if self._total_size <= target:
+            return
+
+        evicted = 0
+        freed = 0
+        for key, size in self._conn.execute("SELECT key, size FROM entries ORDER BY accessed").fetchall():
+            if self._total_size - freed <= target:
+                break
+            self._conn.execute("DELETE FROM entries WHERE key = ?", (key,))
+            freed += size
+            evicted += 1
+        self._total_size -= freed
+        self.logger.debug(f"OCR cache evicted {evicted} entries ({freed} bytes)")
+
+    def purge_expired(self, locked: bool = False) -> int:
+        """Delete every entry past its TTL; returns the number removed"""
+        if not self.ttl:
+            return 0
+        cutoff = time.time() - self.ttl
+
+        def purge():
+            freed, count = self._conn.execute(
+                "SELECT COALESCE(SUM(size), 0), COUNT(*) FROM entries WHERE created < ?", (cutoff,)
+            ).fetchone()
+            if count:
+                self._conn.execute("DELETE FROM entries WHERE created < ?", (cutoff,))
+                self._total_size -= freed
+            return count
+
+        if locked:
+            return purge()
+        with self._lock:
+            return purge()
+
+    def clear(self) -> int:
+        """Remove every entry; returns the number removed"""
+        with self._lock:
+            count = self._conn.execute("SELECT COUNT(*) FROM entries").fetchone()[0]
+            self._conn.execute("DELETE FROM entries")
+            self._conn.execute("VACUUM")
+            self._total_size = 0
+        return count
+
+    def get_stats(self) -> Dict[str, Any]:
+        """Entry count, stored size and on-disk footprint from the index"""
+        with self._lock:
+            count, oldest = self._conn.execute("SELECT COUNT(*), MIN(created) FROM entries").fetchone()
+            total_size = self._total_size
+        disk_size = sum(
+            path.stat().st_size for path in self.cache_dir.glob(self.db_path.name + "*") if path.is_file()
+        )
+        return {
+            'file_count': count,
+            'entry_count': count,
+            'total_size': total_size,
+            'total_size_mb': round(total_size / (1024 * 1024), 2),
+            'disk_size': disk_size,
+            'max_size_mb': round(self.max_bytes / (1024 * 1024), 2),
+            'ttl': self.ttl,
+            'oldest_entry': oldest,
+            'hash': content_hash_name()
+        }
+
+    def close(self):
+        """Close the index connection"""
+        with self._lock:
+            self._conn.close()
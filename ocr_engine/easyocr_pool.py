@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""
+Shared EasyOCR Reader Pool
+Keeps a bounded set of warm EasyOCR readers that worker threads borrow,
+instead of every thread loading its own copy of the model weights
+"""
+
+import logging
+import queue
+import threading
+from contextlib import contextmanager
+from typing import Any, Dict, Iterator, List, Optional, Tuple
+
+import numpy as np
+
+try:
+    import easyocr
+    EASYOCR_AVAILABLE = True
+except ImportError:
+    EASYOCR_AVAILABLE = False
+
+
+def resolve_gpu(setting: Any) -> bool:
+    """Translate the easyocr_gpu setting (True/False/'auto') into a device choice"""
+    if setting == 'auto':
+        try:
+            import torch
+            return bool(torch.cuda.is_available())
+        except Exception:
+            return False
+    return bool(setting)
+
+
+class EasyOCRReaderPool:
+    """
+    Bounded pool of EasyOCR readers for one language set
+
+    Readers are created on demand up to ``size`` and handed out one caller at
+    a time; a caller that finds every reader busy waits for one to be returned
+    rather than loading another model. ``warm()`` pre-loads readers so the
+    first request does not pay the model load.
+    """
+
+    def __init__(self, languages: List[str], size: int = 1, gpu: bool = False,
+                 logger: Optional[logging.Logger] = None):
+        self.languages = list(languages)
+        self.size = max(1, int(size))
+        self.gpu = gpu
+        self.logger = logger or logging.getLogger("EasyOCRReaderPool")
+        self._idle: "queue.Queue[Any]" = queue.Queue()
+        self._created = 0
+        self._lock = threading.Lock()
+
+    def _create_reader(self):
+        """Load one EasyOCR model (the expensive part: seconds and hundreds of MB)"""
+        self.logger.info(
+            f"Loading EasyOCR reader {self._created}/{self.size} for {self.languages} "
+            f"({'GPU' if self.gpu else 'CPU'})"
+        )
+        return easyocr.Reader(self.languages, gpu=self.gpu, verbose=False)
+
+    def warm(self, count: Optional[int] = None) -> int:
+        """
+        Pre-load readers into the pool
+
+        Args:
+            count: Number of readers to have loaded (defaults to the pool size)
+
+        Returns:
+            Number of readers loaded by this call
+        """
+        target = min(self.size, count or self.size)
+        loaded = 0
+        while True:
+            with self._lock:
+                if self._created >= target:
+                    return loaded
+                self._created += 1
+            try:
+                self._idle.put(self._create_reader())
+                loaded += 1
+            except Exception:
+                with self._lock:
+                    self._created -= 1
+                raise
+
+    def warm_async(self, count: Optional[int] = None) -> threading.Thread:
+        """Warm the pool on a daemon thread so engine start-up is not blocked"""
+        def run():
+            try:
+                self.warm(count)
+            except Exception as e:
+                self.logger.warning(f"EasyOCR warm-up failed: {e}")
+
+        thread = threading.Thread(target=run, name="easyocr-warmup", daemon=True)
+        thread.start()
+        return thread
+
+    @contextmanager
+    def reader(self) -> Iterator[Any]:
+        """Borrow a reader for the duration of the block"""
+        try:
+            reader = self._idle.get_nowait()
+        except queue.Empty:
+            reader = None
+            with self._lock:
+                can_create = self._created < self.size
+                if can_create:
+                    self._created += 1
+            if can_create:
+                try:
+                    reader = self._create_reader()
+                except Exception:
+                    with self._lock:
+                        self._created -= 1
+                    raise
+            else:
+                reader = self._idle.get()
+        try:
+            yield reader
+        finally:
+            self._idle.put(reader)
+
+    def readtext(self, image: np.ndarray, **kwargs) -> List[Tuple]:
+        """Run recognition on one RGB or grayscale image"""
+        with self.reader() as reader:
+            return reader.readtext(image, **kwargs)
+
+    def readtext_batch(self, images: List[np.ndarray], batch_size: int = 8, **kwargs) -> List[List[Tuple]]:
+        """
+        Run recognition on several images with one borrowed reader
+
+        Images sharing a shape (pages rendered at one DPI, tiles of one image)
+        go through ``readtext_batched`` so the recognizer sees ``batch_size``
+        crops per forward pass; odd-sized images fall back to ``readtext``.
+
+        Returns:
+            One EasyOCR result list per input image, in input order
+        """
+        groups: Dict[Tuple[int, ...], List[int]] = {}
+        for index, image in enumerate(images):
+            groups.setdefault(tuple(image.shape), []).append(index)
+
+        results: List[Optional[List[Tuple]]] = [None] * len(images)
+        with self.reader() as reader:
+            for indices in groups.values():
+                if len(indices) == 1 or not hasattr(reader, 'readtext_batched'):
+                    for index in indices:
+                        results[index] = reader.readtext(images[index], batch_size=batch_size, **kwargs)
+                    continue
+
+                batch = reader.readtext_batched(
+                    [images[index] for index in indices], batch_size=batch_size, **kwargs
+                )
+                for index, result in zip(indices, batch):
+                    results[index] = result
+        return results
+
+    def get_stats(self) -> Dict[str, Any]:
+        """Pool size, loaded readers and device"""
+        return {
+            'languages': self.languages,
+            'size': self.size,
+            'loaded': self._created,
+            'idle': self._idle.qsize(),
+            'gpu': self.gpu
+        }
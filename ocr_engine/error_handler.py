@@ -91,6 +91,24 @@ class OCRErrorHandler:
             OCRErrorType.API_ERROR,
         }
     
+    def is_retryable(self, error: BaseException) -> bool:
+        """Whether retrying could help: OCR errors by type (also when wrapped), anything else yes"""
+        while error is not None:
+            if isinstance(error, OCRError):
+                return error.error_type in self.retryable_errors
+            error = error.__cause__
+        return True
+    
+    def retry_wait(self, error: BaseException, delay: float) -> float:
+        """
+        Seconds to wait before the next attempt: the backoff delay or a longer
+        server-requested wait, never more than max_retry_delay
+        """
+        while error is not None and not isinstance(error, OCRError):
+            error = error.__cause__
+        retry_after = error.details.get('retry_after') if error is not None else None
+        return min(max(delay, retry_after or 0), self.max_retry_delay)
+    
     def with_retry(self, 
                    func: Callable,
                    *args,
@@ -126,7 +144,7 @@ class OCRErrorHandler:
                 last_error = e
                 
                 # Don't retry permanent errors
-                if e.error_type not in self.retryable_errors:
+                if not self.is_retryable(e):
                     self.logger.error(f"Non-retryable error: {e}")
                     raise e
                 
@@ -135,12 +153,15 @@ class OCRErrorHandler:
                     self.logger.error(f"All retry attempts exhausted: {e}")
                     raise e
                 
+                # Honour a server-requested wait (e.g. quota retry delay) if longer
+                wait_time = self.retry_wait(e, current_delay)
+                
                 # Log retry attempt
                 self.logger.warning(
-                    f"Attempt {attempt + 1} failed, retrying in {current_delay}s: {e}"
+                    f"Attempt {attempt + 1} failed, retrying in {wait_time}s: {e}"
                 )
                 
-                time.sleep(current_delay)
+                time.sleep(wait_time)
                 current_delay = min(
                     current_delay * self.backoff_multiplier,
                     self.max_retry_delay
@@ -7,9 +7,11 @@ Provides Google Cloud Vision API integration for OCR functionality
 import os
 import logging
 import json
+import uuid
 from pathlib import Path
-from typing import Dict, Any, Optional, List
+from typing import Dict, Any, Optional, List, Tuple, Union, Callable
 import tempfile
+from concurrent.futures import ThreadPoolExecutor, wait, FIRST_COMPLETED
 
 try:
     from google.cloud import vision
@@ -18,12 +20,16 @@ try:
 except ImportError:
     GOOGLE_VISION_AVAILABLE = False
 
-from .error_handler import OCRError, OCRErrorType
+from .error_handler import OCRError, OCRErrorType, OCRErrorHandler
 
 
 class GoogleVisionBackend:
     """Google Vision API backend for OCR processing"""
     
+    # API limits: images per batch_annotate_images call, pages per inline file request
+    MAX_BATCH_IMAGES = 16
+    MAX_FILE_PAGES = 5
+    
     def __init__(self, config: Optional[Dict[str, Any]] = None, logger: Optional[logging.Logger] = None):
         """
         Initialize Google Vision backend
@@ -35,7 +41,9 @@ class GoogleVisionBackend:
         self.config = config or {}
         self.logger = logger or logging.getLogger("GoogleVisionBackend")
         self.client = None
+        self.credentials = None
         self.available = False
+        self.error_handler = OCRErrorHandler(self.config)
         
         # Initialize client if credentials are available
         self._initialize_client()
@@ -51,6 +59,7 @@ class GoogleVisionBackend:
             credentials = self._get_credentials()
             if credentials:
                 self.client = vision.ImageAnnotatorClient(credentials=credentials)
+                self.credentials = credentials
                 self.available = True
                 self.logger.info("Google Vision API client initialized successfully")
             else:
@@ -102,107 +111,458 @@ class GoogleVisionBackend:
         """Check if Google Vision API is available"""
         return self.available and self.client is not None
     
-    def extract_text(self, image_path: str, options: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
+    def extract_text(self, image_path: Union[str, bytes], options: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
         """
         Extract text from image using Google Vision API
         
         Args:
-            image_path: Path to the image file
+            image_path: Path to the image file, or encoded image bytes
             options: OCR options (languages, etc.)
             
         Returns:
             Dictionary with extracted text and metadata
         """
-        if not self.is_available():
-            raise OCRError(
-                "Google Vision API not available",
-                OCRErrorType.API_ERROR,
-                suggestion="Check API credentials and configuration"
-            )
+        self._require_available()
         
         try:
-            image_path = Path(image_path)
-            if not image_path.exists():
-                raise OCRError(
-                    f"Image file not found: {image_path}",
-                    OCRErrorType.IMAGE_NOT_FOUND
-                )
-            
-            # Read image file
-            with open(image_path, 'rb') as image_file:
-                content = image_file.read()
+            request = self._build_request(self._load_content(image_path), options)
+            response = self.client.annotate_image(request=request)
+            return self._parse_response(response)
             
-            # Create Vision API image object
-            image = vision.Image(content=content)
-            
-            # Configure text detection
-            features = [vision.Feature(type_=vision.Feature.Type.TEXT_DETECTION)]
+        except OCRError:
+            raise
+        except Exception as e:
+            raise self._classify_api_exception(e)
+    
+    def extract_text_batch(self,
+                           images: List[Union[str, bytes]],
+                           options: Optional[Dict[str, Any]] = None,
+                           progress_callback: Optional[Callable[[int, int], None]] = None) -> List[Dict[str, Any]]:
+        """
+        Extract text from many images with batched, concurrent API calls
+        
+        Images are packed into ``batch_annotate_images`` requests of up to
+        ``batch_size`` images and at most ``max_in_flight`` requests are
+        outstanding at once. Each request is retried with backoff through
+        OCRErrorHandler, honouring the server's retry delay on quota errors.
+        
+        Args:
+            images: Image paths or encoded image bytes
+            options: OCR options (languages, etc.)
+            progress_callback: Optional callback(done, total) per finished image
             
-            # Set language hints if provided
-            image_context = None
-            if options and 'languages' in options:
-                # Convert language codes to Google Vision format
-                language_hints = self._convert_language_codes(options['languages'])
-                if language_hints:
-                    image_context = vision.ImageContext(language_hints=language_hints)
+        Returns:
+            One result per input image, in input order. Images that fail carry
+            ``success: False`` and an ``error`` message instead of raising;
+            ``request_failed`` marks those whose API call itself failed and
+            ``unreadable`` those never sent because they could not be loaded.
+        """
+        self._require_available()
+        
+        total = len(images)
+        results: List[Optional[Dict[str, Any]]] = [None] * total
+        batch_size = max(1, min(int(self.config.get('batch_size', self.MAX_BATCH_IMAGES)), self.MAX_BATCH_IMAGES))
+        max_in_flight = max(1, int(self.config.get('max_in_flight', 4)))
+        done = 0
+        
+        def finish(index: int, result: Dict[str, Any]):
+            nonlocal done
+            results[index] = result
+            done += 1
+            if progress_callback:
+                progress_callback(done, total)
+        
+        def annotate(indices: List[int]):
+            requests, sent, unreadable = [], [], []
+            for index in indices:
+                try:
+                    requests.append(self._build_request(self._load_content(images[index]), options))
+                    sent.append(index)
+                except OCRError as e:
+                    unreadable.append((index, e))
+            responses = []
+            if requests:
+                responses = self.error_handler.with_retry(
+                    self._call_api, self.client.batch_annotate_images, requests
+                ).responses
+            return sent, responses, unreadable
+        
+        batches = [list(range(i, min(i + batch_size, total))) for i in range(0, total, batch_size)]
+        
+        with ThreadPoolExecutor(max_workers=max_in_flight) as executor:
+            pending = {}
+            batch_iter = iter(batches)
             
-            # Perform text detection
-            if image_context:
-                request = vision.AnnotateImageRequest(
-                    image=image,
-                    features=features,
-                    image_context=image_context
-                )
-                response = self.client.annotate_image(request=request)
-            else:
-                response = self.client.text_detection(image=image)
+            def submit_next() -> bool:
+                indices = next(batch_iter, None)
+                if indices is None:
+                    return False
+                pending[executor.submit(annotate, indices)] = indices
+                return True
             
-            # Check for errors
-            if response.error.message:
-                raise OCRError(
-                    f"Google Vision API error: {response.error.message}",
-                    OCRErrorType.API_ERROR
-                )
+            # Keep exactly max_in_flight requests outstanding; payloads for
+            # later batches are not read until a slot frees up
+            for _ in range(max_in_flight):
+                if not submit_next():
+                    break
             
-            # Extract text and confidence
-            text_annotations = response.text_annotations
-            if not text_annotations:
-                return {
-                    'text': '',
-                    'confidence': 0,
-                    'source': 'google_vision',
-                    'word_count': 0,
-                    'character_count': 0
-                }
+            while pending:
+                finished, _ = wait(list(pending), return_when=FIRST_COMPLETED)
+                for future in finished:
+                    indices = pending.pop(future)
+                    try:
+                        sent, responses, unreadable = future.result()
+                    except Exception as e:
+                        self.logger.error(f"Google Vision batch of {len(indices)} images failed: {e}")
+                        for index in indices:
+                            finish(index, {**self._error_result(e), 'request_failed': True})
+                    else:
+                        for index, error in unreadable:
+                            finish(index, {**self._error_result(error), 'unreadable': True})
+                        for index, response in zip(sent, responses):
+                            try:
+                                finish(index, self._parse_response(response))
+                            except OCRError as e:
+                                finish(index, self._error_result(e))
+                    submit_next()
+        
+        return results
+    
+    def extract_text_from_pdf(self,
+                              pdf_path: Union[str, Path],
+                              options: Optional[Dict[str, Any]] = None,
+                              start_page: int = 0,
+                              stop_page: Optional[int] = None,
+                              progress_callback: Optional[Callable[[int, int], None]] = None) -> Dict[str, Any]:
+        """
+        OCR a PDF with Vision's file annotation, without rasterising locally
+        
+        With ``gcs_bucket`` configured the PDF is uploaded once and read by a
+        single ``async_batch_annotate_files`` operation (a ``gs://`` URI is
+        referenced in place). Without a bucket the pages are split locally into
+        documents of five pages, the inline limit, which go to
+        ``batch_annotate_files`` concurrently; each page is sent exactly once.
+        
+        Args:
+            pdf_path: Local PDF path or ``gs://`` URI
+            options: OCR options (languages, etc.)
+            start_page: First page to return (0-based)
+            stop_page: Stop before this page (default: the end)
+            progress_callback: Optional callback(pages_done, total_pages)
             
-            # First annotation contains the full text
-            full_text = text_annotations[0].description
+        Returns:
+            Dictionary with the combined ``text`` and ``pages`` as
+            ``(page_index, text)`` pairs in page order
+        """
+        self._require_available()
+        
+        if str(pdf_path).startswith('gs://') or self.config.get('gcs_bucket'):
+            pages = self._annotate_pdf_async(str(pdf_path), options, start_page, stop_page, progress_callback)
+        else:
+            pages = self._annotate_pdf_inline(Path(pdf_path), options, start_page, stop_page, progress_callback)
+        
+        full_text = "".join(f"\n--- Page {page_num + 1} ---\n{text}\n" for page_num, text in pages).strip()
+        return {
+            'text': full_text,
+            'pages': pages,
+            'source': 'google_vision',
+            'word_count': len(full_text.split()),
+            'character_count': len(full_text)
+        }
+    
+    def _file_request(self, input_config, options: Optional[Dict[str, Any]], request_type=None, **fields):
+        """Create a document text detection request for a PDF"""
+        request = (request_type or vision.AnnotateFileRequest)(
+            input_config=input_config,
+            features=[vision.Feature(type_=vision.Feature.Type.DOCUMENT_TEXT_DETECTION)],
+            **fields
+        )
+        image_context = self._image_context(options)
+        if image_context:
+            request.image_context = image_context
+        return request
+    
+    def _annotate_pdf_inline(self, pdf_path: Path, options: Optional[Dict[str, Any]], start_page: int,
+                             stop_page: Optional[int],
+                             progress_callback: Optional[Callable[[int, int], None]]) -> List[Tuple[int, str]]:
+        """Send a PDF's pages inline as five-page documents, at most max_in_flight at once"""
+        try:
+            import fitz  # PyMuPDF
+        except ImportError:
+            raise OCRError("PyMuPDF not available to split the PDF for Google Vision", OCRErrorType.API_ERROR,
+                           suggestion="Install PyMuPDF or configure gcs_bucket for asynchronous annotation")
+        if not pdf_path.exists():
+            raise OCRError(f"PDF file not found: {pdf_path}", OCRErrorType.IMAGE_NOT_FOUND)
+        
+        def annotate(content: bytes, count: int):
+            request = self._file_request(
+                vision.InputConfig(content=content, mime_type='application/pdf'), options,
+                pages=list(range(1, count + 1))
+            )
+            response = self.error_handler.with_retry(
+                self._call_api, self.client.batch_annotate_files, [request]
+            ).responses[0]
+            if getattr(response, 'error', None) is not None and response.error.message:
+                raise OCRError(f"Google Vision API error: {response.error.message}", OCRErrorType.API_ERROR)
+            return [self._page_text(page) for page in response.responses]
+        
+        page_texts = {}
+        max_in_flight = max(1, int(self.config.get('max_in_flight', 4)))
+        
+        # PyMuPDF documents are not thread-safe, so the slices are cut here and
+        # only the requests run on the pool; unsent slices are not built yet
+        doc = fitz.open(str(pdf_path))
+        try:
+            start_page = max(0, start_page)
+            stop_page = len(doc) if stop_page is None else min(len(doc), stop_page)
+            total_pages = max(0, stop_page - start_page)
             
-            # Calculate average confidence from individual words
-            confidences = []
-            for annotation in text_annotations[1:]:  # Skip first one (full text)
-                if hasattr(annotation, 'confidence'):
-                    confidences.append(annotation.confidence * 100)
+            def collect(finished):
+                for future in finished:
+                    first = pending.pop(future)
+                    for offset, text in enumerate(future.result()):
+                        page_texts[first + offset] = text
+                    if progress_callback:
+                        progress_callback(len(page_texts), total_pages)
             
-            avg_confidence = sum(confidences) / len(confidences) if confidences else None
+            with ThreadPoolExecutor(max_workers=max_in_flight) as executor:
+                pending = {}
+                try:
+                    for first in range(start_page, stop_page, self.MAX_FILE_PAGES):
+                        last = min(first + self.MAX_FILE_PAGES, stop_page) - 1
+                        part = fitz.open()
+                        try:
+                            part.insert_pdf(doc, from_page=first, to_page=last)
+                            content = part.tobytes(garbage=3, deflate=True)
+                        finally:
+                            part.close()
+                        pending[executor.submit(annotate, content, last - first + 1)] = first
+                        if len(pending) >= max_in_flight:
+                            collect(wait(list(pending), return_when=FIRST_COMPLETED)[0])
+                    while pending:
+                        collect(wait(list(pending), return_when=FIRST_COMPLETED)[0])
+                finally:
+                    for future in pending:
+                        future.cancel()
+        finally:
+            doc.close()
+        
+        return [(page_num, page_texts.get(page_num, '')) for page_num in range(start_page, stop_page)]
+    
+    def _annotate_pdf_async(self, pdf_uri: str, options: Optional[Dict[str, Any]], start_page: int,
+                            stop_page: Optional[int],
+                            progress_callback: Optional[Callable[[int, int], None]]) -> List[Tuple[int, str]]:
+        """Annotate a PDF in Cloud Storage with one asynchronous operation, uploading it first if local"""
+        try:
+            from google.cloud import storage
+        except ImportError:
+            raise OCRError("google-cloud-storage not installed", OCRErrorType.API_ERROR,
+                           suggestion="Install google-cloud-storage for asynchronous PDF annotation")
+        
+        bucket_name = self.config.get('gcs_bucket')
+        if not bucket_name:
+            bucket_name = pdf_uri[len('gs://'):].split('/', 1)[0]
+        storage_client = storage.Client(project=self.config.get('gcs_project'), credentials=self.credentials)
+        bucket = storage_client.bucket(bucket_name)
+        job_prefix = f"{self.config.get('gcs_prefix', 'ocr').strip('/')}/{uuid.uuid4().hex}"
+        output_prefix = f"{job_prefix}/output/"
+        
+        uploaded = None
+        if not pdf_uri.startswith('gs://'):
+            pdf_path = Path(pdf_uri)
+            if not pdf_path.exists():
+                raise OCRError(f"PDF file not found: {pdf_path}", OCRErrorType.IMAGE_NOT_FOUND)
+            uploaded = bucket.blob(f"{job_prefix}/{pdf_path.name}")
+            self.error_handler.with_retry(uploaded.upload_from_filename, str(pdf_path),
+                                          content_type='application/pdf')
+            pdf_uri = f"gs://{bucket_name}/{uploaded.name}"
+        
+        page_texts = {}
+        try:
+            request = self._file_request(
+                vision.InputConfig(gcs_source=vision.GcsSource(uri=pdf_uri), mime_type='application/pdf'),
+                options, request_type=vision.AsyncAnnotateFileRequest,
+                output_config=vision.OutputConfig(
+                    gcs_destination=vision.GcsDestination(uri=f"gs://{bucket_name}/{output_prefix}"),
+                    batch_size=max(1, min(int(self.config.get('pdf_batch_size', 20)), 100))
+                )
+            )
+            operation = self.error_handler.with_retry(
+                self._call_api, self.client.async_batch_annotate_files, [request]
+            )
+            try:
+                operation.result(timeout=self.config.get('pdf_timeout', 600))
+            except Exception as e:
+                raise self._classify_api_exception(e)
             
+            # Each output file is an AnnotateFileResponse for batch_size pages
+            for blob in storage_client.list_blobs(bucket_name, prefix=output_prefix):
+                for response in json.loads(blob.download_as_bytes()).get('responses', []):
+                    page_num = response.get('context', {}).get('pageNumber', 0) - 1
+                    if response.get('error', {}).get('message'):
+                        self.logger.warning(f"Google Vision failed on page {page_num + 1} of {pdf_uri}: "
+                                            f"{response['error']['message']}")
+                        text = ''
+                    else:
+                        text = response.get('fullTextAnnotation', {}).get('text', '').strip()
+                    page_texts[page_num] = text
+        finally:
+            # The upload and the output files are scratch data for this call
+            try:
+                leftovers = list(storage_client.list_blobs(bucket_name, prefix=output_prefix))
+            except Exception as e:
+                self.logger.warning(f"Could not list gs://{bucket_name}/{output_prefix} for cleanup: {e}")
+                leftovers = []
+            for blob in ([uploaded] if uploaded is not None else []) + leftovers:
+                try:
+                    blob.delete()
+                except Exception as e:
+                    self.logger.warning(f"Could not remove gs://{bucket_name}/{blob.name}: {e}")
+        
+        # The async API always annotates the whole file; keep the requested range
+        total_pages = max(page_texts, default=-1) + 1
+        stop_page = total_pages if stop_page is None else min(total_pages, stop_page)
+        pages = [(page_num, page_texts.get(page_num, '')) for page_num in range(max(0, start_page), stop_page)]
+        if progress_callback:
+            progress_callback(len(pages), len(pages))
+        return pages
+    
+    @staticmethod
+    def _page_text(response) -> str:
+        """Full text of one page of a file annotation, raising its per-page error"""
+        if response.error.message:
+            raise OCRError(f"Google Vision API error: {response.error.message}", OCRErrorType.API_ERROR)
+        full_text = response.full_text_annotation.text
+        return full_text.strip() if full_text else ''
+    
+    def _require_available(self):
+        """Raise a configuration hint when the API client is not usable"""
+        if not self.is_available():
+            raise OCRError(
+                "Google Vision API not available",
+                OCRErrorType.API_ERROR,
+                suggestion="Check API credentials and configuration"
+            )
+    
+    def _load_content(self, image_path: Union[str, bytes]) -> bytes:
+        """Return encoded image bytes for a path or an in-memory image"""
+        if isinstance(image_path, (bytes, bytearray, memoryview)):
+            # Already-encoded image supplied by the caller; no file round trip
+            return bytes(image_path)
+        
+        image_path = Path(image_path)
+        if not image_path.exists():
+            raise OCRError(
+                f"Image file not found: {image_path}",
+                OCRErrorType.IMAGE_NOT_FOUND
+            )
+        
+        # Read image file
+        with open(image_path, 'rb') as image_file:
+            return image_file.read()
+    
+    def _image_context(self, options: Optional[Dict[str, Any]]):
+        """Build language hints from OCR options, if any"""
+        if options and 'languages' in options:
+            # Convert language codes to Google Vision format
+            language_hints = self._convert_language_codes(options['languages'])
+            if language_hints:
+                return vision.ImageContext(language_hints=language_hints)
+        return None
+    
+    def _build_request(self, content: bytes, options: Optional[Dict[str, Any]]):
+        """Create a text detection request for one encoded image"""
+        request = vision.AnnotateImageRequest(
+            image=vision.Image(content=content),
+            features=[vision.Feature(type_=vision.Feature.Type.TEXT_DETECTION)]
+        )
+        image_context = self._image_context(options)
+        if image_context:
+            request.image_context = image_context
+        return request
+    
+    def _call_api(self, method: Callable, requests: List[Any]):
+        """Send one batch call, mapping client failures to (retryable) OCR errors"""
+        try:
+            return method(requests=requests)
+        except Exception as e:
+            raise self._classify_api_exception(e)
+    
+    def _parse_response(self, response) -> Dict[str, Any]:
+        """Turn an AnnotateImageResponse into an OCR result dictionary"""
+        # Check for errors
+        if response.error.message:
+            raise OCRError(
+                f"Google Vision API error: {response.error.message}",
+                OCRErrorType.API_ERROR
+            )
+        
+        # Extract text and confidence
+        text_annotations = response.text_annotations
+        if not text_annotations:
             return {
-                'text': full_text.strip() if full_text else '',
-                'confidence': avg_confidence,
+                'text': '',
+                'confidence': 0,
                 'source': 'google_vision',
-                'word_count': len(full_text.split()) if full_text else 0,
-                'character_count': len(full_text) if full_text else 0,
-                'raw_response': response  # For advanced use cases
+                'word_count': 0,
+                'character_count': 0
             }
-            
-        except OCRError:
-            raise
-        except Exception as e:
-            raise OCRError(
-                f"Google Vision API processing failed: {e}",
-                OCRErrorType.API_ERROR,
-                original_error=e
+        
+        # First annotation contains the full text
+        full_text = text_annotations[0].description
+        
+        # Calculate average confidence from individual words
+        confidences = []
+        for annotation in text_annotations[1:]:  # Skip first one (full text)
+            if hasattr(annotation, 'confidence'):
+                confidences.append(annotation.confidence * 100)
+        
+        avg_confidence = sum(confidences) / len(confidences) if confidences else None
+        
+        return {
+            'text': full_text.strip() if full_text else '',
+            'confidence': avg_confidence,
+            'source': 'google_vision',
+            'word_count': len(full_text.split()) if full_text else 0,
+            'character_count': len(full_text) if full_text else 0,
+            'raw_response': response  # For advanced use cases
+        }
+    
+    def _classify_api_exception(self, error: Exception) -> OCRError:
+        """Map client exceptions to OCR errors, keeping quota waits for backoff"""
+        status = getattr(error, 'code', None)
+        status = getattr(status, 'value', status)
+        if isinstance(status, tuple):  # grpc.StatusCode values are (int, name)
+            status = status[0]
+        
+        if status in (429, 8, 503, 14):  # HTTP 429/503, gRPC RESOURCE_EXHAUSTED/UNAVAILABLE
+            retry_after = None
+            for detail in getattr(error, 'details', None) or []:
+                retry_delay = getattr(detail, 'retry_delay', None)
+                if retry_delay is not None:
+                    retry_after = retry_delay.seconds + retry_delay.nanos / 1e9
+            return OCRError(
+                f"Google Vision API rate limited: {error}",
+                OCRErrorType.TRANSIENT_ERROR,
+                details={'retry_after': retry_after} if retry_after else None,
+                original_error=error
             )
+        
+        return OCRError(
+            f"Google Vision API processing failed: {error}",
+            OCRErrorType.API_ERROR,
+            original_error=error
+        )
+    
+    @staticmethod
+    def _error_result(error: Exception) -> Dict[str, Any]:
+        """Per-image failure entry used by batch extraction"""
+        return {
+            'text': '',
+            'source': 'google_vision',
+            'error': str(error),
+            'success': False
+        }
     
     def _convert_language_codes(self, languages: List[str]) -> List[str]:
         """
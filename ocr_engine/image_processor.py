@@ -4,125 +4,382 @@ Image Processor for OCR - Handles image preprocessing and optimization
 
 import cv2
 import numpy as np
-from PIL import Image, ImageEnhance
+from PIL import Image
 from pathlib import Path
-from typing import Optional, Dict, Any
+from typing import Optional, Dict, Any, Union, Tuple
+import io
 import logging
+import math
+import threading
+import warnings
+
+# Anything ImageProcessor can load: a file path, an already decoded BGR or
+# grayscale array, or encoded image bytes (PNG, JPEG, ...)
+ImageSource = Union[str, Path, np.ndarray, bytes, bytearray, memoryview]
+
+# Scratch buffers larger than this (in pixels) are not kept between images
+MAX_POOLED_PIXELS = 4096 * 4096
+
+# Quality analysis runs on a thumbnail and a central crop of at most this size
+ANALYSIS_SIZE = 512
+
+# Estimated noise sigma (0-255 scale) above which denoising pays off; clean
+# renders and screenshots measure well below 1, phone photos and faxes 3-10
+NOISE_SIGMA_THRESHOLD = 2.5
+
+# 2nd-98th percentile spread of gray levels below which contrast is stretched
+LOW_CONTRAST_SPREAD = 150
+
+# Background brightness range across the page above which a global threshold
+# would lose text in the darker parts, so adaptive thresholding is used
+UNEVEN_BACKGROUND_RANGE = 40
+
+# Skew search range and step (degrees); smaller skews are left alone
+MAX_SKEW_DEGREES = 5.0
+SKEW_STEP_DEGREES = 0.5
+MIN_DESKEW_DEGREES = 1.0
+
+# Text OCRs best at about 300 DPI; scans below MIN_TEXT_DPI are upscaled
+TARGET_TEXT_DPI = 300
+MIN_TEXT_DPI = 200
+
+# Immerkaer's noise-estimation kernel: the difference of two Laplacians,
+# which cancels smooth image content
+_NOISE_KERNEL = np.array([[1, -2, 1], [-2, 4, -2], [1, -2, 1]], dtype=np.float32)
+
+_opencl_state: Optional[bool] = None
+
+
+def opencl_available() -> bool:
+    """Whether OpenCV can run the preprocessing on an OpenCL device (checked once)"""
+    global _opencl_state
+    if _opencl_state is None:
+        try:
+            _opencl_state = bool(cv2.ocl.haveOpenCL())
+            if _opencl_state:
+                cv2.ocl.setUseOpenCL(True)
+        except Exception:
+            _opencl_state = False
+    return _opencl_state
+
+
+class _ScratchBuffers:
+    """
+    Per-thread 8-bit images reused from one preprocess_image call to the next
+
+    Each slot keeps one flat allocation, grown to the largest image seen, and
+    hands out views of the requested shape, so a worker OCR'ing page after
+    page stops allocating intermediate images.
+    """
+
+    def __init__(self):
+        self._local = threading.local()
+
+    def get(self, slot: int, shape: Tuple[int, ...]) -> np.ndarray:
+        size = int(np.prod(shape))
+        if size > MAX_POOLED_PIXELS:
+            return np.empty(shape, dtype=np.uint8)
+        buffers = getattr(self._local, 'buffers', None)
+        if buffers is None:
+            buffers = self._local.buffers = {}
+        flat = buffers.get(slot)
+        if flat is None or flat.size < size:
+            flat = buffers[slot] = np.empty(size, dtype=np.uint8)
+        return flat[:size].reshape(shape)
+
 
 class ImageProcessor:
     """Handles image preprocessing for optimal OCR results"""
     
     def __init__(self, logger: Optional[logging.Logger] = None):
         self.logger = logger or logging.getLogger(__name__)
+        self._scratch = _ScratchBuffers()
     
-    def preprocess_image(self, image_path: str, options: Dict[str, Any] = None) -> np.ndarray:
+    def preprocess_image(self, image_path: ImageSource, options: Dict[str, Any] = None) -> np.ndarray:
         """
         Preprocess image for optimal OCR results
         
         Args:
-            image_path: Path to the image file
-            options: Preprocessing options
+            image_path: Path to the image file, a decoded numpy array, or encoded image bytes
+            options: Preprocessing options, see preprocess_with_plan()
             
         Returns:
-            Preprocessed image as numpy array
+            Preprocessed grayscale image as numpy array
+        """
+        return self.preprocess_with_plan(image_path, options)[0]
+    
+    def preprocess_with_plan(self, image_path: ImageSource,
+                             options: Dict[str, Any] = None) -> Tuple[np.ndarray, Dict[str, Any]]:
+        """
+        Preprocess an image and report which stages ran
+        
+        The image is reduced to grayscale first (files and bytes are decoded
+        straight to one channel), so every later stage touches a single
+        channel. With ``adaptive`` on (the default), a quick quality analysis
+        of the working image (see analyze_quality) decides which of deskew,
+        contrast, denoise and upscale are worth running and picks the
+        threshold, so a clean screenshot skips the expensive denoising that a
+        noisy fax needs. Intermediate images live in per-thread buffers
+        reused across calls; only the result is newly allocated, and an input
+        array is never modified.
+        
+        Args:
+            options: max_dimension (or resize_max); adaptive; enhance_contrast,
+                denoise, deskew and upscale (off forbids the stage, on lets
+                the analysis decide, or forces it when adaptive is off);
+                contrast_factor and denoise_strength (fixed values for
+                non-adaptive runs); threshold_method ('auto', 'adaptive',
+                'otsu', 'binary' or 'none'); and use_opencl (True, False or
+                'auto') to run the stages through cv2.UMat on an OpenCL device
+        
+        Returns:
+            (image, plan) where plan is ``{'adaptive', 'steps', 'quality',
+            ...stage parameters}``, suitable for result metadata
         """
         options = options or {}
         
         try:
-            # Load image
-            image = self.load_image(image_path)
+            use_umat = bool(options.get('use_opencl', False)) and opencl_available()
+            in_memory = isinstance(image_path, np.ndarray)
+            image = self._single_channel_view(self.load_image(image_path, grayscale=not in_memory))
+            shape = image.shape[:2]
+            steps = []
+            # Which scratch slot holds the current image (None: not a scratch buffer)
+            slot = None
             
-            # Apply preprocessing steps
-            image = self.resize_image(image, options.get('max_dimension', 2048))
-            image = self.enhance_contrast(image, options.get('contrast_factor', 1.5))
-            image = self.denoise_image(image, options.get('denoise', True))
+            def target(shape):
+                """Output buffer for the next stage; the UMat path lets OpenCL allocate"""
+                nonlocal slot
+                if use_umat:
+                    return None
+                slot = 1 if slot == 0 else 0
+                return self._scratch.get(slot, shape)
             
-            # Convert to grayscale for OCR
-            if len(image.shape) == 3:
-                image = cv2.cvtColor(image, cv2.COLOR_BGR2GRAY)
+            if image.ndim == 3:
+                conversion = self._gray_conversion(image)
+                if use_umat:
+                    image = cv2.cvtColor(cv2.UMat(image), conversion)
+                else:
+                    image = cv2.cvtColor(image, conversion, dst=target(image.shape[:2]))
+                steps.append('grayscale')
+            elif use_umat:
+                image = cv2.UMat(image)
             
-            # Apply thresholding
-            image = self.apply_threshold(image, options.get('threshold_method', 'adaptive'))
+            scale = 1.0
+            size = self._scaled_size(shape, options.get('max_dimension', options.get('resize_max', 2048)))
+            if size is not None:
+                scale = size[0] / shape[1]
+                image = cv2.resize(image, size, dst=target((size[1], size[0])), interpolation=cv2.INTER_AREA)
+                shape = (size[1], size[0])
+                steps.append('resize')
             
-            return image
+            if options.get('adaptive', True):
+                working = image.get() if use_umat else image
+                dpi = self.source_dpi(image_path)
+                quality = self.analyze_quality(working, dpi * scale if dpi else None)
+                plan = self.plan_stages(quality, options, shape)
+            else:
+                plan = self._fixed_plan(options)
+            
+            # Decoded images and scratch buffers are ours to overwrite; a
+            # caller's array is copied by the first stage that writes
+            def owned():
+                return use_umat or slot is not None or not in_memory
+            
+            if plan.get('deskew_angle'):
+                center = (shape[1] / 2, shape[0] / 2)
+                rotation = cv2.getRotationMatrix2D(center, plan['deskew_angle'], 1.0)
+                image = cv2.warpAffine(image, rotation, (shape[1], shape[0]), dst=target(shape),
+                                       flags=cv2.INTER_LINEAR, borderMode=cv2.BORDER_REPLICATE)
+                steps.append('deskew')
+            
+            if plan.get('contrast_factor'):
+                dst = None if use_umat else (image if owned() else target(shape))
+                # The image is single-channel by now; a UMat cannot report that itself
+                image = self.enhance_contrast(image, plan['contrast_factor'], dst=dst, channels=1)
+                steps.append('contrast')
+            
+            if plan.get('denoise_strength'):
+                image = self.denoise_image(image, True, dst=target(shape), strength=plan['denoise_strength'],
+                                           channels=1)
+                steps.append('denoise')
+            
+            if plan.get('upscale_to'):
+                width, height = plan['upscale_to']
+                image = cv2.resize(image, (width, height), dst=target((height, width)),
+                                   interpolation=cv2.INTER_CUBIC)
+                shape = (height, width)
+                steps.append('upscale')
+            
+            # Thresholding writes the result into a fresh array, so it can
+            # outlive the scratch buffers
+            method = plan['threshold_method']
+            result = self.apply_threshold(image, method, dst=None if use_umat else np.empty(shape, dtype=np.uint8))
+            if method in ('adaptive', 'otsu', 'binary'):
+                steps.append('threshold')
+            if use_umat:
+                result = result.get()
+            elif result is image and slot is not None:
+                result = image.copy()
+            
+            plan['steps'] = steps
+            if use_umat:
+                plan['opencl'] = True
+            return result, plan
             
         except Exception as e:
-            self.logger.error(f"Error preprocessing image {image_path}: {str(e)}")
+            self.logger.error(f"Error preprocessing image {self.describe_source(image_path)}: {str(e)}")
             raise
     
-    def load_image(self, image_path: str) -> np.ndarray:
-        """Load image using OpenCV"""
-        image = cv2.imread(image_path)
+    @staticmethod
+    def _single_channel_view(image: np.ndarray) -> np.ndarray:
+        """An (h, w, 1) array as (h, w), without copying"""
+        return image[:, :, 0] if image.ndim == 3 and image.shape[2] == 1 else image
+    
+    @staticmethod
+    def _channel_count(image) -> int:
+        """Channels of an array or cv2.UMat (a UMat has no shape, so it is downloaded to find out)"""
+        if not isinstance(image, np.ndarray):
+            image = image.get()
+        return image.shape[2] if image.ndim == 3 else 1
+    
+    @staticmethod
+    def _gray_conversion(image: np.ndarray) -> int:
+        return cv2.COLOR_BGRA2GRAY if image.shape[2] == 4 else cv2.COLOR_BGR2GRAY
+    
+    def load_image(self, image_path: ImageSource, grayscale: bool = False) -> np.ndarray:
+        """Load image using OpenCV
+
+        Arrays are returned as-is (preprocessing never modifies its input in
+        place) and encoded bytes are decoded straight from memory, so callers
+        holding a rendered page never need a temporary file. ``grayscale``
+        decodes to a single channel, a third of the memory for huge scans.
+        """
+        if isinstance(image_path, np.ndarray):
+            if grayscale and len(image_path.shape) == 3:
+                return cv2.cvtColor(image_path, cv2.COLOR_BGR2GRAY)
+            return image_path
+
+        flags = cv2.IMREAD_GRAYSCALE if grayscale else cv2.IMREAD_COLOR
+        if isinstance(image_path, (bytes, bytearray, memoryview)):
+            image = cv2.imdecode(np.frombuffer(image_path, dtype=np.uint8), flags)
+        else:
+            image = cv2.imread(str(image_path), flags)
         if image is None:
-            raise ValueError(f"Could not load image: {image_path}")
+            raise ValueError(f"Could not load image: {self.describe_source(image_path)}")
         return image
+
+    @staticmethod
+    def get_dimensions(image_path: ImageSource) -> Optional[Tuple[int, int]]:
+        """
+        (width, height) of an image without decoding its pixels
+        
+        Returns None when the header cannot be read. Images beyond PIL's
+        decompression-bomb limit are reported as oversized so callers tile them.
+        """
+        if isinstance(image_path, np.ndarray):
+            return image_path.shape[1], image_path.shape[0]
+        try:
+            source = io.BytesIO(image_path) if isinstance(image_path, (bytes, bytearray, memoryview)) else str(image_path)
+            with warnings.catch_warnings():
+                warnings.simplefilter('ignore', Image.DecompressionBombWarning)
+                with Image.open(source) as image:
+                    return image.size
+        except Image.DecompressionBombError:
+            return (2 ** 31, 2 ** 31)
+        except Exception:
+            return None
+    
+    @staticmethod
+    def describe_source(image_path: ImageSource) -> str:
+        """Human-readable label for an image source, used in logs and results"""
+        if isinstance(image_path, np.ndarray):
+            return f"<array {'x'.join(str(d) for d in image_path.shape)}>"
+        if isinstance(image_path, (bytes, bytearray, memoryview)):
+            return f"<{len(image_path)} bytes>"
+        return str(image_path)
+    
+    @staticmethod
+    def _scaled_size(shape: Tuple[int, ...], max_dimension: int) -> Optional[Tuple[int, int]]:
+        """(width, height) to resize to, or None when the image already fits"""
+        height, width = shape[:2]
+        if max(height, width) <= max_dimension:
+            return None
+        scale = max_dimension / max(height, width)
+        return int(width * scale), int(height * scale)
     
     def resize_image(self, image: np.ndarray, max_dimension: int = 2048) -> np.ndarray:
         """Resize image while maintaining aspect ratio"""
-        height, width = image.shape[:2]
-        
-        if max(height, width) > max_dimension:
-            scale = max_dimension / max(height, width)
-            new_width = int(width * scale)
-            new_height = int(height * scale)
-            image = cv2.resize(image, (new_width, new_height), interpolation=cv2.INTER_AREA)
-        
-        return image
+        size = self._scaled_size(image.shape, max_dimension)
+        if size is None:
+            return image
+        return cv2.resize(image, size, interpolation=cv2.INTER_AREA)
+    
+    @staticmethod
+    def _contrast_table(mean: float, factor: float) -> np.ndarray:
+        """Lookup table of PIL's ImageEnhance.Contrast: blend each level with the mean gray"""
+        mean = int(mean + 0.5)
+        levels = np.arange(256, dtype=np.float32)
+        return np.clip(mean + factor * (levels - mean) + 0.5, 0, 255).astype(np.uint8)
     
-    def enhance_contrast(self, image: np.ndarray, factor: float = 1.5) -> np.ndarray:
-        """Enhance image contrast"""
+    def enhance_contrast(self, image: np.ndarray, factor: float = 1.5,
+                         dst: Optional[np.ndarray] = None, channels: Optional[int] = None) -> np.ndarray:
+        """
+        Enhance image contrast
+        
+        Same result as PIL's ImageEnhance.Contrast, computed as one lookup
+        table pass. ``dst`` may be ``image`` itself to work in place.
+        ``channels`` saves looking it up (a cv2.UMat has to be downloaded).
+        """
+        if factor == 1.0:
+            return image
         try:
-            # Convert to PIL Image
-            if len(image.shape) == 3:
-                pil_image = Image.fromarray(cv2.cvtColor(image, cv2.COLOR_BGR2RGB))
+            if (channels or self._channel_count(image)) > 1:
+                # Mean luminance from the per-channel means (BGR order), as PIL's "L" mode weighs them
+                blue, green, red = cv2.mean(image)[:3]
+                mean = 0.299 * red + 0.587 * green + 0.114 * blue
             else:
-                pil_image = Image.fromarray(image)
-            
-            # Enhance contrast
-            enhancer = ImageEnhance.Contrast(pil_image)
-            enhanced = enhancer.enhance(factor)
-            
-            # Convert back to numpy array
-            if len(image.shape) == 3:
-                return cv2.cvtColor(np.array(enhanced), cv2.COLOR_RGB2BGR)
-            else:
-                return np.array(enhanced)
+                mean = cv2.mean(image)[0]
+            return cv2.LUT(image, self._contrast_table(mean, factor), dst=dst)
                 
         except Exception as e:
             self.logger.warning(f"Contrast enhancement failed: {str(e)}")
             return image
     
-    def denoise_image(self, image: np.ndarray, apply: bool = True) -> np.ndarray:
-        """Apply denoising to improve OCR accuracy"""
+    def denoise_image(self, image: np.ndarray, apply: bool = True,
+                      dst: Optional[np.ndarray] = None, strength: float = 10,
+                      channels: Optional[int] = None) -> np.ndarray:
+        """Apply denoising to improve OCR accuracy (``dst`` must not be ``image``)"""
         if not apply:
             return image
         
         try:
-            if len(image.shape) == 3:
+            if (channels or self._channel_count(image)) > 1:
                 # Color image
-                return cv2.fastNlMeansDenoisingColored(image, None, 10, 10, 7, 21)
+                return cv2.fastNlMeansDenoisingColored(image, dst, strength, strength, 7, 21)
             else:
                 # Grayscale image
-                return cv2.fastNlMeansDenoising(image, None, 10, 7, 21)
+                return cv2.fastNlMeansDenoising(image, dst, strength, 7, 21)
         except Exception as e:
             self.logger.warning(f"Denoising failed: {str(e)}")
             return image
     
-    def apply_threshold(self, image: np.ndarray, method: str = 'adaptive') -> np.ndarray:
+    def apply_threshold(self, image: np.ndarray, method: str = 'adaptive',
+                        dst: Optional[np.ndarray] = None) -> np.ndarray:
         """Apply thresholding to improve text contrast"""
         try:
             if method == 'adaptive':
                 # Adaptive thresholding works well for varying lighting
                 return cv2.adaptiveThreshold(
-                    image, 255, cv2.ADAPTIVE_THRESH_GAUSSIAN_C, cv2.THRESH_BINARY, 11, 2
+                    image, 255, cv2.ADAPTIVE_THRESH_GAUSSIAN_C, cv2.THRESH_BINARY, 11, 2, dst=dst
                 )
             elif method == 'otsu':
                 # Otsu's method for bimodal images
-                _, thresh = cv2.threshold(image, 0, 255, cv2.THRESH_BINARY + cv2.THRESH_OTSU)
+                _, thresh = cv2.threshold(image, 0, 255, cv2.THRESH_BINARY + cv2.THRESH_OTSU, dst=dst)
                 return thresh
             elif method == 'binary':
                 # Simple binary threshold
-                _, thresh = cv2.threshold(image, 127, 255, cv2.THRESH_BINARY)
+                _, thresh = cv2.threshold(image, 127, 255, cv2.THRESH_BINARY, dst=dst)
                 return thresh
             else:
                 return image
@@ -131,17 +388,180 @@ class ImageProcessor:
             self.logger.warning(f"Thresholding failed: {str(e)}")
             return image
     
-    def get_image_info(self, image_path: str) -> Dict[str, Any]:
-        """Get basic information about an image file"""
+    @staticmethod
+    def source_dpi(image_path: ImageSource) -> Optional[float]:
+        """Horizontal DPI recorded in a file's header, or None (arrays carry none)"""
+        if isinstance(image_path, np.ndarray):
+            return None
+        try:
+            source = io.BytesIO(image_path) if isinstance(image_path, (bytes, bytearray, memoryview)) else str(image_path)
+            with warnings.catch_warnings():
+                warnings.simplefilter('ignore', Image.DecompressionBombWarning)
+                with Image.open(source) as image:
+                    dpi = image.info.get('dpi')
+            return float(dpi[0]) if dpi and dpi[0] else None
+        except Exception:
+            return None
+    
+    def analyze_quality(self, gray: np.ndarray, dpi: Optional[float] = None) -> Dict[str, Any]:
+        """
+        Cheap quality measurements of a grayscale image, for plan_stages()
+        
+        Returns:
+            noise: Estimated noise sigma (Immerkaer's method on the flat areas
+                of a full-resolution central crop, so text edges do not count)
+            contrast_spread: 2nd to 98th percentile gray-level range
+            background_range: Brightness range of the background across a
+                4x4 grid, a measure of uneven lighting
+            skew: Degrees to rotate (cv2.getRotationMatrix2D convention) so
+                text lines run level, None when no text was found
+            dpi: Resolution of the working image, if the file recorded one
+        """
+        height, width = gray.shape[:2]
+        
+        top, left = max(0, (height - ANALYSIS_SIZE) // 2), max(0, (width - ANALYSIS_SIZE) // 2)
+        crop = gray[top:top + ANALYSIS_SIZE, left:left + ANALYSIS_SIZE].astype(np.float32)
+        noise = 0.0
+        if crop.shape[0] > 2 and crop.shape[1] > 2:
+            response = np.abs(cv2.filter2D(crop, -1, _NOISE_KERNEL))[1:-1, 1:-1]
+            gradient = (np.abs(cv2.Sobel(crop, cv2.CV_32F, 1, 0)) + np.abs(cv2.Sobel(crop, cv2.CV_32F, 0, 1)))[1:-1, 1:-1]
+            flat = gradient <= np.percentile(gradient, 80)
+            if flat.any():
+                noise = float(response[flat].mean() * math.sqrt(math.pi / 2) / 6)
+        
+        scale = min(1.0, ANALYSIS_SIZE / max(height, width))
+        thumb = gray if scale == 1.0 else cv2.resize(
+            gray, (max(1, int(width * scale)), max(1, int(height * scale))), interpolation=cv2.INTER_AREA)
+        
+        cumulative = np.cumsum(np.bincount(thumb.ravel(), minlength=256))
+        total = cumulative[-1]
+        low = int(np.searchsorted(cumulative, total * 0.02))
+        high = int(np.searchsorted(cumulative, total * 0.98))
+        
+        # Background: the bright end of each cell (dark text on a light page)
+        cells = [cell for band in np.array_split(thumb, 4, axis=0) for cell in np.array_split(band, 4, axis=1)
+                 if cell.size]
+        backgrounds = [float(np.percentile(cell, 90)) for cell in cells]
+        
+        return {
+            'noise': round(noise, 2),
+            'contrast_spread': high - low,
+            'background_range': round(max(backgrounds) - min(backgrounds), 1) if backgrounds else 0.0,
+            'skew': self._estimate_skew(thumb),
+            'dpi': round(dpi, 1) if dpi else None,
+        }
+    
+    @staticmethod
+    def _estimate_skew(thumb: np.ndarray) -> Optional[float]:
+        """
+        Rotation that makes the row profile of the ink sharpest
+        
+        Level text lines give rows that are all ink or all gap, so the
+        variance of the per-row ink counts peaks at the right angle. The
+        search rotates with the same matrix the deskew stage uses, so the
+        sign convention cannot disagree.
+        """
+        _, ink = cv2.threshold(thumb, 0, 1, cv2.THRESH_BINARY_INV + cv2.THRESH_OTSU)
+        ink_fraction = float(ink.mean())
+        if not 0.005 <= ink_fraction <= 0.5:
+            return None
+        height, width = ink.shape
+        center = (width / 2, height / 2)
+        
+        def sharpness(angle):
+            rotation = cv2.getRotationMatrix2D(center, angle, 1.0)
+            rotated = cv2.warpAffine(ink, rotation, (width, height), flags=cv2.INTER_NEAREST)
+            return float(rotated.sum(axis=1, dtype=np.float64).var())
+        
+        level = sharpness(0.0)
+        steps = int(MAX_SKEW_DEGREES / SKEW_STEP_DEGREES)
+        best_score, best_angle = max((sharpness(i * SKEW_STEP_DEGREES), i * SKEW_STEP_DEGREES)
+                                     for i in range(-steps, steps + 1))
+        # A flat optimum means no clear line structure (pictures, sparse text)
+        if best_score <= level * 1.1:
+            return 0.0
+        return best_angle
+    
+    def plan_stages(self, quality: Dict[str, Any], options: Dict[str, Any],
+                    shape: Tuple[int, int]) -> Dict[str, Any]:
+        """
+        Choose stage parameters from analyze_quality() results
+        
+        A stage switched off in ``options`` never runs; otherwise it runs
+        only when the measurements say it helps.
+        """
+        plan = {'adaptive': True, 'quality': quality}
+        
+        spread = quality['contrast_spread']
+        if options.get('enhance_contrast', True) and spread < LOW_CONTRAST_SPREAD:
+            plan['contrast_factor'] = round(min(3.0, max(1.2, 200 / max(spread, 1))), 2)
+        
+        if options.get('denoise', True) and quality['noise'] > NOISE_SIGMA_THRESHOLD:
+            # fastNlMeans strength tracks the noise level
+            plan['denoise_strength'] = int(round(min(15, max(5, quality['noise'] * 2))))
+        
+        skew = quality.get('skew')
+        if options.get('deskew', True) and skew and abs(skew) >= MIN_DESKEW_DEGREES:
+            plan['deskew_angle'] = skew
+        
+        dpi = quality.get('dpi')
+        height, width = shape
+        max_dimension = options.get('max_dimension', options.get('resize_max', 2048))
+        # Only trust the DPI of plausible page scans (3-17 inches wide): photos
+        # and screenshots often carry a meaningless 72
+        if options.get('upscale', True) and dpi and dpi < MIN_TEXT_DPI and 3 <= width / dpi <= 17:
+            factor = min(TARGET_TEXT_DPI / dpi, max_dimension / max(height, width))
+            if factor > 1.25:
+                plan['upscale_to'] = (int(width * factor), int(height * factor))
+        
+        method = options.get('threshold_method', 'auto')
+        if method == 'auto':
+            method = 'adaptive' if (quality['background_range'] > UNEVEN_BACKGROUND_RANGE or
+                                    'denoise_strength' in plan) else 'otsu'
+        plan['threshold_method'] = method
+        return plan
+    
+    @staticmethod
+    def plan_options(plan: Dict[str, Any]) -> Dict[str, Any]:
+        """Preprocessing options that apply a plan as-is, without analysing again"""
+        return {
+            'adaptive': False,
+            'enhance_contrast': bool(plan.get('contrast_factor')),
+            'contrast_factor': plan.get('contrast_factor'),
+            'denoise': bool(plan.get('denoise_strength')),
+            'denoise_strength': plan.get('denoise_strength'),
+            'threshold_method': plan['threshold_method'],
+        }
+    
+    @staticmethod
+    def _fixed_plan(options: Dict[str, Any]) -> Dict[str, Any]:
+        """The same stages for every image, as configured (adaptive off)"""
+        method = options.get('threshold_method', 'adaptive')
+        plan = {'adaptive': False, 'threshold_method': 'adaptive' if method == 'auto' else method}
+        if options.get('enhance_contrast', True):
+            plan['contrast_factor'] = options.get('contrast_factor', 1.5)
+        if options.get('denoise', True):
+            plan['denoise_strength'] = options.get('denoise_strength', 10)
+        return plan
+    
+    def get_image_info(self, image_path: ImageSource) -> Dict[str, Any]:
+        """Get basic information about an image file or in-memory image"""
         try:
             image = self.load_image(image_path)
             height, width = image.shape[:2]
             
+            if isinstance(image_path, np.ndarray):
+                file_size = image_path.nbytes
+            elif isinstance(image_path, (bytes, bytearray, memoryview)):
+                file_size = len(image_path)
+            else:
+                file_size = Path(image_path).stat().st_size
+            
             return {
                 'width': width,
                 'height': height,
                 'channels': image.shape[2] if len(image.shape) == 3 else 1,
-                'file_size': Path(image_path).stat().st_size
+                'file_size': file_size
             }
             
         except Exception as e:
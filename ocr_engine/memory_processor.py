@@ -7,10 +7,11 @@ Implements memory-safe image processing with size limits and chunking
 import cv2
 import numpy as np
 from pathlib import Path
-from typing import Generator, Tuple, Optional, Dict, Any
+from typing import Generator, Tuple, Optional, Dict, Any, List
 import logging
 import tempfile
 import gc
+import struct
 
 class MemoryLimitError(Exception):
     """Exception raised when memory limits are exceeded"""
@@ -128,6 +129,83 @@ class MemoryEfficientImageProcessor:
             self.logger.error(f"Error processing image chunks: {e}")
             raise
     
+    @staticmethod
+    def tile_positions(length: int, tile_size: int, overlap: int) -> List[int]:
+        """
+        Start offsets of overlapping tiles covering ``length`` pixels
+        
+        Every tile is exactly ``tile_size`` long (the last one is shifted back
+        to end at the edge) so tiles can share OCR batches.
+        """
+        if length <= tile_size:
+            return [0]
+        step = max(1, tile_size - overlap)
+        positions = list(range(0, length - tile_size, step))
+        positions.append(length - tile_size)
+        return positions
+    
+    @staticmethod
+    def tile_cores(positions: List[int], tile_size: int, length: int) -> List[Tuple[int, int]]:
+        """
+        Non-overlapping [start, end) span owned by each tile
+        
+        Neighbouring tiles split their overlap at its midpoint, so every pixel
+        (and every detected word centre) belongs to exactly one tile.
+        """
+        cores = []
+        for index, start in enumerate(positions):
+            core_start = 0 if index == 0 else (positions[index - 1] + tile_size + start) // 2
+            core_end = length if index == len(positions) - 1 else (start + tile_size + positions[index + 1]) // 2
+            cores.append((core_start, core_end))
+        return cores
+    
+    def iter_tiles(self, image: np.ndarray, tile_size: int,
+                   overlap: int = 128) -> Generator[Tuple[int, int, np.ndarray, Tuple[int, int, int, int]], None, None]:
+        """
+        Split an image into overlapping tiles without copying
+        
+        Args:
+            image: Full-resolution image
+            tile_size: Tile edge length in pixels
+            overlap: Pixels shared between neighbouring tiles
+            
+        Yields:
+            (x, y, tile view, core box (x0, y0, x1, y1) in image coordinates)
+        """
+        height, width = image.shape[:2]
+        xs = self.tile_positions(width, tile_size, overlap)
+        ys = self.tile_positions(height, tile_size, overlap)
+        x_cores = self.tile_cores(xs, tile_size, width)
+        y_cores = self.tile_cores(ys, tile_size, height)
+        
+        for y, (core_y0, core_y1) in zip(ys, y_cores):
+            for x, (core_x0, core_x1) in zip(xs, x_cores):
+                tile = image[y:y + tile_size, x:x + tile_size]
+                yield x, y, tile, (core_x0, core_y0, core_x1, core_y1)
+    
+    def plan_tile_size(self, image_info: Dict[str, Any], budget_bytes: int,
+                       min_tile: int = 512, max_tile: int = 4096) -> int:
+        """
+        Largest square tile whose estimated processing memory fits the budget
+        
+        Args:
+            image_info: Dictionary with 'channels' (width/height are ignored)
+            budget_bytes: Memory allowed for processing one tile
+            min_tile: Smallest useful tile edge
+            max_tile: Largest tile edge
+            
+        Returns:
+            Tile edge length in pixels
+        """
+        reference = 1000
+        per_pixel = self.estimate_memory_usage({
+            'width': reference,
+            'height': reference,
+            'channels': image_info.get('channels', 3)
+        }) / float(reference * reference)
+        edge = int((budget_bytes / per_pixel) ** 0.5) if per_pixel > 0 else max_tile
+        return max(min_tile, min(max_tile, edge))
+    
     def resize_image_if_needed(self, image: np.ndarray, 
                              max_dimension: Optional[int] = None) -> np.ndarray:
         """
@@ -227,6 +305,112 @@ class MemoryEfficientImageProcessor:
             self.logger.error(f"Error getting image info: {e}")
             return {}
     
+    @staticmethod
+    def read_image_header(image_path: str) -> Dict[str, Any]:
+        """
+        Read width, height and channel count from the file header without decoding pixels
+        
+        Supports PNG, JPEG, GIF, BMP, TIFF and WebP; returns {} for anything
+        else or a damaged header. Cheap enough to call on every file before
+        deciding whether it may start.
+        
+        Args:
+            image_path: Path to image file
+            
+        Returns:
+            Dictionary with 'width', 'height' and 'channels', or empty
+        """
+        try:
+            with open(image_path, 'rb') as f:
+                head = f.read(32)
+                if head.startswith(b'\x89PNG\r\n\x1a\n') and head[12:16] == b'IHDR':
+                    width, height = struct.unpack('>II', head[16:24])
+                    # Colour type: 0 grey, 2 RGB, 3 palette, 4 grey+alpha, 6 RGBA
+                    channels = {0: 1, 2: 3, 3: 3, 4: 2, 6: 4}.get(head[25], 3)
+                    return {'width': width, 'height': height, 'channels': channels}
+                if head[:6] in (b'GIF87a', b'GIF89a'):
+                    width, height = struct.unpack('<HH', head[6:10])
+                    return {'width': width, 'height': height, 'channels': 3}
+                if head[:2] == b'BM' and len(head) >= 26:
+                    width, height = struct.unpack('<ii', head[18:26])
+                    return {'width': abs(width), 'height': abs(height), 'channels': 3}
+                if head[:4] == b'RIFF' and head[8:12] == b'WEBP':
+                    chunk = head[12:16]
+                    if chunk == b'VP8X':
+                        width = int.from_bytes(head[24:27], 'little') + 1
+                        height = int.from_bytes(f.read(3), 'little') + 1
+                        return {'width': width, 'height': height, 'channels': 4}
+                    if chunk == b'VP8L':
+                        bits = int.from_bytes(head[21:25], 'little')
+                        return {'width': (bits & 0x3FFF) + 1, 'height': ((bits >> 14) & 0x3FFF) + 1,
+                                'channels': 4}
+                    if chunk == b'VP8 ':
+                        rest = f.read(2)
+                        width, height = struct.unpack('<HH', head[26:28] + rest)
+                        return {'width': width & 0x3FFF, 'height': height & 0x3FFF, 'channels': 3}
+                    return {}
+                if head[:2] == b'\xff\xd8':
+                    return MemoryEfficientImageProcessor._read_jpeg_header(f)
+                if head[:4] in (b'II*\x00', b'MM\x00*'):
+                    return MemoryEfficientImageProcessor._read_tiff_header(f, '<' if head[:2] == b'II' else '>')
+        except (OSError, struct.error, ValueError):
+            pass
+        return {}
+    
+    @staticmethod
+    def _read_jpeg_header(f) -> Dict[str, Any]:
+        """Walk JPEG markers up to the first start-of-frame segment"""
+        f.seek(2)
+        while True:
+            marker = f.read(2)
+            if len(marker) < 2 or marker[0] != 0xFF:
+                return {}
+            code = marker[1]
+            if code in (0xD8, 0x01) or 0xD0 <= code <= 0xD7:
+                continue
+            length = struct.unpack('>H', f.read(2))[0]
+            # SOF0-SOF15, except DHT (C4), JPG (C8) and DAC (CC)
+            if 0xC0 <= code <= 0xCF and code not in (0xC4, 0xC8, 0xCC):
+                _, height, width, channels = struct.unpack('>BHHB', f.read(6))
+                return {'width': width, 'height': height, 'channels': channels}
+            f.seek(length - 2, 1)
+    
+    @staticmethod
+    def _read_tiff_header(f, order: str) -> Dict[str, Any]:
+        """Read ImageWidth, ImageLength and SamplesPerPixel from the first IFD"""
+        f.seek(4)
+        f.seek(struct.unpack(order + 'I', f.read(4))[0])
+        tags = {}
+        for _ in range(struct.unpack(order + 'H', f.read(2))[0]):
+            tag, kind, _, value = struct.unpack(order + 'HHI4s', f.read(12))
+            if tag in (256, 257, 277):
+                # SHORT values sit in the first two bytes of the value field
+                tags[tag] = struct.unpack(order + ('H' if kind == 3 else 'I'), value[:2 if kind == 3 else 4])[0]
+        if 256 not in tags or 257 not in tags:
+            return {}
+        return {'width': tags[256], 'height': tags[257], 'channels': tags.get(277, 1)}
+    
+    def estimate_file_memory(self, image_path: str) -> int:
+        """
+        Estimate the peak memory of recognising an image file, before loading it
+        
+        Uses the header dimensions with estimate_memory_usage; unreadable
+        headers fall back to a multiple of the file size.
+        
+        Args:
+            image_path: Path to image file
+            
+        Returns:
+            Estimated memory usage in bytes
+        """
+        header = self.read_image_header(image_path)
+        if header:
+            return self.estimate_memory_usage(header)
+        try:
+            return Path(image_path).stat().st_size * 10
+        except OSError:
+            return 0
+    
     def estimate_memory_usage(self, image_info: Dict[str, Any]) -> int:
         """
         Estimate memory usage for image processing
@@ -11,11 +11,13 @@ import os
 import logging
 import time
 from pathlib import Path
-from typing import List, Dict, Any, Optional, Tuple, Callable
+from typing import List, Dict, Any, Optional, Tuple, Callable, Iterable, Iterator
+import collections
+import itertools
 import json
 import hashlib
 import tempfile
-from concurrent.futures import ThreadPoolExecutor, as_completed
+from concurrent.futures import ThreadPoolExecutor, as_completed, wait, FIRST_COMPLETED
 import threading
 import numpy as np
 
@@ -39,8 +41,17 @@ try:
 except ImportError:
     GOOGLE_VISION_AVAILABLE = False
 
-from .image_processor import ImageProcessor
+from .image_processor import ImageProcessor, ImageSource
+from .easyocr_pool import EasyOCRReaderPool, resolve_gpu
+from .tesseract_api import TesseractAPIPool, TESSEROCR_AVAILABLE
+from .memory_processor import memory_processor
+from .cache_store import OCRResultCache, new_content_hasher, content_hash_name, update_hasher_from_file
 from .format_detector import OCRFormatDetector
+from .backend_router import BackendRouter, BackendRoutingError
+from converter_core.backpressure import bounded_submit
+from converter_core.errors import JobCancelled
+from converter_core.metrics import METRICS
+from converter_core.scheduler import check_cancelled
 
 import tesseract_config  # Auto-configure Tesseract
 class OCREngineError(Exception):
@@ -77,6 +88,7 @@ class OCREngine:
         """
         self.config = config or {}
         self.logger = logger or logging.getLogger("OCREngine")
+        self.metrics = METRICS
         self.image_processor = ImageProcessor(self.logger)
         self.format_detector = OCRFormatDetector()
         
@@ -87,37 +99,83 @@ class OCREngine:
         # Initialize OCR backends
         self._initialize_backends()
         
-        # Thread-local storage for OCR readers
-        self._thread_local = threading.local()
+        # In-process Tesseract engines, one pool per language set and config
+        self._tesseract_pools: Dict[Tuple[Any, ...], TesseractAPIPool] = {}
+        self._tesseract_pools_lock = threading.Lock()
+        self._tesseract_api_failed = False
+        
+        # Shared EasyOCR reader pools, one per language set
+        self._easyocr_pools: Dict[Tuple[str, ...], EasyOCRReaderPool] = {}
+        self._easyocr_pools_lock = threading.Lock()
         
         # Configuration defaults
         self.default_config = {
             'backend': 'auto',
             'languages': ['en'],
             'use_cache': True,
-            'cache_ttl': 86400,  # 24 hours
+            'cache_ttl': 86400,  # 24 hours; 0 or None never expires
+            'cache_max_size_mb': 256,
             'preprocessing': {
                 'enhance_contrast': True,
                 'denoise': True,
                 'resize_max': 2048,
-                'threshold_method': 'adaptive'
+                'threshold_method': 'auto',  # 'auto' picks otsu or adaptive per image
+                'adaptive': True,  # analyse each image and skip stages it does not need
+                'use_opencl': False  # True or 'auto' runs preprocessing through cv2.UMat when OpenCL is present
             },
             'tesseract_config': '--oem 3 --psm 6',
-            'confidence_threshold': 30
+            'tesseract_engine': 'auto',  # 'api' (in-process tesserocr), 'cli' (pytesseract) or 'auto'
+            'tesseract_pool_size': None,  # None: one API per CPU
+            'confidence_threshold': 30,
+            'pdf_render_dpi': 200,
+            'pdf_min_text_chars': 50,
+            'pdf_ocr_workers': None,  # None uses one worker per CPU
+            'easyocr_gpu': False,  # True, False or 'auto' (use CUDA when torch sees it)
+            'easyocr_pool_size': None,  # None: 1 reader on GPU, else min(4, CPUs)
+            'easyocr_batch_size': 8,
+            'easyocr_warm_start': False,  # Also implied by backend='easyocr'
+            'tiled_ocr': True,  # Tile images larger than preprocessing allows instead of downsampling
+            'tile_memory_mb': None,  # Budget for all in-flight tiles; None uses the memory processor limit
+            'tile_overlap': 128,
+            'tile_max_size': 4096,
+            'tile_workers': None,  # None: min(4, CPUs)
+            'hedge_after': None,  # Seconds before a slow Google Vision request is raced by a local backend
+            'circuit_failures': 3,  # Consecutive failures that open a backend's circuit
+            'circuit_error_rate': 0.5,  # ...or this share of failures over the last circuit_window calls
+            'circuit_window': 20,
+            'circuit_cooldown': 30.0,  # Seconds an open circuit skips the backend before probing it
+            'circuit_slow_call': None  # Calls slower than this many seconds count as failures
         }
         
         # Merge user config with defaults
         self.config = {**self.default_config, **self.config}
+        
+        # Indexed result cache with TTL and size cap
+        self.result_cache = OCRResultCache(
+            self.cache_dir,
+            ttl=self.config['cache_ttl'],
+            max_size_mb=self.config['cache_max_size_mb'],
+            logger=self.logger
+        )
+        
+        # Per-backend health and circuit breakers for fallback routing
+        self.router = BackendRouter(self.config, self.logger)
+        
+        # Load EasyOCR models in the background when they are going to be used
+        if self.is_easyocr_available() and (
+                self.config['backend'] == 'easyocr' or self.config['easyocr_warm_start']):
+            self._get_easyocr_pool(self.config['languages']).warm_async()
 
     def _initialize_backends(self):
         """Initialize available OCR backends"""
         self.backends = {}
         
         # Tesseract OCR
-        if TESSERACT_AVAILABLE:
+        if TESSERACT_AVAILABLE or TESSEROCR_AVAILABLE:
             try:
-                # Test if tesseract is available
-                pytesseract.get_tesseract_version()
+                # tesserocr links libtesseract itself; only the CLI needs a binary
+                if not TESSEROCR_AVAILABLE:
+                    pytesseract.get_tesseract_version()
                 self.backends['tesseract'] = {
                     'name': 'Tesseract OCR',
                     'priority': 1,
@@ -232,245 +290,582 @@ class OCREngine:
             'priority': backend_info['priority']
         }
 
-    def _get_easyocr_reader(self, languages: List[str] = None):
-        """Get thread-local EasyOCR reader"""
-        if not hasattr(self._thread_local, 'easyocr_reader'):
-            if languages is None:
-                languages = self.config['languages']
-            self._thread_local.easyocr_reader = easyocr.Reader(
-                languages, 
-                gpu=False,  # Disable GPU for compatibility
-                verbose=False
-            )
-        return self._thread_local.easyocr_reader
-
-    def _get_cache_key(self, image_path: Path, options: Dict[str, Any]) -> str:
+    def _get_easyocr_pool(self, languages: List[str] = None) -> EasyOCRReaderPool:
+        """Get the shared EasyOCR reader pool for a language set"""
+        if languages is None:
+            languages = self.config['languages']
+        key = tuple(languages)
+        with self._easyocr_pools_lock:
+            pool = self._easyocr_pools.get(key)
+            if pool is None:
+                gpu = resolve_gpu(self.config.get('easyocr_gpu', False))
+                size = self.config.get('easyocr_pool_size')
+                if not size:
+                    # One GPU serialises inference anyway; on CPU each reader is a core's worth of work
+                    size = 1 if gpu else min(4, os.cpu_count() or 1)
+                pool = EasyOCRReaderPool(languages, size=size, gpu=gpu, logger=self.logger)
+                self._easyocr_pools[key] = pool
+            return pool
+
+    def _get_tesseract_pool(self, options: Dict[str, Any]) -> TesseractAPIPool:
+        """Get the shared Tesseract API pool for the options' languages and config"""
+        languages = options.get('languages', ['en'])
+        config = options.get('tesseract_config', '--oem 3 --psm 6')
+        key = (tuple(languages), config)
+        with self._tesseract_pools_lock:
+            pool = self._tesseract_pools.get(key)
+            if pool is None:
+                size = options.get('tesseract_pool_size') or os.cpu_count() or 1
+                pool = TesseractAPIPool(languages, config, size=size, logger=self.logger)
+                self._tesseract_pools[key] = pool
+            return pool
+
+    def _get_cache_key(self, image_path: ImageSource, options: Dict[str, Any]) -> str:
         """Generate cache key for OCR result"""
-        # Create hash from file content and options
-        hasher = hashlib.md5()
+        # Hash the full image content: scanner output often shares long
+        # headers, so a prefix hash collides across different pages
+        hasher = new_content_hasher()
         
-        # Add file content hash
-        if image_path.exists():
-            with open(image_path, 'rb') as f:
-                hasher.update(f.read(1024))  # First 1KB for speed
+        if isinstance(image_path, np.ndarray):
+            hasher.update(str((image_path.shape, image_path.dtype.str)).encode())
+            hasher.update(memoryview(np.ascontiguousarray(image_path)).cast('B'))
+        elif isinstance(image_path, (bytes, bytearray, memoryview)):
+            hasher.update(image_path)
+        elif Path(image_path).exists():
+            update_hasher_from_file(hasher, image_path)
         
         # Add options hash
-        options_str = json.dumps(options, sort_keys=True)
+        options_str = json.dumps(options, sort_keys=True, default=str)
         hasher.update(options_str.encode())
         
-        return hasher.hexdigest()
+        return f"{content_hash_name()}:{hasher.hexdigest()}"
 
-    def _load_from_cache(self, cache_key: str) -> Optional[str]:
-        """Load OCR result from cache"""
-        cache_file = self.cache_dir / f"{cache_key}.txt"
-        if cache_file.exists():
-            try:
-                with open(cache_file, 'r', encoding='utf-8') as f:
-                    return f.read()
-            except Exception as e:
-                self.logger.warning(f"Failed to load from cache: {e}")
-        return None
+    def _load_from_cache(self, cache_key: str) -> Optional[Dict[str, Any]]:
+        """Load OCR result (text, confidence, metadata) from cache"""
+        try:
+            entry = self.result_cache.get(cache_key)
+        except Exception as e:
+            self.logger.warning(f"Failed to load from cache: {e}")
+            entry = None
+        self.metrics.inc('cache_lookups_total', cache='ocr', result='miss' if entry is None else 'hit')
+        return entry
 
-    def _save_to_cache(self, cache_key: str, text: str) -> None:
+    def _save_to_cache(self, cache_key: str, result: Dict[str, Any]) -> None:
         """Save OCR result to cache"""
-        cache_file = self.cache_dir / f"{cache_key}.txt"
+        metadata = {
+            name: result[name] for name in ('backend', 'source', 'duration', 'fallback', 'fallback_backend', 'fallback_reason')
+            if name in result
+        }
         try:
-            with open(cache_file, 'w', encoding='utf-8') as f:
-                f.write(text)
+            self.result_cache.put(cache_key, result['text'], result.get('confidence'), metadata)
         except Exception as e:
             self.logger.warning(f"Failed to save to cache: {e}")
 
-    def extract_text(self, image_path: str, options: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
+    @staticmethod
+    def _cached_result(entry: Dict[str, Any]) -> Dict[str, Any]:
+        """Build an extraction result from a cache entry"""
+        text = entry['text']
+        return {
+            'text': text,
+            'source': 'cache',
+            'confidence': entry.get('confidence'),
+            'cached_backend': entry.get('metadata', {}).get('backend'),
+            'word_count': len(text.split()),
+            'character_count': len(text)
+        }
+
+    def extract_text(self, image_path: ImageSource, options: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
         """
         Extract text from an image using OCR
         
         Args:
-            image_path: Path to the image file
+            image_path: Path to the image file, a decoded BGR/grayscale numpy
+                array, or encoded image bytes. In-memory images skip all temp
+                file I/O and the decode round trip.
             options: OCR options (backend, languages, etc.)
             
         Returns:
             Dictionary with extracted text and metadata
-        """
-        image_path = Path(image_path)
-        if not image_path.exists():
-            raise FileNotFoundError(f"Image file not found: {image_path}")
         
-        if not self.format_detector.is_ocr_supported(str(image_path)):
-            raise ValueError(f"Unsupported image format: {image_path.suffix}")
+        The calling thread waits for the result: when Google Vision is the
+        only backend its retries keep the caller waiting through the backoff
+        (see BackendRouter.run).
+        """
+        in_memory = isinstance(image_path, (np.ndarray, bytes, bytearray, memoryview))
+        if not in_memory:
+            image_path = Path(image_path)
+            if not image_path.exists():
+                raise FileNotFoundError(f"Image file not found: {image_path}")
+            
+            if not self.format_detector.is_ocr_supported(str(image_path)):
+                raise ValueError(f"Unsupported image format: {image_path.suffix}")
         
         # Merge options with config
         ocr_options = {**self.config, **(options or {})}
         
         # Check cache first
+        cache_key = None
         if ocr_options.get('use_cache', True):
             cache_key = self._get_cache_key(image_path, ocr_options)
-            cached_text = self._load_from_cache(cache_key)
-            if cached_text:
-                return {
-                    'text': cached_text,
-                    'source': 'cache',
-                    'confidence': None,
-                    'word_count': len(cached_text.split()),
-                    'character_count': len(cached_text)
-                }
+            cached = self._load_from_cache(cache_key)
+            if cached is not None:
+                return self._cached_result(cached)
         
         # Select backend
         backend = ocr_options.get('backend', 'auto')
         if backend == 'auto':
             backend = self.get_preferred_backend()
         
-        # Preprocess image
-        try:
-            processed_image = self.image_processor.preprocess_image(
-                str(image_path), 
-                ocr_options.get('preprocessing', {})
-            )
-        except Exception as e:
-            raise ImageProcessingError(f"Image preprocessing failed: {e}")
+        # Preprocess lazily: Google Vision uploads the original image, so the
+        # local pipeline (denoise, threshold) only runs when a local backend
+        # consumes it, and at most once when Vision falls back
+        preprocessed = []
         
-        # Extract text based on backend with fallback support
-        start_time = time.time()
-        result = None
+        def processed_image():
+            if not preprocessed:
+                try:
+                    with self.metrics.timer('stage_seconds', stage='preprocess'):
+                        preprocessed.append(self.image_processor.preprocess_with_plan(
+                            image_path if in_memory else str(image_path),
+                            ocr_options.get('preprocessing', {})
+                        ))
+                except Exception as e:
+                    raise ImageProcessingError(f"Image preprocessing failed: {e}")
+                for step in preprocessed[0][1]['steps']:
+                    self.metrics.inc('preprocess_steps_total', step=step)
+            return preprocessed[0][0]
         
-        if backend == 'google_vision' and self.is_google_vision_available():
-            try:
-                result = self._extract_with_google_vision(str(image_path), ocr_options)
-            except Exception as e:
-                self.logger.warning(f"Google Vision API failed: {e}")
-                # Fallback to Tesseract if available
-                if self.is_tesseract_available():
-                    self.logger.info("Falling back to Tesseract OCR")
-                    try:
-                        result = self._extract_with_tesseract(processed_image, ocr_options)
-                        result['fallback'] = True
-                        result['fallback_reason'] = f"Google Vision failed: {str(e)}"
-                    except Exception as fallback_error:
-                        self.logger.error(f"Tesseract fallback also failed: {fallback_error}")
-                        raise OCRBackendError(f"Both Google Vision and Tesseract failed. Google Vision: {e}, Tesseract: {fallback_error}")
-                elif self.is_easyocr_available():
-                    self.logger.info("Falling back to EasyOCR")
-                    try:
-                        result = self._extract_with_easyocr(processed_image, ocr_options)
-                        result['fallback'] = True
-                        result['fallback_reason'] = f"Google Vision failed: {str(e)}"
-                    except Exception as fallback_error:
-                        self.logger.error(f"EasyOCR fallback also failed: {fallback_error}")
-                        raise OCRBackendError(f"Both Google Vision and EasyOCR failed. Google Vision: {e}, EasyOCR: {fallback_error}")
-                else:
-                    raise OCRBackendError(f"Google Vision failed and no fallback backends available: {e}")
+        # Oversized images are OCR'd as full-resolution tiles instead of being
+        # downsampled by preprocessing
+        def run_local(name):
+            if self._needs_tiling(image_path, ocr_options):
+                return self._extract_tiled(image_path, name, ocr_options)
+            if name == 'tesseract':
+                return self._extract_with_tesseract(processed_image(), ocr_options)
+            return self._extract_with_easyocr(processed_image(), ocr_options)
         
+        def run_backend(name):
+            if name == 'google_vision':
+                return self._extract_with_google_vision(image_path, ocr_options)
+            return run_local(name)
+        
+        # Google Vision falls back to the local backends; a local choice runs alone
+        if backend == 'google_vision' and self.is_google_vision_available():
+            candidates = ['google_vision'] + self._local_fallbacks()
         elif backend == 'tesseract' and self.is_tesseract_available():
-            result = self._extract_with_tesseract(processed_image, ocr_options)
+            candidates = ['tesseract']
         elif backend == 'easyocr' and self.is_easyocr_available():
-            result = self._extract_with_easyocr(processed_image, ocr_options)
+            candidates = ['easyocr']
         else:
+            self.metrics.inc('ocr_pages_total', backend=backend, status='unavailable')
             raise OCRBackendError(f"Selected backend '{backend}' is not available")
         
+        # The router skips backends with an open circuit and can hedge a slow
+        # Vision request (hedge_after) with the local fallback
+        start_time = time.time()
+        try:
+            used, result, passed_over = self.router.run(candidates, run_backend, ocr_options.get('hedge_after'))
+        except BackendRoutingError as e:
+            self.metrics.inc('ocr_pages_total', backend=backend, status='failure')
+            raise OCRBackendError(f"OCR failed on every backend: {e}") from e
+        
         if result is None:
             raise OCRBackendError("OCR extraction failed - no result generated")
+        if used != backend:
+            reason = ", ".join(f"{self.backends[name]['name']}: {why}" for name, why in passed_over.items())
+            self.logger.info(f"Fell back to {self.backends[used]['name']} ({reason})")
+            result['fallback'] = True
+            result['fallback_backend'] = used
+            result['fallback_reason'] = reason
         
         duration = time.time() - start_time
+        # Recognition time only: preprocessing is recorded as its own stage
+        self.metrics.observe('stage_seconds', duration, stage='ocr', backend=backend)
+        self.metrics.inc('ocr_pages_total', backend=backend,
+                         status='fallback' if result.get('fallback') else 'success')
         
         # Add metadata
         result.update({
             'backend': backend,
             'duration': duration,
-            'image_path': str(image_path),
+            'image_path': ImageProcessor.describe_source(image_path),
             'word_count': len(result['text'].split()),
             'character_count': len(result['text'])
         })
+        if preprocessed:
+            # Which stages the quality analysis chose for this image
+            result['preprocessing'] = preprocessed[0][1]
         
         # Cache result
-        if ocr_options.get('use_cache', True):
-            cache_key = self._get_cache_key(image_path, ocr_options)
-            self._save_to_cache(cache_key, result['text'])
+        if cache_key:
+            self._save_to_cache(cache_key, result)
         
         return result
 
+    def _local_fallbacks(self) -> List[str]:
+        """Local backends to fall back to from Google Vision, in preference order"""
+        return [name for name, available in (('tesseract', self.is_tesseract_available()),
+                                              ('easyocr', self.is_easyocr_available())) if available]
+
+    def get_backend_health(self) -> Dict[str, Dict[str, Any]]:
+        """Circuit state, error rate and latency of every backend the router has used"""
+        return self.router.get_stats()
+
     def _extract_with_tesseract(self, image: np.ndarray, options: Dict[str, Any]) -> Dict[str, Any]:
         """Extract text using Tesseract OCR"""
         try:
-            # Convert numpy array to PIL Image
-            if len(image.shape) == 3:
-                pil_image = Image.fromarray(cv2.cvtColor(image, cv2.COLOR_BGR2RGB))
-            else:
-                pil_image = Image.fromarray(image)
-            
-            # Extract text
-            text = pytesseract.image_to_string(
-                pil_image,
-                lang='+'.join(options.get('languages', ['en'])),
-                config=options.get('tesseract_config', '--oem 3 --psm 6')
-            )
-            
-            # Get confidence data
-            try:
-                data = pytesseract.image_to_data(
-                    pil_image,
-                    lang='+'.join(options.get('languages', ['en'])),
-                    output_type=pytesseract.Output.DICT
-                )
-                confidences = [int(conf) for conf in data['conf'] if int(conf) > 0]
-                avg_confidence = sum(confidences) / len(confidences) if confidences else 0
-            except:
-                avg_confidence = None
-            
+            recognised = self._recognize_tesseract(image, options)
             return {
-                'text': text.strip(),
-                'confidence': avg_confidence,
-                'source': 'tesseract'
+                'text': recognised['text'].strip(),
+                'confidence': recognised['confidence'],
+                'source': 'tesseract',
+                'tesseract_engine': recognised['engine']
             }
             
+        except OCRBackendError:
+            raise
         except Exception as e:
             raise OCRBackendError(f"Tesseract OCR failed: {e}")
 
+    def _use_tesseract_api(self, options: Dict[str, Any]) -> bool:
+        """Whether Tesseract runs in-process through tesserocr rather than as a pytesseract subprocess"""
+        engine = options.get('tesseract_engine', 'auto')
+        if engine == 'cli':
+            return False
+        if engine == 'api':
+            if not TESSEROCR_AVAILABLE:
+                raise OCRBackendError("tesseract_engine 'api' needs tesserocr. Install with: pip install tesserocr")
+            return True
+        return TESSEROCR_AVAILABLE and not (self._tesseract_api_failed and TESSERACT_AVAILABLE)
+
+    def _recognize_tesseract(self, image: np.ndarray, options: Dict[str, Any]) -> Dict[str, Any]:
+        """
+        One Tesseract recognition pass over a preprocessed image
+        
+        Returns text, average word confidence and (x, y, w, h, text,
+        confidence) word boxes together. The in-process API reads the numpy
+        buffer directly; the pytesseract fallback makes a single
+        image_to_data call and rebuilds the text from its lines.
+        """
+        if len(image.shape) == 3:
+            # Tesseract expects RGB channel order
+            image = image[:, :, 2::-1] if image.shape[2] >= 3 else image[:, :, 0]
+        
+        if self._use_tesseract_api(options):
+            try:
+                result = self._get_tesseract_pool(options).recognize(image)
+                result['engine'] = 'api'
+                return result
+            except Exception as e:
+                if options.get('tesseract_engine', 'auto') == 'api' or not TESSERACT_AVAILABLE:
+                    raise OCRBackendError(f"Tesseract API failed: {e}")
+                # A missing language model or broken tessdata: stop retrying
+                # the API and keep going with the CLI
+                self._tesseract_api_failed = True
+                self.logger.warning(f"Tesseract API unavailable, using the tesseract CLI: {e}")
+        
+        data = pytesseract.image_to_data(
+            Image.fromarray(np.ascontiguousarray(image)),
+            lang='+'.join(options.get('languages', ['en'])),
+            config=options.get('tesseract_config', '--oem 3 --psm 6'),
+            output_type=pytesseract.Output.DICT
+        )
+        words = []
+        for index, text in enumerate(data['text']):
+            confidence = float(data['conf'][index])
+            if text.strip() and confidence >= 0:
+                words.append((data['left'][index], data['top'][index],
+                              data['width'][index], data['height'][index], text.strip(), confidence))
+        confidences = [word[5] for word in words if word[5] > 0]
+        return {
+            'text': self._text_from_tesseract_data(data),
+            'confidence': sum(confidences) / len(confidences) if confidences else 0,
+            'words': words,
+            'engine': 'cli'
+        }
+
+    @staticmethod
+    def _text_from_tesseract_data(data: Dict[str, List[Any]]) -> str:
+        """Text laid out as image_to_string would: words by line, a blank line between paragraphs"""
+        paragraphs = []
+        lines: List[List[str]] = []
+        paragraph_key = line_key = None
+        for index, text in enumerate(data['text']):
+            if not str(text).strip():
+                continue
+            paragraph = (data['block_num'][index], data['par_num'][index])
+            line = paragraph + (data['line_num'][index],)
+            if paragraph != paragraph_key:
+                if lines:
+                    paragraphs.append('\n'.join(' '.join(words) for words in lines))
+                lines = []
+                paragraph_key = paragraph
+                line_key = None
+            if line != line_key:
+                lines.append([])
+                line_key = line
+            lines[-1].append(str(text).strip())
+        if lines:
+            paragraphs.append('\n'.join(' '.join(words) for words in lines))
+        return '\n\n'.join(paragraphs)
+
+    def _tile_memory_budget(self, options: Dict[str, Any]) -> int:
+        """Bytes of processing memory allowed across all in-flight tiles"""
+        budget_mb = options.get('tile_memory_mb') or memory_processor.max_memory_mb
+        return int(budget_mb * 1024 * 1024)
+
+    def _needs_tiling(self, image_path: ImageSource, options: Dict[str, Any]) -> bool:
+        """True when an image is too large to OCR whole without losing resolution"""
+        if not options.get('tiled_ocr', True):
+            return False
+        dimensions = self.image_processor.get_dimensions(image_path)
+        if dimensions is None:
+            return False
+        width, height = dimensions
+        preprocessing = options.get('preprocessing', {})
+        max_dimension = preprocessing.get('max_dimension', preprocessing.get('resize_max', 2048))
+        estimated = memory_processor.estimate_memory_usage({'width': width, 'height': height, 'channels': 1})
+        return max(width, height) > max_dimension or estimated > self._tile_memory_budget(options)
+
+    def _tile_words(self, tile: np.ndarray, backend: str, options: Dict[str, Any]) -> List[Tuple[int, int, int, int, str, float]]:
+        """OCR one preprocessed tile into (x, y, w, h, text, confidence) word boxes"""
+        if backend == 'tesseract':
+            return self._recognize_tesseract(tile, options)['words']
+        
+        pool = self._get_easyocr_pool(options.get('languages', ['en']))
+        words = []
+        for bbox, text, confidence in pool.readtext(self._easyocr_input(tile)):
+            if confidence >= options.get('confidence_threshold', 30):
+                xs = [point[0] for point in bbox]
+                ys = [point[1] for point in bbox]
+                words.append((int(min(xs)), int(min(ys)), int(max(xs) - min(xs)), int(max(ys) - min(ys)),
+                              text, confidence))
+        return words
+
+    @staticmethod
+    def _merge_words(words: List[Tuple[int, int, int, int, str, float]]) -> str:
+        """Lay out word boxes in reading order: lines top to bottom, words left to right"""
+        if not words:
+            return ''
+        heights = sorted(word[3] for word in words)
+        line_height = max(1, heights[len(heights) // 2])
+        
+        lines = []
+        for word in sorted(words, key=lambda word: word[1] + word[3] / 2):
+            centre = word[1] + word[3] / 2
+            if lines and abs(centre - lines[-1][0]) <= line_height / 2:
+                lines[-1][1].append(word)
+            else:
+                lines.append([centre, [word]])
+        
+        text_lines = []
+        previous_centre = None
+        for centre, line_words in lines:
+            # A gap of more than one blank line's height starts a new paragraph
+            if previous_centre is not None and centre - previous_centre > line_height * 2.5:
+                text_lines.append('')
+            text_lines.append(' '.join(word[4] for word in sorted(line_words, key=lambda word: word[0])))
+            previous_centre = centre
+        return '\n'.join(text_lines)
+
+    def _extract_tiled(self, image_path: ImageSource, backend: str, options: Dict[str, Any]) -> Dict[str, Any]:
+        """
+        OCR a large image as overlapping full-resolution tiles
+        
+        The image is decoded once in grayscale and split into views by
+        MemoryEfficientImageProcessor. Tile size comes from
+        estimate_memory_usage so that all tiles in flight together stay
+        within tile_memory_mb. Each word belongs to the tile whose core
+        contains its centre, which removes duplicates from the overlaps
+        before the words are merged into reading order.
+        """
+        try:
+            image = self.image_processor.load_image(image_path, grayscale=True)
+        except Exception as e:
+            raise ImageProcessingError(f"Image preprocessing failed: {e}")
+        
+        workers = options.get('tile_workers') or min(4, os.cpu_count() or 1)
+        tile_size = memory_processor.plan_tile_size(
+            {'channels': 1}, self._tile_memory_budget(options) // workers,
+            max_tile=options.get('tile_max_size', 4096)
+        )
+        overlap = min(options.get('tile_overlap', 128), tile_size // 4)
+        preprocessing = {**options.get('preprocessing', {}), 'max_dimension': tile_size, 'resize_max': tile_size}
+        plan = None
+        if preprocessing.get('adaptive', True):
+            # One plan for the whole image, so every tile gets the same stages;
+            # rotating or rescaling tiles would break the word coordinates
+            quality = self.image_processor.analyze_quality(image)
+            plan = self.image_processor.plan_stages(
+                quality, {**preprocessing, 'deskew': False, 'upscale': False}, image.shape[:2])
+            preprocessing.update(ImageProcessor.plan_options(plan))
+            plan['steps'] = [step for step, key in (('contrast', 'contrast_factor'), ('denoise', 'denoise_strength'))
+                             if plan.get(key)]
+            if plan['threshold_method'] in ('adaptive', 'otsu', 'binary'):
+                plan['steps'].append('threshold')
+        
+        def ocr_tile(tile):
+            try:
+                processed = self.image_processor.preprocess_image(tile, preprocessing)
+            except Exception as e:
+                raise ImageProcessingError(f"Image preprocessing failed: {e}")
+            return self._tile_words(processed, backend, options)
+        
+        words = []
+        tile_count = 0
+        with ThreadPoolExecutor(max_workers=workers) as executor:
+            futures = []
+            for x, y, tile, core in memory_processor.iter_tiles(image, tile_size, overlap):
+                futures.append((x, y, core, executor.submit(ocr_tile, tile)))
+                tile_count += 1
+            for x, y, (core_x0, core_y0, core_x1, core_y1), future in futures:
+                try:
+                    check_cancelled()
+                    tile_words = future.result()
+                except ImageProcessingError:
+                    raise
+                except JobCancelled:
+                    for _, _, _, queued in futures:
+                        queued.cancel()
+                    raise
+                except Exception as e:
+                    raise OCRBackendError(f"{backend} failed on tile at ({x}, {y}): {e}")
+                for left, top, width, height, text, confidence in tile_words:
+                    left += x
+                    top += y
+                    centre_x = left + width / 2
+                    centre_y = top + height / 2
+                    if core_x0 <= centre_x < core_x1 and core_y0 <= centre_y < core_y1:
+                        words.append((left, top, width, height, text, confidence))
+        
+        confidences = [word[5] for word in words]
+        self.logger.info(
+            f"Tiled OCR: {image.shape[1]}x{image.shape[0]} image as {tile_count} tiles of {tile_size}px"
+        )
+        return {
+            'text': self._merge_words(words),
+            'confidence': sum(confidences) / len(confidences) if confidences else 0,
+            'source': backend,
+            'tiled': True,
+            'tile_count': tile_count,
+            'tile_size': tile_size,
+            'preprocessing': plan or {'adaptive': False}
+        }
+
+    @staticmethod
+    def _easyocr_input(image: np.ndarray) -> np.ndarray:
+        """Convert BGR to RGB if needed"""
+        if len(image.shape) == 3:
+            return cv2.cvtColor(image, cv2.COLOR_BGR2RGB)
+        return image
+
+    @staticmethod
+    def _easyocr_result(results: List[Tuple], options: Dict[str, Any]) -> Dict[str, Any]:
+        """Combine EasyOCR detections into text and an average confidence"""
+        text_parts = []
+        confidences = []
+        
+        for (bbox, text, confidence) in results:
+            if confidence >= options.get('confidence_threshold', 30):
+                text_parts.append(text)
+                confidences.append(confidence)
+        
+        combined_text = ' '.join(text_parts)
+        avg_confidence = sum(confidences) / len(confidences) if confidences else 0
+        
+        return {
+            'text': combined_text.strip(),
+            'confidence': avg_confidence,
+            'source': 'easyocr'
+        }
+
     def _extract_with_easyocr(self, image: np.ndarray, options: Dict[str, Any]) -> Dict[str, Any]:
         """Extract text using EasyOCR"""
         try:
-            reader = self._get_easyocr_reader(options.get('languages', ['en']))
-            
-            # Convert BGR to RGB if needed
-            if len(image.shape) == 3:
-                image_rgb = cv2.cvtColor(image, cv2.COLOR_BGR2RGB)
-            else:
-                image_rgb = image
-            
-            # Extract text
-            results = reader.readtext(image_rgb)
-            
-            # Combine text and calculate confidence
-            text_parts = []
-            confidences = []
-            
-            for (bbox, text, confidence) in results:
-                if confidence >= options.get('confidence_threshold', 30):
-                    text_parts.append(text)
-                    confidences.append(confidence)
-            
-            combined_text = ' '.join(text_parts)
-            avg_confidence = sum(confidences) / len(confidences) if confidences else 0
-            
-            return {
-                'text': combined_text.strip(),
-                'confidence': avg_confidence,
-                'source': 'easyocr'
-            }
+            pool = self._get_easyocr_pool(options.get('languages', ['en']))
+            results = pool.readtext(self._easyocr_input(image))
+            return self._easyocr_result(results, options)
             
         except Exception as e:
             raise OCRBackendError(f"EasyOCR failed: {e}")
 
-    def _extract_with_google_vision(self, image_path: str, options: Dict[str, Any]) -> Dict[str, Any]:
+    def extract_text_batch_easyocr(
+        self,
+        images: List[ImageSource],
+        options: Optional[Dict[str, Any]] = None
+    ) -> List[Dict[str, Any]]:
+        """
+        Run EasyOCR over several images in batched forward passes
+        
+        Each image (a path, array, encoded bytes, or a tile from
+        MemoryEfficientImageProcessor) is preprocessed, then all of them are fed
+        to one pooled reader so same-sized inputs share recognizer batches.
+        
+        Returns:
+            One result per image, in input order
+        """
+        if not self.is_easyocr_available():
+            raise OCRBackendError("Selected backend 'easyocr' is not available")
+        
+        ocr_options = {**self.config, **(options or {})}
+        prepared = []
+        for image in images:
+            source = image if isinstance(image, (np.ndarray, bytes, bytearray, memoryview)) else str(image)
+            try:
+                with self.metrics.timer('stage_seconds', stage='preprocess'):
+                    processed = self.image_processor.preprocess_image(source, ocr_options.get('preprocessing', {}))
+            except Exception as e:
+                raise ImageProcessingError(f"Image preprocessing failed: {e}")
+            prepared.append(self._easyocr_input(processed))
+        
+        start_time = time.time()
+        try:
+            pool = self._get_easyocr_pool(ocr_options.get('languages', ['en']))
+            batch = pool.readtext_batch(prepared, batch_size=ocr_options.get('easyocr_batch_size', 8))
+        except Exception as e:
+            raise OCRBackendError(f"EasyOCR failed: {e}")
+        duration = time.time() - start_time
+        self.metrics.observe('stage_seconds', duration, stage='ocr_batch', backend='easyocr')
+        self.metrics.inc('ocr_pages_total', len(images), backend='easyocr', status='success')
+        
+        results = []
+        for image, detections in zip(images, batch):
+            result = self._easyocr_result(detections, ocr_options)
+            result.update({
+                'backend': 'easyocr',
+                'duration': duration,
+                'image_path': ImageProcessor.describe_source(image),
+                'word_count': len(result['text'].split()),
+                'character_count': len(result['text'])
+            })
+            results.append(result)
+        return results
+
+    def _extract_with_google_vision(self, image_path: ImageSource, options: Dict[str, Any]) -> Dict[str, Any]:
         """Extract text using Google Vision API"""
         try:
             if not hasattr(self, 'google_vision_backend'):
                 raise OCRBackendError("Google Vision backend not initialized")
             
             # Use the Google Vision backend to extract text
-            result = self.google_vision_backend.extract_text(image_path, options)
+            result = self.google_vision_backend.extract_text(self._vision_input(image_path), options)
             return result
             
         except Exception as e:
-            raise OCRBackendError(f"Google Vision API failed: {e}")
+            # Chained so the router can tell transient API errors from permanent ones
+            raise OCRBackendError(f"Google Vision API failed: {e}") from e
+
+    @staticmethod
+    def _vision_input(image: ImageSource):
+        """A path string or encoded bytes for the Vision API; decoded arrays are encoded once in memory"""
+        if isinstance(image, np.ndarray):
+            ok, encoded = cv2.imencode('.png', image)
+            if not ok:
+                raise ImageProcessingError("Could not encode image for Google Vision")
+            return encoded.tobytes()
+        if isinstance(image, Path):
+            return str(image)
+        return image
 
     def extract_text_from_multiple_images(
         self, 
@@ -489,39 +884,283 @@ class OCREngine:
             progress_callback: Optional callback for progress updates
             
         Returns:
-            List of extraction results
+            List of extraction results. For very large jobs use
+            iter_extract_text(), which keeps only a bounded window in memory.
         """
+        ocr_options = {**self.config, **(options or {})}
+        batch_extract = self._batch_extractor(ocr_options)
+        if batch_extract is not None:
+            return batch_extract(image_paths, ocr_options, progress_callback)
+        
         results = []
+        for _, result in self.iter_extract_text(image_paths, options, max_workers):
+            results.append(result)
+            
+            # Update progress
+            if progress_callback:
+                progress_callback(len(results), len(image_paths))
         
-        with ThreadPoolExecutor(max_workers=max_workers) as executor:
-            # Submit all tasks
-            future_to_path = {
-                executor.submit(self.extract_text, path, options): path
-                for path in image_paths
-            }
+        return results
+
+    def iter_extract_text(
+        self,
+        image_paths: Iterable[ImageSource],
+        options: Optional[Dict[str, Any]] = None,
+        max_workers: int = 2,
+        max_in_flight: Optional[int] = None,
+        cancel_event: Optional[threading.Event] = None
+    ) -> Iterator[Tuple[int, Dict[str, Any]]]:
+        """
+        Stream OCR results for any number of images with bounded memory
+        
+        Images are pulled from ``image_paths`` (a list or any iterator) only
+        as workers free up, and each result is yielded as soon as it is ready,
+        so a job of hundreds of thousands of images never holds more than a
+        window of them. Batched backends (Google Vision, EasyOCR) receive the
+        stream in windows of ``max_in_flight`` images.
+        
+        Args:
+            image_paths: Image paths, arrays or encoded bytes
+            options: OCR options
+            max_workers: Concurrent extract_text calls for per-image backends
+            max_in_flight: Images submitted ahead of the workers (default:
+                ocr 'max_in_flight' option, else 2 per worker; 64 per window
+                for batched backends)
+            cancel_event: Set to stop; images already being recognised finish
+                and are yielded, the rest are never started
             
-            # Process completed tasks
-            for i, future in enumerate(as_completed(future_to_path)):
-                path = future_to_path[future]
+        Yields:
+            (input index, result) in completion order; failures are yielded as
+            results with 'success': False and 'error'
+        """
+        ocr_options = {**self.config, **(options or {})}
+        max_in_flight = max_in_flight or ocr_options.get('max_in_flight')
+        indexed = enumerate(image_paths)
+        
+        batch_extract = self._batch_extractor(ocr_options)
+        if batch_extract is not None:
+            window = max(1, int(max_in_flight or 64))
+            while cancel_event is None or not cancel_event.is_set():
+                group = list(itertools.islice(indexed, window))
+                if not group:
+                    return
+                for (index, _), result in zip(group, batch_extract([path for _, path in group], ocr_options)):
+                    yield index, result
+            return
+        
+        def extract(item):
+            return self.extract_text(item[1], options)
+        
+        with ThreadPoolExecutor(max_workers=max_workers) as executor:
+            for (index, path), future in bounded_submit(executor, extract, indexed,
+                                                        max(int(max_in_flight or 2 * max_workers), max_workers),
+                                                        cancel_event):
                 try:
                     result = future.result()
-                    results.append(result)
-                    
-                    # Update progress
-                    if progress_callback:
-                        progress_callback(i + 1, len(image_paths))
-                        
                 except Exception as e:
-                    self.logger.error(f"Failed to process {path}: {e}")
-                    results.append({
-                        'image_path': path,
+                    self.logger.error(f"Failed to process {ImageProcessor.describe_source(path)}: {e}")
+                    result = {
+                        'image_path': ImageProcessor.describe_source(path),
                         'text': '',
                         'error': str(e),
                         'success': False
-                    })
+                    }
+                yield index, result
+
+    def _batch_extractor(self, ocr_options: Dict[str, Any]) -> Optional[Callable]:
+        """The list-batching implementation for the selected backend, or None for per-image OCR"""
+        backend = ocr_options.get('backend', 'auto')
+        if backend == 'auto':
+            backend = self.get_preferred_backend()
+        # Cloud OCR is latency bound, so Vision gets batched requests with its
+        # own in-flight limit (google_vision.batch_size / max_in_flight); while
+        # its circuit is open the images go one by one to the local fallback
+        if backend == 'google_vision' and self.is_google_vision_available():
+            # Read-only check: a batch of cache hits records nothing, so it must not hold the probe
+            if self._local_fallbacks() and not self.router.health('google_vision').accepting():
+                return None
+            return self._extract_batch_with_google_vision
+        # EasyOCR gets batched inference across its shared reader pool
+        if backend == 'easyocr' and self.is_easyocr_available():
+            return self._extract_batch_with_easyocr
+        return None
+
+    def _split_cached_results(
+        self,
+        image_paths: List[ImageSource],
+        options: Dict[str, Any]
+    ) -> Tuple[List[Optional[Dict[str, Any]]], Dict[int, str], List[int]]:
+        """Fill results from the OCR cache; return (results, cache keys by index, uncached indices)"""
+        results: List[Optional[Dict[str, Any]]] = [None] * len(image_paths)
+        cache_keys = {}
+        misses = []
+        
+        for index, path in enumerate(image_paths):
+            if options.get('use_cache', True):
+                # In-memory images are keyed by their content, as in extract_text
+                in_memory = isinstance(path, (np.ndarray, bytes, bytearray, memoryview))
+                cache_keys[index] = self._get_cache_key(path if in_memory else Path(path), options)
+                cached = self._load_from_cache(cache_keys[index])
+                if cached is not None:
+                    results[index] = self._cached_result(cached)
+                    results[index]['image_path'] = ImageProcessor.describe_source(path)
+                    continue
+            misses.append(index)
+        
+        return results, cache_keys, misses
+
+    def _extract_batch_with_easyocr(
+        self,
+        image_paths: List[ImageSource],
+        options: Dict[str, Any],
+        progress_callback: Optional[Callable[[int, int], None]] = None
+    ) -> List[Dict[str, Any]]:
+        """Feed uncached images to the EasyOCR pool in batches, one batch per pooled reader"""
+        total = len(image_paths)
+        results, cache_keys, misses = self._split_cached_results(image_paths, options)
+        done = total - len(misses)
+        if progress_callback and done:
+            progress_callback(done, total)
+        
+        batch_size = max(1, int(options.get('easyocr_batch_size', 8)))
+        batches = [misses[i:i + batch_size] for i in range(0, len(misses), batch_size)]
+        pool = self._get_easyocr_pool(options.get('languages', ['en']))
+        
+        with ThreadPoolExecutor(max_workers=pool.size) as executor:
+            future_to_batch = {
+                executor.submit(self.extract_text_batch_easyocr, [image_paths[i] for i in batch], options): batch
+                for batch in batches
+            }
+            for future in as_completed(future_to_batch):
+                batch = future_to_batch[future]
+                try:
+                    batch_results = future.result()
+                except Exception as e:
+                    self.logger.error(f"EasyOCR batch of {len(batch)} images failed: {e}")
+                    batch_results = [{'text': '', 'error': str(e), 'success': False} for _ in batch]
+                
+                for index, result in zip(batch, batch_results):
+                    result['image_path'] = ImageProcessor.describe_source(image_paths[index])
+                    if result.get('success', True) and index in cache_keys:
+                        self._save_to_cache(cache_keys[index], result)
+                    results[index] = result
+                
+                done += len(batch)
+                if progress_callback:
+                    progress_callback(done, total)
+        
+        return results
+
+    def _extract_batch_with_google_vision(
+        self,
+        image_paths: List[ImageSource],
+        options: Dict[str, Any],
+        progress_callback: Optional[Callable[[int, int], None]] = None
+    ) -> List[Dict[str, Any]]:
+        """Serve cached images locally and send the rest to Vision in batched requests"""
+        total = len(image_paths)
+        results, cache_keys, misses = self._split_cached_results(image_paths, options)
+        
+        # Paths and encoded bytes go as they are; arrays are encoded once
+        sent, inputs = [], []
+        for index in misses:
+            try:
+                inputs.append(self._vision_input(image_paths[index]))
+                sent.append(index)
+            except ImageProcessingError as e:
+                results[index] = {'image_path': ImageProcessor.describe_source(image_paths[index]),
+                                  'text': '', 'error': str(e), 'success': False}
+        
+        # Cache hits and unencodable images are settled before any request
+        settled = total - len(sent)
+        if progress_callback and settled:
+            progress_callback(settled, total)
+        
+        def batch_progress(done: int, _):
+            if progress_callback:
+                progress_callback(settled + done, total)
+        
+        # A half-open circuit lets one batch through as its probe; concurrent
+        # batches meanwhile go to the local fallback like single images do
+        health = self.router.health('google_vision')
+        duration = 0.0
+        if sent and not health.allow():
+            reason = f"circuit open, next probe in {health.retry_in():.0f}s"
+            batch_results = [{'text': '', 'error': reason, 'success': False} for _ in sent]
+            batch_progress(len(sent), len(sent))
+        elif sent:
+            start_time = time.time()
+            try:
+                batch_results = self.google_vision_backend.extract_text_batch(
+                    inputs, options, progress_callback=batch_progress
+                )
+            except BaseException:
+                health.release()
+                raise
+            duration = time.time() - start_time
+            # One health sample per batch, from the API calls alone: images that
+            # could not be loaded say nothing about the service, and an image
+            # Vision answered with an error still means the service is up
+            reached = [result for result in batch_results if not result.get('unreadable')]
+            failed = [result for result in reached if result.get('request_failed')]
+            if not reached:
+                health.release()
+            elif len(failed) == len(reached):
+                health.record_failure(duration, failed[0].get('error', ''))
+            else:
+                health.record_success(duration / len(reached))
+        else:
+            batch_results = []
+        
+        for index, result in zip(sent, batch_results):
+            result.pop('request_failed', None)
+            result.pop('unreadable', None)
+            path = ImageProcessor.describe_source(image_paths[index])
+            if result.get('success', True):
+                result.update({'backend': 'google_vision', 'duration': duration})
+                if index in cache_keys:
+                    self._save_to_cache(cache_keys[index], result)
+            else:
+                self.logger.error(f"Failed to process {path}: {result.get('error')}")
+            result['image_path'] = path
+            results[index] = result
+        
+        # Images Vision could not read get the local fallback extract_text gives them
+        failed = [index for index in misses if not results[index].get('success', True)]
+        if failed and self._local_fallbacks():
+            with ThreadPoolExecutor(max_workers=min(len(failed), os.cpu_count() or 1)) as executor:
+                futures = {executor.submit(self._local_fallback, image_paths[index], options,
+                                           results[index].get('error', '')): index for index in failed}
+                for future in as_completed(futures):
+                    index = futures[future]
+                    result = future.result()
+                    if result is not None:
+                        results[index] = result
+                        if index in cache_keys:
+                            self._save_to_cache(cache_keys[index], result)
         
         return results
 
+    def _local_fallback(self, image: ImageSource, options: Dict[str, Any], reason: str) -> Optional[Dict[str, Any]]:
+        """Recognise one image Vision failed on with the first local backend that succeeds, or None"""
+        for name in self._local_fallbacks():
+            try:
+                result = self.extract_text(image, {**options, 'backend': name, 'use_cache': False})
+            except JobCancelled:
+                raise
+            except Exception as e:
+                self.logger.warning(f"{self.backends[name]['name']} fallback failed for "
+                                    f"{ImageProcessor.describe_source(image)}: {e}")
+                continue
+            result.update({
+                'backend': 'google_vision',
+                'fallback': True,
+                'fallback_backend': name,
+                'fallback_reason': f"{self.backends['google_vision']['name']}: {reason}"
+            })
+            return result
+        return None
+
     def get_image_info(self, image_path: str) -> Dict[str, Any]:
         """Get information about an image file"""
         try:
@@ -532,6 +1171,8 @@ class OCREngine:
     def clear_cache(self) -> bool:
         """Clear the OCR cache"""
         try:
+            self.result_cache.clear()
+            # Remove entries written by the old one-file-per-key layout
             for cache_file in self.cache_dir.glob("*.txt"):
                 cache_file.unlink()
             return True
@@ -542,21 +1183,14 @@ class OCREngine:
     def get_cache_size(self) -> int:
         """Get the total size of the cache in bytes"""
         try:
-            return sum(f.stat().st_size for f in self.cache_dir.glob("*.txt") if f.is_file())
+            return self.result_cache.get_stats()['total_size']
         except:
             return 0
 
     def get_cache_stats(self) -> Dict[str, Any]:
         """Get cache statistics"""
         try:
-            cache_files = list(self.cache_dir.glob("*.txt"))
-            total_size = sum(f.stat().st_size for f in cache_files)
-            
-            return {
-                'file_count': len(cache_files),
-                'total_size': total_size,
-                'total_size_mb': round(total_size / (1024 * 1024), 2)
-            }
+            return self.result_cache.get_stats()
         except Exception as e:
             return {'error': str(e)}
 
@@ -617,62 +1251,241 @@ class OCREngine:
             self.logger.error(f"Failed to save result: {e}")
             return False
 
-    def extract_text_from_pdf(self, pdf_path: str, language: str = 'eng') -> str:
+    @staticmethod
+    def _pixmap_to_array(pix) -> np.ndarray:
+        """View a PyMuPDF pixmap's samples as a (height, width[, channels]) uint8 array without copying"""
+        samples = getattr(pix, 'samples_mv', None)
+        if samples is None:
+            samples = pix.samples
+        rows = np.frombuffer(samples, dtype=np.uint8).reshape(pix.height, pix.stride)
+        image = rows[:, :pix.width * pix.n].reshape(pix.height, pix.width, pix.n)
+        return image[:, :, 0] if pix.n == 1 else image
+
+    def extract_text_from_pdf(
+        self,
+        pdf_path: str,
+        language: str = 'eng',
+        dpi: Optional[int] = None,
+        max_workers: Optional[int] = None,
+        progress_callback: Optional[Callable[[int, int], None]] = None,
+        start_page: int = 0,
+        max_pages: Optional[int] = None,
+        backend: Optional[str] = None
+    ) -> str:
         """
         Extract text from PDF using OCR
-        
+
+        With Google Vision selected the whole document goes to Vision's file
+        annotation (see GoogleVisionBackend.extract_text_from_pdf), falling
+        back to the local page pipeline if that fails or its circuit is open.
+        Otherwise pages with an embedded text layer are used as-is. Low-text
+        pages are rendered one at a time by a producer loop and OCR'd
+        concurrently on a worker pool from in-memory buffers; results are
+        reassembled in page order.
+
         Args:
             pdf_path: Path to PDF file
             language: Language for OCR (default: eng)
-            
+            dpi: Render resolution for OCR'd pages (default: config 'pdf_render_dpi')
+            max_workers: Concurrent OCR workers (default: config 'pdf_ocr_workers' or CPU count)
+            progress_callback: Optional callback(pages_done, total_pages)
+            start_page: First page to read (0-based)
+            max_pages: Read at most this many pages; see also extract_text_partial()
+            backend: OCR backend (default: config 'backend')
+
         Returns:
             Extracted text string
         """
         try:
-            # Import PDF processing libraries
-            try:
-                import fitz  # PyMuPDF
-            except ImportError:
-                self.logger.error("PyMuPDF not available for PDF processing")
-                return ""
-            
-            pdf_path = Path(pdf_path)
-            if not pdf_path.exists():
-                self.logger.error(f"PDF file not found: {pdf_path}")
-                return ""
-            
-            # Open PDF and extract text
-            doc = fitz.open(str(pdf_path))
-            text = ""
-            
-            for page_num in range(len(doc)):
-                page = doc[page_num]
-                page_text = page.get_text()
-                
-                # If page has no text or very little text, use OCR
-                if not page_text.strip() or len(page_text.strip()) < 50:
-                    # Convert page to image and OCR
-                    pix = page.get_pixmap()
-                    img_data = pix.tobytes("png")
-                    
-                    # Save temporary image
-                    temp_image = pdf_path.parent / f"temp_page_{page_num}.png"
-                    with open(temp_image, 'wb') as f:
-                        f.write(img_data)
-                    
-                    # OCR the image
-                    ocr_result = self.extract_text(str(temp_image), {'language': language})
-                    ocr_text = ocr_result.get('text', '')
-                    text += f"\n--- Page {page_num + 1} ---\n{ocr_text}\n"
-                    
-                    # Clean up
-                    temp_image.unlink(missing_ok=True)
-                else:
-                    text += f"\n--- Page {page_num + 1} ---\n{page_text}\n"
-            
-            doc.close()
+            stop_page = start_page + max_pages if max_pages else None
+            if self._pdf_backend(backend) == 'google_vision':
+                text = self._extract_pdf_with_google_vision(pdf_path, language, start_page, stop_page,
+                                                            progress_callback)
+                if text is not None:
+                    return text
+            pages = self.iter_pdf_pages(pdf_path, language, dpi, max_workers, progress_callback,
+                                        start_page, stop_page)
+            text = "".join(f"\n--- Page {page_num + 1} ---\n{page_text}\n" for page_num, page_text in pages)
             return text.strip()
-            
+
         except Exception as e:
             self.logger.error(f"PDF OCR extraction failed: {e}")
-            return ""
\ No newline at end of file
+            return ""
+
+    def extract_text_partial(
+        self,
+        pdf_path: str,
+        max_pages: Optional[int] = None,
+        max_bytes: Optional[int] = None,
+        cursor: Optional[int] = None,
+        language: str = 'eng',
+        dpi: Optional[int] = None,
+        max_workers: Optional[int] = None
+    ) -> Dict[str, Any]:
+        """
+        Extract only the first pages of a PDF (or those from ``cursor`` on)
+
+        Stops after ``max_pages`` pages or once ``max_bytes`` of UTF-8 text
+        have been recognised; later pages are neither rendered nor OCR'd.
+
+        Returns:
+            ``{'pages': [(page_num, text), ...], 'text', 'cursor', 'complete'}``
+            where page numbers are 1-based and ``cursor`` (the next 0-based
+            page, or None at the end) continues the extraction
+        """
+        start_page = cursor or 0
+        stop_page = start_page + max_pages if max_pages else None
+        pages = []
+        size = 0
+        next_page = None
+        stream = self.iter_pdf_pages(pdf_path, language, dpi, max_workers, None, start_page, stop_page)
+        try:
+            for page_num, page_text in stream:
+                pages.append((page_num + 1, page_text))
+                size += len(page_text.encode('utf-8'))
+                next_page = page_num + 1
+                if max_bytes and size >= max_bytes:
+                    break
+            else:
+                next_page = stop_page
+        finally:
+            stream.close()
+
+        if next_page is not None and next_page >= self._pdf_page_count(pdf_path):
+            next_page = None
+        text = "".join(f"\n--- Page {page_num} ---\n{page_text}\n" for page_num, page_text in pages)
+        return {'pages': pages, 'text': text.strip(), 'cursor': next_page, 'complete': next_page is None}
+
+    def _pdf_backend(self, backend: Optional[str]) -> Optional[str]:
+        """The backend a whole-document PDF request resolves to, or None when none is available"""
+        backend = backend or self.config.get('backend', 'auto')
+        if backend == 'auto':
+            if not self.is_available():
+                return None
+            backend = self.get_preferred_backend()
+        return backend
+
+    def _extract_pdf_with_google_vision(self, pdf_path: str, language: str, start_page: int,
+                                        stop_page: Optional[int],
+                                        progress_callback: Optional[Callable[[int, int], None]]) -> Optional[str]:
+        """OCR a PDF with Vision file annotation through the router; None means use the local pipeline"""
+        if not self.is_google_vision_available():
+            return None
+        # Claims the half-open probe, which router.call reports back or releases
+        if not self.router.health('google_vision').allow():
+            self.logger.info(f"Google Vision circuit open, OCRing {Path(pdf_path).name} locally")
+            return None
+        options = {'languages': [language]} if language else None
+        try:
+            result = self.router.call('google_vision', lambda _: self.google_vision_backend.extract_text_from_pdf(
+                pdf_path, options, start_page, stop_page, progress_callback))
+        except JobCancelled:
+            raise
+        except Exception as e:
+            self.logger.warning(f"Google Vision PDF annotation failed for {Path(pdf_path).name}, "
+                                f"falling back to local page OCR: {e}")
+            return None
+        self.metrics.inc('ocr_pages_total', len(result['pages']), backend='google_vision', status='success')
+        return result['text']
+
+    @staticmethod
+    def _pdf_page_count(pdf_path: str) -> int:
+        import fitz  # PyMuPDF
+        doc = fitz.open(str(pdf_path))
+        try:
+            return len(doc)
+        finally:
+            doc.close()
+
+    def iter_pdf_pages(
+        self,
+        pdf_path: str,
+        language: str = 'eng',
+        dpi: Optional[int] = None,
+        max_workers: Optional[int] = None,
+        progress_callback: Optional[Callable[[int, int], None]] = None,
+        start_page: int = 0,
+        stop_page: Optional[int] = None
+    ) -> Iterator[Tuple[int, str]]:
+        """
+        Yield ``(page_index, text)`` for a PDF's pages, in page order
+
+        Only pages ``start_page`` to ``stop_page - 1`` (default: to the end)
+        are read, and only as fast as the caller consumes them plus a window
+        of ``max_workers * 2`` pages in OCR, so stopping early skips the rest.
+
+        Raises:
+            OCREngineError: If PyMuPDF is missing or the file does not exist
+        """
+        try:
+            import fitz  # PyMuPDF
+        except ImportError:
+            raise OCREngineError("PyMuPDF not available for PDF processing")
+
+        pdf_path = Path(pdf_path)
+        if not pdf_path.exists():
+            raise OCREngineError(f"PDF file not found: {pdf_path}")
+
+        dpi = dpi or self.config.get('pdf_render_dpi', 200)
+        max_workers = max_workers or self.config.get('pdf_ocr_workers') or (os.cpu_count() or 1)
+        min_text_chars = self.config.get('pdf_min_text_chars', 50)
+        zoom = fitz.Matrix(dpi / 72, dpi / 72)
+
+        # PyMuPDF documents are not thread-safe, so pages are rendered here
+        # and only the OCR step runs on the pool
+        doc = fitz.open(str(pdf_path))
+        try:
+            start_page = max(0, start_page)
+            stop_page = len(doc) if stop_page is None else min(len(doc), stop_page)
+            total_pages = max(0, stop_page - start_page)
+            pages_done = 0
+
+            def finish(page_num, page_text, future):
+                nonlocal pages_done
+                if future is not None:
+                    try:
+                        page_text = future.result().get('text', '')
+                    except Exception as e:
+                        self.logger.warning(f"OCR failed for page {page_num + 1} of {pdf_path.name}: {e}")
+                        page_text = ''
+                pages_done += 1
+                if progress_callback:
+                    progress_callback(pages_done, total_pages)
+                return page_num, page_text
+
+            with ThreadPoolExecutor(max_workers=max_workers) as executor:
+                # Pages leave in order; rendered-but-unprocessed pages are bounded
+                # so memory stays flat on long documents
+                pending = collections.deque()
+                max_in_flight = max_workers * 2
+                try:
+                    for page_num in range(start_page, stop_page):
+                        # A cancelled scheduler job stops between pages
+                        check_cancelled()
+                        page = doc[page_num]
+                        page_text = page.get_text()
+
+                        # If page has no text or very little text, use OCR
+                        if len(page_text.strip()) >= min_text_chars:
+                            pending.append((page_num, page_text, None, None))
+                        else:
+                            # Render straight to grayscale and wrap the pixmap's sample
+                            # buffer as an array: no PNG encode, temp file or re-decode
+                            pix = page.get_pixmap(matrix=zoom, colorspace=fitz.csGRAY, alpha=False)
+                            page_image = self._pixmap_to_array(pix)
+                            future = executor.submit(self.extract_text, page_image, {'language': language})
+                            # The array borrows the pixmap's memory, so keep it alive until OCR finishes
+                            pending.append((page_num, '', future, pix))
+
+                        while pending and (pending[0][2] is None or pending[0][2].done() or
+                                           len(pending) >= max_in_flight):
+                            yield finish(*pending.popleft()[:3])
+
+                    while pending:
+                        yield finish(*pending.popleft()[:3])
+                finally:
+                    for _, _, future, _ in pending:
+                        if future is not None:
+                            future.cancel()
+        finally:
+            doc.close()
@@ -5,11 +5,15 @@ OCR Integration Module - Integrates OCR functionality with the main application
 import threading
 import time
 from pathlib import Path
-from typing import List, Dict, Any, Optional
+from typing import List, Dict, Any, Optional, Iterable, Iterator
 import logging
-from concurrent.futures import ThreadPoolExecutor, as_completed
+from converter_core.admission import JOB_BASE_BYTES, MemoryBudget, admit_submit, shared_budget
+from converter_core.backpressure import bounded_submit
+from converter_core.errors import JobCancelled
+from converter_core.scheduler import PRIORITY_BATCH, Job, shared_scheduler
 from .ocr_engine import OCREngine
 from .format_detector import OCRFormatDetector
+from .memory_processor import memory_processor
 
 class OCRIntegration:
     """Integrates OCR functionality with the document converter"""
@@ -25,6 +29,14 @@ class OCRIntegration:
         self.ocr_engine = OCREngine(ocr_config, logger)
         self.is_available = len(self.ocr_engine.get_available_backends()) > 0
         
+        # Images are admitted against the budget batch conversion uses, so a
+        # run of huge scans is serialised instead of exhausting memory
+        performance = ocr_config.get('performance') if isinstance(ocr_config, dict) else None
+        performance = performance if isinstance(performance, dict) else {}
+        self.memory_budget: Optional[MemoryBudget] = None
+        if performance.get('memory_admission', True):
+            self.memory_budget = shared_budget(performance.get('memory_budget_mb'))
+        
     def check_availability(self) -> Dict[str, Any]:
         """Check if OCR functionality is available"""
         backends = self.ocr_engine.get_available_backends()
@@ -45,18 +57,29 @@ class OCRIntegration:
             'supported_formats': list(OCRFormatDetector.get_supported_extensions())
         }
     
-    def process_files(self, file_paths: List[str], output_dir: str, 
+    def process_files(self, file_paths: Iterable[str], output_dir: str, 
                      output_format: str = 'txt', max_workers: int = 2,
-                     progress_callback=None) -> Dict[str, Any]:
+                     progress_callback=None, skip_existing: bool = False,
+                     collect_results: bool = True, max_in_flight: Optional[int] = None,
+                     cancel_event: Optional[threading.Event] = None,
+                     job: Optional[Job] = None) -> Dict[str, Any]:
         """
         Process multiple image files with OCR
         
         Args:
-            file_paths: List of image file paths
+            file_paths: Image file paths (a list or any iterable)
             output_dir: Output directory for results
             output_format: Output format (txt, json, markdown)
             max_workers: Maximum number of concurrent workers
             progress_callback: Optional callback for progress updates
+            skip_existing: Leave files whose output already exists alone, so
+                an interrupted job resumes where it stopped
+            collect_results: Keep every per-file result in 'results'; turn off
+                for huge jobs and watch progress_callback or iter_process_files
+            max_in_flight: Files queued ahead of the workers (default: 2 per worker)
+            cancel_event: Set to stop; files being recognised finish first
+            job: Scheduler job to run as (priority, mid-file cancellation and
+                a progress event per file); defaults to batch priority
             
         Returns:
             Dictionary with processing results
@@ -64,69 +87,128 @@ class OCRIntegration:
         if not self.is_available:
             raise RuntimeError("OCR functionality is not available")
         
-        # Filter supported files
-        supported_files = OCRFormatDetector.filter_supported_files(file_paths)
-        unsupported_count = len(file_paths) - len(supported_files)
+        sized = hasattr(file_paths, '__len__')
+        start_time = time.time()
+        results = []
+        successful = 0
+        failed = 0
+        skipped = 0
+        unsupported_count = 0
+        processed = 0
+        
+        for result in self.iter_process_files(file_paths, output_dir, output_format, max_workers,
+                                              skip_existing, max_in_flight, cancel_event, job):
+            if result.get('unsupported'):
+                unsupported_count += 1
+                continue
+            processed += 1
+            if collect_results:
+                results.append(result)
+            
+            if result.get('skipped'):
+                skipped += 1
+            elif result.get('success', False):
+                successful += 1
+            elif not result.get('cancelled'):
+                failed += 1
+                
+            # Update progress
+            total = len(file_paths) - unsupported_count if sized else processed
+            if progress_callback:
+                progress_callback(processed, total)
+            if job is not None:
+                job.progress(processed, total, file=result['file'])
+        
+        if job is not None:
+            job.finish()
         
-        if not supported_files:
+        if not processed:
             return {
                 'successful': 0,
-                'failed': len(file_paths),
+                'failed': unsupported_count,
                 'skipped': 0,
                 'results': [],
                 'duration': 0,
                 'message': "No supported image files found"
             }
         
-        start_time = time.time()
-        results = []
-        successful = 0
-        failed = 0
-        
-        # Process files with threading
-        with ThreadPoolExecutor(max_workers=max_workers) as executor:
-            # Submit all tasks
-            future_to_file = {
-                executor.submit(self._process_single_file, file_path, output_dir, output_format): file_path
-                for file_path in supported_files
-            }
-            
-            # Process completed tasks
-            for future in as_completed(future_to_file):
-                file_path = future_to_file[future]
-                try:
-                    result = future.result()
-                    results.append(result)
-                    
-                    if result.get('success', False):
-                        successful += 1
-                    else:
-                        failed += 1
-                        
-                    # Update progress
-                    if progress_callback:
-                        progress_callback(len(results), len(supported_files))
-                        
-                except Exception as e:
-                    self.logger.error(f"Failed to process {file_path}: {str(e)}")
-                    results.append({
-                        'file': str(file_path),
-                        'success': False,
-                        'error': str(e)
-                    })
-                    failed += 1
-        
         duration = time.time() - start_time
         
         return {
             'successful': successful,
             'failed': failed + unsupported_count,
-            'skipped': 0,
+            'skipped': skipped,
             'results': results,
             'duration': duration,
+            'cancelled': (cancel_event is not None and cancel_event.is_set()) or (job is not None and job.cancelled),
             'message': f"Processed {successful} files successfully"
         }
     
+    def iter_process_files(self, file_paths: Iterable[str], output_dir: str, output_format: str = 'txt',
+                           max_workers: int = 2, skip_existing: bool = False,
+                           max_in_flight: Optional[int] = None,
+                           cancel_event: Optional[threading.Event] = None,
+                           job: Optional[Job] = None) -> Iterator[Dict[str, Any]]:
+        """
+        OCR image files, yielding each file's result as soon as it is written
+        
+        Files are pulled from ``file_paths`` only as workers free up, so
+        memory stays constant for any job size; with a memory budget, each
+        image also waits until its estimated peak memory (from the header
+        dimensions) fits. Unsupported files are yielded with
+        'unsupported': True and existing outputs (with skip_existing) with
+        'skipped': True. Workers come from the shared job scheduler, at the
+        job's priority (batch priority without one); files stopped by a
+        cancelled job are yielded with 'cancelled': True.
+        """
+        if not self.is_available:
+            raise RuntimeError("OCR functionality is not available")
+        if job is not None and cancel_event is None:
+            cancel_event = job.cancel_event
+        
+        def pending():
+            for file_path in file_paths:
+                if not OCRFormatDetector.is_ocr_supported(str(file_path)):
+                    yield {'file': str(file_path), 'success': False, 'unsupported': True,
+                           'error': "Unsupported image format"}
+                    continue
+                if skip_existing:
+                    output_path = Path(output_dir) / (Path(file_path).stem + self._get_extension(output_format))
+                    if output_path.exists():
+                        yield {'file': str(file_path), 'output_file': str(output_path), 'success': True,
+                               'skipped': True}
+                        continue
+                yield file_path
+        
+        def process(item):
+            # Unsupported/skipped records ride through the pool so they are
+            # delivered in step with the window instead of buffering up
+            if isinstance(item, dict):
+                return item
+            return self._process_single_file(item, output_dir, output_format)
+        
+        def estimate(item):
+            return 0 if isinstance(item, dict) else JOB_BASE_BYTES + memory_processor.estimate_file_memory(item)
+        
+        # Process files on the workers shared with document conversion
+        max_in_flight = max(max_in_flight or 2 * max_workers, max_workers)
+        with shared_scheduler().executor(PRIORITY_BATCH, job, max_workers) as executor:
+            if self.memory_budget is None:
+                submitted = bounded_submit(executor, process, pending(), max_in_flight, cancel_event)
+            else:
+                submitted = admit_submit(executor, process, pending(), max_in_flight, self.memory_budget,
+                                         estimate, cancel_event)
+            for file_path, future in submitted:
+                try:
+                    yield future.result()
+                except Exception as e:
+                    self.logger.error(f"Failed to process {file_path}: {str(e)}")
+                    yield {
+                        'file': str(file_path),
+                        'success': False,
+                        'error': str(e)
+                    }
+    
     def _process_single_file(self, file_path: str, output_dir: str, output_format: str) -> Dict[str, Any]:
         """Process a single image file with OCR"""
         try:
@@ -151,6 +233,8 @@ class OCRIntegration:
                 'character_count': result.get('character_count', 0)
             }
             
+        except JobCancelled:
+            return {'file': str(file_path), 'success': False, 'cancelled': True}
         except Exception as e:
             return {
                 'file': str(file_path),
@@ -5,13 +5,14 @@ Implements comprehensive security validation and sanitization
 """
 
 import re
-import html
 import os
 from pathlib import Path
 from typing import List, Dict, Any, Optional
 import hashlib
 import logging
 
+from converter_core.textkernels import sanitize_ocr_text
+
 class SecurityError(Exception):
     """Custom exception for security-related errors"""
     pass
@@ -126,22 +127,10 @@ class OCRSecurityValidator:
         if not isinstance(text, str):
             return ""
         
-        # Remove potential XSS patterns
-        # Remove script tags and JavaScript handlers
-        text = re.sub(r'<script[^>]*>.*?</script>', '', text, flags=re.IGNORECASE | re.DOTALL)
-        text = re.sub(r'on\w+\s*=\s*["\'][^"\']*["\']', '', text, flags=re.IGNORECASE)
-        text = re.sub(r'javascript:', '', text, flags=re.IGNORECASE)
-        
-        # HTML escape to prevent injection
-        text = html.escape(text)
-        
-        # Remove control characters except newlines and tabs
-        text = re.sub(r'[\x00-\x08\x0B\x0C\x0E-\x1F\x7F]', '', text)
-        
-        # Limit excessive whitespace
-        text = re.sub(r'\s+', ' ', text).strip()
-        
-        return text
+        # Script tags, event handlers and javascript: are stripped, then
+        # escaping, control-character removal and whitespace collapsing run
+        # as one pass (compiled when available)
+        return sanitize_ocr_text(text)
     
     def generate_safe_filename(self, original_filename: str) -> str:
         """
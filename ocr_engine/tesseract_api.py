@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""
+In-Process Tesseract API Pool
+Keeps initialised libtesseract engines (through tesserocr) that worker
+threads borrow, so an image is recognised once, in memory, without spawning
+a tesseract process or reloading the language model per call
+"""
+
+import logging
+import os
+import queue
+import shlex
+import threading
+from contextlib import contextmanager
+from typing import Any, Dict, Iterator, List, Optional, Tuple
+
+import numpy as np
+
+try:
+    import tesserocr
+    TESSEROCR_AVAILABLE = True
+except ImportError:
+    TESSEROCR_AVAILABLE = False
+
+Word = Tuple[int, int, int, int, str, float]
+
+
+def parse_tesseract_config(config: str) -> Tuple[Optional[int], Optional[int], Dict[str, str]]:
+    """
+    Split a tesseract command-line config ('--oem 3 --psm 6 -c key=value')
+    into its OEM, PSM and ``-c`` variables for the API
+    """
+    oem = psm = None
+    variables: Dict[str, str] = {}
+    args = shlex.split(config or '')
+    index = 0
+    while index < len(args):
+        arg = args[index]
+        value = args[index + 1] if index + 1 < len(args) else None
+        if arg in ('--oem', '--psm') and value is not None:
+            if arg == '--oem':
+                oem = int(value)
+            else:
+                psm = int(value)
+            index += 2
+            continue
+        if arg == '-c' and value is not None and '=' in value:
+            key, _, setting = value.partition('=')
+            variables[key] = setting
+            index += 2
+            continue
+        if arg.startswith('-c') and '=' in arg:
+            key, _, setting = arg[2:].partition('=')
+            variables[key] = setting
+        index += 1
+    return oem, psm, variables
+
+
+class TesseractAPIPool:
+    """
+    Bounded pool of initialised Tesseract APIs for one language set and config
+
+    Like EasyOCRReaderPool: APIs are created on demand up to ``size`` and
+    lent to one caller at a time. An API is not thread-safe, but
+    recognition releases the GIL, so ``size`` threads recognise in parallel.
+    """
+
+    def __init__(self, languages: List[str], config: str = '--oem 3 --psm 6', size: int = 1,
+                 tessdata: Optional[str] = None, logger: Optional[logging.Logger] = None):
+        self.languages = list(languages)
+        self.config = config
+        self.size = max(1, int(size))
+        self.tessdata = tessdata or os.environ.get('TESSDATA_PREFIX')
+        self.logger = logger or logging.getLogger("TesseractAPIPool")
+        self._oem, self._psm, self._variables = parse_tesseract_config(config)
+        self._idle: "queue.Queue[Any]" = queue.Queue()
+        self._created = 0
+        self._lock = threading.Lock()
+
+    def _create_api(self):
+        """Initialise one engine: loads the language model once for its lifetime"""
+        kwargs: Dict[str, Any] = {'lang': '+'.join(self.languages)}
+        if self.tessdata:
+            kwargs['path'] = self.tessdata
+        if self._psm is not None:
+            kwargs['psm'] = self._psm
+        if self._oem is not None:
+            kwargs['oem'] = self._oem
+        self.logger.info(f"Initialising Tesseract API {self._created}/{self.size} for {self.languages}")
+        api = tesserocr.PyTessBaseAPI(**kwargs)
+        for key, value in self._variables.items():
+            api.SetVariable(key, value)
+        return api
+
+    @contextmanager
+    def api(self) -> Iterator[Any]:
+        """Borrow an API for the duration of the block"""
+        try:
+            api = self._idle.get_nowait()
+        except queue.Empty:
+            api = None
+            with self._lock:
+                can_create = self._created < self.size
+                if can_create:
+                    self._created += 1
+            if can_create:
+                try:
+                    api = self._create_api()
+                except Exception:
+                    with self._lock:
+                        self._created -= 1
+                    raise
+            else:
+                api = self._idle.get()
+        try:
+            yield api
+        finally:
+            # Drop the image (and its recognition results) before lending it out again
+            api.Clear()
+            self._idle.put(api)
+
+    def recognize(self, image: np.ndarray) -> Dict[str, Any]:
+        """
+        Recognise one grayscale, RGB or RGBA image in a single pass
+
+        The pixel buffer is handed to Tesseract as raw bytes; nothing is
+        encoded or written to disk.
+
+        Returns:
+            ``{'text', 'confidence', 'words'}`` where words are
+            ``(x, y, w, h, text, confidence)`` boxes in image coordinates
+        """
+        image = np.ascontiguousarray(image)
+        if image.dtype != np.uint8:
+            image = image.astype(np.uint8)
+        height, width = image.shape[:2]
+        channels = 1 if image.ndim == 2 else image.shape[2]
+
+        with self.api() as api:
+            api.SetImageBytes(image.tobytes(), width, height, channels, width * channels)
+            api.Recognize()
+            text = api.GetUTF8Text()
+            words = self._words(api)
+
+        confidences = [word[5] for word in words if word[5] > 0]
+        return {
+            'text': text,
+            'confidence': sum(confidences) / len(confidences) if confidences else 0,
+            'words': words
+        }
+
+    @staticmethod
+    def _words(api) -> List[Word]:
+        """Word boxes and confidences of the last recognition, read from its result iterator"""
+        level = tesserocr.RIL.WORD
+        words = []
+        iterator = api.GetIterator()
+        if iterator is None:
+            return words
+        for item in tesserocr.iterate_level(iterator, level):
+            text = item.GetUTF8Text(level)
+            box = item.BoundingBox(level)
+            if not text or not text.strip() or box is None:
+                continue
+            x1, y1, x2, y2 = box
+            words.append((x1, y1, x2 - x1, y2 - y1, text.strip(), float(item.Confidence(level))))
+        return words
+
+    def close(self):
+        """End every idle API; one still borrowed goes back to the pool and is ended by a later close"""
+        while True:
+            try:
+                api = self._idle.get_nowait()
+            except queue.Empty:
+                return
+            with self._lock:
+                self._created -= 1
+            api.End()
+
+    def get_stats(self) -> Dict[str, Any]:
+        """Pool size, initialised APIs and config"""
+        return {
+            'languages': self.languages,
+            'config': self.config,
+            'size': self.size,
+            'loaded': self._created,
+            'idle': self._idle.qsize()
+        }
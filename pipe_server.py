@@ -0,0 +1,526 @@
+#!/usr/bin/env python3
+"""
+Converter Pipe Server for VB6/VFP9 Integration
+Long-lived daemon answering VB6_PipeClient.bas / VFP9_PipeClient.prg requests
+on \\\\.\\pipe\\UniversalConverter with warm converter and OCR engines
+Designed and built by Beau Lewis (blewisxx@gmail.com)
+"""
+
+import argparse
+import json
+import logging
+import os
+import socket
+import socketserver
+import stat
+import sys
+import tempfile
+import threading
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional
+
+try:
+    import pywintypes
+    import win32file
+    import win32pipe
+    import winerror
+    PYWIN32_AVAILABLE = True
+except ImportError:
+    PYWIN32_AVAILABLE = False
+
+from converter_core import (
+    UniversalConverter, ConfigManager, DocumentConverterError
+)
+from converter_core.metrics import METRICS
+from converter_core.scheduler import PRIORITY_INTERACTIVE, Job, shared_scheduler
+
+PIPE_NAME = r'\\.\pipe\UniversalConverter'
+SOCKET_NAME = 'UniversalConverter.sock'
+PIPE_BUFFER_SIZE = 65536
+MAX_REQUEST_BYTES = 1024 * 1024
+# Legacy clients read a single 4 KB buffer; keep error text well inside it
+MAX_ERROR_CHARS = 1024
+
+
+class ConversionService:
+    """
+    Warm conversion engines shared by every connected client
+
+    One UniversalConverter (readers, writers, caches) is built at start-up
+    and the OCR engine on first use, so each request pays only for its own
+    conversion. Requests from concurrent clients run in parallel, bounded by
+    ``max_concurrent``. ``handle`` never raises: every outcome is a response.
+    """
+
+    FORMAT_ALIASES = {'md': 'markdown', 'htm': 'html', 'text': 'txt'}
+    OCR_OUTPUT_FORMATS = ('txt', 'json', 'markdown')
+
+    def __init__(self, config_file: Optional[str] = None, max_concurrent: Optional[int] = None,
+                 ocr_integration=None, logger: Optional[logging.Logger] = None,
+                 ocr_factory: Optional[Callable[[], Any]] = None):
+        self.logger = logger or logging.getLogger("PipeServer")
+        self.config_manager = ConfigManager(config_file)
+        self.converter = UniversalConverter("PipeServer", config_manager=self.config_manager)
+        self._ocr_integration = ocr_integration
+        self._ocr_factory = ocr_factory
+        self._ocr_lock = threading.Lock()
+        self._slots = threading.BoundedSemaphore(max_concurrent or os.cpu_count() or 1)
+        self._stats_lock = threading.Lock()
+        self.stats = {'requests': 0, 'converted': 0, 'failed': 0, 'started': time.time()}
+
+    @property
+    def ocr_integration(self):
+        """OCR engine, loaded on first OCR request and kept warm afterwards"""
+        with self._ocr_lock:
+            if self._ocr_integration is None:
+                if self._ocr_factory is not None:
+                    self._ocr_integration = self._ocr_factory()
+                else:
+                    from ocr_engine.ocr_integration import OCRIntegration
+                    self._ocr_integration = OCRIntegration(config_manager=self.config_manager)
+            return self._ocr_integration
+
+    def handle(self, request: Dict[str, Any]) -> Dict[str, Any]:
+        """
+        Process one request
+
+        Requests are ``{"input", "output", "input_format", "output_format"}``
+        as sent by the legacy clients, optionally with ``"ocr": true`` and
+        ``"language"``. ``{"command": "ping"}`` and ``{"command": "stats"}``
+        report server health; ``{"command": "metrics"}`` returns the stage
+        timing metrics (``"format": "prometheus"`` for the text format).
+
+        Returns:
+            ``{"status": "success", ...}`` or ``{"status": "failed", "error": ...}``.
+            Legacy clients only look for the word "success", so failure
+            responses carry no boolean "success" key.
+        """
+        command = str(request.get('command', 'convert')).lower()
+        if command == 'ping':
+            return {'status': 'success', 'message': 'pong'}
+        if command == 'stats':
+            with self._stats_lock:
+                stats = dict(self.stats)
+            stats['uptime'] = round(time.time() - stats.pop('started'), 1)
+            return {'status': 'success', **stats}
+        if command == 'metrics':
+            metrics = self.converter.metrics
+            if str(request.get('format', 'json')).lower() == 'prometheus':
+                return {'status': 'success', 'text': metrics.to_prometheus()}
+            return {'status': 'success', 'metrics': metrics.snapshot()}
+        if command != 'convert':
+            return self._failure(f"Unknown command: {command}")
+
+        with self._stats_lock:
+            self.stats['requests'] += 1
+        start_time = time.time()
+        try:
+            # Client requests are interactive: they run ahead of batch work
+            # sharing the scheduler's workers in this process
+            with self._slots:
+                output_path = shared_scheduler().run(
+                    self._convert, request, job=Job("Pipe request", PRIORITY_INTERACTIVE))
+        except Exception as e:
+            self.logger.error(f"Conversion request failed: {e}")
+            with self._stats_lock:
+                self.stats['failed'] += 1
+            return self._failure(str(e))
+
+        with self._stats_lock:
+            self.stats['converted'] += 1
+        return {
+            'status': 'success',
+            'output': str(output_path),
+            'duration': round(time.time() - start_time, 3)
+        }
+
+    def _convert(self, request: Dict[str, Any]) -> Path:
+        """Run a document or OCR conversion; raises on any failure"""
+        input_value = request.get('input')
+        output_value = request.get('output')
+        if not input_value or not output_value:
+            raise DocumentConverterError("Request needs both 'input' and 'output' paths")
+
+        input_path = Path(input_value)
+        output_path = Path(output_value)
+        input_format = self._normalize_format(request.get('input_format') or 'auto')
+        output_format = self._normalize_format(request.get('output_format') or 'txt')
+        output_path.parent.mkdir(parents=True, exist_ok=True)
+
+        if request.get('ocr') or self._is_image(input_path):
+            self._convert_with_ocr(input_path, output_path, output_format, request.get('language'))
+        else:
+            self.converter.convert_file(input_path, output_path, input_format, output_format)
+        return output_path
+
+    def _convert_with_ocr(self, input_path: Path, output_path: Path, output_format: str,
+                          language: Optional[str]):
+        """OCR an image or scanned PDF into txt, json or markdown"""
+        if not input_path.exists():
+            raise DocumentConverterError(f"Input file not found: {input_path}")
+        if output_format not in self.OCR_OUTPUT_FORMATS:
+            raise DocumentConverterError(
+                f"OCR output must be one of {', '.join(self.OCR_OUTPUT_FORMATS)}, not {output_format}"
+            )
+
+        engine = self.ocr_integration.ocr_engine
+        languages = [language] if language else None
+        if input_path.suffix.lower() == '.pdf':
+            text = engine.extract_text_from_pdf(str(input_path), language=language or 'eng')
+            result = {'text': text, 'word_count': len(text.split()), 'character_count': len(text)}
+        else:
+            result = engine.extract_text(str(input_path), {'languages': languages} if languages else None)
+
+        if not engine.save_result(result, str(output_path), output_format):
+            raise DocumentConverterError(f"Could not write OCR output: {output_path}")
+
+    @staticmethod
+    def _is_image(input_path: Path) -> bool:
+        """Images can only be converted through OCR"""
+        return input_path.suffix.lower() in (
+            '.jpg', '.jpeg', '.png', '.tif', '.tiff', '.bmp', '.gif', '.webp'
+        )
+
+    def _normalize_format(self, name: str) -> str:
+        name = str(name).lower().lstrip('.')
+        return self.FORMAT_ALIASES.get(name, name)
+
+    @staticmethod
+    def _failure(message: str) -> Dict[str, Any]:
+        return {'status': 'failed', 'error': message[:MAX_ERROR_CHARS]}
+
+
+def decode_request(data: bytes) -> Dict[str, Any]:
+    """
+    Parse one request as sent by a legacy or JSON-aware client
+
+    VB6/VFP9 clients build JSON by string concatenation in the ANSI code page
+    without escaping, so ``C:\\temp\\a.md`` arrives with bare backslashes.
+    Such payloads either fail to parse or parse into control characters,
+    which never occur in real paths. In both cases the backslashes are taken
+    literally.
+    """
+    try:
+        text = data.decode('utf-8')
+    except UnicodeDecodeError:
+        text = data.decode('mbcs' if sys.platform == 'win32' else 'latin-1')
+    text = text.strip().strip('\x00')
+
+    def has_control_chars(value: Any) -> bool:
+        if isinstance(value, str):
+            return any(char in value for char in '\t\n\r\b\f')
+        if isinstance(value, dict):
+            return any(has_control_chars(item) for item in value.values())
+        return False
+
+    try:
+        request = json.loads(text)
+        if isinstance(request, dict) and not has_control_chars(request):
+            return request
+    except json.JSONDecodeError:
+        pass
+
+    request = json.loads(text.replace('\\', '\\\\'))
+    if not isinstance(request, dict):
+        raise ValueError("Request must be a JSON object")
+    return request
+
+
+def process_message(service: ConversionService, data: bytes) -> bytes:
+    """Decode, handle and encode one request/response round trip"""
+    try:
+        response = service.handle(decode_request(data))
+    except Exception as e:
+        response = {'status': 'failed', 'error': f"Invalid request: {e}"[:MAX_ERROR_CHARS]}
+    return json.dumps(response).encode('utf-8')
+
+
+class _SocketRequestHandler(socketserver.StreamRequestHandler):
+    """Newline-delimited JSON; a final request without newline is answered at EOF"""
+
+    def handle(self):
+        service = self.server.service
+        while True:
+            line = self.rfile.readline(MAX_REQUEST_BYTES)
+            if not line:
+                return
+            if not line.strip():
+                continue
+            self.wfile.write(process_message(service, line) + b'\n')
+            self.wfile.flush()
+
+
+class _ThreadingUnixServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    daemon_threads = True
+
+
+class _ThreadingTCPServer(socketserver.ThreadingMixIn, socketserver.TCPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+def default_socket_path() -> str:
+    """
+    The per-user Unix socket path: in $XDG_RUNTIME_DIR, else in a private
+    0700 directory under the temp dir that must belong to the current user
+    """
+    runtime_dir = os.environ.get('XDG_RUNTIME_DIR')
+    if not runtime_dir:
+        runtime_dir = os.path.join(tempfile.gettempdir(), f"UniversalConverter-{os.getuid()}")
+        try:
+            os.mkdir(runtime_dir, 0o700)
+        except FileExistsError:
+            pass
+        # Anyone can create names in the shared temp dir, so never trust one we did not make
+        info = os.lstat(runtime_dir)
+        if not stat.S_ISDIR(info.st_mode) or info.st_uid != os.getuid() or info.st_mode & 0o077:
+            raise DocumentConverterError(f"Refusing to use {runtime_dir}: not a private directory of this user")
+    return os.path.join(runtime_dir, SOCKET_NAME)
+
+
+class SocketTransport:
+    """
+    Unix socket (or localhost TCP) transport for non-Windows hosts and tests
+
+    The Unix socket is private to the service user: it lives in a per-user
+    runtime directory by default and is chmod 0600 once bound, since any
+    client that connects can have the daemon read and write its files.
+    """
+
+    def __init__(self, service: ConversionService, socket_path: Optional[str] = None,
+                 port: Optional[int] = None):
+        self.service = service
+        self.socket_path = None
+        if port is not None or not hasattr(socket, 'AF_UNIX'):
+            self.server = _ThreadingTCPServer(('127.0.0.1', port or 0), _SocketRequestHandler)
+            self.address = self.server.server_address
+        else:
+            socket_path = socket_path or default_socket_path()
+            self._remove_stale_socket(socket_path)
+            self.server = _ThreadingUnixServer(socket_path, _SocketRequestHandler)
+            try:
+                os.chmod(socket_path, 0o600)
+            except OSError:
+                self.server.server_close()
+                os.unlink(socket_path)
+                raise
+            self.socket_path = socket_path
+            self.address = self.socket_path
+        self.server.service = service
+
+    @staticmethod
+    def _remove_stale_socket(socket_path: str):
+        """Unlink a socket left behind by an earlier run of this user; refuse anything else"""
+        try:
+            info = os.lstat(socket_path)
+        except FileNotFoundError:
+            return
+        if not stat.S_ISSOCK(info.st_mode):
+            raise DocumentConverterError(f"Refusing to replace {socket_path}: it is not a socket")
+        if info.st_uid != os.getuid():
+            raise DocumentConverterError(f"Refusing to replace {socket_path}: it belongs to another user")
+        os.unlink(socket_path)
+
+    def serve_forever(self):
+        self.server.serve_forever()
+
+    def shutdown(self):
+        self.server.shutdown()
+        self.server.server_close()
+        if self.socket_path and os.path.exists(self.socket_path):
+            os.unlink(self.socket_path)
+
+
+class NamedPipeTransport:
+    """
+    Windows named pipe transport in message mode
+
+    A fresh pipe instance is created for every connection, so any number of
+    clients can be connected at once; each is served on its own thread and
+    may send several requests before closing its handle.
+    """
+
+    def __init__(self, service: ConversionService, pipe_name: str = PIPE_NAME):
+        if not PYWIN32_AVAILABLE:
+            raise DocumentConverterError("Named pipes need pywin32: pip install pywin32")
+        self.service = service
+        self.pipe_name = pipe_name
+        self.address = pipe_name
+        self._stopping = threading.Event()
+
+    def _create_instance(self):
+        return win32pipe.CreateNamedPipe(
+            self.pipe_name,
+            win32pipe.PIPE_ACCESS_DUPLEX,
+            win32pipe.PIPE_TYPE_MESSAGE | win32pipe.PIPE_READMODE_MESSAGE | win32pipe.PIPE_WAIT,
+            win32pipe.PIPE_UNLIMITED_INSTANCES,
+            PIPE_BUFFER_SIZE, PIPE_BUFFER_SIZE, 0, None
+        )
+
+    def serve_forever(self):
+        while not self._stopping.is_set():
+            handle = self._create_instance()
+            try:
+                win32pipe.ConnectNamedPipe(handle, None)
+            except pywintypes.error as e:
+                if e.winerror != winerror.ERROR_PIPE_CONNECTED:
+                    win32file.CloseHandle(handle)
+                    continue
+            if self._stopping.is_set():
+                win32file.CloseHandle(handle)
+                break
+            threading.Thread(target=self._serve_client, args=(handle,), daemon=True).start()
+
+    def _read_message(self, handle) -> bytes:
+        chunks = []
+        result, data = win32file.ReadFile(handle, PIPE_BUFFER_SIZE)
+        chunks.append(data)
+        while result == winerror.ERROR_MORE_DATA:
+            result, data = win32file.ReadFile(handle, PIPE_BUFFER_SIZE)
+            chunks.append(data)
+        return b''.join(chunks)
+
+    def _serve_client(self, handle):
+        try:
+            while True:
+                try:
+                    data = self._read_message(handle)
+                except pywintypes.error:
+                    break  # Client closed its handle
+                if data.strip():
+                    win32file.WriteFile(handle, process_message(self.service, data))
+        finally:
+            try:
+                win32file.FlushFileBuffers(handle)
+                win32pipe.DisconnectNamedPipe(handle)
+            except pywintypes.error:
+                pass
+            win32file.CloseHandle(handle)
+
+    def shutdown(self):
+        self._stopping.set()
+        # Unblock the pending ConnectNamedPipe with a throwaway connection
+        try:
+            handle = win32file.CreateFile(
+                self.pipe_name, win32file.GENERIC_READ | win32file.GENERIC_WRITE,
+                0, None, win32file.OPEN_EXISTING, 0, None
+            )
+            win32file.CloseHandle(handle)
+        except pywintypes.error:
+            pass
+
+
+class MetricsHTTPServer:
+    """
+    Prometheus scrape endpoint: GET /metrics (text format) or /metrics.json
+
+    Runs on its own daemon thread next to the pipe/socket transport.
+    """
+
+    def __init__(self, port: int, host: str = '127.0.0.1', registry=METRICS):
+        from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+        class Handler(BaseHTTPRequestHandler):
+            def do_GET(self):
+                path = self.path.split('?', 1)[0]
+                if path == '/metrics':
+                    body = registry.to_prometheus().encode('utf-8')
+                    content_type = 'text/plain; version=0.0.4; charset=utf-8'
+                elif path == '/metrics.json':
+                    body = registry.to_json().encode('utf-8')
+                    content_type = 'application/json'
+                else:
+                    self.send_error(404)
+                    return
+                self.send_response(200)
+                self.send_header('Content-Type', content_type)
+                self.send_header('Content-Length', str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+            def log_message(self, format, *args):
+                pass
+
+        self.server = ThreadingHTTPServer((host, port), Handler)
+        self.server.daemon_threads = True
+        self.address = f"http://{host}:{self.server.server_address[1]}/metrics"
+        threading.Thread(target=self.server.serve_forever, daemon=True).start()
+
+    def shutdown(self):
+        self.server.shutdown()
+        self.server.server_close()
+
+
+def create_transport(service: ConversionService, pipe_name: str = PIPE_NAME,
+                     socket_path: Optional[str] = None, port: Optional[int] = None):
+    """Named pipe on Windows with pywin32, otherwise a local socket"""
+    if PYWIN32_AVAILABLE and socket_path is None and port is None:
+        return NamedPipeTransport(service, pipe_name)
+    return SocketTransport(service, socket_path, port)
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    """Entry point for the pipe server"""
+    parser = argparse.ArgumentParser(
+        description="Serve VB6/VFP9 conversion requests from a long-lived process"
+    )
+    parser.add_argument('--pipe-name', default=PIPE_NAME,
+                        help=f'Named pipe to listen on (Windows, default: {PIPE_NAME})')
+    parser.add_argument('--socket', metavar='PATH',
+                        help=f'Listen on a Unix socket instead (default elsewhere: '
+                             f'$XDG_RUNTIME_DIR/{SOCKET_NAME}, else a private directory in the temp dir)')
+    parser.add_argument('--port', type=int,
+                        help='Listen on 127.0.0.1:PORT instead')
+    parser.add_argument('--workers', type=int, default=None,
+                        help='Maximum concurrent conversions (default: CPU count)')
+    parser.add_argument('--config', metavar='CONFIG_FILE',
+                        help='Use specific configuration file')
+    parser.add_argument('--preload-ocr', action='store_true',
+                        help='Load the OCR engine at start-up instead of on first use')
+    parser.add_argument('--metrics-port', type=int, metavar='PORT',
+                        help='Serve Prometheus metrics on http://127.0.0.1:PORT/metrics')
+    parser.add_argument('--verbose', '-v', action='store_true',
+                        help='Enable verbose output')
+    args = parser.parse_args(argv)
+
+    logging.basicConfig(
+        level=logging.DEBUG if args.verbose else logging.INFO,
+        format='%(asctime)s - %(name)s - %(levelname)s - %(message)s'
+    )
+    logger = logging.getLogger("PipeServer")
+
+    service = ConversionService(args.config, max_concurrent=args.workers, logger=logger)
+    if args.preload_ocr:
+        service.ocr_integration
+
+    try:
+        transport = create_transport(service, args.pipe_name, args.socket, args.port)
+    except DocumentConverterError as e:
+        logger.error(str(e))
+        return 1
+
+    metrics_server = None
+    if args.metrics_port is not None:
+        try:
+            metrics_server = MetricsHTTPServer(args.metrics_port)
+        except OSError as e:
+            logger.error(f"Could not serve metrics on port {args.metrics_port}: {e}")
+            transport.shutdown()
+            return 1
+        logger.info(f"Serving metrics on {metrics_server.address}")
+
+    logger.info(f"Converter pipe server listening on {transport.address}")
+    try:
+        transport.serve_forever()
+    except KeyboardInterrupt:
+        logger.info("Shutting down")
+    finally:
+        transport.shutdown()
+        if metrics_server is not None:
+            metrics_server.shutdown()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
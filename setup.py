@@ -4,7 +4,7 @@ Setup script for OCR Document Converter
 For publishing to PyPI
 """
 
-from setuptools import setup, find_packages
+from setuptools import setup, find_packages, Extension
 from pathlib import Path
 
 # Read the README file
@@ -26,6 +26,11 @@ setup(
         "Source Code": "https://github.com/Beaulewis1977/quick_ocr_doc_converter",
     },
     packages=find_packages(exclude=["tests*", "dev_docs_backup*", "build_installer*"]),
+    # Single-pass escaping and sanitising kernels; optional, since
+    # converter_core.textkernels falls back to pure Python without a compiler
+    ext_modules=[
+        Extension("converter_core._textkernels", ["converter_core/_textkernels.c"], optional=True),
+    ],
     classifiers=[
         "Development Status :: 5 - Production/Stable",
         "Intended Audience :: End Users/Desktop",
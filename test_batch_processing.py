@@ -346,6 +346,596 @@ class TestBatchProcessing(unittest.TestCase):
         
         print("✅ Error handling in batch processing validated")
 
+class TestBatchExecutors(unittest.TestCase):
+    """Test the in-process thread and process batch executors"""
+
+    def setUp(self):
+        """Set up test environment"""
+        from universal_document_converter import UniversalConverter
+        self.temp_dir = Path(tempfile.mkdtemp())
+        self.input_dir = self.temp_dir / "input"
+        self.output_dir = self.temp_dir / "output"
+        self.input_dir.mkdir()
+        self.files = []
+        for i in range(6):
+            path = self.input_dir / f"doc{i}.txt"
+            path.write_text(f"Document {i}\n\nSecond paragraph {i}", encoding='utf-8')
+            self.files.append(path)
+        self.converter = UniversalConverter(enable_caching=False)
+
+    def tearDown(self):
+        """Clean up test environment"""
+        import shutil
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def _run_batch(self, executor):
+        progress = []
+        results = self.converter.convert_batch(
+            self.files, self.output_dir, output_format='markdown', max_workers=2,
+            progress_callback=lambda done, total, result: progress.append((done, total)),
+            executor=executor, chunk_size=2
+        )
+        return results, progress
+
+    def test_thread_executor(self):
+        """Thread executor converts every file"""
+        results, progress = self._run_batch('thread')
+        self.assertEqual(results['successful'], len(self.files))
+        self.assertEqual(len(progress), len(self.files))
+
+    def test_process_executor(self):
+        """Process executor converts every file and streams per-file progress"""
+        results, progress = self._run_batch('process')
+        self.assertEqual(results['successful'], len(self.files), results['errors'])
+        self.assertEqual([done for done, _ in progress], list(range(1, len(self.files) + 1)))
+        for path in self.files:
+            self.assertIn("Second paragraph", (self.output_dir / f"{path.stem}.md").read_text(encoding='utf-8'))
+
+    def test_unknown_executor(self):
+        """Unknown executor names are rejected"""
+        from universal_document_converter import ConfigurationError
+        with self.assertRaises(ConfigurationError):
+            self._run_batch('cluster')
+
+class TestIncrementalBatch(unittest.TestCase):
+    """Test manifest-driven incremental re-conversion"""
+
+    def setUp(self):
+        """Set up test environment"""
+        from universal_document_converter import UniversalConverter
+        self.temp_dir = Path(tempfile.mkdtemp())
+        self.input_dir = self.temp_dir / "input"
+        self.output_dir = self.temp_dir / "output"
+        (self.input_dir / "sub").mkdir(parents=True)
+        self.files = []
+        for i, name in enumerate(["a.txt", "b.txt", "sub/c.txt"]):
+            path = self.input_dir / name
+            path.write_text(f"Document {i}", encoding='utf-8')
+            self.files.append(path)
+        self.converter = UniversalConverter(enable_caching=False)
+
+    def tearDown(self):
+        """Clean up test environment"""
+        import shutil
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def _run(self, files=None, executor='thread'):
+        return self.converter.convert_batch(
+            files if files is not None else self.files, self.output_dir, output_format='markdown',
+            max_workers=2, base_dir=self.input_dir, executor=executor, incremental=True
+        )
+
+    def test_second_run_converts_nothing(self):
+        """Unchanged sources are skipped without being read"""
+        self.assertEqual(self._run()['successful'], 3)
+
+        results = self._run()
+        self.assertEqual(results['successful'], 0)
+        self.assertEqual(results['unchanged'], 3)
+
+    def test_modified_and_new_sources_are_converted(self):
+        """Only changed or added files are converted, over their old output"""
+        self._run()
+        self.files[0].write_text("Document 0 revised and longer", encoding='utf-8')
+        new_file = self.input_dir / "d.txt"
+        new_file.write_text("Brand new", encoding='utf-8')
+
+        results = self._run(self.files + [new_file])
+        self.assertEqual(results['successful'], 2)
+        self.assertEqual(results['unchanged'], 2)
+        self.assertIn("revised", (self.output_dir / "a.md").read_text(encoding='utf-8'))
+
+    def test_touched_but_identical_source_is_unchanged(self):
+        """A new mtime with the same bytes is settled by the content hash"""
+        self._run()
+        stat = self.files[1].stat()
+        os.utime(self.files[1], ns=(stat.st_atime_ns, stat.st_mtime_ns + 5_000_000_000))
+
+        results = self._run()
+        self.assertEqual(results['unchanged'], 3)
+
+    def test_deleted_sources_are_pruned(self):
+        """Outputs of deleted sources are removed, along with emptied folders"""
+        self._run()
+        self.files[2].unlink()
+
+        results = self._run(self.files[:2])
+        self.assertEqual(results['pruned'], 1)
+        self.assertFalse((self.output_dir / "sub").exists())
+        self.assertTrue((self.output_dir / "a.md").exists())
+
+    def test_subset_run_keeps_other_outputs(self):
+        """Running over part of the tree never prunes sources that still exist"""
+        self._run()
+        results = self._run(self.files[:1])
+        self.assertEqual(results['pruned'], 0)
+        self.assertTrue((self.output_dir / "sub" / "c.md").exists())
+
+    def test_process_executor_records_manifest(self):
+        """Fingerprints from process workers land in the manifest"""
+        self.assertEqual(self._run(executor='process')['successful'], 3)
+        self.assertEqual(self._run(executor='process')['unchanged'], 3)
+
+class TestWatchFolder(unittest.TestCase):
+    """Test watch-folder debouncing, the persistent work queue and live ingest"""
+
+    def setUp(self):
+        """Set up test environment"""
+        self.temp_dir = Path(tempfile.mkdtemp())
+        self.inbox = self.temp_dir / "inbox"
+        self.output_dir = self.temp_dir / "output"
+        self.inbox.mkdir()
+
+    def tearDown(self):
+        """Clean up test environment"""
+        import shutil
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_debouncer_waits_for_writes_to_settle(self):
+        """A file is released only after it stops changing for the settle period"""
+        from converter_core.watcher import Debouncer
+        path = self.inbox / "scan.txt"
+        path.write_text("part one", encoding='utf-8')
+
+        debouncer = Debouncer(settle_seconds=1.0)
+        debouncer.touch(str(path), now=100.0)
+        self.assertEqual(debouncer.ready(now=100.5), [])
+
+        # Still being written without a new event: held for another period
+        with open(path, 'a', encoding='utf-8') as f:
+            f.write(" and part two")
+        self.assertEqual(debouncer.ready(now=101.5), [])
+        self.assertEqual(debouncer.ready(now=102.6), [str(path)])
+        self.assertEqual(len(debouncer), 0)
+
+    def test_work_queue_survives_restart(self):
+        """Running jobs are recovered, and changes during a run requeue the job"""
+        from converter_core.watcher import WorkQueue
+        db_path = self.temp_dir / "queue.sqlite3"
+        queue = WorkQueue(db_path, max_attempts=2, retry_delay=0)
+        for name in ("a.txt", "b.txt"):
+            queue.enqueue(self.inbox / name)
+        first, second = queue.claim(10)
+        queue.enqueue(first)  # changed while running
+        queue.complete(first)
+        queue.close()
+
+        queue = WorkQueue(db_path, max_attempts=2, retry_delay=0)
+        self.assertEqual(queue.recover(), 1)
+        self.assertEqual(sorted(queue.claim(10)), sorted([first, second]))
+        self.assertTrue(queue.fail(second, "locked"))
+        queue.claim(10)
+        self.assertFalse(queue.fail(second, "locked"))
+        self.assertEqual(queue.counts().get('failed'), 1)
+        queue.close()
+
+    def test_dropped_files_are_converted(self):
+        """Files landing in the folder (existing or new) are converted and mirrored"""
+        from universal_document_converter import UniversalConverter
+        from converter_core.watcher import FolderWatcher
+
+        (self.inbox / "existing.txt").write_text("Already here", encoding='utf-8')
+        (self.inbox / "ignored.tmp").write_text("partial", encoding='utf-8')
+        watcher = FolderWatcher(self.inbox, self.output_dir, UniversalConverter(enable_caching=False),
+                                settle_seconds=0.2, poll_interval=0.1, use_native=False)
+        watcher.start()
+        try:
+            (self.inbox / "sub").mkdir()
+            (self.inbox / "sub" / "new.txt").write_text("Dropped later", encoding='utf-8')
+            deadline = time.time() + 10
+            target = self.output_dir / "sub" / "new.md"
+            while time.time() < deadline and not target.exists():
+                time.sleep(0.1)
+        finally:
+            watcher.stop()
+
+        self.assertTrue((self.output_dir / "existing.md").exists())
+        self.assertIn("Dropped later", target.read_text(encoding='utf-8'))
+        self.assertFalse((self.output_dir / "ignored.md").exists())
+        self.assertEqual(watcher.stats['failed'], 0)
+
+    def test_batch_level_error_releases_claimed_files(self):
+        """A convert_batch that raises leaves its files queued for retry, not stuck running"""
+        from converter_core.errors import ConfigurationError
+        from converter_core.watcher import FolderWatcher
+
+        class BrokenConverter:
+            def convert_batch(self, *args, **kwargs):
+                raise ConfigurationError("manifest is locked")
+
+        for name in ("a.txt", "b.txt"):
+            (self.inbox / name).write_text("Document", encoding='utf-8')
+        reported = []
+        watcher = FolderWatcher(self.inbox, self.output_dir, BrokenConverter(), use_native=False,
+                                on_result=reported.append)
+        try:
+            self.assertEqual(watcher.sweep(), 2)
+            self.assertEqual(watcher.process_pending(), 2)
+            counts = watcher.queue.counts()
+        finally:
+            watcher.queue.close()
+
+        self.assertNotIn('running', counts)
+        self.assertEqual(watcher.stats['failed'], 2)
+        self.assertEqual([r['status'] for r in reported], ['error', 'error'])
+        self.assertIn("manifest is locked", reported[0]['error'])
+
+class TestStreamingDiscovery(unittest.TestCase):
+    """Test the streaming scandir walker and batches fed from it"""
+
+    def setUp(self):
+        """Set up test environment"""
+        from universal_document_converter import UniversalConverter
+        self.temp_dir = Path(tempfile.mkdtemp())
+        self.input_dir = self.temp_dir / "input"
+        self.output_dir = self.temp_dir / "output"
+        self.expected = set()
+        for depth in range(3):
+            directory = self.input_dir.joinpath(*[f"level{d}" for d in range(depth)])
+            directory.mkdir(parents=True, exist_ok=True)
+            for name in (f"doc{depth}.txt", f"page{depth}.HTML", f"notes{depth}.md"):
+                (directory / name).write_text(f"Document at depth {depth}", encoding='utf-8')
+                self.expected.add(directory / name)
+            (directory / f"image{depth}.png").write_bytes(b"not a document")
+            (directory / f"~$doc{depth}.txt").write_text("lock file", encoding='utf-8')
+        self.converter = UniversalConverter(enable_caching=False)
+
+    def tearDown(self):
+        """Clean up test environment"""
+        import shutil
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_single_pass_matches_all_extensions(self):
+        """Parallel and serial walks find every supported file once, in any case, skipping lock files"""
+        from converter_core.discovery import walk_directory
+        for workers in (1, 4):
+            found = list(walk_directory(self.input_dir, max_workers=workers))
+            self.assertEqual(len(found), len(self.expected))
+            self.assertEqual(set(found), self.expected)
+
+        top_level = set(walk_directory(self.input_dir, recursive=False))
+        self.assertEqual(top_level, {path for path in self.expected if path.parent == self.input_dir})
+
+    def test_walk_can_be_abandoned(self):
+        """Closing the stream early stops the scanner threads"""
+        import threading
+        from converter_core.discovery import walk_directory
+        before = threading.active_count()
+        stream = walk_directory(self.input_dir, max_workers=4, queue_size=1)
+        next(stream)
+        stream.close()
+        deadline = time.time() + 5
+        while threading.active_count() > before and time.time() < deadline:
+            time.sleep(0.05)
+        self.assertLessEqual(threading.active_count(), before)
+
+    def test_batch_consumes_stream(self):
+        """convert_batch takes a generator for both executors and counts files as they arrive"""
+        from converter_core.discovery import iter_input_files
+        for executor in ('thread', 'process'):
+            output_dir = self.output_dir / executor
+            progress = []
+            results = self.converter.convert_batch(
+                iter_input_files([str(self.input_dir)], recursive=True), output_dir,
+                input_format='auto', output_format='txt', max_workers=2, base_dir=self.input_dir,
+                executor=executor, progress_callback=lambda done, total, result: progress.append(total)
+            )
+            convertible = [path for path in self.expected if path.suffix == '.txt']
+            self.assertEqual(results['total'], len(self.expected))
+            self.assertEqual(len(progress), len(self.expected))
+            for path in convertible:
+                output = output_dir / path.relative_to(self.input_dir).with_suffix('.txt')
+                self.assertTrue(output.exists(), f"{executor}: {output}")
+
+class TestBatchBackpressure(unittest.TestCase):
+    """Test bounded in-flight submission, streamed results and cancellation"""
+
+    def setUp(self):
+        """Set up test environment"""
+        from universal_document_converter import UniversalConverter
+        self.temp_dir = Path(tempfile.mkdtemp())
+        self.input_dir = self.temp_dir / "input"
+        self.output_dir = self.temp_dir / "output"
+        self.input_dir.mkdir()
+        self.files = []
+        for i in range(12):
+            path = self.input_dir / f"doc{i:02d}.txt"
+            path.write_text(f"Document {i}", encoding='utf-8')
+            self.files.append(path)
+        self.converter = UniversalConverter(enable_caching=False)
+
+    def tearDown(self):
+        """Clean up test environment"""
+        import shutil
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_bounded_submit_limits_in_flight(self):
+        """Items are pulled only as tasks finish, never more than the window ahead"""
+        import threading
+        from converter_core.backpressure import bounded_submit
+        pulled = []
+        finished = []
+        peak = [0]
+        lock = threading.Lock()
+
+        def items():
+            for i in range(50):
+                pulled.append(i)
+                with lock:
+                    peak[0] = max(peak[0], len(pulled) - len(finished))
+                yield i
+
+        def work(item):
+            time.sleep(0.001)
+            with lock:
+                finished.append(item)
+            return item * 2
+
+        with ThreadPoolExecutor(max_workers=3) as pool:
+            values = sorted(future.result() for _, future in bounded_submit(pool, work, items(), 5))
+        self.assertEqual(values, [i * 2 for i in range(50)])
+        self.assertLessEqual(peak[0], 5)
+
+    def test_cancel_stops_batch_and_incremental_run_resumes(self):
+        """A cancelled incremental batch keeps what it converted; the next run does the rest"""
+        import threading
+        cancel = threading.Event()
+        seen = []
+
+        stream = self.converter.iter_convert_batch(
+            iter(self.files), self.output_dir, 'txt', 'markdown', max_workers=1, max_in_flight=1,
+            incremental=True, cancel_event=cancel
+        )
+        for result in stream:
+            seen.append(result)
+            if len(seen) == 3:
+                cancel.set()
+
+        converted = len([r for r in seen if r['status'] == 'success'])
+        self.assertGreaterEqual(converted, 3)
+        self.assertLess(converted, len(self.files))
+
+        results = self.converter.convert_batch(self.files, self.output_dir, 'txt', 'markdown',
+                                               max_workers=2, incremental=True)
+        self.assertEqual(results['unchanged'], converted)
+        self.assertEqual(results['successful'], len(self.files) - converted)
+        self.assertFalse(results['cancelled'])
+
+    def test_error_records_are_capped(self):
+        """Only max_errors error records are kept; the rest are counted"""
+        missing = [self.input_dir / f"missing{i}.txt" for i in range(5)]
+        results = self.converter.convert_batch(missing, self.output_dir, 'txt', 'markdown',
+                                               max_workers=2, max_errors=2)
+        self.assertEqual(results['failed'], 5)
+        self.assertEqual(len(results['errors']), 2)
+        self.assertEqual(results['errors_dropped'], 3)
+
+class TestMemoryAdmission(unittest.TestCase):
+    """Test memory-aware admission of batch jobs"""
+
+    def test_giants_run_alone_and_small_jobs_share(self):
+        """A job bigger than the budget waits for the others to drain, then runs by itself"""
+        import threading
+        from converter_core.admission import MemoryBudget, admit_submit
+        budget = MemoryBudget(100)
+        running = []
+        overlaps = {'small': 0, 'giant': 0}
+        lock = threading.Lock()
+
+        def work(weight):
+            with lock:
+                running.append(weight)
+                if weight > 100 and len(running) > 1:
+                    overlaps['giant'] += 1
+                elif len(running) > 1:
+                    overlaps['small'] += 1
+            time.sleep(0.01)
+            with lock:
+                running.remove(weight)
+            return weight
+
+        weights = [10] * 6 + [150] + [10] * 6 + [150, 150]
+        with ThreadPoolExecutor(max_workers=4) as pool:
+            done = [future.result() for _, future in
+                    admit_submit(pool, work, iter(weights), 4, budget, lambda weight: weight, max_bypass=2)]
+        self.assertEqual(sorted(done), sorted(weights))
+        self.assertEqual(overlaps['giant'], 0)
+        self.assertGreater(overlaps['small'], 0)
+        self.assertEqual(budget.used, 0)
+        self.assertEqual(budget.running, 0)
+
+    def test_estimates_follow_format_and_size(self):
+        """Bigger files and inflating containers get bigger estimates"""
+        from converter_core.admission import JOB_BASE_BYTES, estimate_job_memory
+        self.assertEqual(estimate_job_memory("missing.txt"), JOB_BASE_BYTES)
+        self.assertGreater(estimate_job_memory("a.docx", size=1 << 20), estimate_job_memory("a.txt", size=1 << 20))
+        self.assertGreater(estimate_job_memory("a.txt", size=1 << 22), estimate_job_memory("a.txt", size=1 << 20))
+        self.assertEqual(estimate_job_memory("a.dat", 'txt', size=100), estimate_job_memory("b.txt", size=100))
+
+    def test_tiny_budget_still_converts_everything(self):
+        """With every file over budget the batch runs one at a time but completes"""
+        import shutil
+        from converter_core.admission import MemoryBudget
+        from universal_document_converter import UniversalConverter
+        temp_dir = Path(tempfile.mkdtemp())
+        try:
+            files = []
+            for i in range(6):
+                path = temp_dir / f"doc{i}.txt"
+                path.write_text(f"Document {i}", encoding='utf-8')
+                files.append(path)
+            converter = UniversalConverter(enable_caching=False)
+            converter.memory_budget = MemoryBudget(1)
+            results = converter.convert_batch(files, temp_dir / "out", 'txt', 'markdown', max_workers=3)
+            self.assertEqual(results['successful'], 6)
+            self.assertEqual(converter.memory_budget.used, 0)
+        finally:
+            shutil.rmtree(temp_dir, ignore_errors=True)
+
+class TestDistributedBatch(unittest.TestCase):
+    """Test the leased shard queue and coordinator/worker batches"""
+
+    def setUp(self):
+        """Set up test environment"""
+        self.temp_dir = Path(tempfile.mkdtemp())
+        self.input_dir = self.temp_dir / "input"
+        self.output_dir = self.temp_dir / "output"
+        (self.input_dir / "sub").mkdir(parents=True)
+
+    def tearDown(self):
+        """Clean up test environment"""
+        import shutil
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_expired_leases_move_and_stale_reports_are_ignored(self):
+        """A shard whose lease runs out goes to another worker; the old token can no longer report"""
+        from converter_core.distributed import ShardQueue
+        queue = ShardQueue(self.temp_dir / "shards.sqlite3", lease_seconds=0.05, max_attempts=2, retry_delay=0)
+        queue.add([{'files': ['a.txt', 'b.txt']}, {'files': ['c.txt']}])
+
+        first = queue.lease('node-1')
+        second = queue.lease('node-1')
+        time.sleep(0.1)
+        retaken = queue.lease('node-2')
+        self.assertEqual(retaken['shard'], first['shard'])
+        self.assertEqual(retaken['attempt'], 2)
+        self.assertFalse(queue.complete(first['shard'], first['token'], {'successful': 2}))
+        self.assertTrue(queue.renew(retaken['shard'], retaken['token']))
+        self.assertTrue(queue.complete(retaken['shard'], retaken['token'], {'successful': 2}))
+
+        # The second shard's lease expired too: its last attempt fails for good
+        again = queue.lease('node-2')
+        self.assertEqual(again['shard'], second['shard'])
+        self.assertFalse(queue.fail(again['shard'], again['token'], "disk full"))
+        self.assertTrue(queue.finished())
+
+        merged = queue.merged_results()
+        self.assertEqual(merged['successful'], 2)
+        self.assertEqual(merged['unprocessed'], 1)
+        self.assertEqual(merged['nodes'], {'node-2': 2})
+        self.assertEqual(merged['failed_shards'][0]['error'], "disk full")
+        queue.close()
+
+    def test_workers_share_a_sharded_batch(self):
+        """Two workers drain a coordinator's shards and the merged totals cover every file"""
+        import threading
+        from universal_document_converter import UniversalConverter
+        from converter_core.distributed import BatchCoordinator, BatchWorker, ShardQueue, build_shards
+        from converter_core.errors import DocumentConverterError
+
+        for i in range(5):
+            folder = self.input_dir / "sub" if i % 2 else self.input_dir
+            (folder / f"doc{i}.txt").write_text(f"Document {i}", encoding='utf-8')
+        shards = build_shards([{'input': [str(self.input_dir)], 'output': str(self.output_dir),
+                                'from_format': 'txt', 'to_format': 'markdown', 'recursive': True}],
+                              shard_size=2)
+        self.assertEqual(len(shards), 3)
+
+        queue = ShardQueue(lease_seconds=5)
+        queue.add(shards)
+        coordinator = BatchCoordinator(queue, ('127.0.0.1', 0), secret='farm', poll_interval=0.1)
+        coordinator.start()
+        try:
+            rejected = BatchWorker(UniversalConverter(enable_caching=False), coordinator.address,
+                                   secret='wrong', connect_timeout=0)
+            with self.assertRaises(DocumentConverterError):
+                rejected.run()
+
+            workers = [BatchWorker(UniversalConverter(enable_caching=False), coordinator.address,
+                                   worker_id=f"node-{n}", secret='farm', max_workers=2) for n in range(2)]
+            threads = [threading.Thread(target=worker.run) for worker in workers]
+            for thread in threads:
+                thread.start()
+            self.assertTrue(coordinator.wait(timeout=30))
+            for thread in threads:
+                thread.join(timeout=10)
+        finally:
+            coordinator.shutdown(linger=0)
+
+        merged = queue.merged_results()
+        self.assertEqual(merged['successful'], 5)
+        self.assertEqual(merged['shards_done'], 3)
+        self.assertEqual(sum(worker.stats['shards'] for worker in workers), 3)
+        self.assertTrue((self.output_dir / "sub" / "doc1.md").exists())
+        self.assertTrue((self.output_dir / "doc4.md").exists())
+        queue.close()
+
+    def test_mostly_failed_shard_is_retried_and_open_binds_need_a_secret(self):
+        """A node that fails a whole shard hands it back; it goes to other shards first"""
+        from converter_core.distributed import BatchCoordinator, BatchWorker, ShardQueue
+        from converter_core.errors import ConfigurationError
+
+        class FlakyConverter:
+            """Fails every file of the first shard it converts (a broken mount), then recovers"""
+
+            def __init__(self):
+                self.calls = []
+
+            def convert_batch(self, file_list, **kwargs):
+                self.calls.append([str(path) for path in file_list])
+                broken = len(self.calls) == 1
+                return {'duration': 0.0, 'errors_dropped': 0, 'skipped': 0, 'unchanged': 0,
+                        'total': len(file_list), 'successful': 0 if broken else len(file_list),
+                        'failed': len(file_list) if broken else 0,
+                        'errors': [{'file': str(path), 'error': 'Input/output error'}
+                                   for path in file_list] if broken else []}
+
+        queue = ShardQueue(lease_seconds=5, retry_delay=0)
+        queue.add([{'files': ['a.txt', 'b.txt'], 'output': str(self.output_dir)},
+                   {'files': ['c.txt'], 'output': str(self.output_dir)}])
+        with self.assertRaises(ConfigurationError):
+            BatchCoordinator(queue, ('0.0.0.0', 0))
+        coordinator = BatchCoordinator(queue, ('127.0.0.1', 0), poll_interval=0.1)
+        coordinator.start()
+        try:
+            converter = FlakyConverter()
+            worker = BatchWorker(converter, coordinator.address, worker_id='node-1')
+            worker.run()
+        finally:
+            coordinator.shutdown(linger=0)
+
+        self.assertEqual(converter.calls, [['a.txt', 'b.txt'], ['c.txt'], ['a.txt', 'b.txt']])
+        self.assertEqual(worker.stats['failed_shards'], 1)
+        merged = queue.merged_results()
+        self.assertEqual((merged['successful'], merged['failed'], merged['shards_done']), (3, 0, 2))
+        queue.close()
+
+    def test_refused_coordinator_start_enqueues_nothing(self):
+        """A coordinator that may not start leaves no shards in its queue database"""
+        from converter_core.distributed import ShardQueue
+        (self.input_dir / "doc.txt").write_text("Document", encoding='utf-8')
+        queue_db = self.temp_dir / "shards.sqlite3"
+        env = {key: value for key, value in os.environ.items() if key != 'CONVERTER_CLUSTER_SECRET'}
+        cmd = [sys.executable, "cli.py", str(self.input_dir), "-o", str(self.output_dir), "-t", "markdown",
+               "--distribute", "0.0.0.0:0", "--queue-db", str(queue_db)]
+
+        result = subprocess.run(cmd, capture_output=True, text=True, timeout=60, env=env)
+        self.assertNotEqual(result.returncode, 0)
+        self.assertIn("cluster secret", result.stdout)
+        queue = ShardQueue(queue_db)
+        self.assertEqual(queue.counts(), {})
+        queue.close()
+
 def run_batch_processing_tests():
     """Run batch processing tests"""
     print("🧪 Running Batch Processing Tests")
@@ -354,6 +944,13 @@ def run_batch_processing_tests():
     # Create test suite
     test_suite = unittest.TestSuite()
     test_suite.addTest(unittest.makeSuite(TestBatchProcessing))
+    test_suite.addTest(unittest.makeSuite(TestBatchExecutors))
+    test_suite.addTest(unittest.makeSuite(TestIncrementalBatch))
+    test_suite.addTest(unittest.makeSuite(TestWatchFolder))
+    test_suite.addTest(unittest.makeSuite(TestStreamingDiscovery))
+    test_suite.addTest(unittest.makeSuite(TestBatchBackpressure))
+    test_suite.addTest(unittest.makeSuite(TestMemoryAdmission))
+    test_suite.addTest(unittest.makeSuite(TestDistributedBatch))
     
     # Run tests
     runner = unittest.TextTestRunner(verbosity=2)
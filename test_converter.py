@@ -19,7 +19,7 @@ sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
 
 try:
     from universal_document_converter import (
-        FormatDetector, UniversalConverter,
+        FormatDetector, UniversalConverter, ContentCache,
         DocxReader, PdfReader, TxtReader, HtmlReader, RtfReader,
         MarkdownWriter, TxtWriter, HtmlWriter, RtfWriter,
         DocumentConverterError, UnsupportedFormatError, FileProcessingError, DependencyError
@@ -29,6 +29,39 @@ except ImportError as e:
     print(f"Warning: Could not import converter modules: {e}")
     MODULES_AVAILABLE = False
 
+try:
+    from converter_core import pdf_engine
+
+    class FakePdfEngine(pdf_engine.PdfTextEngine):
+        """Text engine over a plain file holding form-feed separated pages"""
+
+        name = 'fake'
+
+        @classmethod
+        def available(cls):
+            return True
+
+        @staticmethod
+        def page_count(path):
+            return len(Path(path).read_text(encoding='utf-8').split('\f'))
+
+        @staticmethod
+        def extract_range(path, start, stop):
+            return Path(path).read_text(encoding='utf-8').split('\f')[start:stop]
+
+        @classmethod
+        def open_renderer(cls, path):
+            return FakePageRenderer()
+
+    class FakePageRenderer:
+        def render(self, index, dpi):
+            return f"image {index}".encode()
+
+        def close(self):
+            pass
+except ImportError:
+    pass
+
 class TestFormatDetector(unittest.TestCase):
     """Test the format detection functionality"""
     
@@ -393,6 +426,745 @@ class TestReaderWriterClasses(unittest.TestCase):
         self.assertIn("\\\\backslashes", content)
         self.assertIn("{\\rtf1", content)  # RTF header
 
+    def test_txt_reader_streams_large_files(self):
+        """Test TXT reader yields paragraphs lazily above the memory threshold"""
+        large_file = self.temp_dir / "large.txt"
+        large_file.write_text("First line\nsame paragraph\n\nSecond\n\n\nThird", encoding='utf-8')
+
+        reader = TxtReader(max_memory_mb=0)
+        blocks = reader.iter_read(large_file)
+
+        self.assertFalse(isinstance(blocks, list))
+        self.assertEqual(list(blocks), [
+            ('paragraph', 'First line\nsame paragraph'),
+            ('paragraph', 'Second'),
+            ('paragraph', 'Third')
+        ])
+
+    def test_writers_accept_generators(self):
+        """Test writers consume a content stream incrementally"""
+        def blocks():
+            yield ('heading', 1, 'Streamed')
+            yield ('paragraph', 'Body text')
+
+        for writer, name in ((MarkdownWriter(), "stream.md"), (TxtWriter(), "stream.txt"),
+                             (HtmlWriter(), "stream.html"), (RtfWriter(), "stream.rtf")):
+            with self.subTest(writer=type(writer).__name__):
+                output_file = self.temp_dir / name
+                writer.write(blocks(), output_file)
+                self.assertIn("Body text", output_file.read_text(encoding='utf-8'))
+
+    def test_failed_stream_removes_partial_output(self):
+        """Test a reader failing mid-stream reports a read error and leaves no output"""
+        class FailingReader(TxtReader):
+            def iter_read(self, file_path):
+                yield ('paragraph', 'partial')
+                raise ValueError("corrupt input")
+
+        test_file = self.temp_dir / "input.txt"
+        test_file.write_text("content", encoding='utf-8')
+        output_file = self.temp_dir / "output.md"
+
+        converter = UniversalConverter(enable_caching=False)
+        converter.readers['txt'] = FailingReader()
+        with self.assertRaises(FileProcessingError) as ctx:
+            converter.convert_file(test_file, output_file, 'txt', 'markdown')
+
+        self.assertIn("Failed to read", str(ctx.exception))
+        self.assertFalse(output_file.exists())
+        self.assertEqual(list(self.temp_dir.glob('.*')), [])
+
+    def test_failed_overwrite_keeps_previous_output(self):
+        """Test a conversion failing mid-stream does not clobber the output it would replace"""
+        class FailingReader(TxtReader):
+            def iter_read(self, file_path):
+                yield ('paragraph', 'partial')
+                raise ValueError("corrupt input")
+
+        test_file = self.temp_dir / "input.txt"
+        test_file.write_text("Good content", encoding='utf-8')
+        output_file = self.temp_dir / "output.md"
+
+        converter = UniversalConverter(enable_caching=False)
+        converter.convert_file(test_file, output_file, 'txt', 'markdown')
+        converter.readers['txt'] = FailingReader()
+        with self.assertRaises(FileProcessingError):
+            converter.convert_file(test_file, output_file, 'txt', 'markdown')
+
+        self.assertIn("Good content", output_file.read_text(encoding='utf-8'))
+        self.assertEqual(list(self.temp_dir.glob('.*')), [])
+
+class TestContentCache(unittest.TestCase):
+    """Test the persistent content-addressed conversion cache"""
+
+    def setUp(self):
+        """Set up test environment"""
+        if not MODULES_AVAILABLE:
+            self.skipTest("Converter modules not available")
+
+        self.temp_dir = Path(tempfile.mkdtemp())
+        self.converter = UniversalConverter()
+        self.converter.content_cache = ContentCache(self.temp_dir / "cache")
+
+    def tearDown(self):
+        """Clean up test files"""
+        if hasattr(self, 'temp_dir'):
+            shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_same_content_under_new_path_skips_reader(self):
+        """Test a copy of an already converted file is served from the cache"""
+        first = self.temp_dir / "a" / "report.txt"
+        second = self.temp_dir / "b" / "copy.txt"
+        for path in (first, second):
+            path.parent.mkdir()
+            path.write_text("Cached paragraph\n\nAnother one", encoding='utf-8')
+
+        self.converter.convert_file(first, self.temp_dir / "first.md", 'txt', 'markdown')
+
+        class ExplodingReader(TxtReader):
+            def iter_read(self, file_path):
+                raise AssertionError("reader should not run on a cache hit")
+
+        self.converter.readers['txt'] = ExplodingReader()
+        self.converter.convert_file(second, self.temp_dir / "second.html", 'txt', 'html')
+
+        self.assertIn("Another one", (self.temp_dir / "second.html").read_text(encoding='utf-8'))
+
+    def test_changed_content_misses(self):
+        """Test editing a source invalidates its cache entry"""
+        source = self.temp_dir / "doc.txt"
+        source.write_text("Old text", encoding='utf-8')
+        self.converter.convert_file(source, self.temp_dir / "out.md", 'txt', 'markdown')
+
+        source.write_text("New text", encoding='utf-8')
+        self.converter.convert_file(source, self.temp_dir / "out.md", 'txt', 'markdown')
+
+        self.assertIn("New text", (self.temp_dir / "out.md").read_text(encoding='utf-8'))
+
+    def test_lru_eviction_respects_size_cap(self):
+        """Test the cache evicts least recently used entries past its cap"""
+        cache = ContentCache(self.temp_dir / "small_cache", max_size_mb=1)
+        blocks = [('paragraph', os.urandom(200 * 1024).hex())]
+        for i in range(8):
+            cache.put(f"{i:064x}", blocks, 'txt')
+
+        stats = cache.get_stats()
+        self.assertLessEqual(stats['total_size'], 1024 * 1024)
+        self.assertIsNotNone(cache.get(f"{7:064x}"))
+        self.assertIsNone(cache.get(f"{0:064x}"))
+
+    def test_hash_memo_is_bounded(self):
+        """Test the per-process source hash memo keeps only the most recently hashed files"""
+        cache = ContentCache(self.temp_dir / "memo_cache")
+        cache.HASH_MEMO_ENTRIES = 3
+        sources = []
+        for i in range(5):
+            source = self.temp_dir / f"memo_{i}.txt"
+            source.write_text(f"file {i}", encoding='utf-8')
+            sources.append(source)
+            cache.hash_file(source)
+        cache.hash_file(sources[2])
+        cache.hash_file(sources[0])
+
+        self.assertEqual(len(cache._hash_memo), 3)
+        self.assertEqual([Path(key[0]).name for key in cache._hash_memo],
+                         ['memo_4.txt', 'memo_2.txt', 'memo_0.txt'])
+
+    def test_clear(self):
+        """Test clearing removes all entries"""
+        self.converter.content_cache.put("ab" * 32, [('paragraph', 'x')], 'txt')
+        self.assertEqual(self.converter.content_cache.clear(), 1)
+        self.assertEqual(self.converter.content_cache.get_stats()['entries'], 0)
+
+class TestHeadlessCore(unittest.TestCase):
+    """Test the GUI-free converter_core package and its reader/writer registry"""
+
+    def setUp(self):
+        """Set up test environment"""
+        if not MODULES_AVAILABLE:
+            self.skipTest("Converter modules not available")
+
+        self.temp_dir = Path(tempfile.mkdtemp())
+
+    def tearDown(self):
+        """Clean up test files"""
+        if hasattr(self, 'temp_dir'):
+            shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_import_without_tkinter_or_parsers(self):
+        """Test the CLI imports with tkinter unavailable and loads no optional parser"""
+        import subprocess
+        script = (
+            "import sys; sys.modules['tkinter'] = None\n"
+            "import cli\n"
+            "heavy = ('tkinter', 'PyPDF2', 'docx', 'bs4', 'ebooklib', 'markdown', 'cv2', 'numpy', 'psutil')\n"
+            "print(','.join(m for m in heavy if sys.modules.get(m)))\n"
+        )
+        result = subprocess.run([sys.executable, "-c", script], capture_output=True, text=True,
+                                cwd=os.path.dirname(os.path.abspath(__file__)), timeout=60)
+        self.assertEqual(result.returncode, 0, result.stderr)
+        self.assertEqual(result.stdout.strip(), "")
+
+    def test_readers_created_on_first_use(self):
+        """Test converters instantiate a reader only when its format is converted"""
+        from converter_core import registry
+
+        created = []
+
+        class CountingReader(TxtReader):
+            def __init__(self):
+                created.append(self)
+
+        registry.readers.register('counted', CountingReader)
+        try:
+            converter = UniversalConverter(enable_caching=False)
+            self.assertIn('counted', converter.readers)
+            self.assertEqual(created, [])
+            self.assertIs(converter.readers['counted'], converter.readers['counted'])
+            self.assertEqual(len(created), 1)
+        finally:
+            registry.readers.unregister('counted')
+
+    def test_registered_plugin_format_converts(self):
+        """Test a reader registered with the decorator is detected and converted"""
+        from converter_core import DocumentReader, register_reader, registry
+
+        @register_reader('csvtest', extensions=['.csvtest'], name='CSV Test')
+        class CsvReader(DocumentReader):
+            def iter_read(self, file_path):
+                for line in Path(file_path).read_text(encoding='utf-8').splitlines():
+                    yield ('paragraph', line.replace(',', ' | '))
+
+        try:
+            source = self.temp_dir / "table.csvtest"
+            source.write_text("a,b\nc,d", encoding='utf-8')
+            output = self.temp_dir / "table.md"
+
+            self.assertEqual(FormatDetector.detect_format(source), 'csvtest')
+            UniversalConverter(enable_caching=False).convert_file(source, output, 'auto', 'markdown')
+            self.assertIn("a | b", output.read_text(encoding='utf-8'))
+        finally:
+            registry.readers.unregister('csvtest')
+            FormatDetector.SUPPORTED_INPUT_FORMATS.pop('csvtest', None)
+
+    def test_missing_dependencies_checked_without_import(self):
+        """Test optional dependencies are reported without importing them"""
+        from converter_core import registry
+
+        registry.readers.register('needsmissing', TxtReader, requires=('surely_not_installed_mod',))
+        try:
+            self.assertEqual(registry.readers.missing_dependencies('needsmissing'),
+                             ['surely_not_installed_mod'])
+            self.assertEqual(registry.readers.missing_dependencies('txt'), [])
+        finally:
+            registry.readers.unregister('needsmissing')
+
+class TestConversionMetrics(unittest.TestCase):
+    """Test per-stage metrics recorded by the converter and their exports"""
+
+    def setUp(self):
+        """Set up test environment"""
+        if not MODULES_AVAILABLE:
+            self.skipTest("Converter modules not available")
+
+        from converter_core.metrics import MetricsRegistry
+        self.temp_dir = Path(tempfile.mkdtemp())
+        self.converter = UniversalConverter(enable_caching=False)
+        self.converter.metrics = MetricsRegistry()
+
+    def tearDown(self):
+        """Clean up test files"""
+        if hasattr(self, 'temp_dir'):
+            shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_convert_file_records_stages(self):
+        """Test detect, read, write and total timings are recorded per format"""
+        source = self.temp_dir / "input.txt"
+        source.write_text("First paragraph\n\nSecond paragraph", encoding='utf-8')
+
+        self.converter.convert_file(source, self.temp_dir / "output.md", 'auto', 'markdown')
+
+        metrics = self.converter.metrics
+        self.assertEqual(metrics.get('stage_seconds', stage='detect')['count'], 1)
+        self.assertEqual(metrics.get('stage_seconds', stage='read', format='txt')['count'], 1)
+        self.assertEqual(metrics.get('stage_seconds', stage='write', format='markdown')['count'], 1)
+        self.assertEqual(metrics.get('conversions_total', input_format='txt', output_format='markdown',
+                                     status='success'), 1)
+
+    def test_prometheus_export(self):
+        """Test the text exposition has cumulative buckets, sum and count"""
+        from converter_core.metrics import MetricsRegistry
+
+        metrics = MetricsRegistry(prefix='test')
+        metrics.describe('stage_seconds', 'histogram', 'Stage time', buckets=[0.1, 1.0])
+        metrics.observe('stage_seconds', 0.05, stage='read')
+        metrics.observe('stage_seconds', 0.5, stage='read')
+        metrics.inc('cache_lookups_total', cache='content', result='hit')
+
+        text = metrics.to_prometheus()
+        self.assertIn('# TYPE test_stage_seconds histogram', text)
+        self.assertIn('test_stage_seconds_bucket{stage="read",le="0.1"} 1', text)
+        self.assertIn('test_stage_seconds_bucket{stage="read",le="1"} 2', text)
+        self.assertIn('test_stage_seconds_bucket{stage="read",le="+Inf"} 2', text)
+        self.assertIn('test_stage_seconds_count{stage="read"} 2', text)
+        self.assertIn('test_cache_lookups_total{cache="content",result="hit"} 1', text)
+
+        metrics.write(self.temp_dir / "metrics.json")
+        import json
+        exported = json.loads((self.temp_dir / "metrics.json").read_text(encoding='utf-8'))
+        self.assertEqual(exported['metrics']['stage_seconds']['series'][0]['value']['count'], 2)
+
+    def test_process_batch_merges_worker_metrics(self):
+        """Test stage timings recorded in process workers reach the parent with utilisation"""
+        files = []
+        for i in range(4):
+            path = self.temp_dir / f"doc{i}.txt"
+            path.write_text(f"Document {i}", encoding='utf-8')
+            files.append(path)
+
+        results = self.converter.convert_batch(files, self.temp_dir / "out", 'txt', 'markdown',
+                                               max_workers=2, executor='process')
+
+        metrics = self.converter.metrics
+        self.assertEqual(results['successful'], 4)
+        self.assertEqual(metrics.get('stage_seconds', stage='read', format='txt')['count'], 4)
+        self.assertEqual(metrics.get('batch_files_total', executor='process', status='success'), 4)
+        self.assertEqual(metrics.get('batch_queue_depth', executor='process'), 0)
+        self.assertEqual(metrics.get('batch_workers_busy', executor='process'), 0)
+        self.assertGreater(results['worker_utilization'], 0)
+
+class TestMultiFormatOutput(unittest.TestCase):
+    """Test reading a document once and writing it in several formats"""
+
+    def setUp(self):
+        """Set up test environment"""
+        if not MODULES_AVAILABLE:
+            self.skipTest("Converter modules not available")
+
+        from converter_core.metrics import MetricsRegistry
+        self.temp_dir = Path(tempfile.mkdtemp())
+        self.source = self.temp_dir / "input.txt"
+        self.source.write_text("First paragraph\n\nSecond paragraph", encoding='utf-8')
+        self.converter = UniversalConverter(enable_caching=False)
+        self.converter.metrics = MetricsRegistry()
+
+    def tearDown(self):
+        """Clean up test files"""
+        if hasattr(self, 'temp_dir'):
+            shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_one_read_many_writes(self):
+        """Test the reader runs once and every writer gets the full content"""
+        self.converter.convert_file(self.source, self.temp_dir / "out" / "doc", 'auto',
+                                    ['markdown', 'html', 'txt'])
+
+        out = self.temp_dir / "out"
+        self.assertIn("Second paragraph", (out / "doc.md").read_text(encoding='utf-8'))
+        self.assertIn("<p>Second paragraph</p>", (out / "doc.html").read_text(encoding='utf-8'))
+        self.assertIn("Second paragraph", (out / "doc.txt").read_text(encoding='utf-8'))
+
+        metrics = self.converter.metrics
+        self.assertEqual(metrics.get('stage_seconds', stage='read', format='txt')['count'], 1)
+        for fmt in ('markdown', 'html', 'txt'):
+            self.assertEqual(metrics.get('stage_seconds', stage='write', format=fmt)['count'], 1)
+            self.assertEqual(metrics.get('conversions_total', input_format='txt', output_format=fmt,
+                                         status='success'), 1)
+
+    def test_failing_writer_leaves_others(self):
+        """Test one failed format raises without losing the outputs of the others"""
+        class BrokenWriter:
+            def write(self, content, output_path):
+                next(iter(content))
+                Path(output_path).write_text("partial", encoding='utf-8')
+                raise RuntimeError("disk full")
+
+        self.converter.writers['html'] = BrokenWriter()
+        targets = {'markdown': self.temp_dir / "a.md", 'html': self.temp_dir / "a.html"}
+        with self.assertRaises(FileProcessingError):
+            self.converter.convert_file(self.source, targets, 'txt', ['markdown', 'html'])
+        self.assertTrue(targets['markdown'].exists())
+        self.assertFalse(targets['html'].exists())
+
+    def test_batch_writes_every_format(self):
+        """Test convert_batch with several formats reports each file once"""
+        second = self.temp_dir / "second.txt"
+        second.write_text("Another document", encoding='utf-8')
+        output_dir = self.temp_dir / "batch"
+
+        results = self.converter.convert_batch([self.source, second], output_dir, 'auto', ['markdown', 'html'],
+                                               max_workers=2, base_dir=self.temp_dir)
+        self.assertEqual(results['successful'], 2)
+        self.assertEqual(sorted(p.name for p in output_dir.iterdir()),
+                         ['input.html', 'input.md', 'second.html', 'second.md'])
+
+        # Only the missing format is written on the next run
+        (output_dir / "second.html").unlink()
+        seen = []
+        self.converter.convert_batch([self.source, second], output_dir, 'auto', ['markdown', 'html'],
+                                     base_dir=self.temp_dir, progress_callback=lambda done, total, r: seen.append(r))
+        by_file = {r['file']: r for r in seen}
+        self.assertEqual(by_file['input.txt']['status'], 'skipped')
+        self.assertEqual(by_file['second.txt']['outputs'], ['second.html'])
+
+class TestPdfEngine(unittest.TestCase):
+    """Test page-range PDF extraction and the OCR fallback for scanned pages"""
+
+    def setUp(self):
+        """Set up test environment"""
+        if not MODULES_AVAILABLE:
+            self.skipTest("Converter modules not available")
+
+        self.temp_dir = Path(tempfile.mkdtemp())
+        self.source = self.temp_dir / "doc.pdf"
+
+    def tearDown(self):
+        """Clean up test files"""
+        if hasattr(self, 'temp_dir'):
+            shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def write_pages(self, pages):
+        self.source.write_text('\f'.join(pages), encoding='utf-8')
+
+    def test_parallel_ranges_keep_page_order(self):
+        """Test pages extracted over worker processes come back in order"""
+        self.write_pages([f"Page {i} " + "text " * 20 for i in range(40)] + ["   "])
+        blocks = list(pdf_engine.iter_pdf_pages(self.source, FakePdfEngine, workers=2, pages_per_range=3,
+                                                min_parallel_pages=8))
+        self.assertEqual([block[1] for block in blocks], list(range(1, 41)))
+        self.assertTrue(blocks[39][2].startswith("Page 39 "))
+
+    def test_thin_pages_are_ocred(self):
+        """Test pages with too little text are replaced by OCR output only when it finds more"""
+        long_text = "A full text layer " * 5
+        self.write_pages([long_text, "", "12", ""])
+        recognised = {b"image 1": "Scanned page text", b"image 2": "", b"image 3": ""}
+        calls = []
+
+        def ocr_page(image):
+            calls.append(image)
+            return recognised[image]
+
+        blocks = list(pdf_engine.iter_pdf_pages(self.source, FakePdfEngine, workers=1, ocr_page=ocr_page))
+        self.assertEqual(blocks, [('page', 1, long_text.strip()), ('page', 2, "Scanned page text"),
+                                  ('page', 3, "12")])
+        self.assertEqual(sorted(calls), [b"image 1", b"image 2", b"image 3"])
+
+    def test_unavailable_ocr_stops_rendering(self):
+        """Test an OCR callback reporting no backend is not asked again"""
+        self.write_pages([""] * 10)
+        calls = []
+
+        def ocr_page(image):
+            calls.append(image)
+            return None
+
+        self.assertEqual(list(pdf_engine.iter_pdf_pages(self.source, FakePdfEngine, workers=1,
+                                                        ocr_page=ocr_page, ocr_workers=1)), [])
+        self.assertLessEqual(len(calls), 3)
+
+    def test_engine_selection(self):
+        """Test unknown engines are rejected and PDF support accepts either library"""
+        from converter_core import registry
+        from converter_core.errors import ConfigurationError
+
+        with self.assertRaises(ConfigurationError):
+            pdf_engine.select_engine('nonexistent')
+        missing = registry.readers.missing_dependencies('pdf')
+        if not (pdf_engine.PyMuPDFEngine.available() or pdf_engine.PyPDF2Engine.available()):
+            self.assertEqual(missing, ['fitz or PyPDF2'])
+        else:
+            self.assertEqual(missing, [])
+
+class TestPartialRead(unittest.TestCase):
+    """Test reading only the start of a document, with a cursor to continue"""
+
+    def setUp(self):
+        """Set up test environment"""
+        if not MODULES_AVAILABLE:
+            self.skipTest("Converter modules not available")
+
+        self.temp_dir = Path(tempfile.mkdtemp())
+
+    def tearDown(self):
+        """Clean up test files"""
+        if hasattr(self, 'temp_dir'):
+            shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_block_limits_and_cursor(self):
+        """Test max_blocks and max_bytes cut the stream and the cursor resumes after them"""
+        source = self.temp_dir / "long.txt"
+        source.write_text("\n\n".join(f"Paragraph {i}" for i in range(10)), encoding='utf-8')
+        reader = TxtReader()
+
+        first = reader.read_partial(source, max_blocks=4)
+        self.assertEqual([block[1] for block in first.blocks], [f"Paragraph {i}" for i in range(4)])
+        self.assertFalse(first.complete)
+
+        second = reader.read_partial(source, max_bytes=20, cursor=first.cursor)
+        self.assertEqual([block[1] for block in second.blocks], ["Paragraph 4", "Paragraph 5"])
+
+        rest = reader.read_partial(source, cursor=second.cursor)
+        self.assertEqual(len(rest.blocks), 4)
+        self.assertTrue(rest.complete)
+
+    def test_pdf_reads_only_requested_pages(self):
+        """Test a PDF partial read seeks to the cursor page and never parses later pages"""
+        source = self.temp_dir / "doc.pdf"
+        source.write_text('\f'.join(f"Page {i} text" for i in range(100)), encoding='utf-8')
+        ranges = []
+
+        class CountingEngine(FakePdfEngine):
+            @staticmethod
+            def extract_range(path, start, stop):
+                ranges.append((start, stop))
+                return FakePdfEngine.extract_range(path, start, stop)
+
+        reader = PdfReader(engine=CountingEngine, workers=1, ocr_fallback=False)
+        first = reader.read_partial(source, max_pages=2)
+        self.assertEqual([block[1] for block in first.blocks], [1, 2])
+        self.assertEqual(first.cursor, 2)
+        self.assertEqual(ranges, [(0, 2)])
+
+        second = reader.read_partial(source, max_pages=3, cursor=first.cursor)
+        self.assertEqual([block[1] for block in second.blocks], [3, 4, 5])
+        self.assertEqual(ranges[-1], (2, 5))
+
+        last = reader.read_partial(source, max_pages=10, cursor=95)
+        self.assertEqual(len(last.blocks), 5)
+        self.assertTrue(last.complete)
+
+    def test_converter_preview(self):
+        """Test UniversalConverter.preview renders the first blocks with a writer"""
+        source = self.temp_dir / "notes.txt"
+        source.write_text("\n\n".join(f"Note {i}" for i in range(50)), encoding='utf-8')
+        converter = UniversalConverter(enable_caching=False)
+
+        preview = converter.preview(source, 'markdown', max_blocks=3)
+        self.assertEqual(preview['text'].split(), ["Note", "0", "Note", "1", "Note", "2"])
+        self.assertEqual(preview['cursor'], 3)
+        self.assertFalse(preview['complete'])
+        with self.assertRaises(FileProcessingError):
+            converter.preview(self.temp_dir / "missing.txt")
+
+class TestTextDecoding(unittest.TestCase):
+    """Test the shared encoding detection used by the text-based readers"""
+
+    def setUp(self):
+        """Set up test environment"""
+        if not MODULES_AVAILABLE:
+            self.skipTest("Converter modules not available")
+
+        self.temp_dir = Path(tempfile.mkdtemp())
+
+    def tearDown(self):
+        """Clean up test files"""
+        if hasattr(self, 'temp_dir'):
+            shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def read_both_ways(self, path):
+        """Blocks from the in-memory and the memory-mapped TxtReader paths"""
+        small = list(TxtReader().iter_read(path))
+        large = list(TxtReader(max_memory_mb=0).iter_read(path))
+        self.assertEqual(small, large)
+        return [block[1] for block in small]
+
+    def test_legacy_and_bom_encodings(self):
+        """Test latin-1 and UTF-16 files decode with the same paragraphs on both paths"""
+        legacy = self.temp_dir / "legacy.txt"
+        legacy.write_bytes("Café crème\r\n\r\nNaïve  \r\n  \r\nrésumé\n".encode('latin-1'))
+        self.assertEqual(self.read_both_ways(legacy), ["Café crème", "Naïve", "résumé"])
+
+        wide = self.temp_dir / "wide.txt"
+        wide.write_bytes("Ünïcode line\nsecond line\n\nΩ end".encode('utf-16'))
+        self.assertEqual(self.read_both_ways(wide), ["Ünïcode line\nsecond line", "Ω end"])
+
+    def test_bad_byte_after_sample_keeps_detected_encoding(self):
+        """Test a stray byte past the sample neither fails the read nor re-decodes the file"""
+        from converter_core import textdecode
+
+        source = self.temp_dir / "mixed.txt"
+        head = "naïve " * (textdecode.SAMPLE_BYTES // 6)
+        source.write_bytes(head.encode('utf-8') + b"\n\nprice \xa3 5\n\nfin")
+        paragraphs = self.read_both_ways(source)
+        self.assertEqual(paragraphs[0], head.strip())
+        self.assertEqual(paragraphs[1:], ["price £ 5", "fin"])
+
+    def test_html_charset_declaration(self):
+        """Test a <meta charset> is honoured and a BOM overrides it"""
+        from converter_core import textdecode
+
+        page = self.temp_dir / "page.html"
+        page.write_bytes('<meta charset="cp1252"><p>\u201cquoted\u201d</p>'.encode('cp1252'))
+        self.assertIn("\u201cquoted\u201d", textdecode.read_text(page, declared=True))
+
+        page.write_bytes(b'\xef\xbb\xbf' + '<meta charset="cp1252"><p>€</p>'.encode('utf-8'))
+        self.assertEqual(textdecode.read_text(page, declared=True), '<meta charset="cp1252"><p>€</p>')
+
+class TestTextKernels(unittest.TestCase):
+    """Test the escaping and sanitising kernels and their pure-Python fallbacks"""
+
+    SAMPLES = ["", "plain text", "a < b & \"c\" > 'd'", "{\\rtf} \\par", "café € 😀 <&>",
+               "tabs\tand\nnewlines\x00\x0b\x1f\x7f  \u3000 end ", "\u00a0 <x> \u2028"]
+
+    def setUp(self):
+        """Set up test environment"""
+        if not MODULES_AVAILABLE:
+            self.skipTest("Converter modules not available")
+
+    def test_kernels_match_pure_python(self):
+        """Test the compiled kernels (when built) and the fallbacks give identical results"""
+        import html
+        import re
+        from converter_core import textkernels
+
+        for sample in self.SAMPLES:
+            self.assertEqual(textkernels.escape_html(sample), html.escape(sample))
+            self.assertEqual(textkernels.py_escape_html(sample), html.escape(sample))
+            self.assertEqual(textkernels.escape_rtf(sample), textkernels.py_escape_rtf(sample))
+            # The regex passes the single-pass sanitiser replaced
+            expected = re.sub(r'[\x00-\x08\x0B\x0C\x0E-\x1F\x7F]', '', html.escape(sample))
+            expected = re.sub(r'\s+', ' ', expected).strip()
+            self.assertEqual(textkernels.sanitize_text(sample), expected)
+            self.assertEqual(textkernels.py_sanitize_text(sample), expected)
+        self.assertEqual(textkernels.escape_rtf("{a\\b}"), "\\{a\\\\b\\}")
+
+        writer = HtmlWriter()
+        self.assertEqual(writer._escape_html("<b>"), "&lt;b&gt;")
+
+    def test_markdown_scanner_matches_pure_python(self):
+        """Test the Markdown block scanner (compiled when built) matches the fallback on random input"""
+        import random
+        from converter_core import textkernels
+
+        def scan(scanner, lines, chunk):
+            blocks = []
+            for start in range(0, len(lines), chunk):
+                blocks.extend(scanner.feed(lines[start:start + chunk]))
+            return blocks + scanner.close()
+
+        sample = ["# Title", "", "First line", "  continued  ", "- item", "2. step", "> quote",
+                  "```", "  code", "```", "####### too deep", "tail"]
+        self.assertEqual(scan(textkernels.MarkdownScanner(), sample, 5), [
+            ('heading', 1, 'Title'), ('paragraph', 'First line continued'), ('list_item', 'item'),
+            ('numbered_list_item', 'step'), ('blockquote', 'quote'), ('code_block', '  code'),
+            ('paragraph', 'tail')])
+
+        # Fragments around every rule: fences, heading depths, markers without
+        # their space, non-ASCII digits and whitespace, stray newlines
+        fragments = ['```', '`', '#', '## ', '####### ', '- ', '-', '* ', '+ ', '> ', '>', '1. ', '12.',
+                     '3.\t', '\u00b23. ', '\u0663. ', '.', ' ', '\t', '\u3000', '\u00a0', '\x1c', '\r',
+                     '\n', 'word', 'caf\u00e9', '\U0001f600', '0']
+        rng = random.Random(29)
+        for _ in range(2000):
+            lines = [''.join(rng.choice(fragments) for _ in range(rng.randint(0, 6)))
+                     for _ in range(rng.randint(0, 30))]
+            expected = scan(textkernels.PyMarkdownScanner(), lines, len(lines) or 1)
+            self.assertEqual(scan(textkernels.MarkdownScanner(), lines, rng.randint(1, 5)), expected, lines)
+
+    def test_ocr_output_sanitizer(self):
+        """Test OCR text loses scripts and handlers, even ones assembled by an earlier removal"""
+        from ocr_engine.security import OCRSecurityValidator
+
+        sanitized = OCRSecurityValidator().sanitize_ocr_output(
+            "<script>alert(1)</script>Total:\x00  5 < 6\n\n<a onclick='x'>go</a> java<script></script>script:ok")
+        self.assertEqual(sanitized, "Total: 5 &lt; 6 &lt;a &gt;go&lt;/a&gt; ok")
+        self.assertEqual(OCRSecurityValidator().sanitize_ocr_output(None), "")
+
+class TestJobScheduler(unittest.TestCase):
+    """Test the shared priority scheduler and job cancellation"""
+
+    def setUp(self):
+        """Set up test environment"""
+        if not MODULES_AVAILABLE:
+            self.skipTest("Converter modules not available")
+
+        from converter_core import scheduler
+        self.scheduler_module = scheduler
+        self.scheduler = scheduler.JobScheduler(max_workers=2, interactive_reserve=1)
+        self.temp_dir = Path(tempfile.mkdtemp())
+
+    def tearDown(self):
+        """Clean up test files"""
+        if hasattr(self, 'scheduler'):
+            self.scheduler.shutdown(cancel_futures=True)
+        if hasattr(self, 'temp_dir'):
+            shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_interactive_runs_ahead_of_batch(self):
+        """Test an interactive task starts while batch tasks hold every batch worker"""
+        import threading
+        sched = self.scheduler_module
+        release = threading.Event()
+        order = []
+
+        blocker = self.scheduler.submit(release.wait, priority=sched.PRIORITY_BATCH)
+        queued = [self.scheduler.submit(order.append, f"batch {i}", priority=sched.PRIORITY_BATCH)
+                  for i in range(2)]
+        preview = self.scheduler.submit(order.append, "preview", priority=sched.PRIORITY_INTERACTIVE)
+
+        preview.result(timeout=5)
+        self.assertEqual(order, ["preview"])
+        release.set()
+        for future in [blocker] + queued:
+            future.result(timeout=5)
+        self.assertEqual(order, ["preview", "batch 0", "batch 1"])
+
+    def test_executor_limits_its_own_tasks(self):
+        """Test a JobExecutor runs no more tasks at once than its max_workers"""
+        import threading
+        lock = threading.Lock()
+        running = [0, 0]
+
+        def task():
+            with lock:
+                running[0] += 1
+                running[1] = max(running)
+            time.sleep(0.02)
+            with lock:
+                running[0] -= 1
+
+        with self.scheduler.executor(max_workers=1) as executor:
+            futures = [executor.submit(task) for _ in range(4)]
+        self.assertTrue(all(future.done() for future in futures))
+        self.assertEqual(running[1], 1)
+
+    def test_cancelled_job_stops_conversion(self):
+        """Test cancellation stops a file between blocks and ends the batch early"""
+        from converter_core import JobCancelled
+        sched = self.scheduler_module
+
+        sources = []
+        for i in range(4):
+            source = self.temp_dir / f"doc{i}.txt"
+            # Unique text so no cached conversion bypasses the reader
+            source.write_text("\n\n".join(f"{self.temp_dir.name} {i} paragraph {n}" for n in range(50)),
+                              encoding='utf-8')
+            sources.append(source)
+        converter = UniversalConverter()
+
+        job = sched.Job("test", sched.PRIORITY_NORMAL)
+        job.cancel()
+        output = self.temp_dir / "single.md"
+        with sched.job_context(job):
+            with self.assertRaises(JobCancelled):
+                converter.convert_file(sources[0], output, 'txt', 'markdown')
+        self.assertFalse(output.exists())
+
+        events = []
+
+        def listener(event):
+            events.append(event)
+            if event['event'] == 'progress':
+                job.cancel()
+
+        job = sched.Job("batch", sched.PRIORITY_BATCH, listener)
+        results = converter.convert_batch(sources, self.temp_dir / "out", 'txt', 'markdown',
+                                          max_workers=1, executor='thread', max_in_flight=1, job=job)
+        self.assertTrue(results['cancelled'])
+        self.assertLess(results['successful'], len(sources))
+        self.assertEqual(events[-1]['event'], 'finished')
+        self.assertEqual(job.state, 'cancelled')
+
 class TestPerformance(unittest.TestCase):
     """Test conversion performance"""
     
@@ -1201,6 +1973,14 @@ def main():
         suite.addTest(loader.loadTestsFromTestCase(TestConverters))
         suite.addTest(loader.loadTestsFromTestCase(TestEdgeCases))
         suite.addTest(loader.loadTestsFromTestCase(TestReaderWriterClasses))
+        suite.addTest(loader.loadTestsFromTestCase(TestHeadlessCore))
+        suite.addTest(loader.loadTestsFromTestCase(TestConversionMetrics))
+        suite.addTest(loader.loadTestsFromTestCase(TestMultiFormatOutput))
+        suite.addTest(loader.loadTestsFromTestCase(TestPdfEngine))
+        suite.addTest(loader.loadTestsFromTestCase(TestPartialRead))
+        suite.addTest(loader.loadTestsFromTestCase(TestTextDecoding))
+        suite.addTest(loader.loadTestsFromTestCase(TestTextKernels))
+        suite.addTest(loader.loadTestsFromTestCase(TestJobScheduler))
         suite.addTest(loader.loadTestsFromTestCase(TestPerformance))
         suite.addTest(loader.loadTestsFromTestCase(TestErrorHandling))
         suite.addTest(loader.loadTestsFromTestCase(TestFormatSpecificFeatures))
@@ -319,6 +319,85 @@ class TestFallbackSystem(unittest.TestCase):
         
         print("✅ Fallback configuration validated")
 
+class TestGoogleVisionBatching(unittest.TestCase):
+    """Test batched, concurrency-limited Vision requests against a fake client"""
+    
+    def setUp(self):
+        """Build a backend around a fake ImageAnnotatorClient"""
+        from unittest import mock
+        import threading
+        from ocr_engine import google_vision_backend
+        
+        self.vision_patch = mock.patch.object(google_vision_backend, 'vision', mock.MagicMock(), create=True)
+        self.vision_patch.start()
+        
+        self.lock = threading.Lock()
+        self.in_flight = 0
+        self.max_seen = 0
+        self.batch_sizes = []
+        self.failures_left = 0
+        
+        def batch_annotate_images(requests):
+            with self.lock:
+                if self.failures_left:
+                    self.failures_left -= 1
+                    error = RuntimeError("Quota exceeded")
+                    error.code = 429
+                    raise error
+                self.in_flight += 1
+                self.max_seen = max(self.max_seen, self.in_flight)
+                self.batch_sizes.append(len(requests))
+            time.sleep(0.02)
+            with self.lock:
+                self.in_flight -= 1
+            responses = []
+            for _ in requests:
+                response = mock.MagicMock()
+                response.error.message = ''
+                response.text_annotations = [mock.MagicMock(description='page text')]
+                responses.append(response)
+            return mock.MagicMock(responses=responses)
+        
+        config = {'batch_size': 4, 'max_in_flight': 2, 'retry_delay': 0.01}
+        self.backend = google_vision_backend.GoogleVisionBackend.__new__(google_vision_backend.GoogleVisionBackend)
+        self.backend.config = config
+        self.backend.logger = mock.MagicMock()
+        self.backend.error_handler = google_vision_backend.OCRErrorHandler(config)
+        self.backend.client = mock.MagicMock()
+        self.backend.client.batch_annotate_images.side_effect = batch_annotate_images
+        self.backend.available = True
+    
+    def tearDown(self):
+        """Remove the fake vision module"""
+        self.vision_patch.stop()
+    
+    def test_images_packed_into_limited_concurrent_batches(self):
+        """Ten images become three requests, never more than two in flight"""
+        progress = []
+        images = [b'png-bytes'] * 10
+        results = self.backend.extract_text_batch(images, progress_callback=lambda done, total: progress.append(done))
+        
+        self.assertEqual(len(results), 10)
+        self.assertTrue(all(result['text'] == 'page text' for result in results))
+        self.assertEqual(sorted(self.batch_sizes), [2, 4, 4])
+        self.assertLessEqual(self.max_seen, 2)
+        self.assertEqual(progress[-1], 10)
+    
+    def test_rate_limited_batches_are_retried(self):
+        """Quota errors are retried with backoff instead of failing the images"""
+        self.failures_left = 2
+        results = self.backend.extract_text_batch([b'png-bytes'] * 3)
+        
+        self.assertTrue(all(result['text'] == 'page text' for result in results))
+        self.assertEqual(self.batch_sizes, [3])
+    
+    def test_unreadable_image_fails_alone(self):
+        """A missing file is reported per image without sinking its batch"""
+        results = self.backend.extract_text_batch([b'png-bytes', '/nonexistent/image.png'])
+        
+        self.assertEqual(results[0]['text'], 'page text')
+        self.assertFalse(results[1]['success'])
+
 def run_google_vision_tests():
     """Run Google Vision API integration tests"""
     print("🧪 Running Google Vision API Integration Tests")
@@ -330,6 +409,7 @@ def run_google_vision_tests():
     # Add Google Vision API tests
     test_suite.addTest(unittest.makeSuite(TestGoogleVisionIntegration))
     test_suite.addTest(unittest.makeSuite(TestFallbackSystem))
+    test_suite.addTest(unittest.makeSuite(TestGoogleVisionBatching))
     
     # Run tests
     runner = unittest.TextTestRunner(verbosity=2)
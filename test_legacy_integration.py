@@ -333,6 +333,111 @@ class TestLegacyConfiguration(unittest.TestCase):
         
         print("✅ VFP9 configuration structure validated")
 
+class TestPipeServer(unittest.TestCase):
+    """Test the persistent converter server behind the pipe clients"""
+
+    def setUp(self):
+        """Start a server on a temporary socket"""
+        import threading
+        from pipe_server import ConversionService, SocketTransport
+
+        self.temp_dir = tempfile.mkdtemp()
+        self.service = ConversionService(max_concurrent=4)
+        self.transport = SocketTransport(self.service, port=0)
+        self.thread = threading.Thread(target=self.transport.serve_forever, daemon=True)
+        self.thread.start()
+
+        self.input_file = os.path.join(self.temp_dir, "input.txt")
+        with open(self.input_file, 'w', encoding='utf-8') as f:
+            f.write("Title\n\nBody text for the pipe server.")
+
+    def tearDown(self):
+        """Stop the server and clean up"""
+        import shutil
+        self.transport.shutdown()
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def _send(self, *payloads):
+        """Send raw request payloads on one connection and return the decoded responses"""
+        import socket
+        with socket.create_connection(self.transport.address, timeout=30) as connection:
+            stream = connection.makefile('rwb')
+            responses = []
+            for payload in payloads:
+                stream.write(payload + b'\n')
+                stream.flush()
+                responses.append(json.loads(stream.readline()))
+            return responses
+
+    def test_legacy_request_with_unescaped_paths(self):
+        """A request built like VB6_PipeClient.bas (bare backslashes) still resolves its paths"""
+        from pipe_server import decode_request
+        request = decode_request(b'{"input":"C:\\temp\\new\\a.md","output":"C:\\out\\b.rtf",'
+                                 b'"input_format":"markdown","output_format":"rtf"}')
+        self.assertEqual(request['input'], 'C:\\temp\\new\\a.md')
+
+        escaped = decode_request(json.dumps({'input': 'C:\\temp\\a.md'}).encode())
+        self.assertEqual(escaped['input'], 'C:\\temp\\a.md')
+
+    def test_many_requests_share_one_converter(self):
+        """Requests on one connection reuse the warm converter and report success"""
+        payloads = []
+        for index in range(3):
+            payloads.append(json.dumps({
+                'input': self.input_file,
+                'output': os.path.join(self.temp_dir, f"out_{index}.html"),
+                'input_format': 'text',
+                'output_format': 'html'
+            }).encode())
+        responses = self._send(*payloads)
+
+        self.assertEqual([response['status'] for response in responses], ['success'] * 3)
+        for index in range(3):
+            self.assertTrue(os.path.exists(os.path.join(self.temp_dir, f"out_{index}.html")))
+        self.assertEqual(self.service.stats['converted'], 3)
+
+    def test_failure_response_is_not_mistaken_for_success(self):
+        """Legacy clients search the response for "success"; failures must not contain it"""
+        response = self._send(json.dumps({
+            'input': os.path.join(self.temp_dir, 'missing.md'),
+            'output': os.path.join(self.temp_dir, 'out.txt'),
+            'output_format': 'txt'
+        }).encode())[0]
+
+        self.assertEqual(response['status'], 'failed')
+        self.assertNotIn('success', json.dumps(response).lower())
+
+    @unittest.skipUnless(hasattr(__import__('socket'), 'AF_UNIX'), "needs Unix sockets")
+    def test_default_unix_socket_is_private(self):
+        """The default socket sits in a 0700 per-user directory and only its owner may connect"""
+        import stat
+        from unittest import mock
+        from converter_core import DocumentConverterError
+        from pipe_server import SocketTransport, default_socket_path
+
+        env = {key: value for key, value in os.environ.items() if key != 'XDG_RUNTIME_DIR'}
+        with mock.patch.dict(os.environ, env, clear=True), mock.patch.object(tempfile, 'tempdir', self.temp_dir):
+            socket_path = default_socket_path()
+            transport = SocketTransport(self.service)
+            transport.server.server_close()
+            self.assertEqual(transport.address, socket_path)
+            self.assertEqual(stat.S_IMODE(os.stat(os.path.dirname(socket_path)).st_mode), 0o700)
+            self.assertEqual(stat.S_IMODE(os.stat(socket_path).st_mode), 0o600)
+
+            # A stale socket of ours is replaced; anything else at the path is left alone
+            SocketTransport(self.service).server.server_close()
+            os.unlink(socket_path)
+            with open(socket_path, 'w') as f:
+                f.write("not a socket")
+            with self.assertRaises(DocumentConverterError):
+                SocketTransport(self.service)
+            self.assertTrue(os.path.isfile(socket_path))
+
+            # A shared directory someone else could have prepared is refused
+            os.chmod(os.path.dirname(socket_path), 0o777)
+            with self.assertRaises(DocumentConverterError):
+                default_socket_path()
+
 def run_legacy_integration_tests():
     """Run legacy integration tests"""
     print("🧪 Running Legacy Integration Tests")
@@ -344,6 +449,7 @@ def run_legacy_integration_tests():
     # Add test classes
     test_suite.addTest(unittest.makeSuite(TestLegacyIntegration))
     test_suite.addTest(unittest.makeSuite(TestLegacyConfiguration))
+    test_suite.addTest(unittest.makeSuite(TestPipeServer))
     
     # Run tests
     runner = unittest.TextTestRunner(verbosity=2)
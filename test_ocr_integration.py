@@ -7,6 +7,7 @@ Tests all aspects of the OCR functionality in the Universal Document Converter
 import os
 import sys
 import tempfile
+import time
 import unittest
 from pathlib import Path
 import json
@@ -62,6 +63,27 @@ class TestOCREngine(unittest.TestCase):
         result = self.ocr_engine.extract_text(invalid_file)
         self.assertEqual(result, "")
 
+    def test_google_vision_skips_local_preprocessing(self):
+        """Vision uploads the original image; preprocessing runs once, only on fallback"""
+        from unittest import mock
+        image = np.zeros((20, 20, 3), dtype=np.uint8)
+        engine = self.ocr_engine
+        options = {'backend': 'google_vision', 'use_cache': False}
+
+        with mock.patch.object(engine, 'is_google_vision_available', return_value=True), \
+                mock.patch.object(engine, 'is_tesseract_available', return_value=True), \
+                mock.patch.object(engine.image_processor, 'preprocess_image', return_value=image) as preprocess, \
+                mock.patch.object(engine, '_extract_with_tesseract', return_value={'text': 'local'}), \
+                mock.patch.object(engine, '_extract_with_google_vision', return_value={'text': 'cloud'}) as vision:
+            self.assertEqual(engine.extract_text(image, options)['text'], 'cloud')
+            preprocess.assert_not_called()
+
+            vision.side_effect = RuntimeError("quota exceeded")
+            result = engine.extract_text(image, options)
+            self.assertEqual(result['text'], 'local')
+            self.assertTrue(result['fallback'])
+            preprocess.assert_called_once()
+
 class TestOCRIntegration(unittest.TestCase):
     """Test the OCR integration layer"""
     
@@ -174,6 +196,73 @@ class TestImageProcessor(unittest.TestCase):
         enhanced = self.processor.enhance_image(test_image)
         self.assertIsNotNone(enhanced)
 
+    def test_load_image_from_memory(self):
+        """Arrays are used as-is and encoded bytes are decoded without a file"""
+        import cv2
+        img_array = np.zeros((20, 30, 3), dtype=np.uint8)
+        self.assertIs(self.processor.load_image(img_array), img_array)
+
+        ok, encoded = cv2.imencode('.png', img_array)
+        self.assertTrue(ok)
+        decoded = self.processor.load_image(encoded.tobytes())
+        self.assertEqual(decoded.shape, (20, 30, 3))
+
+    def test_preprocess_reuses_buffers_without_aliasing(self):
+        """Scratch buffers are reused, but results and inputs are never shared or modified"""
+        from PIL import ImageEnhance
+        img_array = np.random.randint(0, 255, (40, 60, 3), dtype=np.uint8)
+        original = img_array.copy()
+
+        first = self.processor.preprocess_image(img_array, {'denoise': False})
+        second = self.processor.preprocess_image(np.zeros_like(img_array), {'denoise': False})
+        self.assertTrue(np.array_equal(img_array, original))
+        self.assertEqual(first.shape, (40, 60))
+        self.assertFalse(np.shares_memory(first, second))
+
+        # The lookup-table contrast matches PIL's ImageEnhance.Contrast
+        gray = np.random.randint(0, 255, (30, 30), dtype=np.uint8)
+        expected = np.array(ImageEnhance.Contrast(Image.fromarray(gray)).enhance(1.5)).astype(int)
+        self.assertLessEqual(np.abs(self.processor.enhance_contrast(gray, 1.5).astype(int) - expected).max(), 1)
+
+    def test_adaptive_plan_skips_denoise_on_clean_pages(self):
+        """Quality analysis denoises a noisy scan but not a clean render, and records the plan"""
+        page = np.full((400, 600), 255, dtype=np.uint8)
+        for row in range(40, 360, 30):
+            page[row:row + 12, 40:560] = 20  # text-line-like bars
+
+        _, clean_plan = self.processor.preprocess_with_plan(page)
+        self.assertNotIn('denoise', clean_plan['steps'])
+        self.assertEqual(clean_plan['threshold_method'], 'otsu')
+        self.assertLess(clean_plan['quality']['noise'], 1.0)
+
+        rng = np.random.default_rng(0)
+        noisy = np.clip(page + rng.normal(0, 20, page.shape), 0, 255).astype(np.uint8)
+        _, noisy_plan = self.processor.preprocess_with_plan(noisy)
+        self.assertIn('denoise', noisy_plan['steps'])
+
+        _, fixed_plan = self.processor.preprocess_with_plan(page, {'adaptive': False})
+        self.assertEqual(fixed_plan['steps'], ['contrast', 'denoise', 'threshold'])
+
+    def test_opencl_pipeline_applies_contrast_and_denoise(self):
+        """The cv2.UMat path runs contrast and denoise instead of skipping them with a warning"""
+        from unittest import mock
+        from ocr_engine import image_processor
+        if not isinstance(getattr(image_processor.cv2, 'UMat', None), type) or not image_processor.opencl_available():
+            self.skipTest("OpenCL is not available")
+        rng = np.random.default_rng(0)
+        page = np.clip(110 + rng.normal(0, 15, (120, 160)), 0, 255).astype(np.uint8)
+        options = {'adaptive': False, 'threshold_method': 'none', 'use_opencl': True}
+
+        with mock.patch.object(self.processor.logger, 'warning') as warning:
+            plain, _ = self.processor.preprocess_with_plan(page, {**options, 'enhance_contrast': False, 'denoise': False})
+            contrast, plan = self.processor.preprocess_with_plan(page, {**options, 'denoise': False})
+            denoised, _ = self.processor.preprocess_with_plan(page, {**options, 'enhance_contrast': False})
+        warning.assert_not_called()
+        self.assertTrue(plan['opencl'])
+        self.assertEqual(plan['steps'], ['contrast'])
+        self.assertFalse(np.array_equal(contrast, plain))
+        self.assertFalse(np.array_equal(denoised, plain))
+
 class TestConfiguration(unittest.TestCase):
     """Test configuration and settings"""
     
@@ -260,6 +349,749 @@ class TestErrorHandling(unittest.TestCase):
         finally:
             os.unlink(empty_file)
 
+class TestPdfOCRPipeline(unittest.TestCase):
+    """Test page-parallel PDF OCR"""
+
+    def setUp(self):
+        """Set up a fake PyMuPDF document with every third page born-digital"""
+        from unittest import mock
+
+        class FakePage:
+            def __init__(self, index):
+                self.index = index
+
+            def get_text(self):
+                return "embedded text " * 10 if self.index % 3 == 0 else ""
+
+            def get_pixmap(self, **kwargs):
+                # 3x2 grayscale pixmap with one byte of row padding, filled with the page index
+                pixmap = mock.MagicMock(width=3, height=2, stride=4, n=1, samples_mv=None)
+                pixmap.samples = bytes([self.index]) * 8
+                return pixmap
+
+        class FakeDoc(list):
+            def close(self):
+                pass
+
+        self.temp_dir = tempfile.mkdtemp()
+        self.pdf_path = os.path.join(self.temp_dir, 'scan.pdf')
+        Path(self.pdf_path).write_bytes(b'%PDF-1.4')
+
+        fake_fitz = mock.MagicMock()
+        fake_fitz.open = lambda path: FakeDoc(FakePage(i) for i in range(9))
+        self.fitz_patch = mock.patch.dict(sys.modules, {'fitz': fake_fitz})
+        self.fitz_patch.start()
+
+        self.ocr_engine = OCREngine()
+        self.ocr_engine.extract_text = lambda image, options=None: {'text': f"ocr page_{int(image[0, 0])}"}
+
+    def tearDown(self):
+        """Clean up test environment"""
+        import shutil
+        self.fitz_patch.stop()
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_pages_returned_in_order_with_progress(self):
+        """OCR'd and embedded pages are merged in page order and progress covers every page"""
+        progress = []
+        text = self.ocr_engine.extract_text_from_pdf(
+            self.pdf_path, max_workers=3, progress_callback=lambda done, total: progress.append((done, total))
+        )
+
+        page_markers = [line for line in text.splitlines() if line.startswith('--- Page')]
+        self.assertEqual(page_markers, [f"--- Page {i} ---" for i in range(1, 10)])
+        self.assertIn("ocr page_1", text)
+        self.assertIn("embedded text", text)
+        self.assertEqual(progress[-1], (9, 9))
+        self.assertEqual(len(progress), 9)
+
+    def test_pages_ocr_from_memory(self):
+        """Rendered pages reach the OCR call as arrays without touching disk"""
+        seen = []
+        self.ocr_engine.extract_text = lambda image, options=None: seen.append(image) or {'text': ''}
+        self.ocr_engine.extract_text_from_pdf(self.pdf_path, max_workers=2)
+
+        self.assertEqual(len(seen), 6)
+        self.assertTrue(all(isinstance(image, np.ndarray) and image.shape == (2, 3) for image in seen))
+        self.assertEqual(os.listdir(self.temp_dir), ['scan.pdf'])
+
+    def test_partial_extraction_with_cursor(self):
+        """A partial read only OCRs the pages it returns and resumes from its cursor"""
+        seen = []
+        self.ocr_engine.extract_text = lambda image, options=None: seen.append(image) or {'text': "ocr text"}
+
+        first = self.ocr_engine.extract_text_partial(self.pdf_path, max_pages=3, max_workers=2)
+        self.assertEqual([num for num, _ in first['pages']], [1, 2, 3])
+        self.assertEqual((first['cursor'], first['complete']), (3, False))
+        self.assertEqual(len(seen), 2)
+
+        rest = self.ocr_engine.extract_text_partial(self.pdf_path, cursor=first['cursor'], max_workers=2)
+        self.assertEqual([num for num, _ in rest['pages']], list(range(4, 10)))
+        self.assertTrue(rest['complete'])
+        self.assertIn("--- Page 9 ---", rest['text'])
+        self.assertEqual(len(seen), 6)
+
+    def test_google_vision_annotates_whole_pdf_with_local_fallback(self):
+        """With Vision selected the PDF goes to file annotation; a failure falls back to page OCR"""
+        from unittest import mock
+        engine = self.ocr_engine
+        with mock.patch.object(engine, 'is_google_vision_available', return_value=True), \
+                mock.patch.object(engine, 'google_vision_backend', create=True) as vision:
+            vision.extract_text_from_pdf.return_value = {'text': "cloud text", 'pages': [(0, "cloud text")]}
+            self.assertEqual(engine.extract_text_from_pdf(self.pdf_path, backend='google_vision'), "cloud text")
+            self.assertEqual(vision.extract_text_from_pdf.call_args[0][0], self.pdf_path)
+
+            vision.extract_text_from_pdf.side_effect = RuntimeError("bad pdf")
+            text = engine.extract_text_from_pdf(self.pdf_path, backend='google_vision')
+        self.assertIn("ocr page_1", text)
+        self.assertIn("--- Page 9 ---", text)
+
+    def test_google_vision_pdf_sends_each_page_once(self):
+        """Inline file annotation sends five-page slices, not the whole PDF per group"""
+        from types import SimpleNamespace
+        from unittest import mock
+        from ocr_engine import google_vision_backend as gvb
+
+        class FakeFeature(SimpleNamespace):
+            Type = SimpleNamespace(DOCUMENT_TEXT_DETECTION='document_text_detection')
+
+        class FakeSlice:
+            def insert_pdf(self, doc, from_page, to_page):
+                self.pages = (from_page, to_page)
+
+            def tobytes(self, **kwargs):
+                return f"{self.pages[0]}-{self.pages[1]}".encode()
+
+            def close(self):
+                pass
+
+        def annotate_files(requests):
+            request, = requests
+            first = int(request.input_config.content.split(b'-')[0])
+            pages = [SimpleNamespace(error=SimpleNamespace(message=''),
+                                     full_text_annotation=SimpleNamespace(text=f"text {first + offset} "))
+                     for offset in range(len(request.pages))]
+            return SimpleNamespace(responses=[SimpleNamespace(error=SimpleNamespace(message=''),
+                                                              responses=pages)])
+
+        fake_vision = SimpleNamespace(AnnotateFileRequest=SimpleNamespace, InputConfig=SimpleNamespace,
+                                      Feature=FakeFeature)
+        fitz_module = sys.modules['fitz']
+        open_document = fitz_module.open
+        with mock.patch.object(gvb, 'vision', fake_vision, create=True), \
+                mock.patch.object(fitz_module, 'open', lambda path=None: FakeSlice() if path is None
+                                  else open_document(path)):
+            backend = gvb.GoogleVisionBackend({'max_in_flight': 2})
+            backend.client, backend.available = mock.MagicMock(), True
+            backend.client.batch_annotate_files.side_effect = annotate_files
+            progress = []
+            result = backend.extract_text_from_pdf(self.pdf_path, start_page=1,
+                                                   progress_callback=lambda done, total: progress.append(done))
+
+        sent = [call.kwargs['requests'][0].input_config.content
+                for call in backend.client.batch_annotate_files.call_args_list]
+        self.assertEqual(sorted(sent), [b'1-5', b'6-8'])
+        self.assertEqual(result['pages'], [(page, f"text {page}") for page in range(1, 9)])
+        self.assertIn("--- Page 9 ---\ntext 8", result['text'])
+        self.assertEqual((len(progress), progress[-1]), (2, 8))
+
+class TestEasyOCRReaderPool(unittest.TestCase):
+    """Test the shared EasyOCR reader pool"""
+
+    def setUp(self):
+        """Replace easyocr.Reader with a cheap fake that counts model loads"""
+        from unittest import mock
+        from ocr_engine import easyocr_pool
+
+        self.loads = []
+
+        class FakeReader:
+            def __init__(reader, languages, gpu=False, verbose=False):
+                self.loads.append(gpu)
+
+            def readtext(reader, image, **kwargs):
+                time.sleep(0.01)
+                return [(None, f"single {image.shape[1]}", 0.9)]
+
+            def readtext_batched(reader, images, **kwargs):
+                return [[(None, f"batched {image.shape[1]}", 0.9)] for image in images]
+
+        fake_easyocr = mock.MagicMock(Reader=FakeReader)
+        self.easyocr_patch = mock.patch.object(easyocr_pool, 'easyocr', fake_easyocr, create=True)
+        self.easyocr_patch.start()
+        self.pool_class = easyocr_pool.EasyOCRReaderPool
+
+    def tearDown(self):
+        """Restore easyocr"""
+        self.easyocr_patch.stop()
+
+    def test_readers_shared_across_threads(self):
+        """Eight threads share two readers instead of loading eight models"""
+        from concurrent.futures import ThreadPoolExecutor
+        pool = self.pool_class(['en'], size=2)
+        image = np.zeros((10, 10), dtype=np.uint8)
+
+        with ThreadPoolExecutor(max_workers=8) as executor:
+            list(executor.map(lambda _: pool.readtext(image), range(32)))
+
+        self.assertEqual(len(self.loads), 2)
+
+    def test_warm_preloads_readers(self):
+        """warm() loads the pool up front so the first request is fast"""
+        pool = self.pool_class(['en'], size=3, gpu=True)
+        self.assertEqual(pool.warm(), 3)
+        self.assertEqual(self.loads, [True, True, True])
+        self.assertEqual(pool.get_stats()['idle'], 3)
+
+    def test_batch_groups_same_sized_images(self):
+        """Same-shaped images share a batched call; odd ones are read singly, order kept"""
+        pool = self.pool_class(['en'], size=1)
+        images = [np.zeros((10, width), dtype=np.uint8) for width in (20, 30, 20)]
+
+        results = pool.readtext_batch(images)
+        self.assertEqual([r[0][1] for r in results], ["batched 20", "single 30", "batched 20"])
+
+class TestTesseractAPIPool(unittest.TestCase):
+    """Test the in-process Tesseract engine pool"""
+
+    def setUp(self):
+        """Replace tesserocr with a fake API that counts model loads and recognitions"""
+        from unittest import mock
+        from ocr_engine import tesseract_api
+
+        self.loads = []
+        self.recognitions = []
+        test = self
+
+        class FakeWord:
+            def __init__(word, text, box, confidence):
+                word.text, word.box, word.confidence = text, box, confidence
+
+            def GetUTF8Text(word, level):
+                return word.text
+
+            def BoundingBox(word, level):
+                return word.box
+
+            def Confidence(word, level):
+                return word.confidence
+
+        class FakeAPI:
+            def __init__(api, lang='eng', psm=None, oem=None, path=None):
+                if lang == 'missing':
+                    raise RuntimeError("Failed to init API, possibly an invalid tessdata path")
+                test.loads.append((lang, psm, oem))
+                api.variables = {}
+
+            def SetVariable(api, key, value):
+                api.variables[key] = value
+
+            def SetImageBytes(api, data, width, height, bytes_per_pixel, bytes_per_line):
+                api.image = (len(data), width, height, bytes_per_pixel, bytes_per_line)
+
+            def Recognize(api):
+                test.recognitions.append(api.image)
+
+            def GetUTF8Text(api):
+                return "Hello world\n"
+
+            def GetIterator(api):
+                return [FakeWord("Hello", (2, 3, 30, 13), 91.0), FakeWord("world", (34, 3, 70, 13), 87.0)]
+
+            def Clear(api):
+                api.image = None
+
+            def End(api):
+                pass
+
+        fake_tesserocr = mock.MagicMock(PyTessBaseAPI=FakeAPI, iterate_level=lambda iterator, level: iterator)
+        self.tesserocr_patch = mock.patch.object(tesseract_api, 'tesserocr', fake_tesserocr, create=True)
+        self.tesserocr_patch.start()
+        self.tesseract_api = tesseract_api
+
+    def tearDown(self):
+        """Restore tesserocr"""
+        self.tesserocr_patch.stop()
+
+    def test_config_options_reach_the_api(self):
+        """OEM, PSM and -c variables from tesseract_config are applied to each engine"""
+        self.assertEqual(self.tesseract_api.parse_tesseract_config('--oem 1 --psm 4 -c preserve_interword_spaces=1'),
+                         (1, 4, {'preserve_interword_spaces': '1'}))
+        pool = self.tesseract_api.TesseractAPIPool(['eng', 'deu'], '--oem 1 --psm 4 -c preserve_interword_spaces=1')
+        with pool.api() as api:
+            self.assertEqual(api.variables, {'preserve_interword_spaces': '1'})
+        self.assertEqual(self.loads, [('eng+deu', 4, 1)])
+
+    def test_one_pass_per_image_with_one_model_load(self):
+        """Text, word boxes and confidence come from a single recognition on a reused engine"""
+        pool = self.tesseract_api.TesseractAPIPool(['eng'], size=1)
+        image = np.zeros((20, 80), dtype=np.uint8)
+
+        first = pool.recognize(image)
+        pool.recognize(image)
+        self.assertEqual(len(self.loads), 1)
+        self.assertEqual(self.recognitions, [(1600, 80, 20, 1, 80)] * 2)
+        self.assertEqual(first['text'], "Hello world\n")
+        self.assertEqual(first['words'][1], (34, 3, 36, 10, "world", 87.0))
+        self.assertAlmostEqual(first['confidence'], 89.0)
+
+    def test_engine_falls_back_to_cli_when_api_cannot_start(self):
+        """With tesseract_engine 'auto', a failing API init switches the engine to one image_to_data call"""
+        from unittest import mock
+        from ocr_engine import ocr_engine as engine_module
+
+        data = {'text': ['', 'Hello', 'world', 'Next'], 'conf': ['-1', '90', '80', '70'],
+                'left': [0, 1, 20, 1], 'top': [0, 1, 1, 30], 'width': [0, 15, 15, 15], 'height': [0, 9, 9, 9],
+                'block_num': [1, 1, 1, 2], 'par_num': [1, 1, 1, 1], 'line_num': [1, 1, 1, 1]}
+        fake_pytesseract = mock.MagicMock()
+        fake_pytesseract.image_to_data.return_value = data
+        engine = OCREngine()
+        with mock.patch.object(engine_module, 'TESSEROCR_AVAILABLE', True), \
+                mock.patch.object(engine_module, 'TESSERACT_AVAILABLE', True), \
+                mock.patch.object(engine_module, 'pytesseract', fake_pytesseract, create=True):
+            options = {**engine.config, 'languages': ['missing']}
+            result = engine._extract_with_tesseract(np.zeros((40, 40), dtype=np.uint8), options)
+            engine._extract_with_tesseract(np.zeros((40, 40), dtype=np.uint8), options)
+
+        self.assertEqual(result['text'], "Hello world\n\nNext")
+        self.assertEqual(result['tesseract_engine'], 'cli')
+        self.assertAlmostEqual(result['confidence'], 80.0)
+        self.assertEqual(fake_pytesseract.image_to_string.call_count, 0)
+        self.assertEqual(fake_pytesseract.image_to_data.call_count, 2)
+
+class TestOCRResultCache(unittest.TestCase):
+    """Test the indexed OCR result cache"""
+
+    def setUp(self):
+        """Set up test environment"""
+        from ocr_engine.cache_store import OCRResultCache
+        self.temp_dir = tempfile.mkdtemp()
+        self.cache_class = OCRResultCache
+
+    def tearDown(self):
+        """Clean up test environment"""
+        import shutil
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_round_trip_with_metadata(self):
+        """Text, confidence and metadata survive a reopen"""
+        cache = self.cache_class(self.temp_dir)
+        cache.put('k', 'hello world', 87.5, {'backend': 'tesseract'})
+        cache.close()
+
+        entry = self.cache_class(self.temp_dir).get('k')
+        self.assertEqual(entry['text'], 'hello world')
+        self.assertEqual(entry['confidence'], 87.5)
+        self.assertEqual(entry['metadata'], {'backend': 'tesseract'})
+
+    def test_expired_entries_are_dropped(self):
+        """Entries older than the TTL miss and are removed"""
+        cache = self.cache_class(self.temp_dir, ttl=0.05)
+        cache.put('k', 'stale')
+        time.sleep(0.1)
+        self.assertIsNone(cache.get('k'))
+        self.assertEqual(cache.get_stats()['entry_count'], 0)
+
+    def test_size_cap_evicts_least_recently_used(self):
+        """Writes past the cap evict the coldest entries first"""
+        cache = self.cache_class(self.temp_dir, max_size_mb=0.01)
+        for index in range(4):
+            cache.put(f'k{index}', 'x' * 3000)
+            time.sleep(0.01)
+            cache.get('k0')  # keep the first entry hot
+
+        self.assertIsNotNone(cache.get('k0'))
+        self.assertIsNone(cache.get('k1'))
+        self.assertLessEqual(cache.get_stats()['total_size'], 0.01 * 1024 * 1024)
+
+    def test_full_content_hash_distinguishes_shared_headers(self):
+        """Files that only differ after the first kilobyte get different hashes"""
+        from ocr_engine.cache_store import new_content_hasher, update_hasher_from_file
+        digests = []
+        for tail in (b'page one', b'page two'):
+            path = Path(self.temp_dir) / f"{tail.decode()}.tif"
+            path.write_bytes(b'\0' * 4096 + tail)
+            hasher = new_content_hasher()
+            update_hasher_from_file(hasher, path)
+            digests.append(hasher.hexdigest())
+        self.assertNotEqual(digests[0], digests[1])
+
+class TestTiledOCR(unittest.TestCase):
+    """Test full-resolution tiled OCR of oversized images"""
+
+    def test_tile_cores_partition_the_image(self):
+        """Tile cores cover every pixel exactly once and tiles stay full size"""
+        from ocr_engine.memory_processor import MemoryEfficientImageProcessor
+        positions = MemoryEfficientImageProcessor.tile_positions(5000, 2048, 128)
+        cores = MemoryEfficientImageProcessor.tile_cores(positions, 2048, 5000)
+
+        self.assertEqual(positions[-1], 5000 - 2048)
+        self.assertEqual(cores[0][0], 0)
+        self.assertEqual(cores[-1][1], 5000)
+        for (_, end), (start, _) in zip(cores, cores[1:]):
+            self.assertEqual(end, start)
+        for position, (start, end) in zip(positions, cores):
+            self.assertTrue(position <= start < end <= position + 2048)
+
+    def test_tile_size_follows_memory_estimate(self):
+        """A smaller memory budget yields smaller tiles"""
+        from ocr_engine.memory_processor import MemoryEfficientImageProcessor
+        processor = MemoryEfficientImageProcessor()
+        large = processor.plan_tile_size({'channels': 1}, 40 * 1024 * 1024)
+        small = processor.plan_tile_size({'channels': 1}, 4 * 1024 * 1024)
+        self.assertGreater(large, small)
+        estimate = processor.estimate_memory_usage({'width': small, 'height': small, 'channels': 1})
+        self.assertLessEqual(estimate, 4 * 1024 * 1024)
+
+    def test_overlapping_words_are_merged_once_in_reading_order(self):
+        """Words seen by two tiles appear once; lines read top-to-bottom, left-to-right"""
+        from unittest import mock
+        engine = OCREngine()
+        image = np.zeros((1000, 3000), dtype=np.uint8)
+        page = [(100, 100, 200, 40, 'first', 90.0), (1400, 100, 140, 40, 'seam', 90.0),
+                (2700, 100, 200, 40, 'line', 90.0), (100, 150, 200, 40, 'second', 90.0)]
+
+        def words_in_tile(tile, backend, options):
+            # Report every word fully inside this tile, in tile coordinates
+            x0 = tile.__array_interface__['data'][0] - image.__array_interface__['data'][0]
+            return [(x - x0, y, w, h, text, conf) for x, y, w, h, text, conf in page
+                    if x0 <= x and x + w <= x0 + tile.shape[1]]
+
+        options = {**engine.config, 'tile_max_size': 2048, 'tile_overlap': 256, 'tile_workers': 2}
+        with mock.patch.object(engine.image_processor, 'preprocess_image', side_effect=lambda tile, opts: tile), \
+                mock.patch.object(engine, '_tile_words', side_effect=words_in_tile):
+            self.assertTrue(engine._needs_tiling(image, options))
+            result = engine._extract_tiled(image, 'tesseract', options)
+
+        self.assertEqual(result['text'], "first seam line\nsecond")
+        self.assertEqual(result['tile_count'], 2)
+
+class TestStreamingOCRBatches(unittest.TestCase):
+    """Test bounded, streamed OCR batch processing"""
+
+    def setUp(self):
+        """Set up test environment"""
+        self.temp_dir = Path(tempfile.mkdtemp())
+
+    def tearDown(self):
+        """Clean up test environment"""
+        import shutil
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_process_files_pulls_lazily_and_resumes(self):
+        """Only a window of files is pulled ahead; existing outputs are skipped on resume"""
+        import threading
+        from unittest import mock
+        integration = OCRIntegration()
+        integration.is_available = True
+        scans = []
+        for i in range(22):
+            scan = self.temp_dir / f"scan{i}.png"
+            scan.write_bytes(b"png")
+            scans.append(str(scan))
+        output_dir = self.temp_dir / "out"
+        output_dir.mkdir()
+        pulled = []
+        done = []
+        calls = []
+        peak = [0]
+        lock = threading.Lock()
+
+        def images():
+            for scan in scans[:20]:
+                with lock:
+                    pulled.append(scan)
+                    peak[0] = max(peak[0], len(pulled) - len(done))
+                yield scan
+
+        def fake_process(file_path, output_dir, output_format):
+            calls.append(file_path)
+            time.sleep(0.005)
+            output = Path(output_dir) / (Path(file_path).stem + '.txt')
+            output.write_text("text", encoding='utf-8')
+            with lock:
+                done.append(file_path)
+            return {'file': file_path, 'output_file': str(output), 'success': True}
+
+        with mock.patch.object(integration, '_process_single_file', side_effect=fake_process):
+            result = integration.process_files(images(), str(output_dir), max_workers=2, max_in_flight=4,
+                                               collect_results=False)
+            self.assertEqual(result['successful'], 20)
+            self.assertEqual(result['results'], [])
+            self.assertLessEqual(peak[0], 5)
+
+            calls.clear()
+            resumed = list(integration.iter_process_files(scans, str(output_dir), max_workers=2,
+                                                          skip_existing=True))
+        self.assertEqual(sum(1 for r in resumed if r.get('skipped')), 20)
+        self.assertEqual(sorted(calls), sorted(scans[20:]))
+
+    def test_batched_vision_accepts_arrays(self):
+        """Arrays reach batched Vision encoded in memory and are cached by their content"""
+        from unittest import mock
+        from ocr_engine.cache_store import OCRResultCache
+        engine = OCREngine()
+        engine.result_cache = OCRResultCache(self.temp_dir / "cache")
+        images = [np.full((20, 30, 3), shade, dtype=np.uint8) for shade in (0, 128, 255)]
+        options = {'backend': 'google_vision', 'use_cache': True}
+
+        def annotate(inputs, options, progress_callback=None):
+            return [{'text': f"page {i}"} for i in range(len(inputs))]
+
+        with mock.patch.object(engine, 'is_google_vision_available', return_value=True), \
+                mock.patch.object(engine, 'google_vision_backend', create=True) as vision:
+            vision.extract_text_batch.side_effect = annotate
+            first = dict(engine.iter_extract_text(images, options))
+            second = dict(engine.iter_extract_text(images, options))
+
+        self.assertEqual(vision.extract_text_batch.call_count, 1)
+        self.assertTrue(all(isinstance(item, bytes) for item in vision.extract_text_batch.call_args[0][0]))
+        self.assertEqual([first[i]['text'] for i in range(3)], ['page 0', 'page 1', 'page 2'])
+        self.assertTrue(first[0]['image_path'].startswith('<array'))
+        self.assertEqual([second[i]['source'] for i in range(3)], ['cache'] * 3)
+        self.assertEqual(second[2]['text'], 'page 2')
+
+    def test_batched_vision_failures_fall_back_locally(self):
+        """An image batched Vision fails on is recognised locally, like in extract_text"""
+        from unittest import mock
+        engine = OCREngine()
+        images = [b'scan one', b'scan two']
+
+        def annotate(inputs, options, progress_callback=None):
+            return [{'text': 'cloud'}, {'text': '', 'error': 'image too large', 'success': False}]
+
+        with mock.patch.object(engine, 'is_google_vision_available', return_value=True), \
+                mock.patch.object(engine, 'is_tesseract_available', return_value=True), \
+                mock.patch.object(engine, '_needs_tiling', return_value=False), \
+                mock.patch.object(engine.image_processor, 'preprocess_with_plan', return_value=(None, {'steps': []})), \
+                mock.patch.object(engine, '_extract_with_tesseract', side_effect=lambda *_: {'text': 'local'}), \
+                mock.patch.object(engine, 'google_vision_backend', create=True) as vision:
+            vision.extract_text_batch.side_effect = annotate
+            results = dict(engine.iter_extract_text(images, {'backend': 'google_vision', 'use_cache': False}))
+
+        self.assertEqual((results[0]['text'], results[1]['text']), ('cloud', 'local'))
+        self.assertTrue(results[1]['fallback'])
+        self.assertEqual(results[1]['fallback_backend'], 'tesseract')
+        self.assertIn('image too large', results[1]['fallback_reason'])
+
+    def test_batched_vision_claims_the_half_open_probe(self):
+        """Only one batch probes a half-open circuit, and only API call failures count against it"""
+        from unittest import mock
+        from ocr_engine.backend_router import BackendRouter, CLOSED, HALF_OPEN, OPEN
+        now = [0.0]
+        engine = OCREngine()
+        engine.router = BackendRouter({'circuit_failures': 1, 'circuit_cooldown': 10.0}, clock=lambda: now[0])
+        health = engine.router.health('google_vision')
+        health.record_failure(1.0, "deadline exceeded")
+        now[0] = 11.0
+        images = [b'scan one', b'scan two']
+        replies = []
+
+        def annotate(inputs, options, progress_callback=None):
+            return replies.pop(0)
+
+        with mock.patch.object(engine, 'is_google_vision_available', return_value=True), \
+                mock.patch.object(engine, 'is_tesseract_available', return_value=True), \
+                mock.patch.object(engine, '_needs_tiling', return_value=False), \
+                mock.patch.object(engine.image_processor, 'preprocess_with_plan', return_value=(None, {'steps': []})), \
+                mock.patch.object(engine, '_extract_with_tesseract', side_effect=lambda *_: {'text': 'local'}), \
+                mock.patch.object(engine, 'google_vision_backend', create=True) as vision:
+            vision.extract_text_batch.side_effect = annotate
+            options = {'backend': 'google_vision', 'use_cache': False}
+
+            # Images that could not be loaded record nothing and free the probe
+            replies.append([{'text': '', 'error': 'not found', 'success': False, 'unreadable': True}] * 2)
+            engine._extract_batch_with_google_vision(images, options)
+            self.assertEqual(health.state, HALF_OPEN)
+            self.assertTrue(health.accepting())
+
+            # While another caller holds the probe the batch stays local
+            self.assertTrue(health.allow())
+            results = engine._extract_batch_with_google_vision(images, options)
+            self.assertEqual(vision.extract_text_batch.call_count, 1)
+            self.assertEqual([r['fallback_backend'] for r in results], ['tesseract'] * 2)
+            self.assertIn('circuit open', results[0]['fallback_reason'])
+            health.release()
+
+            # An image Vision answered with an error still shows the service is up
+            replies.append([{'text': 'cloud'}, {'text': '', 'error': 'bad image data', 'success': False}])
+            results = engine._extract_batch_with_google_vision(images, options)
+            self.assertEqual(health.state, CLOSED)
+            self.assertNotIn('request_failed', results[0])
+
+            # Failed API calls do count
+            replies.append([{'text': '', 'error': 'unavailable', 'success': False, 'request_failed': True}] * 2)
+            engine._extract_batch_with_google_vision(images, options)
+            self.assertEqual(health.state, OPEN)
+
+class TestImageHeaderEstimates(unittest.TestCase):
+    """Test memory estimates taken from image headers before decoding"""
+
+    def setUp(self):
+        """Set up test environment"""
+        self.temp_dir = Path(tempfile.mkdtemp())
+
+    def tearDown(self):
+        """Clean up test environment"""
+        import shutil
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def _write(self, name, data):
+        path = self.temp_dir / name
+        path.write_bytes(data)
+        return str(path)
+
+    def test_header_dimensions(self):
+        """PNG, GIF, BMP, JPEG and TIFF headers are read without loading pixels"""
+        import struct
+        from ocr_engine.memory_processor import MemoryEfficientImageProcessor
+        read = MemoryEfficientImageProcessor.read_image_header
+        png = b'\x89PNG\r\n\x1a\n' + struct.pack('>I', 13) + b'IHDR' + struct.pack('>IIBBBBB', 2480, 3508, 8, 0, 0, 0, 0)
+        gif = b'GIF89a' + struct.pack('<HH', 640, 480) + b'\x00' * 8
+        bmp = b'BM' + b'\x00' * 16 + struct.pack('<ii', 800, -600) + b'\x00' * 8
+        jpeg = (b'\xff\xd8' + b'\xff\xe0' + struct.pack('>H', 16) + b'\x00' * 14 +
+                b'\xff\xc0' + struct.pack('>HBHHB', 17, 8, 1200, 1600, 3) + b'\x00' * 9)
+        tiff = (b'II*\x00' + struct.pack('<I', 8) + struct.pack('<H', 3) +
+                struct.pack('<HHIHH', 256, 3, 1, 5000, 0) + struct.pack('<HHII', 257, 4, 1, 7000) +
+                struct.pack('<HHIHH', 277, 3, 1, 1, 0) + b'\x00' * 4)
+
+        self.assertEqual(read(self._write("a.png", png)), {'width': 2480, 'height': 3508, 'channels': 1})
+        self.assertEqual(read(self._write("a.gif", gif)), {'width': 640, 'height': 480, 'channels': 3})
+        self.assertEqual(read(self._write("a.bmp", bmp)), {'width': 800, 'height': 600, 'channels': 3})
+        self.assertEqual(read(self._write("a.jpg", jpeg)), {'width': 1600, 'height': 1200, 'channels': 3})
+        self.assertEqual(read(self._write("a.tif", tiff)), {'width': 5000, 'height': 7000, 'channels': 1})
+        self.assertEqual(read(self._write("a.png", b'not an image')), {})
+
+    def test_file_estimate_scales_with_pixels(self):
+        """Estimates use header dimensions, falling back to file size"""
+        import struct
+        from ocr_engine.memory_processor import MemoryEfficientImageProcessor
+        processor = MemoryEfficientImageProcessor()
+
+        def png(width, height):
+            return (b'\x89PNG\r\n\x1a\n' + struct.pack('>I', 13) + b'IHDR' +
+                    struct.pack('>IIBBBBB', width, height, 8, 2, 0, 0, 0))
+
+        small = processor.estimate_file_memory(self._write("small.png", png(100, 100)))
+        large = processor.estimate_file_memory(self._write("large.png", png(10000, 10000)))
+        self.assertEqual(small, processor.estimate_memory_usage({'width': 100, 'height': 100, 'channels': 3}))
+        self.assertEqual(large, small * 10000)
+        self.assertEqual(processor.estimate_file_memory(self._write("broken.png", b'x' * 50)), 500)
+
+class TestBackendRouter(unittest.TestCase):
+    """Test circuit breaking, hedging and scheduled retries across OCR backends"""
+
+    def test_open_circuit_skips_to_fallback_until_probe(self):
+        """Failing Vision opens its circuit; after the cooldown one probe closes it again"""
+        from ocr_engine.backend_router import BackendRouter, CLOSED, OPEN
+        now = [0.0]
+        router = BackendRouter({'circuit_failures': 2, 'circuit_cooldown': 10.0}, clock=lambda: now[0])
+        calls = []
+        outage = [True]
+
+        def recognise(name):
+            calls.append(name)
+            if name == 'google_vision' and outage[0]:
+                raise RuntimeError("deadline exceeded")
+            return name
+
+        for _ in range(2):
+            self.assertEqual(router.run(['google_vision', 'tesseract'], recognise)[0], 'tesseract')
+        self.assertEqual(router.health('google_vision').state, OPEN)
+
+        calls.clear()
+        used, _, reasons = router.run(['google_vision', 'tesseract'], recognise)
+        self.assertEqual((used, calls), ('tesseract', ['tesseract']))
+        self.assertIn('circuit open', reasons['google_vision'])
+
+        outage[0] = False
+        now[0] = 11.0
+        # Checking without calling leaves the probe for the next real request
+        self.assertTrue(router.health('google_vision').accepting())
+        self.assertTrue(router.health('google_vision').accepting())
+        self.assertEqual(router.run(['google_vision', 'tesseract'], recognise)[0], 'google_vision')
+        self.assertEqual(router.health('google_vision').state, CLOSED)
+
+    def test_slow_remote_request_is_hedged(self):
+        """A Vision request past the hedge budget is raced by the local backend and still recorded"""
+        import threading
+        from ocr_engine.backend_router import BackendRouter
+        router = BackendRouter()
+        release = threading.Event()
+
+        def recognise(name):
+            if name == 'google_vision':
+                release.wait(5)
+            return name
+
+        used, result, reasons = router.run(['google_vision', 'tesseract'], recognise, hedge_after=0.05)
+        self.assertEqual((used, result), ('tesseract', 'tesseract'))
+        self.assertIn('hedge budget', reasons['google_vision'])
+
+        release.set()
+        health = router.health('google_vision')
+        deadline = time.time() + 5
+        while health.calls == 0 and time.time() < deadline:
+            time.sleep(0.01)
+        self.assertEqual((health.calls, health.errors), (1, 0))
+        self.assertGreaterEqual(health.latency, 0.05)
+
+    def test_hedged_remote_answer_wins_the_race(self):
+        """Vision answering after the hedge budget but before the local backend is returned at once"""
+        import threading
+        from ocr_engine.backend_router import BackendRouter
+        router = BackendRouter()
+        release = threading.Event()
+
+        def recognise(name):
+            if name == 'google_vision':
+                time.sleep(0.2)
+            else:
+                release.wait(5)
+            return name
+
+        start = time.time()
+        try:
+            used, result, reasons = router.run(['google_vision', 'tesseract'], recognise, hedge_after=0.05)
+        finally:
+            release.set()
+        self.assertEqual((used, result), ('google_vision', 'google_vision'))
+        self.assertLess(time.time() - start, 2)
+        self.assertNotIn('google_vision', reasons)
+
+    def test_last_resort_remote_retries_on_timer(self):
+        """Transient Vision errors are retried only when nothing can fall back; permanent ones never"""
+        from ocr_engine.backend_router import BackendRouter, BackendRoutingError
+        from ocr_engine.error_handler import PermanentOCRError, TransientOCRError
+        router = BackendRouter({'google_vision': {'retry_attempts': 3, 'retry_delay': 0.01}})
+        errors = [TransientOCRError("503 unavailable")]
+        calls = []
+
+        def recognise(name):
+            calls.append(name)
+            if errors:
+                raise errors.pop(0)
+            return 'cloud'
+
+        self.assertEqual(router.run(['google_vision'], recognise)[1], 'cloud')
+        self.assertEqual(len(calls), 2)
+
+        calls.clear()
+        errors[:] = [TransientOCRError("503 unavailable")]
+        self.assertEqual(router.run(['google_vision', 'tesseract'], recognise)[0], 'tesseract')
+        self.assertEqual(calls, ['google_vision', 'tesseract'])
+
+        calls.clear()
+        errors[:] = [PermanentOCRError("invalid credentials")]
+        with self.assertRaises(BackendRoutingError) as raised:
+            router.run(['google_vision'], recognise)
+        self.assertIn('invalid credentials', raised.exception.failures['google_vision'])
+        self.assertEqual(len(calls), 1)
+
+        # A server-requested wait is honoured only up to max_retry_delay
+        quota = TransientOCRError("quota", details={'retry_after': 3600})
+        self.assertEqual(router.retry_policy.retry_wait(quota, 0.01), router.retry_policy.max_retry_delay)
+
 def create_test_suite():
     """Create comprehensive test suite"""
     suite = unittest.TestSuite()
@@ -272,6 +1104,14 @@ def create_test_suite():
     suite.addTest(unittest.makeSuite(TestConfiguration))
     suite.addTest(unittest.makeSuite(TestBatchProcessing))
     suite.addTest(unittest.makeSuite(TestErrorHandling))
+    suite.addTest(unittest.makeSuite(TestPdfOCRPipeline))
+    suite.addTest(unittest.makeSuite(TestEasyOCRReaderPool))
+    suite.addTest(unittest.makeSuite(TestTesseractAPIPool))
+    suite.addTest(unittest.makeSuite(TestOCRResultCache))
+    suite.addTest(unittest.makeSuite(TestTiledOCR))
+    suite.addTest(unittest.makeSuite(TestStreamingOCRBatches))
+    suite.addTest(unittest.makeSuite(TestImageHeaderEstimates))
+    suite.addTest(unittest.makeSuite(TestBackendRouter))
     
     return suite
 
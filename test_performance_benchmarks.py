@@ -323,6 +323,55 @@ class TestPerformanceBenchmarks(unittest.TestCase):
             }
             print("⚠️  No concurrent conversions succeeded")
 
+class TestInProcessBenchmarks(unittest.TestCase):
+    """Smoke tests for the in-process per-stage benchmark suite"""
+
+    def setUp(self):
+        self.temp_dir = Path(tempfile.mkdtemp())
+
+    def tearDown(self):
+        import shutil
+        shutil.rmtree(self.temp_dir, ignore_errors=True)
+
+    def test_quick_reader_writer_suites(self):
+        """Quick run records every registered reader and writer, measured or skipped"""
+        from benchmark_suite import run_suites
+        from converter_core import registry
+
+        document = run_suites(['readers', 'writers'], self.temp_dir, quick=True, quiet=True)
+        results = document['results']
+
+        self.assertIn('cpu_count', document['environment'])
+        self.assertGreater(results['reader.txt.small']['throughput'], 0)
+        self.assertEqual(results['reader.txt.small']['unit'], 'MB')
+        for fmt in registry.writers.keys():
+            record = results[f"writer.{fmt}.small"]
+            self.assertTrue('throughput' in record or 'skipped' in record)
+        json.dumps(document)
+
+    def test_baseline_comparison(self):
+        """Throughput drops beyond the tolerance are regressions; missing/skipped entries are ignored"""
+        from benchmark_suite import compare_to_baseline
+
+        baseline = {
+            'reader.txt': {'throughput': 100.0, 'unit': 'MB'},
+            'writer.txt': {'throughput': 100.0, 'unit': 'MB'},
+            'writer.html': {'throughput': 100.0, 'unit': 'MB'},
+            'ocr.tesseract': {'throughput': 1.0, 'unit': 'pages'},
+        }
+        results = {
+            'reader.txt': {'throughput': 80.0, 'unit': 'MB'},
+            'writer.txt': {'throughput': 95.0, 'unit': 'MB'},
+            'writer.html': {'throughput': 130.0, 'unit': 'MB'},
+            'ocr.tesseract': {'stage': 'ocr', 'skipped': 'no OCR backend available'},
+            'image.pipeline': {'throughput': 5.0, 'unit': 'MP'},
+        }
+
+        report = compare_to_baseline(results, baseline, tolerance=0.15)
+        self.assertEqual([entry['name'] for entry in report['regressions']], ['reader.txt'])
+        self.assertAlmostEqual(report['regressions'][0]['change'], -0.2)
+        self.assertEqual([entry['name'] for entry in report['improvements']], ['writer.html'])
+
 def run_performance_benchmarks():
     """Run performance benchmark tests"""
     print("🏃 Running Performance Benchmarks")
@@ -331,6 +380,7 @@ def run_performance_benchmarks():
     # Create test suite
     test_suite = unittest.TestSuite()
     test_suite.addTest(unittest.makeSuite(TestPerformanceBenchmarks))
+    test_suite.addTest(unittest.makeSuite(TestInProcessBenchmarks))
     
     # Run tests
     runner = unittest.TextTestRunner(verbosity=2)
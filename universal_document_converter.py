@@ -11,1384 +11,23 @@ import threading
 import os
 from pathlib import Path
 import sys
-import mimetypes
-import re
-import logging
-import datetime
-import json
-from typing import Optional, Union, Dict, Any
-import concurrent.futures
+from typing import Optional
 import time
-import hashlib
-from threading import Lock
-import gc
-
-# Optional dependency for memory monitoring
-try:
-    import psutil
-    PSUTIL_AVAILABLE = True
-except ImportError:
-    PSUTIL_AVAILABLE = False
-
-# Custom Exception Classes
-class DocumentConverterError(Exception):
-    """Base exception class for document converter errors"""
-    pass
-
-class UnsupportedFormatError(DocumentConverterError):
-    """Raised when an unsupported file format is encountered"""
-    pass
-
-class FileProcessingError(DocumentConverterError):
-    """Raised when file processing fails"""
-    pass
-
-class DependencyError(DocumentConverterError):
-    """Raised when required dependencies are missing"""
-    pass
-
-class ConfigurationError(DocumentConverterError):
-    """Raised when configuration operations fail"""
-    pass
-
-# Logging System
-class ConverterLogger:
-    """Enhanced logging system for the document converter"""
-
-    def __init__(self, name: str = "DocumentConverter", log_level: str = "INFO"):
-        self.name = name
-        self.log_level = getattr(logging, log_level.upper(), logging.INFO)
-        self._logger = None
-        self._setup_logger()
-
-    def _setup_logger(self):
-        """Setup logger with appropriate handlers and formatting"""
-        self._logger = logging.getLogger(self.name)
-        self._logger.setLevel(self.log_level)
-
-        # Clear existing handlers to avoid duplicates
-        self._logger.handlers.clear()
-
-        # Create formatter
-        formatter = logging.Formatter(
-            '%(asctime)s - %(name)s - %(levelname)s - %(message)s',
-            datefmt='%Y-%m-%d %H:%M:%S'
-        )
-
-        # Console handler
-        console_handler = logging.StreamHandler()
-        console_handler.setLevel(self.log_level)
-        console_handler.setFormatter(formatter)
-        self._logger.addHandler(console_handler)
-
-        # File handler (optional, logs to file in user's temp directory)
-        try:
-            log_dir = Path.home() / "Documents" / "DocumentConverter" / "logs"
-            log_dir.mkdir(parents=True, exist_ok=True)
-            log_file = log_dir / f"converter_{datetime.datetime.now().strftime('%Y%m%d')}.log"
-
-            file_handler = logging.FileHandler(log_file, encoding='utf-8')
-            file_handler.setLevel(logging.DEBUG)  # File gets all messages
-            file_handler.setFormatter(formatter)
-            self._logger.addHandler(file_handler)
-        except Exception:
-            # If file logging fails, continue with console only
-            pass
-
-    def get_logger(self) -> logging.Logger:
-        """Get the configured logger instance"""
-        return self._logger
-
-
-# Configuration Management System
-class ConfigManager:
-    """Manages user preferences, settings persistence, and configuration files"""
-
-    DEFAULT_CONFIG = {
-        'general': {
-            'default_input_format': 'auto',
-            'default_output_format': 'markdown',
-            'default_output_directory': str(Path.home() / "Desktop" / "converted_documents"),
-            'preserve_folder_structure': True,
-            'overwrite_existing_files': False,
-            'auto_open_output_folder': False
-        },
-        'performance': {
-            'enable_caching': True,
-            'max_worker_threads': min(4, (os.cpu_count() or 1) + 1),
-            'memory_threshold_mb': 500,
-            'enable_memory_monitoring': True
-        },
-        'gui': {
-            'window_width': 700,
-            'window_height': 600,
-            'theme': 'light',  # 'light' or 'dark'
-            'font_size': 9,
-            'show_advanced_options': True,
-            'remember_window_position': True,
-            'last_window_x': None,
-            'last_window_y': None
-        },
-        'logging': {
-            'log_level': 'INFO',
-            'enable_file_logging': True,
-            'log_retention_days': 30,
-            'console_logging': True
-        },
-        'formats': {
-            'custom_extensions': {},  # Custom file extension mappings
-            'format_preferences': {}  # Per-format specific settings
-        }
-    }
-
-    def __init__(self, config_file: Optional[str] = None):
-        """Initialize configuration manager
-
-        Args:
-            config_file: Path to configuration file. If None, uses default location.
-        """
-        self.config_dir = Path.home() / ".quick_document_convertor"
-        self.config_dir.mkdir(exist_ok=True)
-
-        if config_file:
-            self.config_file = Path(config_file)
-        else:
-            self.config_file = self.config_dir / "config.json"
-
-        import copy
-        self.config = copy.deepcopy(self.DEFAULT_CONFIG)
-        self.logger = ConverterLogger("ConfigManager").get_logger()
-
-        # Load existing configuration
-        self.load_config()
-
-    def load_config(self) -> bool:
-        """Load configuration from file
-
-        Returns:
-            True if config was loaded successfully, False otherwise
-        """
-        try:
-            if self.config_file.exists():
-                with open(self.config_file, 'r', encoding='utf-8') as f:
-                    loaded_config = json.load(f)
-
-                # Merge with defaults to ensure all keys exist
-                self._merge_config(self.config, loaded_config)
-                self.logger.info(f"Configuration loaded from {self.config_file}")
-                return True
-            else:
-                self.logger.info("No configuration file found, using defaults")
-                return False
-        except Exception as e:
-            self.logger.error(f"Failed to load configuration: {e}")
-            raise ConfigurationError(f"Failed to load configuration: {e}")
-
-    def save_config(self) -> bool:
-        """Save current configuration to file
-
-        Returns:
-            True if config was saved successfully, False otherwise
-        """
-        try:
-            # Ensure config directory exists
-            self.config_file.parent.mkdir(parents=True, exist_ok=True)
-
-            with open(self.config_file, 'w', encoding='utf-8') as f:
-                json.dump(self.config, f, indent=2, ensure_ascii=False)
-
-            self.logger.info(f"Configuration saved to {self.config_file}")
-            return True
-        except Exception as e:
-            self.logger.error(f"Failed to save configuration: {e}")
-            raise ConfigurationError(f"Failed to save configuration: {e}")
-
-    def _merge_config(self, default: dict, loaded: dict) -> None:
-        """Recursively merge loaded config with defaults"""
-        for key, value in loaded.items():
-            if key in default:
-                if isinstance(value, dict) and isinstance(default[key], dict):
-                    self._merge_config(default[key], value)
-                else:
-                    default[key] = value
-
-    def get(self, section: str, key: str, default=None):
-        """Get a configuration value
-
-        Args:
-            section: Configuration section name
-            key: Configuration key name
-            default: Default value if key not found
-
-        Returns:
-            Configuration value or default
-        """
-        try:
-            return self.config.get(section, {}).get(key, default)
-        except Exception:
-            return default
-
-    def set(self, section: str, key: str, value) -> None:
-        """Set a configuration value
-
-        Args:
-            section: Configuration section name
-            key: Configuration key name
-            value: Value to set
-        """
-        if section not in self.config:
-            self.config[section] = {}
-        self.config[section][key] = value
-
-    def get_section(self, section: str) -> dict:
-        """Get entire configuration section
-
-        Args:
-            section: Section name
-
-        Returns:
-            Dictionary containing section configuration
-        """
-        return self.config.get(section, {}).copy()
-
-    def update_section(self, section: str, updates: dict) -> None:
-        """Update multiple values in a configuration section
-
-        Args:
-            section: Section name
-            updates: Dictionary of key-value pairs to update
-        """
-        if section not in self.config:
-            self.config[section] = {}
-        self.config[section].update(updates)
-
-    def reset_to_defaults(self, section: Optional[str] = None) -> None:
-        """Reset configuration to defaults
-
-        Args:
-            section: If specified, only reset this section. Otherwise reset all.
-        """
-        import copy
-        if section:
-            if section in self.DEFAULT_CONFIG:
-                self.config[section] = copy.deepcopy(self.DEFAULT_CONFIG[section])
-                self.logger.info(f"Reset section '{section}' to defaults")
-        else:
-            self.config = copy.deepcopy(self.DEFAULT_CONFIG)
-            self.logger.info("Reset all configuration to defaults")
-
-    def export_config(self, export_path: str) -> bool:
-        """Export configuration to a file
-
-        Args:
-            export_path: Path to export file
-
-        Returns:
-            True if export successful, False otherwise
-        """
-        try:
-            export_file = Path(export_path)
-            with open(export_file, 'w', encoding='utf-8') as f:
-                json.dump(self.config, f, indent=2, ensure_ascii=False)
-            self.logger.info(f"Configuration exported to {export_file}")
-            return True
-        except Exception as e:
-            self.logger.error(f"Failed to export configuration: {e}")
-            return False
-
-    def import_config(self, import_path: str) -> bool:
-        """Import configuration from a file
-
-        Args:
-            import_path: Path to import file
-
-        Returns:
-            True if import successful, False otherwise
-        """
-        try:
-            import_file = Path(import_path)
-            if not import_file.exists():
-                raise FileNotFoundError(f"Configuration file not found: {import_file}")
-
-            with open(import_file, 'r', encoding='utf-8') as f:
-                imported_config = json.load(f)
-
-            # Validate imported config structure
-            if not isinstance(imported_config, dict):
-                raise ValueError("Invalid configuration format")
-
-            # Merge with current config
-            self._merge_config(self.config, imported_config)
-            self.logger.info(f"Configuration imported from {import_file}")
-            return True
-        except Exception as e:
-            self.logger.error(f"Failed to import configuration: {e}")
-            return False
-
-    def set_level(self, level: str):
-        """Change the logging level"""
-        self.log_level = getattr(logging, level.upper(), logging.INFO)
-        self._logger.setLevel(self.log_level)
-        for handler in self._logger.handlers:
-            if isinstance(handler, logging.StreamHandler) and not isinstance(handler, logging.FileHandler):
-                handler.setLevel(self.log_level)
-
-class FormatDetector:
-    """Utility class for detecting and validating file formats"""
-    
-    SUPPORTED_INPUT_FORMATS = {
-        'docx': {'extensions': ['.docx'], 'name': 'Word Document', 'reader': 'DocxReader'},
-        'pdf': {'extensions': ['.pdf'], 'name': 'PDF Document', 'reader': 'PdfReader'},
-        'txt': {'extensions': ['.txt'], 'name': 'Text File', 'reader': 'TxtReader'},
-        'html': {'extensions': ['.html', '.htm'], 'name': 'HTML Document', 'reader': 'HtmlReader'},
-        'rtf': {'extensions': ['.rtf'], 'name': 'Rich Text Format', 'reader': 'RtfReader'},
-        'markdown': {'extensions': ['.md', '.markdown'], 'name': 'Markdown Document', 'reader': 'MarkdownReader'},
-        'epub': {'extensions': ['.epub'], 'name': 'EPUB eBook', 'reader': 'EpubReader'}
-    }
-    
-    SUPPORTED_OUTPUT_FORMATS = {
-        'markdown': {'extension': '.md', 'name': 'Markdown', 'writer': 'MarkdownWriter'},
-        'txt': {'extension': '.txt', 'name': 'Plain Text', 'writer': 'TxtWriter'},
-        'html': {'extension': '.html', 'name': 'HTML Document', 'writer': 'HtmlWriter'},
-        'rtf': {'extension': '.rtf', 'name': 'Rich Text Format', 'writer': 'RtfWriter'},
-        'epub': {'extension': '.epub', 'name': 'EPUB eBook', 'writer': 'EpubWriter'}
-    }
-    
-    @classmethod
-    def detect_format(cls, file_path):
-        """Auto-detect the format of a file"""
-        ext = Path(file_path).suffix.lower()
-        for format_key, format_info in cls.SUPPORTED_INPUT_FORMATS.items():
-            if ext in format_info['extensions']:
-                return format_key
-        return None
-    
-    @classmethod
-    def get_input_format_list(cls):
-        """Get list of input formats for dropdown"""
-        formats = [('Auto-detect', 'auto')]
-        for key, info in cls.SUPPORTED_INPUT_FORMATS.items():
-            formats.append((f"{info['name']} ({', '.join(info['extensions'])})", key))
-        return formats
-    
-    @classmethod
-    def get_output_format_list(cls):
-        """Get list of output formats for dropdown"""
-        formats = []
-        for key, info in cls.SUPPORTED_OUTPUT_FORMATS.items():
-            formats.append((f"{info['name']} ({info['extension']})", key))
-        return formats
-
-class DocumentReader:
-    """Base class for document readers"""
-    
-    def read(self, file_path):
-        """Read document and return text content"""
-        raise NotImplementedError
-
-class DocxReader(DocumentReader):
-    """Reader for DOCX files"""
-    
-    def read(self, file_path):
-        from docx import Document
-        doc = Document(file_path)
-        content = []
-        
-        for paragraph in doc.paragraphs:
-            text = paragraph.text.strip()
-            if text:
-                # Preserve heading structure
-                if paragraph.style.name.startswith('Heading'):
-                    level = int(paragraph.style.name.split()[-1]) if paragraph.style.name.split()[-1].isdigit() else 1
-                    content.append(('heading', level, text))
-                else:
-                    content.append(('paragraph', text))
-        
-        return content
-
-class PdfReader(DocumentReader):
-    """Reader for PDF files"""
-    
-    def read(self, file_path):
-        import PyPDF2
-        
-        with open(file_path, 'rb') as file:
-            pdf_reader = PyPDF2.PdfReader(file)
-            content = []
-            
-            for page_num, page in enumerate(pdf_reader.pages):
-                text = page.extract_text()
-                if text.strip():
-                    content.append(('page', page_num + 1, text.strip()))
-        
-        return content
-
-class TxtReader(DocumentReader):
-    """Reader for TXT files with memory optimization for large files"""
-
-    def __init__(self, chunk_size: int = 8192, max_memory_mb: int = 100):
-        """
-        Initialize TXT reader with memory optimization settings
-
-        Args:
-            chunk_size: Size of chunks to read at a time (bytes)
-            max_memory_mb: Maximum memory to use before switching to streaming mode
-        """
-        self.chunk_size = chunk_size
-        self.max_memory_threshold = max_memory_mb * 1024 * 1024  # Convert to bytes
-
-    def read(self, file_path):
-        file_path = Path(file_path)
-        file_size = file_path.stat().st_size
-
-        # Use streaming for large files
-        if file_size > self.max_memory_threshold:
-            return self._read_large_file(file_path)
-        else:
-            return self._read_small_file(file_path)
-
-    def _read_small_file(self, file_path):
-        """Read small files entirely into memory (original behavior)"""
-        encodings = ['utf-8', 'latin-1', 'cp1252', 'iso-8859-1']
-
-        for encoding in encodings:
-            try:
-                with open(file_path, 'r', encoding=encoding) as file:
-                    text = file.read()
-                    # Split into paragraphs
-                    paragraphs = [p.strip() for p in text.split('\n\n') if p.strip()]
-                    return [('paragraph', p) for p in paragraphs]
-            except UnicodeDecodeError:
-                continue
-
-        raise Exception(f"Could not decode file with encodings: {encodings}")
-
-    def _read_large_file(self, file_path):
-        """Read large files in chunks to minimize memory usage"""
-        encodings = ['utf-8', 'latin-1', 'cp1252', 'iso-8859-1']
-
-        for encoding in encodings:
-            try:
-                paragraphs = []
-                current_paragraph = ""
-
-                with open(file_path, 'r', encoding=encoding, buffering=self.chunk_size) as file:
-                    while True:
-                        chunk = file.read(self.chunk_size)
-                        if not chunk:
-                            break
-
-                        # Process chunk line by line
-                        lines = chunk.split('\n')
-
-                        # Handle partial lines at chunk boundaries
-                        if current_paragraph:
-                            lines[0] = current_paragraph + lines[0]
-                            current_paragraph = ""
-
-                        # Save last partial line for next chunk
-                        if not chunk.endswith('\n') and len(lines) > 1:
-                            current_paragraph = lines[-1]
-                            lines = lines[:-1]
-
-                        # Process complete lines
-                        temp_text = '\n'.join(lines)
-                        chunk_paragraphs = [p.strip() for p in temp_text.split('\n\n') if p.strip()]
-                        paragraphs.extend(chunk_paragraphs)
-
-                # Handle any remaining text
-                if current_paragraph.strip():
-                    paragraphs.append(current_paragraph.strip())
-
-                return [('paragraph', p) for p in paragraphs if p]
-
-            except UnicodeDecodeError:
-                continue
-
-        raise Exception(f"Could not decode file with encodings: {encodings}")
-
-class HtmlReader(DocumentReader):
-    """Reader for HTML files"""
-    
-    def read(self, file_path):
-        from bs4 import BeautifulSoup
-        
-        with open(file_path, 'r', encoding='utf-8') as file:
-            soup = BeautifulSoup(file.read(), 'html.parser')
-        
-        content = []
-        
-        # Extract headings and paragraphs
-        for element in soup.find_all(['h1', 'h2', 'h3', 'h4', 'h5', 'h6', 'p', 'div']):
-            text = element.get_text().strip()
-            if text:
-                if element.name.startswith('h'):
-                    level = int(element.name[1])
-                    content.append(('heading', level, text))
-                else:
-                    content.append(('paragraph', text))
-        
-        return content
-
-class RtfReader(DocumentReader):
-    """Reader for RTF files"""
-    
-    def read(self, file_path):
-        from striprtf.striprtf import rtf_to_text
-        
-        with open(file_path, 'r', encoding='utf-8') as file:
-            rtf_content = file.read()
-        
-        text = rtf_to_text(rtf_content)
-        paragraphs = [p.strip() for p in text.split('\n\n') if p.strip()]
-        return [('paragraph', p) for p in paragraphs]
-
-
-class EpubReader(DocumentReader):
-    """Reader for EPUB files"""
-
-    def read(self, file_path):
-        try:
-            import ebooklib
-            from ebooklib import epub
-        except ImportError:
-            raise DependencyError("ebooklib is required for EPUB support. Install with: pip install ebooklib")
-
-        try:
-            # Read the EPUB file
-            book = epub.read_epub(file_path)
-            content = []
-
-            # Extract metadata
-            title = book.get_metadata('DC', 'title')
-            if title:
-                content.append(('heading', 1, title[0][0]))
-
-            authors = book.get_metadata('DC', 'creator')
-            if authors:
-                author_names = [author[0] for author in authors]
-                content.append(('paragraph', f"By: {', '.join(author_names)}"))
-
-            # Process all document items (chapters)
-            for item in book.get_items():
-                if item.get_type() == ebooklib.ITEM_DOCUMENT:
-                    # Parse HTML content
-                    html_content = item.get_content().decode('utf-8')
-                    chapter_content = self._parse_html_content(html_content, item.get_name())
-                    content.extend(chapter_content)
-
-            return content
-
-        except Exception as e:
-            raise FileProcessingError(f"Failed to read EPUB file: {str(e)}")
-
-    def _parse_html_content(self, html_content, chapter_name):
-        """Parse HTML content from EPUB chapter"""
-        try:
-            from bs4 import BeautifulSoup
-        except ImportError:
-            # Fallback to simple text extraction if BeautifulSoup is not available
-            return self._simple_text_extraction(html_content, chapter_name)
-
-        try:
-            soup = BeautifulSoup(html_content, 'html.parser')
-            content = []
-
-            # Add chapter title if available
-            title_elem = soup.find(['h1', 'h2', 'title'])
-            if title_elem and title_elem.get_text().strip():
-                content.append(('heading', 2, title_elem.get_text().strip()))
-            elif chapter_name and not chapter_name.startswith('nav'):
-                # Use filename as chapter title if no title found
-                clean_name = chapter_name.replace('.xhtml', '').replace('.html', '').replace('_', ' ').title()
-                content.append(('heading', 2, clean_name))
-
-            # Extract content elements
-            for element in soup.find_all(['h1', 'h2', 'h3', 'h4', 'h5', 'h6', 'p', 'div']):
-                text = element.get_text().strip()
-                if text and len(text) > 3:  # Skip very short text
-                    if element.name.startswith('h'):
-                        level = min(int(element.name[1]) + 1, 6)  # Offset by 1 since book title is h1
-                        content.append(('heading', level, text))
-                    else:
-                        content.append(('paragraph', text))
-
-            return content
-
-        except Exception:
-            # Fallback to simple extraction
-            return self._simple_text_extraction(html_content, chapter_name)
-
-    def _simple_text_extraction(self, html_content, chapter_name):
-        """Simple text extraction fallback"""
-        import re
-
-        # Remove HTML tags
-        text = re.sub(r'<[^>]+>', '', html_content)
-        # Clean up whitespace
-        text = re.sub(r'\s+', ' ', text).strip()
-
-        content = []
-        if chapter_name and not chapter_name.startswith('nav'):
-            clean_name = chapter_name.replace('.xhtml', '').replace('.html', '').replace('_', ' ').title()
-            content.append(('heading', 2, clean_name))
-
-        if text:
-            # Split into paragraphs
-            paragraphs = [p.strip() for p in text.split('\n\n') if p.strip()]
-            content.extend([('paragraph', p) for p in paragraphs])
-
-        return content
-
-
-class MarkdownReader(DocumentReader):
-    """Reader for Markdown files"""
-
-    def read(self, file_path):
-        try:
-            import markdown
-        except ImportError:
-            raise DependencyError("markdown is required for Markdown support. Install with: pip install markdown")
-
-        try:
-            # Read the markdown file
-            with open(file_path, 'r', encoding='utf-8') as file:
-                md_content = file.read()
-
-            # Parse markdown content
-            content = self._parse_markdown_content(md_content)
-            return content
-
-        except Exception as e:
-            raise FileProcessingError(f"Failed to read Markdown file: {str(e)}")
-
-    def _parse_markdown_content(self, md_content):
-        """Parse Markdown content and extract structured elements"""
-        content = []
-        lines = md_content.split('\n')
-        
-        current_paragraph = []
-        in_code_block = False
-        code_block_content = []
-        
-        for line in lines:
-            line = line.rstrip()
-            
-            # Handle code blocks
-            if line.startswith('```'):
-                if in_code_block:
-                    # End code block
-                    if code_block_content:
-                        content.append(('code_block', '\n'.join(code_block_content)))
-                    code_block_content = []
-                    in_code_block = False
-                else:
-                    # Start code block
-                    if current_paragraph:
-                        content.append(('paragraph', ' '.join(current_paragraph)))
-                        current_paragraph = []
-                    in_code_block = True
-                continue
-            
-            if in_code_block:
-                code_block_content.append(line)
-                continue
-            
-            # Handle headings
-            if line.startswith('#'):
-                # Finish current paragraph
-                if current_paragraph:
-                    content.append(('paragraph', ' '.join(current_paragraph)))
-                    current_paragraph = []
-                
-                # Extract heading
-                level = 0
-                while level < len(line) and line[level] == '#':
-                    level += 1
-                
-                if level <= 6 and level < len(line) and line[level] == ' ':
-                    heading_text = line[level + 1:].strip()
-                    if heading_text:
-                        content.append(('heading', level, heading_text))
-                continue
-            
-            # Handle empty lines (paragraph breaks)
-            if not line.strip():
-                if current_paragraph:
-                    content.append(('paragraph', ' '.join(current_paragraph)))
-                    current_paragraph = []
-                continue
-            
-            # Handle list items
-            if line.lstrip().startswith(('- ', '* ', '+ ')):
-                # Finish current paragraph
-                if current_paragraph:
-                    content.append(('paragraph', ' '.join(current_paragraph)))
-                    current_paragraph = []
-                
-                list_text = line.lstrip()[2:].strip()
-                if list_text:
-                    content.append(('list_item', list_text))
-                continue
-            
-            # Handle numbered lists
-            import re
-            numbered_list_match = re.match(r'^\s*(\d+)\.\s+(.+)', line)
-            if numbered_list_match:
-                # Finish current paragraph
-                if current_paragraph:
-                    content.append(('paragraph', ' '.join(current_paragraph)))
-                    current_paragraph = []
-                
-                list_text = numbered_list_match.group(2).strip()
-                if list_text:
-                    content.append(('numbered_list_item', list_text))
-                continue
-            
-            # Handle blockquotes
-            if line.lstrip().startswith('> '):
-                # Finish current paragraph
-                if current_paragraph:
-                    content.append(('paragraph', ' '.join(current_paragraph)))
-                    current_paragraph = []
-                
-                quote_text = line.lstrip()[2:].strip()
-                if quote_text:
-                    content.append(('blockquote', quote_text))
-                continue
-            
-            # Regular text - add to current paragraph
-            if line.strip():
-                current_paragraph.append(line.strip())
-        
-        # Finish any remaining paragraph
-        if current_paragraph:
-            content.append(('paragraph', ' '.join(current_paragraph)))
-        
-        # Finish any remaining code block
-        if in_code_block and code_block_content:
-            content.append(('code_block', '\n'.join(code_block_content)))
-        
-        return content
-
-
-class DocumentWriter:
-    """Base class for document writers"""
-    
-    def write(self, content, output_path):
-        """Write content to output file"""
-        raise NotImplementedError
-
-class MarkdownWriter(DocumentWriter):
-    """Writer for Markdown files"""
-    
-    def write(self, content, output_path):
-        lines = []
-        
-        for item in content:
-            if item[0] == 'heading':
-                level, text = item[1], item[2]
-                lines.append(f"{'#' * level} {text}")
-                lines.append("")
-            elif item[0] == 'paragraph':
-                lines.append(item[1])
-                lines.append("")
-            elif item[0] == 'page':
-                page_num, text = item[1], item[2]
-                lines.append(f"## Page {page_num}")
-                lines.append("")
-                lines.append(text)
-                lines.append("")
-        
-        with open(output_path, 'w', encoding='utf-8') as file:
-            file.write('\n'.join(lines))
-
-class TxtWriter(DocumentWriter):
-    """Writer for plain text files"""
-    
-    def write(self, content, output_path):
-        lines = []
-        
-        for item in content:
-            if item[0] == 'heading':
-                text = item[2]
-                lines.append(text.upper())
-                lines.append('=' * len(text))
-                lines.append("")
-            elif item[0] == 'paragraph':
-                lines.append(item[1])
-                lines.append("")
-            elif item[0] == 'page':
-                page_num, text = item[1], item[2]
-                lines.append(f"PAGE {page_num}")
-                lines.append("-" * 20)
-                lines.append(text)
-                lines.append("")
-        
-        with open(output_path, 'w', encoding='utf-8') as file:
-            file.write('\n'.join(lines))
-
-class HtmlWriter(DocumentWriter):
-    """Writer for HTML files"""
-    
-    def write(self, content, output_path):
-        lines = [
-            "<!DOCTYPE html>",
-            "<html lang='en'>",
-            "<head>",
-            "    <meta charset='UTF-8'>",
-            "    <meta name='viewport' content='width=device-width, initial-scale=1.0'>",
-            f"    <title>{Path(output_path).stem}</title>",
-            "    <style>",
-            "        body { font-family: Arial, sans-serif; max-width: 800px; margin: 0 auto; padding: 20px; }",
-            "        h1, h2, h3, h4, h5, h6 { color: #333; }",
-            "        p { line-height: 1.6; margin-bottom: 1em; }",
-            "    </style>",
-            "</head>",
-            "<body>"
-        ]
-        
-        for item in content:
-            if item[0] == 'heading':
-                level, text = item[1], item[2]
-                lines.append(f"    <h{level}>{self._escape_html(text)}</h{level}>")
-            elif item[0] == 'paragraph':
-                lines.append(f"    <p>{self._escape_html(item[1])}</p>")
-            elif item[0] == 'page':
-                page_num, text = item[1], item[2]
-                lines.append(f"    <h2>Page {page_num}</h2>")
-                lines.append(f"    <p>{self._escape_html(text)}</p>")
-        
-        lines.extend(["</body>", "</html>"])
-        
-        with open(output_path, 'w', encoding='utf-8') as file:
-            file.write('\n'.join(lines))
-    
-    def _escape_html(self, text):
-        """Escape HTML special characters"""
-        return (text.replace('&', '&amp;')
-                   .replace('<', '&lt;')
-                   .replace('>', '&gt;')
-                   .replace('"', '&quot;')
-                   .replace("'", '&#x27;'))
-
-class RtfWriter(DocumentWriter):
-    """Writer for RTF files"""
-    
-    def write(self, content, output_path):
-        # Basic RTF structure
-        rtf_lines = [
-            r"{\rtf1\ansi\deff0",
-            r"{\fonttbl{\f0 Times New Roman;}}",
-            r"\f0\fs24"
-        ]
-        
-        for item in content:
-            if item[0] == 'heading':
-                level, text = item[1], item[2]
-                size = max(32 - (level * 4), 20)  # Larger size for higher level headings
-                rtf_lines.append(f"\\par\\fs{size}\\b {self._escape_rtf(text)}\\b0\\fs24")
-            elif item[0] == 'paragraph':
-                rtf_lines.append(f"\\par {self._escape_rtf(item[1])}")
-            elif item[0] == 'page':
-                page_num, text = item[1], item[2]
-                rtf_lines.append(f"\\par\\fs28\\b Page {page_num}\\b0\\fs24")
-                rtf_lines.append(f"\\par {self._escape_rtf(text)}")
-        
-        rtf_lines.append("}")
-        
-        with open(output_path, 'w', encoding='utf-8') as file:
-            file.write(''.join(rtf_lines))
-    
-    def _escape_rtf(self, text):
-        """Escape RTF special characters"""
-        return text.replace('\\', '\\\\').replace('{', '\\{').replace('}', '\\}')
-
-
-class EpubWriter(DocumentWriter):
-    """Writer for EPUB files"""
-
-    def write(self, content, output_path):
-        try:
-            import ebooklib
-            from ebooklib import epub
-        except ImportError:
-            raise DependencyError("ebooklib is required for EPUB support. Install with: pip install ebooklib")
-
-        try:
-            # Create new EPUB book
-            book = epub.EpubBook()
-
-            # Extract title and author from content
-            title = "Converted Document"
-            author = "Unknown Author"
-
-            # Look for title in first heading
-            for item in content:
-                if item[0] == 'heading' and item[1] == 1:
-                    title = item[2]
-                    break
-
-            # Look for author in content
-            for item in content:
-                if item[0] == 'paragraph' and item[1].lower().startswith('by:'):
-                    author = item[1][3:].strip()
-                    break
-
-            # Set metadata
-            book.set_identifier(f"converted-{hash(str(content)) % 1000000}")
-            book.set_title(title)
-            book.set_language('en')
-            book.add_author(author)
-
-            # Create chapters
-            chapters = []
-            current_chapter = None
-            current_chapter_content = []
-            chapter_count = 0
-
-            for item in content:
-                if item[0] == 'heading' and item[1] <= 2:
-                    # Start new chapter
-                    if current_chapter is not None:
-                        # Save previous chapter
-                        self._finalize_chapter(current_chapter, current_chapter_content)
-                        chapters.append(current_chapter)
-                        book.add_item(current_chapter)
-
-                    # Create new chapter
-                    chapter_count += 1
-                    chapter_title = item[2] if item[1] == 1 else item[2]
-                    current_chapter = epub.EpubHtml(
-                        title=chapter_title,
-                        file_name=f'chap_{chapter_count:02d}.xhtml',
-                        lang='en'
-                    )
-                    current_chapter_content = []
-
-                    # Add heading to chapter content
-                    level = item[1]
-                    current_chapter_content.append(f'<h{level}>{self._escape_html(item[2])}</h{level}>')
-
-                elif item[0] == 'heading':
-                    # Add sub-heading to current chapter
-                    if current_chapter is None:
-                        # Create first chapter if none exists
-                        chapter_count += 1
-                        current_chapter = epub.EpubHtml(
-                            title="Chapter 1",
-                            file_name=f'chap_{chapter_count:02d}.xhtml',
-                            lang='en'
-                        )
-                        current_chapter_content = []
-
-                    level = min(item[1], 6)
-                    current_chapter_content.append(f'<h{level}>{self._escape_html(item[2])}</h{level}>')
-
-                elif item[0] == 'paragraph':
-                    # Add paragraph to current chapter
-                    if current_chapter is None:
-                        # Create first chapter if none exists
-                        chapter_count += 1
-                        current_chapter = epub.EpubHtml(
-                            title="Chapter 1",
-                            file_name=f'chap_{chapter_count:02d}.xhtml',
-                            lang='en'
-                        )
-                        current_chapter_content = []
-
-                    # Skip author line if it's already in metadata
-                    if not (item[1].lower().startswith('by:') and author != "Unknown Author"):
-                        current_chapter_content.append(f'<p>{self._escape_html(item[1])}</p>')
-
-                elif item[0] == 'page':
-                    # Handle page breaks from PDF
-                    if current_chapter is None:
-                        chapter_count += 1
-                        current_chapter = epub.EpubHtml(
-                            title=f"Page {item[1]}",
-                            file_name=f'chap_{chapter_count:02d}.xhtml',
-                            lang='en'
-                        )
-                        current_chapter_content = []
-
-                    current_chapter_content.append(f'<h3>Page {item[1]}</h3>')
-                    current_chapter_content.append(f'<p>{self._escape_html(item[2])}</p>')
-
-            # Finalize last chapter
-            if current_chapter is not None:
-                self._finalize_chapter(current_chapter, current_chapter_content)
-                chapters.append(current_chapter)
-                book.add_item(current_chapter)
-
-            # Create table of contents
-            book.toc = chapters
-
-            # Add navigation files
-            book.add_item(epub.EpubNcx())
-            book.add_item(epub.EpubNav())
-
-            # Add basic CSS
-            style = """
-                body {
-                    font-family: Georgia, serif;
-                    line-height: 1.6;
-                    margin: 2em;
-                }
-                h1, h2, h3, h4, h5, h6 {
-                    color: #333;
-                    margin-top: 1.5em;
-                    margin-bottom: 0.5em;
-                }
-                p {
-                    margin-bottom: 1em;
-                    text-align: justify;
-                }
-            """
-            nav_css = epub.EpubItem(
-                uid="style_nav",
-                file_name="style/nav.css",
-                media_type="text/css",
-                content=style
-            )
-            book.add_item(nav_css)
-
-            # Define spine (reading order)
-            book.spine = ['nav'] + chapters
-
-            # Write EPUB file
-            epub.write_epub(output_path, book, {})
-
-        except Exception as e:
-            raise FileProcessingError(f"Failed to write EPUB file: {str(e)}")
-
-    def _finalize_chapter(self, chapter, content_list):
-        """Finalize chapter with proper HTML structure"""
-        html_content = f"""
-        <html xmlns="http://www.w3.org/1999/xhtml">
-        <head>
-            <title>{chapter.title}</title>
-            <link rel="stylesheet" type="text/css" href="../style/nav.css"/>
-        </head>
-        <body>
-            {''.join(content_list)}
-        </body>
-        </html>
-        """
-        chapter.content = html_content
-
-    def _escape_html(self, text):
-        """Escape HTML special characters"""
-        return (text.replace('&', '&amp;')
-                   .replace('<', '&lt;')
-                   .replace('>', '&gt;')
-                   .replace('"', '&quot;')
-                   .replace("'", '&#x27;'))
-
-
-class UniversalConverter:
-    """Main conversion engine with enhanced logging, caching, and performance optimization"""
-
-    def __init__(self, logger_name: str = "UniversalConverter", enable_caching: Optional[bool] = None,
-                 config_manager: Optional[ConfigManager] = None):
-        # Initialize configuration manager
-        self.config_manager = config_manager or ConfigManager()
-
-        # Get configuration values
-        if enable_caching is None:
-            enable_caching = self.config_manager.get('performance', 'enable_caching', True)
-
-        log_level = self.config_manager.get('logging', 'log_level', 'INFO')
-        self.logger_instance = ConverterLogger(logger_name, log_level)
-        self.logger = self.logger_instance.get_logger()
-
-        self.readers = {
-            'docx': DocxReader(),
-            'pdf': PdfReader(),
-            'txt': TxtReader(),
-            'html': HtmlReader(),
-            'rtf': RtfReader(),
-            'markdown': MarkdownReader(),
-            'epub': EpubReader()
-        }
-
-        self.writers = {
-            'markdown': MarkdownWriter(),
-            'txt': TxtWriter(),
-            'html': HtmlWriter(),
-            'rtf': RtfWriter(),
-            'epub': EpubWriter()
-        }
-
-        # Performance optimization features from config
-        self.enable_caching = enable_caching
-        self.cache = {}  # Simple in-memory cache
-        self.cache_lock = Lock()  # Thread-safe cache access
-
-        # Memory optimization features from config
-        self.memory_threshold_mb = self.config_manager.get('performance', 'memory_threshold_mb', 500)
-        self.enable_memory_monitoring = (PSUTIL_AVAILABLE and
-                                       self.config_manager.get('performance', 'enable_memory_monitoring', True))
-
-        self.logger.info("UniversalConverter initialized successfully")
-
-    def _get_memory_usage_mb(self) -> float:
-        """Get current memory usage in MB"""
-        if not PSUTIL_AVAILABLE:
-            return 0.0
-        try:
-            process = psutil.Process()
-            return process.memory_info().rss / 1024 / 1024
-        except Exception:
-            return 0.0
-
-    def _should_optimize_memory(self) -> bool:
-        """Check if memory optimization should be enabled"""
-        if not self.enable_memory_monitoring:
-            return False
-
-        current_memory = self._get_memory_usage_mb()
-        return current_memory > self.memory_threshold_mb
-
-    def _cleanup_memory(self):
-        """Force garbage collection to free memory"""
-        gc.collect()
-
-        # Clear cache if memory usage is high
-        if self._should_optimize_memory():
-            with self.cache_lock:
-                cache_size = len(self.cache)
-                if cache_size > 0:
-                    self.cache.clear()
-                    self.logger.debug(f"Cleared cache ({cache_size} entries) due to high memory usage")
-
-    def _get_file_hash(self, file_path: Path) -> str:
-        """Generate a hash for file content and metadata for caching"""
-        try:
-            stat = file_path.stat()
-            # Use file size, modification time, and path for hash
-            content = f"{file_path}:{stat.st_size}:{stat.st_mtime}"
-            return hashlib.md5(content.encode()).hexdigest()
-        except Exception:
-            return None
-
-    def _get_cache_key(self, input_path: Path, output_format: str, input_format: str) -> str:
-        """Generate cache key for conversion"""
-        file_hash = self._get_file_hash(input_path)
-        if file_hash:
-            return f"{file_hash}:{input_format}:{output_format}"
-        return None
-
-    def _is_cached_valid(self, input_path: Path, output_path: Path, cache_key: str) -> bool:
-        """Check if cached result is still valid"""
-        if not self.enable_caching or cache_key not in self.cache:
-            return False
-
-        # Check if output file exists and is newer than input
-        if not output_path.exists():
-            return False
-
-        try:
-            input_mtime = input_path.stat().st_mtime
-            output_mtime = output_path.stat().st_mtime
-            return output_mtime >= input_mtime
-        except Exception:
-            return False
-
-    def convert_file(self, input_path: Union[str, Path], output_path: Union[str, Path],
-                    input_format: Optional[str] = None, output_format: str = 'markdown'):
-        """Convert a single file with enhanced error handling and logging"""
-        try:
-            input_path = Path(input_path)
-            output_path = Path(output_path)
-
-            self.logger.info(f"Starting conversion: {input_path} -> {output_path}")
-
-            # Validate input file exists
-            if not input_path.exists():
-                raise FileProcessingError(f"Input file does not exist: {input_path}")
-
-            # Auto-detect format if not specified
-            if input_format is None or input_format == 'auto':
-                input_format = FormatDetector.detect_format(input_path)
-                if input_format is None:
-                    raise UnsupportedFormatError(f"Unsupported file format: {input_path}")
-                self.logger.debug(f"Auto-detected format: {input_format}")
-
-            # Validate input format
-            if input_format not in self.readers:
-                raise UnsupportedFormatError(f"No reader available for format: {input_format}")
-
-            # Validate output format
-            if output_format not in self.writers:
-                raise UnsupportedFormatError(f"No writer available for format: {output_format}")
-
-            # Check cache if enabled
-            cache_key = None
-            if self.enable_caching:
-                cache_key = self._get_cache_key(input_path, output_format, input_format)
-                if cache_key and self._is_cached_valid(input_path, output_path, cache_key):
-                    self.logger.debug(f"Using cached result for {input_path}")
-                    return
-
-            # Monitor memory before processing
-            initial_memory = self._get_memory_usage_mb()
-            if self.enable_memory_monitoring:
-                self.logger.debug(f"Memory usage before conversion: {initial_memory:.1f} MB")
-
-            # Read the document
-            self.logger.debug(f"Reading document with {input_format} reader")
-            try:
-                content = self.readers[input_format].read(input_path)
-
-                # Check memory after reading
-                if self.enable_memory_monitoring:
-                    post_read_memory = self._get_memory_usage_mb()
-                    memory_increase = post_read_memory - initial_memory
-                    if memory_increase > 50:  # Log if memory increased by more than 50MB
-                        self.logger.debug(f"Memory increased by {memory_increase:.1f} MB after reading")
-
-                    # Cleanup if memory usage is high
-                    if self._should_optimize_memory():
-                        self._cleanup_memory()
-
-            except Exception as e:
-                raise FileProcessingError(f"Failed to read {input_path}: {str(e)}")
-
-            # Create output directory if needed
-            output_path.parent.mkdir(parents=True, exist_ok=True)
-
-            # Write the output
-            self.logger.debug(f"Writing document with {output_format} writer")
-            try:
-                self.writers[output_format].write(content, output_path)
-            except Exception as e:
-                raise FileProcessingError(f"Failed to write {output_path}: {str(e)}")
-
-            # Clear content from memory immediately after writing
-            del content
-
-            # Update cache if enabled
-            if self.enable_caching and cache_key:
-                with self.cache_lock:
-                    self.cache[cache_key] = {
-                        'timestamp': time.time(),
-                        'input_path': str(input_path),
-                        'output_path': str(output_path)
-                    }
-
-            # Final memory check
-            if self.enable_memory_monitoring:
-                final_memory = self._get_memory_usage_mb()
-                total_change = final_memory - initial_memory
-                if abs(total_change) > 10:  # Log significant memory changes
-                    self.logger.debug(f"Memory change during conversion: {total_change:+.1f} MB")
-
-            self.logger.info(f"Conversion completed successfully: {input_path} -> {output_path}")
-
-        except (UnsupportedFormatError, FileProcessingError) as e:
-            self.logger.error(f"Conversion failed: {str(e)}")
-            raise
-        except Exception as e:
-            error_msg = f"Unexpected error during conversion: {str(e)}"
-            self.logger.error(error_msg)
-            raise DocumentConverterError(error_msg) from e
-
-    def convert_batch(self, file_list: list, output_dir: Path, input_format: str = 'auto',
-                     output_format: str = 'markdown', max_workers: int = None,
-                     progress_callback=None, preserve_structure: bool = True,
-                     overwrite_existing: bool = False, base_dir: Path = None) -> Dict[str, Any]:
-        """
-        Convert multiple files concurrently with progress tracking
-
-        Args:
-            file_list: List of input file paths
-            output_dir: Output directory
-            input_format: Input format ('auto' for detection)
-            output_format: Output format
-            max_workers: Maximum number of concurrent workers (None for auto)
-            progress_callback: Function to call with progress updates
-            preserve_structure: Whether to preserve directory structure
-            overwrite_existing: Whether to overwrite existing files
-            base_dir: Base directory for structure preservation
-
-        Returns:
-            Dictionary with conversion results and statistics
-        """
-        if max_workers is None:
-            max_workers = min(4, (os.cpu_count() or 1) + 1)  # Conservative default
-
-        self.logger.info(f"Starting batch conversion of {len(file_list)} files with {max_workers} workers")
-
-        results = {
-            'successful': 0,
-            'failed': 0,
-            'skipped': 0,
-            'total': len(file_list),
-            'errors': [],
-            'start_time': time.time()
-        }
-
-        def convert_single_file(file_info):
-            """Convert a single file with error handling"""
-            file_path, index = file_info
-            try:
-                file_path = Path(file_path)
-
-                # Determine output path
-                if preserve_structure and base_dir:
-                    rel_path = file_path.relative_to(base_dir)
-                    output_ext = FormatDetector.SUPPORTED_OUTPUT_FORMATS[output_format]['extension']
-                    output_file_path = output_dir / rel_path.with_suffix(output_ext)
-                else:
-                    output_ext = FormatDetector.SUPPORTED_OUTPUT_FORMATS[output_format]['extension']
-                    output_file_path = output_dir / f"{file_path.stem}{output_ext}"
-
-                # Skip if exists and not overwriting
-                if output_file_path.exists() and not overwrite_existing:
-                    return {'status': 'skipped', 'file': file_path.name, 'index': index}
-
-                # Convert the file
-                self.convert_file(file_path, output_file_path, input_format, output_format)
-
-                return {'status': 'success', 'file': file_path.name, 'output': output_file_path.name, 'index': index}
-
-            except Exception as e:
-                return {'status': 'error', 'file': file_path.name, 'error': str(e), 'index': index}
-
-        # Execute conversions concurrently
-        with concurrent.futures.ThreadPoolExecutor(max_workers=max_workers) as executor:
-            # Submit all tasks
-            future_to_file = {
-                executor.submit(convert_single_file, (file_path, i)): (file_path, i)
-                for i, file_path in enumerate(file_list)
-            }
-
-            # Process completed tasks
-            for future in concurrent.futures.as_completed(future_to_file):
-                result = future.result()
-
-                if result['status'] == 'success':
-                    results['successful'] += 1
-                elif result['status'] == 'error':
-                    results['failed'] += 1
-                    results['errors'].append(result)
-                elif result['status'] == 'skipped':
-                    results['skipped'] += 1
-
-                # Call progress callback if provided
-                if progress_callback:
-                    completed = results['successful'] + results['failed'] + results['skipped']
-                    progress_callback(completed, results['total'], result)
-
-        results['end_time'] = time.time()
-        results['duration'] = results['end_time'] - results['start_time']
-
-        self.logger.info(f"Batch conversion completed: {results['successful']} successful, "
-                        f"{results['failed']} failed, {results['skipped']} skipped in "
-                        f"{results['duration']:.2f} seconds")
 
-        return results
+# The conversion engine lives in the GUI-free converter_core package; its
+# public names are re-exported here for code that still imports them from
+# this module.
+from converter_core import (
+    DocumentConverterError, UnsupportedFormatError, FileProcessingError, ContentReadError,
+    DependencyError, ConfigurationError, ConverterLogger, ConfigManager, FormatDetector,
+    FormatRegistry, register_reader, register_writer,
+    DocumentReader, DocxReader, PdfReader, TxtReader, HtmlReader, RtfReader, EpubReader, MarkdownReader,
+    DocumentWriter, MarkdownWriter, TxtWriter, HtmlWriter, RtfWriter, EpubWriter,
+    ContentCache, UniversalConverter, BATCH_EXECUTORS
+)
+from converter_core.cache import _ContentRecorder
+from converter_core.engine import PSUTIL_AVAILABLE, _init_batch_worker, _convert_batch_chunk
+from converter_core.scheduler import PRIORITY_NORMAL, Job
 
 
 class SettingsDialog:
@@ -1785,6 +424,7 @@ class UniversalDocumentConverterGUI:
 
         # Initialize converter with config
         self.converter = UniversalConverter("GUI_Converter", config_manager=self.config_manager)
+        self.conversion_job = None
 
         # Variables with config defaults
         self.input_path = tk.StringVar()
@@ -2229,6 +869,9 @@ class UniversalDocumentConverterGUI:
         except Exception as e:
             self.logger.error(f"Error saving settings on close: {e}")
         finally:
+            # Stop a running batch mid-file rather than leaving it to finish in the background
+            if self.conversion_job is not None:
+                self.conversion_job.cancel()
             # Close the application
             self.root.destroy()
 
@@ -2699,7 +1342,9 @@ After setting up file associations, you can double-click EPUB files to open them
                 else:
                     self.update_status(f"Converting... {completed}/{total}")
 
-            # Use batch conversion with multi-threading
+            # Use batch conversion with multi-threading; as a normal-priority
+            # job it runs ahead of background batches on the shared workers
+            self.conversion_job = Job("GUI batch", PRIORITY_NORMAL)
             results = self.converter.convert_batch(
                 file_list=files_to_convert,
                 output_dir=output_dir,
@@ -2709,7 +1354,8 @@ After setting up file associations, you can double-click EPUB files to open them
                 progress_callback=progress_callback,
                 preserve_structure=self.preserve_structure.get(),
                 overwrite_existing=self.overwrite_existing.get(),
-                base_dir=base_dir
+                base_dir=base_dir,
+                job=self.conversion_job
             )
 
             # Final results
@@ -36,6 +36,8 @@ import shutil
 from ocr_engine.ocr_integration import OCRIntegration
 from ocr_engine.format_detector import OCRFormatDetector
 from ocr_engine.config_manager import ConfigManager
+from converter_core.errors import JobCancelled
+from converter_core.scheduler import PRIORITY_INTERACTIVE, PRIORITY_NORMAL, Job, shared_scheduler
 
 # Import OCR Settings GUI
 try:
@@ -67,6 +69,8 @@ class DocumentConverterApp:
         # State variables
         self.current_files = []
         self.processing_thread = None
+        self.conversion_job = None
+        self.preview_job = None
         self.is_processing = False
         self.processed_count = 0
         self.total_files = 0
@@ -532,6 +536,7 @@ class DocumentConverterApp:
         self.start_button.config(state=tk.DISABLED)
         self.cancel_button.config(state=tk.NORMAL)
         
+        self.conversion_job = Job("GUI conversion", PRIORITY_NORMAL)
         self.processing_thread = threading.Thread(target=self.process_files)
         self.processing_thread.daemon = True
         self.processing_thread.start()
@@ -539,24 +544,32 @@ class DocumentConverterApp:
     def cancel_conversion(self):
         """Cancel the conversion process"""
         self.is_processing = False
+        if self.conversion_job is not None:
+            # Also stops the file being converted at its next block or page
+            self.conversion_job.cancel()
         self.status_label.config(text="Cancelling...")
         
     def process_files(self):
-        """Process all files in the queue"""
+        """Process all files in the queue, each on the shared scheduler at normal priority"""
+        job = self.conversion_job
+        scheduler = shared_scheduler()
         try:
             output_dir = Path(self.output_dir_var.get())
             output_dir.mkdir(parents=True, exist_ok=True)
             
             for i, file_path in enumerate(self.current_files):
-                if not self.is_processing:
+                if not self.is_processing or job.cancelled:
                     break
                     
                 self.update_status(f"Processing {os.path.basename(file_path)}...")
                 self.update_progress((i / self.total_files) * 100)
                 
                 try:
-                    self.process_single_file(file_path, output_dir)
+                    scheduler.run(self.process_single_file, file_path, output_dir, job=job)
                     self.processed_count += 1
+                    job.progress(i + 1, self.total_files, file=file_path)
+                except (JobCancelled, concurrent.futures.CancelledError):
+                    break
                 except Exception as e:
                     self.log_error(f"Error processing {file_path}: {str(e)}")
                     
@@ -866,6 +879,9 @@ Enhanced by Terragon Labs"""
             ]
         )
         if filename:
+            if Path(filename).suffix.lower() in ('.docx', '.pdf'):
+                self.reader_stream_file(window, filename)
+                return
             try:
                 # Simple text file reading (can be enhanced for other formats)
                 with open(filename, 'r', encoding='utf-8') as f:
@@ -876,6 +892,43 @@ Enhanced by Terragon Labs"""
             except Exception as e:
                 messagebox.showerror("Error", f"Failed to open file: {str(e)}")
     
+    def reader_stream_file(self, window, filename: str):
+        """Show a document's text a few pages at a time, so the first pages appear at once"""
+        window.reader_text.delete(1.0, tk.END)
+        window.title(f"Document Reader - {Path(filename).name}")
+        window.reader_request = getattr(window, 'reader_request', 0) + 1
+        request = window.reader_request
+        
+        def append(text):
+            if window.winfo_exists() and window.reader_request == request:
+                window.reader_text.insert(tk.END, text + "\n")
+        
+        if self.preview_job is not None:
+            self.preview_job.cancel()
+        job = self.preview_job = Job(f"Reader {Path(filename).name}", PRIORITY_INTERACTIVE)
+        
+        def work():
+            cursor = None
+            # Growing parts: the first screen is quick, and formats that cannot
+            # seek (DOCX re-parses to reach the cursor) are parsed only a few times
+            scale = 1
+            try:
+                while window.reader_request == request and not job.cancelled:
+                    text, cursor = self.load_preview_part(filename, 'txt', cursor, 3 * scale, 50 * scale,
+                                                          64 * 1024 * scale)
+                    self.root.after(0, append, text)
+                    if cursor is None:
+                        break
+                    scale *= 4
+            except JobCancelled:
+                pass
+            except Exception as e:
+                message = f"Failed to open file: {str(e)}"
+                self.root.after(0, lambda: messagebox.showerror("Error", message))
+        
+        # Interactive priority: starts ahead of queued batch work
+        shared_scheduler().submit(work, job=job)
+    
     def reader_save_file(self, window):
         """Save file from document reader"""
         filename = filedialog.asksaveasfilename(
@@ -943,37 +996,86 @@ Enhanced by Terragon Labs"""
         file_combo.pack(side="left", padx=(5, 20))
         
         ttk.Label(control_frame, text="Format:").pack(side="left")
-        preview_format_var = tk.StringVar(value=self.format_var.get())
+        preview_formats = ["txt", "markdown", "html"]
+        preview_format_var = tk.StringVar(value=self.format_var.get() if self.format_var.get() in preview_formats
+                                          else "markdown")
         format_combo = ttk.Combobox(control_frame, textvariable=preview_format_var,
-                                   values=["txt", "markdown", "html"], state="readonly", width=15)
+                                   values=preview_formats, state="readonly", width=15)
         format_combo.pack(side="left", padx=(5, 0))
         
+        more_button = ttk.Button(control_frame, text="Load More", state=tk.DISABLED)
+        more_button.pack(side="right")
+        
         # Preview content
         preview_text = scrolledtext.ScrolledText(preview_window, wrap=tk.WORD, font=("Consolas", 10))
         preview_text.pack(fill="both", expand=True, padx=5, pady=(0, 5))
         
-        # Sample preview content
-        preview_text.insert(1.0, """# Document Preview
+        # Only the first screen is extracted; "Load More" continues from the cursor
+        state = {'cursor': None, 'request': 0}
         
-This is a preview of how your document will look after conversion.
-
-## Features:
-- ✅ OCR text extraction
-- ✅ Format preservation  
-- ✅ Multiple output formats
-- ✅ Batch processing
-
-> **Note**: This is a sample preview. Actual output will vary based on your files and settings.
-
-### Supported Formats:
-| Format | Description | Use Case |
-|--------|-------------|----------|
-| TXT | Plain text | Simple text extraction |
-| Markdown | Formatted text | Documentation, notes |
-| HTML | Web format | Web publishing |
-| DOCX | Word document | Office documents |
-| PDF | Portable format | Archiving, sharing |
-""")
+        def show_part(request, text, cursor, append):
+            if request != state['request'] or not preview_window.winfo_exists():
+                return
+            if not append:
+                preview_text.delete(1.0, tk.END)
+            preview_text.insert(tk.END, text + "\n")
+            state['cursor'] = cursor
+            more_button.config(state=tk.NORMAL if cursor is not None else tk.DISABLED)
+        
+        def load(append=False):
+            if not file_var.get():
+                return
+            file_path = self.current_files[file_combo.current()]
+            output_format = preview_format_var.get()
+            cursor = state['cursor'] if append else None
+            state['request'] += 1
+            request = state['request']
+            more_button.config(state=tk.DISABLED)
+            if not append:
+                preview_text.delete(1.0, tk.END)
+                preview_text.insert(1.0, "Loading preview...")
+            # A newer request supersedes a preview still being extracted
+            if self.preview_job is not None:
+                self.preview_job.cancel()
+            job = self.preview_job = Job(f"Preview {Path(file_path).name}", PRIORITY_INTERACTIVE)
+            
+            def work():
+                try:
+                    text, next_cursor = self.load_preview_part(file_path, output_format, cursor)
+                except JobCancelled:
+                    return
+                except Exception as e:
+                    text, next_cursor = f"Preview failed: {e}", None
+                self.root.after(0, lambda: show_part(request, text, next_cursor, append))
+            
+            shared_scheduler().submit(work, job=job)
+        
+        file_combo.bind("<<ComboboxSelected>>", lambda _: load())
+        format_combo.bind("<<ComboboxSelected>>", lambda _: load())
+        more_button.config(command=lambda: load(append=True))
+        
+        file_combo.current(0)
+        load()
+    
+    def load_preview_part(self, file_path: str, output_format: str, cursor=None, max_pages: int = 3,
+                          max_blocks: int = 50, max_bytes: int = 64 * 1024):
+        """
+        Extract one screen of a file for the preview window
+        
+        Returns (text, cursor); cursor is None once the whole file is shown.
+        """
+        from converter_core import FormatDetector, UniversalConverter
+        
+        if FormatDetector.detect_format(file_path) is not None:
+            if not hasattr(self, 'preview_converter'):
+                self.preview_converter = UniversalConverter(enable_caching=False)
+            part = self.preview_converter.preview(file_path, output_format, max_pages=max_pages,
+                                                  max_blocks=max_blocks, max_bytes=max_bytes, cursor=cursor)
+            return part['text'], part['cursor']
+        
+        # Images: one OCR pass is the whole document
+        result = self.ocr_integration.ocr_engine.extract_text(file_path)
+        return result.get('text', ''), None
     
     def open_bidirectional_editor(self):
         """Open bidirectional markdown editor"""
@@ -16,9 +16,9 @@ from typing import Dict, Any, Optional
 sys.path.insert(0, str(Path(__file__).parent.parent))
 
 try:
-    from cli import main as cli_main, parse_args
-    from ocr_engine.ocr_integration import OCRIntegration
-    from ocr_engine.config_manager import ConfigManager
+    # Only the GUI-free conversion core is loaded here; the OCR engine (numpy,
+    # OpenCV, backends) is imported on the first OCR call
+    from pipe_server import ConversionService
     CLI_AVAILABLE = True
 except ImportError as e:
     CLI_AVAILABLE = False
@@ -39,8 +39,8 @@ class UniversalConverter32:
         # Initialize OCR integration if available
         if CLI_AVAILABLE:
             try:
-                self.config_manager = ConfigManager()
-                self.ocr_integration = OCRIntegration(config_manager=self.config_manager)
+                # Warm converter reused by every call instead of a fresh CLI per document
+                self.service = ConversionService(ocr_factory=self._create_ocr_integration)
                 self.initialized = True
             except Exception as e:
                 self.last_error = f"Initialization failed: {e}"
@@ -49,6 +49,18 @@ class UniversalConverter32:
             self.initialized = False
             self.last_error = f"CLI module not available: {IMPORT_ERROR if 'IMPORT_ERROR' in globals() else 'Unknown error'}"
     
+    @staticmethod
+    def _create_ocr_integration():
+        """Build the OCR integration from the OCR settings on first use"""
+        from ocr_engine.ocr_integration import OCRIntegration
+        from ocr_engine.config_manager import ConfigManager
+        return OCRIntegration(config_manager=ConfigManager())
+
+    @property
+    def ocr_integration(self):
+        """OCR integration, loaded by the conversion service on first use"""
+        return self.service.ocr_integration
+
     def ConvertDocument(self, input_path: str, output_path: str, output_format: str = "txt") -> int:
         """
         Convert document from input to output format
@@ -72,23 +84,12 @@ class UniversalConverter32:
             output_dir.mkdir(parents=True, exist_ok=True)
             
             if self.initialized and CLI_AVAILABLE:
-                # Use CLI directly
-                sys.argv = [
-                    'cli.py',
-                    input_path,
-                    '-o', output_path,
-                    '-t', output_format,
-                    '--quiet'
-                ]
-                
-                result = cli_main()
-                
-                if result == 0:  # Success
-                    self.last_error = ""
-                    return 1
-                else:
-                    self.last_error = "Conversion failed"
-                    return 0
+                # Use the in-process conversion service
+                return self._service_conversion({
+                    'input': input_path,
+                    'output': output_path,
+                    'output_format': output_format
+                })
             else:
                 # Fallback: Use subprocess to call CLI
                 return self._fallback_conversion(input_path, output_path, output_format, False)
@@ -122,25 +123,14 @@ class UniversalConverter32:
             output_dir.mkdir(parents=True, exist_ok=True)
             
             if self.initialized and CLI_AVAILABLE:
-                # Use CLI with OCR options
-                sys.argv = [
-                    'cli.py',
-                    input_path,
-                    '-o', output_path,
-                    '-t', output_format,
-                    '--ocr',
-                    '--lang', ocr_language,
-                    '--quiet'
-                ]
-                
-                result = cli_main()
-                
-                if result == 0:  # Success
-                    self.last_error = ""
-                    return 1
-                else:
-                    self.last_error = "OCR conversion failed"
-                    return 0
+                # Use the in-process conversion service with OCR
+                return self._service_conversion({
+                    'input': input_path,
+                    'output': output_path,
+                    'output_format': output_format,
+                    'ocr': True,
+                    'language': ocr_language
+                })
             else:
                 # Fallback: Use subprocess to call CLI with OCR
                 return self._fallback_conversion(input_path, output_path, output_format, True, ocr_language)
@@ -149,6 +139,15 @@ class UniversalConverter32:
             self.last_error = str(e)
             return 0
     
+    def _service_conversion(self, request: Dict[str, Any]) -> int:
+        """Run one request through the warm conversion service"""
+        response = self.service.handle(request)
+        if response.get('status') == 'success':
+            self.last_error = ""
+            return 1
+        self.last_error = response.get('error', 'Conversion failed')
+        return 0
+    
     def _fallback_conversion(self, input_path: str, output_path: str, output_format: str, 
                            use_ocr: bool = False, ocr_language: str = "eng") -> int:
         """